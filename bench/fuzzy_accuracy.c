@@ -0,0 +1,449 @@
+/*******************************************************************************
+* \file     fuzzy_accuracy.c
+* \author   Ilya Petrukhin (ilya.petrukhin@gmail.com)
+* \brief    Accuracy against speed of the evaluation engines: every variant
+*           on the whole input domain against the double reference
+*           Usage: fuzzy_accuracy [-fcl file | -ts] [-csv file] [-ms time]
+*           Build: gcc -O2 -pthread -Isrc bench/fuzzy_accuracy.c src/fuzzy_*.c
+*                  src/line_controller.c src/line_controller_gen.c -o fuzzy_accuracy
+* \version  2.1
+* \date     2026-10-17
+*******************************************************************************/
+#include  <stdio.h>
+#include  <stdint.h>
+#include  <stdbool.h>
+#include  <stdlib.h>
+#include  <string.h>
+#include  "fuzzy_logic.h"
+#include  "fuzzy_logic16.h"
+#include  "fuzzy_model.h"
+#include  "fuzzy_batch.h"
+#include  "fuzzy_incr.h"
+#include  "fuzzy_sparse.h"
+#include  "fuzzy_grid.h"
+#include  "fuzzy_ct.h"
+#include  "fuzzy_bake.h"
+#include  "fuzzy_fcl.h"
+#include  "fuzzy_ref.h"
+#include  "fuzzy_time.h"
+#include  "line_controller.h"
+
+#define ACC_MAX_IN      (3)             ///< inputs of the full domain, 256^3 points
+#define ACC_MAX_ROWS    (16)            ///< result rows
+
+/// Model under test and its engines
+typedef struct
+{
+  fuzzy_param   *param;
+  fuzzy_model   *model;
+  int8_t        *in;          ///< interpreter input array
+  uint16_t      n_in;
+  size_t        count;        ///< domain points
+  int8_t        *grid;        ///< inputs [count][n_in]
+  double        *grid_d;      ///< the same inputs in double
+  int8_t        *out8;        ///< batch outputs [count]
+  uint8_t       *ws;          ///< workspace
+  fuzzy_incr    inc;
+  fuzzy_sparse  sp;
+  fuzzy_grid    tab;          ///< rule table, n_dim 0 - rules are not a table
+  fuzzy_ct      ct;           ///< constant-time state
+  fuzzy_ref     ref;
+  fuzzy_surface *surface;     ///< baked surface, two inputs only
+  fuzzy_param16 *param16;     ///< 16-bit line controller
+  int16_t       *in16;
+} acc_ctx;
+
+/// Engine variant: outputs of all domain points, scale +-127
+typedef void (*acc_fn) (acc_ctx *c, double *out);
+
+/// Result row
+typedef struct
+{
+  const char  *name;
+  double      max_err;      ///< max |out - ref|
+  double      mean_err;     ///< mean |out - ref|
+  size_t      worst;        ///< point of max error
+  double      ns;           ///< ns per evaluation
+} acc_row;
+
+static acc_row rows[ACC_MAX_ROWS];
+static unsigned n_rows;
+static uint64_t min_ns = 200000000ULL;  ///< min measured time of the variant
+
+
+/// эталон в double
+static void run_ref (acc_ctx *c, double *out)
+{
+  size_t i;
+
+  fuzzy_ref_reset (&c->ref);
+  for (i = 0; i < c->count; i++)
+  {
+    out[i] = process_fuzzy_logic_ref (&c->ref, &c->grid_d[i * c->n_in]);
+  }
+}
+
+/// интерпретатор списков
+static void run_interp (acc_ctx *c, double *out)
+{
+  size_t i;
+  uint16_t d;
+
+  for (i = 0; i < c->count; i++)
+  {
+    for (d = 0; d < c->n_in; d++)
+    {
+      c->in[d] = c->grid[i * c->n_in + d];
+    }
+    out[i] = process_fuzzy_logic (c->param);
+  }
+}
+
+/// скомпилированная модель
+static void run_ws (acc_ctx *c, double *out)
+{
+  size_t i;
+
+  fuzzy_workspace_init (c->model, c->ws);
+  for (i = 0; i < c->count; i++)
+  {
+    out[i] = process_fuzzy_logic_ws (c->model, &c->grid[i * c->n_in], c->ws);
+  }
+}
+
+/// пакетное вычисление всей области одним вызовом
+static void run_batch (acc_ctx *c, double *out)
+{
+  size_t i;
+
+  process_fuzzy_logic_batch (c->model, c->grid, c->count, c->out8);
+  for (i = 0; i < c->count; i++)
+  {
+    out[i] = c->out8[i];
+  }
+}
+
+/// инкрементальное вычисление
+static void run_incr (acc_ctx *c, double *out)
+{
+  size_t i;
+
+  fuzzy_incr_reset (&c->inc);
+  for (i = 0; i < c->count; i++)
+  {
+    out[i] = process_fuzzy_logic_incr (&c->inc, &c->grid[i * c->n_in]);
+  }
+}
+
+/// разреженное вычисление
+static void run_sparse (acc_ctx *c, double *out)
+{
+  size_t i;
+
+  for (i = 0; i < c->count; i++)
+  {
+    out[i] = process_fuzzy_logic_sparse (&c->sp, &c->grid[i * c->n_in]);
+  }
+}
+
+/// таблица правил
+static void run_grid (acc_ctx *c, double *out)
+{
+  size_t i;
+
+  for (i = 0; i < c->count; i++)
+  {
+    out[i] = process_fuzzy_logic_grid (&c->tab, &c->grid[i * c->n_in]);
+  }
+}
+
+/// постоянное время
+static void run_ct (acc_ctx *c, double *out)
+{
+  size_t i;
+
+  for (i = 0; i < c->count; i++)
+  {
+    out[i] = process_fuzzy_logic_ct (&c->ct, &c->grid[i * c->n_in]);
+  }
+}
+
+/// запечённая поверхность
+static void run_surface (acc_ctx *c, double *out)
+{
+  size_t i;
+
+  for (i = 0; i < c->count; i++)
+  {
+    out[i] = fuzzy_surface_eval (c->surface, c->grid[2 * i], c->grid[2 * i + 1]);
+  }
+}
+
+/// сгенерированный код линейного регулятора
+static void run_gen (acc_ctx *c, double *out)
+{
+  size_t i;
+
+  for (i = 0; i < c->count; i++)
+  {
+    out[i] = line_controller_gen (&c->grid[2 * i]);
+  }
+}
+
+/// 16-разрядный линейный регулятор, выход / LINE16_SCALE
+static void run_line16 (acc_ctx *c, double *out)
+{
+  size_t i;
+
+  for (i = 0; i < c->count; i++)
+  {
+    c->in16[0] = (int16_t)(c->grid[2 * i] * LINE16_SCALE);
+    c->in16[1] = (int16_t)(c->grid[2 * i + 1] * LINE16_SCALE);
+    out[i] = process_fuzzy_logic16 (c->param16) / (double)LINE16_SCALE;
+  }
+}
+
+/*******************************************************************************
+* Точность и скорость варианта
+* \brief  Run the variant once for the errors against ref, then repeatedly
+*         for min_ns to measure ns per evaluation, add result row
+*******************************************************************************/
+static void acc_case (acc_ctx *c, const char *name, acc_fn fn, const double *ref, double *out)
+{
+  acc_row *row;
+  double err, sum = 0.0;
+  uint64_t t, dt;
+  size_t i, reps = 0;
+  char point[48];
+  int n = 0;
+  uint16_t d;
+
+  if (n_rows >= ACC_MAX_ROWS)
+  {
+    return;
+  }
+  row = &rows[n_rows++];
+  memset (row, 0, sizeof (acc_row));
+  row->name = name;
+
+  fn (c, out);
+  for (i = 0; i < c->count; i++)
+  {
+    err = (out[i] > ref[i]) ? (out[i] - ref[i]) : (ref[i] - out[i]);
+    sum += err;
+    if (err > row->max_err)
+    {
+      row->max_err = err;
+      row->worst = i;
+    }
+  }
+  row->mean_err = sum / (double)c->count;
+
+  t = fuzzy_time_ns ();
+  do
+  {
+    fn (c, out);
+    reps++;
+    dt = fuzzy_time_ns () - t;
+  } while (dt < min_ns);
+  row->ns = (double)dt / ((double)reps * (double)c->count);
+
+  /// самая плохая точка заново: out перезаписан замерами
+  fn (c, out);
+  for (d = 0; d < c->n_in; d++)
+  {
+    n += snprintf (point + n, sizeof (point) - (size_t)n, "%s%d", d ? ", " : "(",
+                   c->grid[row->worst * c->n_in + d]);
+  }
+  snprintf (point + n, sizeof (point) - (size_t)n, ")");
+  printf ("%-14s %9.3f %9.4f %18s %9.3f %9.3f %10.2f ns %13.0f eval/s %7.2f x\n", name,
+          row->max_err, row->mean_err, point, ref[row->worst], out[row->worst],
+          row->ns, 1e9 / row->ns, rows[0].ns / row->ns);
+}
+
+static bool write_csv (const acc_ctx *c, const double *ref, const char *path)
+{
+  FILE *f = fopen (path, "w");
+  unsigned i;
+  uint16_t d;
+
+  if (f == NULL)
+  {
+    return false;
+  }
+  fprintf (f, "variant,max_err,mean_err,worst_in,ref,ns_per_eval,evals_per_s\n");
+  for (i = 0; i < n_rows; i++)
+  {
+    fprintf (f, "%s,%.4f,%.5f,", rows[i].name, rows[i].max_err, rows[i].mean_err);
+    for (d = 0; d < c->n_in; d++)
+    {
+      fprintf (f, "%s%d", d ? " " : "", c->grid[rows[i].worst * c->n_in + d]);
+    }
+    fprintf (f, ",%.4f,%.3f,%.0f\n", ref[rows[i].worst], rows[i].ns, 1e9 / rows[i].ns);
+  }
+  return fclose (f) == 0;
+}
+
+
+int main (int argc, char **argv)
+{
+  static acc_ctx c;
+  static fuzzy_fcl fcl;
+  static fuzzy_surface surface;
+  const char *csv = NULL, *fcl_path = NULL;
+  fuzzy_param param;
+  fuzzy_param16 param16;
+  fuzzy_model model;
+  int8_t in[LINE_N_IN];
+  int16_t in16[LINE_N_IN];
+  double *ref, *out;
+  unsigned line;
+  size_t i, k;
+  uint16_t d;
+  bool line_ctl, ts = false;
+  int a;
+
+  for (a = 1; a < argc; a++)
+  {
+    if ((strcmp (argv[a], "-fcl") == 0) && (a + 1 < argc))
+    {
+      fcl_path = argv[++a];
+    }
+    else if (strcmp (argv[a], "-ts") == 0)
+    {
+      ts = true;
+    }
+    else if ((strcmp (argv[a], "-csv") == 0) && (a + 1 < argc))
+    {
+      csv = argv[++a];
+    }
+    else if ((strcmp (argv[a], "-ms") == 0) && (a + 1 < argc))
+    {
+      min_ns = strtoull (argv[++a], NULL, 10) * 1000000ULL;
+    }
+    else
+    {
+      printf ("Usage: %s [-fcl file | -ts] [-csv file] [-ms time]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  /// регулятор: линейный, линейный с линейными следствиями или из FCL
+  line_ctl = (fcl_path == NULL) && !ts;
+  if (line_ctl)
+  {
+    line_controller_param (&param, in);
+    c.in = in;
+  }
+  else if (ts)
+  {
+    line_controller_ts_param (&param, in);
+    c.in = in;
+  }
+  else
+  {
+    if (fuzzy_fcl_load (fcl_path, &fcl, &line) != FUZZY_OK)
+    {
+      printf ("Error rules %s line %u!\n", fcl_path, line);
+      return 1;
+    }
+    param = fcl.param;
+    c.in = fcl.in;
+  }
+  if (fuzzy_compile (&param, &model) != FUZZY_OK)
+  {
+    printf ("Error model!\n");
+    return 1;
+  }
+  if (model.n_in > ACC_MAX_IN)
+  {
+    printf ("Error: %u inputs, full domain up to %d inputs!\n", (unsigned)model.n_in, ACC_MAX_IN);
+    return 1;
+  }
+  c.param = &param;
+  c.model = &model;
+  c.n_in = model.n_in;
+
+  /// вся область входов int8_t, вход 0 меняется быстрее всех
+  c.count = (size_t)1 << (8 * c.n_in);
+  c.grid   = malloc (c.count * c.n_in);
+  c.grid_d = malloc (c.count * c.n_in * sizeof (double));
+  c.out8   = malloc (c.count);
+  c.ws     = malloc (fuzzy_workspace_size (&model));
+  ref      = malloc (c.count * sizeof (double));
+  out      = malloc (c.count * sizeof (double));
+  if ((c.grid == NULL) || (c.grid_d == NULL) || (c.out8 == NULL) || (c.ws == NULL) ||
+      (ref == NULL) || (out == NULL) ||
+      (fuzzy_sparse_init (&model, &c.sp) != FUZZY_OK) ||
+      (fuzzy_ref_init (&model, &c.ref) != FUZZY_OK))
+  {
+    printf ("Error memory!\n");
+    return 1;
+  }
+  for (i = 0; i < c.count; i++)
+  {
+    for (d = 0; d < c.n_in; d++)
+    {
+      k = i * c.n_in + d;
+      c.grid[k] = (int8_t)((i >> (8 * d)) & 0xFF);
+      c.grid_d[k] = c.grid[k];
+    }
+  }
+  run_ref (&c, ref);
+
+  printf ("%u inputs, %lu points, %u rules\n", (unsigned)c.n_in, (unsigned long)c.count,
+          (unsigned)model.n_rule);
+  printf ("%-14s %9s %9s %18s %9s %9s %13s %20s %9s\n", "variant", "max err", "mean err",
+          "worst input", "ref", "out", "time", "speed", "vs ref");
+  acc_case (&c, "ref/double", run_ref, ref, out);
+  acc_case (&c, "interpreter", run_interp, ref, out);
+  acc_case (&c, "compiled", run_ws, ref, out);
+  acc_case (&c, "batch", run_batch, ref, out);
+  if (fuzzy_incr_init (&model, &c.inc) == FUZZY_OK)     // constant outputs only
+  {
+    acc_case (&c, "incremental", run_incr, ref, out);
+  }
+  acc_case (&c, "sparse", run_sparse, ref, out);
+  if (fuzzy_grid_init (&model, &c.tab) == FUZZY_OK)
+  {
+    acc_case (&c, "grid", run_grid, ref, out);
+  }
+  if (fuzzy_ct_init (&model, &c.ct) == FUZZY_OK)
+  {
+    acc_case (&c, "const-time", run_ct, ref, out);
+  }
+  if ((c.n_in == 2) && (fuzzy_bake (&model, &surface) == FUZZY_OK))
+  {
+    c.surface = &surface;
+    acc_case (&c, "surface", run_surface, ref, out);
+  }
+  if (line_ctl)
+  {
+    acc_case (&c, "generated", run_gen, ref, out);
+    line_controller_param16 (&param16, in16);
+    c.param16 = &param16;
+    c.in16 = in16;
+    acc_case (&c, "line16", run_line16, ref, out);
+  }
+
+  if (csv && !write_csv (&c, ref, csv))
+  {
+    printf ("Error output!\n");
+    return 1;
+  }
+
+  fuzzy_ref_free (&c.ref);
+  fuzzy_grid_free (&c.tab);
+  fuzzy_ct_free (&c.ct);
+  fuzzy_sparse_free (&c.sp);
+  fuzzy_incr_free (&c.inc);
+  fuzzy_model_free (&model);
+  fuzzy_fcl_free (&fcl);
+  free (out);
+  free (ref);
+  free (c.ws);
+  free (c.out8);
+  free (c.grid_d);
+  free (c.grid);
+  return 0;
+}
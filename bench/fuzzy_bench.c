@@ -0,0 +1,1229 @@
+/*******************************************************************************
+* \file     fuzzy_bench.c
+* \author   Ilya Petrukhin (ilya.petrukhin@gmail.com)
+* \brief    Microbenchmark of the fuzzification functions and the controller
+*           Usage: fuzzy_bench [-csv file] [-json file] [-ms time]
+*           Build: gcc -O2 -pthread -Isrc bench/fuzzy_bench.c src/fuzzy_*.c
+*                  src/line_controller.c src/line_controller_gen.c -o fuzzy_bench
+* \version  2.1
+* \date     2026-10-17
+*******************************************************************************/
+#include  <stdio.h>
+#include  <stdint.h>
+#include  <stdbool.h>
+#include  <stdlib.h>
+#include  <string.h>
+#include  <math.h>
+#include  "fuzzy_logic.h"
+#include  "fuzzy_logic16.h"
+#include  "fuzzy_model.h"
+#include  "fuzzy_batch.h"
+#include  "fuzzy_incr.h"
+#include  "fuzzy_sparse.h"
+#include  "fuzzy_grid.h"
+#include  "fuzzy_ct.h"
+#include  "fuzzy_mamdani.h"
+#include  "fuzzy_fcl.h"
+#include  "fuzzy_image.h"
+#include  "fuzzy_opt.h"
+#include  "fuzzy_time.h"
+#include  "fuzzy_prof.h"
+#include  "fuzzy_fleet.h"
+#include  "fuzzy_chain.h"
+#include  "fuzzy_pool.h"
+#include  "line_controller.h"
+
+#if defined (__GNUC__) && (defined (__x86_64__) || defined (__i386__))
+#include  <x86intrin.h>
+#define BENCH_CYCLES()  __rdtsc ()      ///< time stamp counter
+#define BENCH_HAS_CYCLES  (1)
+#else
+#define BENCH_CYCLES()  (0)
+#define BENCH_HAS_CYCLES  (0)
+#endif
+
+#define BENCH_TRIALS    (5)             ///< best of trials
+#define BENCH_MAX_ROWS  (192)           ///< result rows
+#define BENCH_GRID      (65536)         ///< input pairs of the controller pass
+
+/// One pass of the measured code, returns number of evaluations
+typedef uint32_t (*bench_fn) (void *ctx);
+
+/// Result row
+typedef struct
+{
+  const char  *group;       ///< mf / controller / synthetic ...
+  char        name[32];     ///< case name
+  uint32_t    rules;        ///< rules in the model, 0 - not a model
+  double      ns;           ///< ns per evaluation
+  double      cycles;       ///< TSC cycles per evaluation, 0 - not available
+} bench_row;
+
+/// Fuzzification function case
+typedef struct
+{
+  fuzzy   func;
+  int8_t  a, b, c;
+} bench_mf;
+
+/// 16-bit fuzzification function case
+typedef struct
+{
+  fuzzy16 func;
+  int16_t a, b, c;
+} bench_mf16;
+
+/// 16-bit controller case
+typedef struct
+{
+  fuzzy_param16 *param;
+  int16_t       *in;        ///< input array
+  int8_t        *grid;      ///< inputs [BENCH_GRID][2], * LINE16_SCALE
+} bench_ctl16;
+
+/// Model case: interpreter parameters, compiled model and inputs
+typedef struct
+{
+  fuzzy_param *param;
+  fuzzy_model *model;
+  int8_t      *in;          ///< interpreter input array
+  int8_t      *grid;        ///< inputs [BENCH_GRID][2]
+  int8_t      *out;         ///< outputs [BENCH_GRID]
+  uint8_t     *ws;          ///< workspace
+  fuzzy_incr  *inc;         ///< incremental state
+  fuzzy_sparse *sp;         ///< sparse state
+  uint64_t    n_visit;      ///< rules visited by sparse passes
+  uint64_t    n_sparse;     ///< evaluations of sparse passes
+  fuzzy_grid  *tab;         ///< rule table, NULL - rules are not a table
+  fuzzy_ct    *ct;          ///< constant-time state
+  uint64_t    n_tab_rule;   ///< rules visited by table passes
+  uint64_t    n_tab_cell;   ///< cells visited by table passes
+  uint64_t    n_tab;        ///< evaluations of table passes
+  fuzzy_mamdani *md;        ///< Mamdani tables
+  fuzzy_batch *batch;       ///< prepared batch
+  uint8_t     *scratch;     ///< batch memory of the call
+} bench_ctl;
+
+static bench_row rows[BENCH_MAX_ROWS];
+static unsigned n_rows;
+static uint64_t min_ns = 50000000ULL;   ///< min time of one trial
+static volatile uint32_t sink;          ///< keeps results alive
+
+
+/*******************************************************************************
+* Замер одного случая
+* \brief  Run fn repeatedly for min_ns, best of BENCH_TRIALS, add result row
+* \param[in]  group   group name
+* \param[in]  name    case name
+* \param[in]  rules   rules in the model
+* \param[in]  fn      measured pass
+* \param[in]  ctx     pass context
+*******************************************************************************/
+static void bench_case (const char *group, const char *name, uint32_t rules,
+                        bench_fn fn, void *ctx)
+{
+  bench_row *row;
+  uint64_t t0, t, c0, c;
+  uint64_t evals;
+  double ns, cyc, best_ns = 1e30, best_cyc = 0;
+  unsigned trial;
+
+  fn (ctx);       // прогрев
+  for (trial = 0; trial < BENCH_TRIALS; trial++)
+  {
+    evals = 0;
+    t0 = fuzzy_time_ns ();
+    c0 = BENCH_CYCLES ();
+    do
+    {
+      evals += fn (ctx);
+      t = fuzzy_time_ns () - t0;
+    } while (t < min_ns);
+    c = BENCH_CYCLES () - c0;
+    ns = (double)t / (double)evals;
+    cyc = (double)c / (double)evals;
+    if (ns < best_ns)
+    {
+      best_ns = ns;
+      best_cyc = cyc;
+    }
+  }
+
+  if (n_rows < BENCH_MAX_ROWS)
+  {
+    row = &rows[n_rows++];
+    row->group = group;
+    snprintf (row->name, sizeof (row->name), "%s", name);
+    row->rules = rules;
+    row->ns = best_ns;
+    row->cycles = BENCH_HAS_CYCLES ? best_cyc : 0.0;
+  }
+  printf ("%-12s %-24s %5u %10.2f ns %14.0f eval/s %10.1f cyc\n", group, name, (unsigned)rules,
+          best_ns, 1e9 / best_ns, BENCH_HAS_CYCLES ? best_cyc : 0.0);
+}
+
+/*******************************************************************************
+* функция фуззификации на всём диапазоне int8_t
+*******************************************************************************/
+static uint32_t pass_mf (void *ctx)
+{
+  const bench_mf *m = ctx;
+  uint32_t s = 0;
+  int16_t x;
+
+  for (x = -128; x < 128; x++)
+  {
+    s += m->func ((int8_t)x, m->a, m->b, m->c);
+  }
+  sink += s;
+  return 256;
+}
+
+/*******************************************************************************
+* подготовленная функция фуззификации на всём диапазоне int8_t
+*******************************************************************************/
+static uint32_t pass_prep (void *ctx)
+{
+  const fuzzy_prep *p = ctx;
+  uint32_t s = 0;
+  int16_t x;
+
+  for (x = -128; x < 128; x++)
+  {
+    s += fuzzy_prep_eval (p, (int8_t)x);
+  }
+  sink += s;
+  return 256;
+}
+
+/*******************************************************************************
+* 16-разрядная функция фуззификации, 256 точек на всём диапазоне int16_t
+*******************************************************************************/
+static uint32_t pass_mf16 (void *ctx)
+{
+  const bench_mf16 *m = ctx;
+  uint32_t s = 0;
+  int32_t x;
+
+  for (x = -32768; x < 32768; x += 256)
+  {
+    s += m->func ((int16_t)x, m->a, m->b, m->c);
+  }
+  sink += s;
+  return 256;
+}
+
+/// process_fuzzy_logic16 по сетке всех пар входов
+static uint32_t pass_interp16 (void *ctx)
+{
+  bench_ctl16 *b = ctx;
+  uint32_t s = 0, i;
+
+  for (i = 0; i < BENCH_GRID; i++)
+  {
+    b->in[0] = (int16_t)(b->grid[2 * i] * LINE16_SCALE);
+    b->in[1] = (int16_t)(b->grid[2 * i + 1] * LINE16_SCALE);
+    s += (uint16_t)process_fuzzy_logic16 (b->param);
+  }
+  sink += s;
+  return BENCH_GRID;
+}
+
+/// process_fuzzy_logic по сетке всех пар входов
+static uint32_t pass_interp (void *ctx)
+{
+  bench_ctl *b = ctx;
+  uint32_t s = 0, i;
+
+  for (i = 0; i < BENCH_GRID; i++)
+  {
+    b->in[0] = b->grid[2 * i];
+    b->in[1] = b->grid[2 * i + 1];
+    s += (uint8_t)process_fuzzy_logic (b->param);
+  }
+  sink += s;
+  return BENCH_GRID;
+}
+
+/// скомпилированная модель, рабочая область вызывающего
+static uint32_t pass_ws (void *ctx)
+{
+  bench_ctl *b = ctx;
+  uint32_t s = 0, i;
+
+  for (i = 0; i < BENCH_GRID; i++)
+  {
+    s += (uint8_t)process_fuzzy_logic_ws (b->model, &b->grid[2 * i], b->ws);
+  }
+  sink += s;
+  return BENCH_GRID;
+}
+
+/// инкрементальное вычисление: in[0] меняется каждый шаг, in[1] - каждые 256
+static uint32_t pass_incr (void *ctx)
+{
+  bench_ctl *b = ctx;
+  uint32_t s = 0, i;
+
+  for (i = 0; i < BENCH_GRID; i++)
+  {
+    s += (uint8_t)process_fuzzy_logic_incr (b->inc, &b->grid[2 * i]);
+  }
+  sink += s;
+  return BENCH_GRID;
+}
+
+/// разреженное вычисление, подсчёт посещённых правил
+static uint32_t pass_sparse (void *ctx)
+{
+  bench_ctl *b = ctx;
+  uint32_t s = 0, i;
+
+  for (i = 0; i < BENCH_GRID; i++)
+  {
+    s += (uint8_t)process_fuzzy_logic_sparse (b->sp, &b->grid[2 * i]);
+    b->n_visit += b->sp->n_visit;
+  }
+  b->n_sparse += BENCH_GRID;
+  sink += s;
+  return BENCH_GRID;
+}
+
+/// таблица правил, подсчёт посещённых ячеек и правил
+static uint32_t pass_grid (void *ctx)
+{
+  bench_ctl *b = ctx;
+  uint32_t s = 0, i;
+
+  for (i = 0; i < BENCH_GRID; i++)
+  {
+    s += (uint8_t)process_fuzzy_logic_grid (b->tab, &b->grid[2 * i]);
+    b->n_tab_rule += b->tab->n_visit;
+    b->n_tab_cell += b->tab->n_cell_visit;
+  }
+  b->n_tab += BENCH_GRID;
+  sink += s;
+  return BENCH_GRID;
+}
+
+/// постоянное время
+static uint32_t pass_ct (void *ctx)
+{
+  bench_ctl *b = ctx;
+  uint32_t s = 0, i;
+
+  for (i = 0; i < BENCH_GRID; i++)
+  {
+    s += (uint8_t)process_fuzzy_logic_ct (b->ct, &b->grid[2 * i]);
+  }
+  sink += s;
+  return BENCH_GRID;
+}
+
+/// сгенерированный код линейного регулятора
+static uint32_t pass_gen (void *ctx)
+{
+  const int8_t *grid = ctx;
+  uint32_t s = 0, i;
+
+  for (i = 0; i < BENCH_GRID; i++)
+  {
+    s += (uint8_t)line_controller_gen (&grid[2 * i]);
+  }
+  sink += s;
+  return BENCH_GRID;
+}
+
+/// центроид Мамдани по таблицам срезов
+static uint32_t pass_mamdani (void *ctx)
+{
+  bench_ctl *b = ctx;
+  uint32_t s = 0, i;
+
+  for (i = 0; i < BENCH_GRID; i++)
+  {
+    s += (uint8_t)process_fuzzy_logic_mamdani (b->md, &b->grid[2 * i], b->ws);
+  }
+  sink += s;
+  return BENCH_GRID;
+}
+
+/// центроид Мамдани по всем 256 точкам выхода
+static uint32_t pass_mamdani_naive (void *ctx)
+{
+  bench_ctl *b = ctx;
+  const fuzzy_mamdani *md = b->md;
+  const uint8_t *y_rule = b->ws + md->model->n_mf;
+  uint8_t level[FUZZY_MAX_OUTSET];
+  int32_t summ_mu, summ_mu_y, mu, v;
+  uint32_t s = 0, i, k;
+  int16_t y;
+
+  for (i = 0; i < BENCH_GRID; i++)
+  {
+    fuzzy_model_activate (md->model, &b->grid[2 * i], b->ws);
+    memset (level, 0, sizeof (level));
+    for (k = 0; k < md->model->n_rule; k++)
+    {
+      if ((md->rule_set[k] != FUZZY_NO_SET) && (y_rule[k] > level[md->rule_set[k]]))
+      {
+        level[md->rule_set[k]] = y_rule[k];
+      }
+    }
+    summ_mu = summ_mu_y = 0;
+    for (y = -128; y < 128; y++)
+    {
+      mu = 0;
+      for (k = 0; k < md->n_set; k++)
+      {
+        v = md->tab[k][(uint8_t)y];
+        v = (v < level[k]) ? v : level[k];
+        mu = (v > mu) ? v : mu;
+      }
+      summ_mu += mu;
+      summ_mu_y += mu * y;
+    }
+    s += (summ_mu != 0) ? (uint8_t)lim_s8 ((int16_t)(summ_mu_y / summ_mu)) : 0;
+  }
+  sink += s;
+  return BENCH_GRID;
+}
+
+/// загрузка текста FCL
+static uint32_t pass_fcl (void *ctx)
+{
+  fuzzy_fcl fcl;
+
+  if (fuzzy_fcl_parse (ctx, &fcl, NULL) == FUZZY_OK)
+  {
+    sink += fcl.n_rule;
+  }
+  fuzzy_fcl_free (&fcl);
+  return 1;
+}
+
+/// Image case
+typedef struct
+{
+  void    *image;
+  size_t  size;
+} bench_image;
+
+/// компиляция списков в модель
+static uint32_t pass_compile (void *ctx)
+{
+  fuzzy_model model;
+
+  if (fuzzy_compile (ctx, &model) == FUZZY_OK)
+  {
+    sink += model.n_rule;
+  }
+  fuzzy_model_free (&model);
+  return 1;
+}
+
+/// модель из образа на месте
+static uint32_t pass_image (void *ctx)
+{
+  const bench_image *b = ctx;
+  fuzzy_image img;
+
+  if (fuzzy_image_open (b->image, b->size, &img) == FUZZY_OK)
+  {
+    sink += img.model.n_rule;
+  }
+  return 1;
+}
+
+/*******************************************************************************
+* синтетический текст FCL
+* \brief  Two inputs, 5 terms per input, 5 output singletons, n_rule rules:
+*         AND of pairs, every 4th rule has OR of two terms
+* \param[in]  n_rule  number of rules
+* \return             text, free by caller
+*******************************************************************************/
+static char *synth_fcl (uint32_t n_rule)
+{
+  char *text = malloc (512 + (size_t)n_rule * 96);
+  char *p = text;
+  uint32_t i;
+
+  p += sprintf (p, "FUNCTION_BLOCK synth\n"
+                   "VAR_INPUT a : REAL; b : REAL; END_VAR\n"
+                   "VAR_OUTPUT y : REAL; END_VAR\n");
+  for (i = 0; i < 2; i++)
+  {
+    p += sprintf (p, "FUZZIFY %c\n"
+                     "  TERM t0 := (-100, 1) (-50, 0);\n"
+                     "  TERM t1 := (-100, 0) (-50, 1) (0, 0);\n"
+                     "  TERM t2 := (-40, 0) (-10, 1) (10, 1) (40, 0);\n"
+                     "  TERM t3 := (0, 0) (50, 1) (100, 0);\n"
+                     "  TERM t4 := (50, 0) (100, 1);\n"
+                     "END_FUZZIFY\n", 'a' + (int)i);
+  }
+  p += sprintf (p, "DEFUZZIFY y\n"
+                   "  TERM o0 := -60; TERM o1 := -20; TERM o2 := 0; TERM o3 := 20; TERM o4 := 60;\n"
+                   "END_DEFUZZIFY\n"
+                   "RULEBLOCK r\n");
+  for (i = 0; i < n_rule; i++)
+  {
+    if (i % 4 == 3)
+    {
+      p += sprintf (p, "  RULE %u : IF (a IS t%u OR a IS t%u) AND b IS t%u THEN y IS o%u;\n",
+                    (unsigned)i, (unsigned)(i % 5), (unsigned)((i + 2) % 5),
+                    (unsigned)((i / 5) % 5), (unsigned)((i * 3) % 5));
+    }
+    else
+    {
+      p += sprintf (p, "  RULE %u : IF a IS t%u AND b IS t%u THEN y IS o%u;\n",
+                    (unsigned)i, (unsigned)(i % 5), (unsigned)((i / 5) % 5), (unsigned)((i * 3) % 5));
+    }
+  }
+  sprintf (p, "END_RULEBLOCK\nEND_FUNCTION_BLOCK\n");
+  return text;
+}
+
+/*******************************************************************************
+* приведение к четкости по Мамдани против одноточечного
+*******************************************************************************/
+static void bench_mamdani (const char *group, const char *name, fuzzy_param *param,
+                           uint32_t rules, const fuzzy_outset *set, uint8_t n_set, int8_t *grid)
+{
+  fuzzy_model model;
+  fuzzy_mamdani md;
+  bench_ctl b;
+  char s[32];
+  double ns;
+
+  if ((fuzzy_compile (param, &model) != FUZZY_OK) ||
+      (fuzzy_mamdani_init (&model, set, n_set, &md) != FUZZY_OK))
+  {
+    printf ("%s: Mamdani tables error\n", name);
+    fuzzy_model_free (&model);
+    return;
+  }
+  memset (&b, 0, sizeof (b));
+  b.model = &model;
+  b.grid = grid;
+  b.md = &md;
+  b.ws = malloc (fuzzy_workspace_size (&model));
+  fuzzy_workspace_init (&model, b.ws);
+
+  snprintf (s, sizeof (s), "%s/singleton", name);
+  bench_case (group, s, rules, pass_ws, &b);
+  ns = rows[n_rows - 1].ns;
+  snprintf (s, sizeof (s), "%s/mamdani", name);
+  bench_case (group, s, rules, pass_mamdani, &b);
+  printf ("%-12s %-24s %5u %10.2f x singleton\n", group, s, (unsigned)rules, rows[n_rows - 1].ns / ns);
+  snprintf (s, sizeof (s), "%s/mamdani_naive", name);
+  bench_case (group, s, rules, pass_mamdani_naive, &b);
+  printf ("%-12s %-24s %5u %10.2f x singleton\n", group, s, (unsigned)rules, rows[n_rows - 1].ns / ns);
+
+  free (b.ws);
+  fuzzy_mamdani_free (&md);
+  fuzzy_model_free (&model);
+}
+
+/// пакетное вычисление
+static uint32_t pass_batch (void *ctx)
+{
+  bench_ctl *b = ctx;
+
+  process_fuzzy_batch_ws (b->batch, b->grid, BENCH_GRID, b->out, b->scratch);
+  sink += (uint8_t)b->out[BENCH_GRID / 3];
+  return BENCH_GRID;
+}
+
+/*******************************************************************************
+* Синтетическая база правил
+* \brief  Two inputs, 5 functions per input, n_rule rules: AND of pairs,
+*         every 4th rule is OR of two functions used by the next rule
+* \param[in]  n_rule  number of rules
+* \param[in]  in      input array
+* \param[out] param   fuzzy parameters, lists are allocated by malloc
+*******************************************************************************/
+static void synth_model (uint32_t n_rule, int8_t *in, fuzzy_param *param)
+{
+  static const fuzzy shape[5] = { trapecia, triangle, low, high, cube };
+  fuzzy_funct *f = calloc (10, sizeof (fuzzy_funct));
+  fuzzy_rules *r = calloc (n_rule, sizeof (fuzzy_rules));
+  uint32_t i, k;
+
+  for (i = 0; i < 10; i++)
+  {
+    k = i % 5;
+    f[i].func = shape[k];
+    f[i].xn = (uint8_t)(i / 5);
+    f[i].a = (int8_t)(-100 + 50 * (int)k);
+    f[i].b = (shape[k] == low || shape[k] == high) ? (int8_t)(f[i].a + 30) : 25;
+    f[i].c = 40;
+    f[i].next = &f[(i + 1) % 10];
+  }
+  for (i = 0; i < n_rule; i++)
+  {
+    if ((i % 4 == 3) && (i + 1 < n_rule))
+    {
+      r[i].a = &f[i % 5].y;
+      r[i].op = F_OR;
+      r[i].b = &f[(i + 2) % 5].y;
+      r[i].fin = false;
+    }
+    else if ((i % 4 == 0) && (i > 0))
+    {
+      r[i].a = &r[i - 1].y;
+      r[i].op = F_AND;
+      r[i].b = &f[5 + (i / 5) % 5].y;
+      r[i].fin = true;
+    }
+    else
+    {
+      r[i].a = &f[i % 5].y;
+      r[i].op = F_AND;
+      r[i].b = &f[5 + (i / 5) % 5].y;
+      r[i].fin = true;
+    }
+    r[i].out = (int8_t)((int)((i * 37u) % 61u) - 30);
+    r[i].next = &r[(i + 1) % n_rule];
+  }
+  param->in_array = in;
+  param->start_ffunc = f;
+  param->start_rule = r;
+}
+
+/*******************************************************************************
+* замеры одной модели: интерпретатор, скомпилированная, пакетная
+*******************************************************************************/
+static void bench_model (const char *group, const char *name, fuzzy_param *param,
+                         uint32_t rules, int8_t *grid, int8_t *out)
+{
+  fuzzy_model model;
+  fuzzy_incr inc;
+  fuzzy_sparse sp;
+  fuzzy_grid tab;
+  fuzzy_ct ct;
+  fuzzy_batch batch;
+  bench_ctl b;
+  char s[32];
+  uint32_t i, n_diff = 0;
+
+  if (fuzzy_compile (param, &model) != FUZZY_OK)
+  {
+    printf ("%s: compile error\n", name);
+    return;
+  }
+  b.param = param;
+  b.model = &model;
+  b.in = param->in_array;
+  b.grid = grid;
+  b.out = out;
+  b.ws = malloc (fuzzy_workspace_size (&model));
+  fuzzy_workspace_init (&model, b.ws);
+  b.inc = (fuzzy_incr_init (&model, &inc) == FUZZY_OK) ? &inc : NULL;
+  b.sp = (fuzzy_sparse_init (&model, &sp) == FUZZY_OK) ? &sp : NULL;
+  b.n_visit = b.n_sparse = 0;
+  b.tab = (fuzzy_grid_init (&model, &tab) == FUZZY_OK) ? &tab : NULL;
+  b.n_tab_rule = b.n_tab_cell = b.n_tab = 0;
+  b.ct = (fuzzy_ct_init (&model, &ct) == FUZZY_OK) ? &ct : NULL;
+
+  snprintf (s, sizeof (s), "%s/interp", name);
+  bench_case (group, s, rules, pass_interp, &b);
+  snprintf (s, sizeof (s), "%s/compiled", name);
+  bench_case (group, s, rules, pass_ws, &b);
+  if (b.inc)
+  {
+    snprintf (s, sizeof (s), "%s/incr", name);
+    bench_case (group, s, rules, pass_incr, &b);
+  }
+  if (b.sp)
+  {
+    snprintf (s, sizeof (s), "%s/sparse", name);
+    bench_case (group, s, rules, pass_sparse, &b);
+    printf ("%-12s %-24s %5u %10.2f rules visited per eval\n", group, s, (unsigned)rules,
+            (double)b.n_visit / (double)b.n_sparse);
+  }
+  if (b.tab)
+  {
+    snprintf (s, sizeof (s), "%s/grid", name);
+    bench_case (group, s, rules, pass_grid, &b);
+    printf ("%-12s %-24s %5u %10.2f cells, %.2f rules visited per eval\n", group, s, (unsigned)rules,
+            (double)b.n_tab_cell / (double)b.n_tab, (double)b.n_tab_rule / (double)b.n_tab);
+  }
+  if (b.ct)
+  {
+    for (i = 0; i < BENCH_GRID; i++)
+    {
+      n_diff += (process_fuzzy_logic_ct (b.ct, &grid[2 * i]) != process_fuzzy_logic_ws (&model, &grid[2 * i], b.ws));
+    }
+    fuzzy_workspace_init (&model, b.ws);
+    if (n_diff != 0)
+    {
+      printf ("%s/ct: %u outputs differ from compiled\n", name, (unsigned)n_diff);
+    }
+    snprintf (s, sizeof (s), "%s/ct", name);
+    bench_case (group, s, rules, pass_ct, &b);
+  }
+  if (fuzzy_batch_init (&model, FUZZY_KERNEL_AUTO, &batch) == FUZZY_OK)
+  {
+    b.batch = &batch;
+    b.scratch = malloc (batch.scratch);
+    if (b.scratch)
+    {
+      snprintf (s, sizeof (s), "%s/batch_%s", name, fuzzy_kernel_name (batch.kernel));
+      bench_case (group, s, rules, pass_batch, &b);
+    }
+    free (b.scratch);
+    fuzzy_batch_free (&batch);
+  }
+
+  free (b.ws);
+  fuzzy_incr_free (b.inc);
+  fuzzy_sparse_free (b.sp);
+  fuzzy_grid_free (b.tab);
+  fuzzy_ct_free (b.ct);
+  fuzzy_model_free (&model);
+}
+
+/*******************************************************************************
+* регулятор с линейными следствиями: ошибка относительно 25 правил, время
+*******************************************************************************/
+static void bench_ts (int8_t *grid, int8_t *out)
+{
+  fuzzy_param line, ts;
+  fuzzy_model model;
+  int8_t in[LINE_N_IN], in_ts[LINE_N_IN], y;
+  uint32_t i, diff = 0;
+  int err, max_err = 0;
+  double sum_err = 0.0;
+
+  line_controller_param (&line, in);
+  line_controller_ts_param (&ts, in_ts);
+  if (fuzzy_compile (&ts, &model) != FUZZY_OK)
+  {
+    printf ("line_ts: compile error\n");
+    return;
+  }
+  for (i = 0; i < BENCH_GRID; i++)
+  {
+    in[0] = in_ts[0] = grid[2 * i];
+    in[1] = in_ts[1] = grid[2 * i + 1];
+    y = process_fuzzy_logic (&ts);
+    diff += (y != process_fuzzy_logic_compiled (&model, &grid[2 * i]));
+    err = abs (y - process_fuzzy_logic (&line));
+    max_err = (err > max_err) ? err : max_err;
+    sum_err += err;
+  }
+  fuzzy_model_free (&model);
+  if (diff != 0)
+  {
+    printf ("line_ts/compiled: %u outputs differ from interpreter\n", (unsigned)diff);
+  }
+  printf ("%-12s %-24s %5u %10d max err, %.3f mean err against line\n", "controller", "line_ts",
+          LINE_TS_N_RULE, max_err, sum_err / BENCH_GRID);
+  bench_model ("controller", "line_ts", &ts, LINE_TS_N_RULE, grid, out);
+}
+
+/*******************************************************************************
+* таблица правил n x n: равномерные треугольники, время от размера таблицы
+*******************************************************************************/
+static void bench_grid_table (uint16_t n, int8_t *grid)
+{
+  static const uint8_t xn[2] = { 0, 1 };
+  uint16_t n_term[2] = { n, n };
+  fuzzy_mf_desc *term = calloc (2 * n, sizeof (fuzzy_mf_desc));
+  int8_t *table = malloc ((size_t)n * n);
+  fuzzy_grid tab;
+  bench_ctl b;
+  char s[32];
+  uint32_t i;
+  int step = 254 / (n - 1);
+
+  if ((term == NULL) || (table == NULL))
+  {
+    free (term);
+    free (table);
+    return;
+  }
+  for (i = 0; i < 2u * n; i++)
+  {
+    term[i].shape = FS_TRIANGLE;
+    term[i].xn = (uint8_t)(i / n);
+    term[i].a = (int8_t)(-127 + (int)(i % n) * step);
+    term[i].b = (int8_t)step;
+  }
+  for (i = 0; i < (uint32_t)n * n; i++)
+  {
+    table[i] = (int8_t)((i * 37u) % 255u - 127);
+  }
+  if (fuzzy_grid_table (2, xn, n_term, term, table, &tab) == FUZZY_OK)
+  {
+    memset (&b, 0, sizeof (b));
+    b.grid = grid;
+    b.tab = &tab;
+    snprintf (s, sizeof (s), "table%ux%u", (unsigned)n, (unsigned)n);
+    bench_case ("grid", s, (uint32_t)n * n, pass_grid, &b);
+    printf ("%-12s %-24s %5u %10.2f cells, %.2f rules visited per eval\n", "grid", s, (unsigned)n * n,
+            (double)b.n_tab_cell / (double)b.n_tab, (double)b.n_tab_rule / (double)b.n_tab);
+    fuzzy_grid_free (&tab);
+  }
+  free (term);
+  free (table);
+}
+
+/*******************************************************************************
+* такт флота: все экземпляры
+*******************************************************************************/
+static uint32_t pass_fleet (void *ctx)
+{
+  fuzzy_fleet *fleet = ctx;
+
+  fuzzy_fleet_tick (fleet);
+  sink += (uint8_t)fleet->out[0];
+  return (uint32_t)fleet->n;
+}
+
+/*******************************************************************************
+* флот n экземпляров регулятора линии: пропускная способность и задержка
+* такта от числа исполнителей; выходы такта сверяются с моделью
+*******************************************************************************/
+static void bench_fleet (const fuzzy_model *model, const char *tag, uint32_t n, unsigned threads,
+                         int8_t *grid)
+{
+  fuzzy_fleet fleet;
+  fuzzy_fleet_stats st;
+  uint8_t *ws;
+  char s[32];
+  int8_t in[2];
+  uint32_t i, n_diff = 0;
+
+  if (fuzzy_fleet_init (model, n, threads, 0, &fleet) != FUZZY_OK)
+  {
+    printf ("%s%u: fleet init error\n", tag, (unsigned)n);
+    return;
+  }
+  for (i = 0; i < n; i++)
+  {
+    fuzzy_fleet_in (&fleet, 0)[i] = grid[2 * ((i * 40503u) % BENCH_GRID)];
+    fuzzy_fleet_in (&fleet, 1)[i] = grid[2 * ((i * 40503u) % BENCH_GRID) + 1];
+  }
+  snprintf (s, sizeof (s), "%s%u/t%u", tag, (unsigned)n, fuzzy_pool_size (fleet.pool));
+  pass_fleet (&fleet);
+  ws = malloc (fuzzy_workspace_size (model));
+  if (ws)
+  {
+    for (i = 0; i < n; i++)
+    {
+      in[0] = fuzzy_fleet_in (&fleet, 0)[i];
+      in[1] = fuzzy_fleet_in (&fleet, 1)[i];
+      n_diff += (fleet.out[i] != process_fuzzy_logic_ws (model, in, ws));
+    }
+    free (ws);
+  }
+  if (n_diff != 0)
+  {
+    printf ("%s: %u outputs differ from compiled\n", s, (unsigned)n_diff);
+  }
+  fuzzy_fleet_reset_stats (&fleet);
+  bench_case ("fleet", s, LINE_N_RULE, pass_fleet, &fleet);
+  fuzzy_fleet_get_stats (&fleet, &st);
+  printf ("%-12s %-24s %5u tick p50 %.1f p90 %.1f p99 %.1f p99.9 %.1f max %.1f us, %.2f stolen\n",
+          "fleet", s, (unsigned)LINE_N_RULE, st.p50_ns / 1e3, st.p90_ns / 1e3, st.p99_ns / 1e3,
+          st.p999_ns / 1e3, st.max_ns / 1e3, (double)st.stolen / (double)st.ticks);
+  fuzzy_fleet_free (&fleet);
+}
+
+/// Chain case: two stages by hand and by the chain
+typedef struct
+{
+  const fuzzy_model *heading;   ///< stage 0
+  const fuzzy_model *track;     ///< stage 1
+  uint8_t     *ws0, *ws1;       ///< workspaces of the stages
+  int16_t     (*out0) (int8_t out);   ///< output scaling of stage 0
+  int8_t      (*link) (int16_t x);    ///< input scaling of the course in stage 1
+  fuzzy_chain *chain;
+  int16_t     *raw;             ///< raw inputs [BENCH_GRID][2]
+} bench_chain;
+
+/// курс в десятых долях градуса
+static int16_t chain_out_tenth (int8_t out)
+{
+  return (int16_t)(out * 1800 / 127);
+}
+
+/// вход курса: корневая кривая усиления, больше чувствительность у нуля
+static int8_t chain_in_sqrt (int16_t x)
+{
+  float g = sqrtf (fabsf ((float)x) / 1800.0f) * 127.0f;
+
+  return lim_s8 ((int16_t)lrintf ((x < 0) ? -g : g));
+}
+
+/// ступени вручную: выход через out0 в int16_t, вход через link
+static int16_t chain_manual (bench_chain *b, const int16_t *raw)
+{
+  int8_t in[LINE_N_IN];
+  int16_t course;
+
+  in[0] = in0_scaling (raw[0]);
+  in[1] = in1_scaling (raw[1]);
+  course = b->out0 (process_fuzzy_logic_ws (b->heading, in, b->ws0));
+  in[0] = b->link (course);
+  in[1] = in1_scaling (raw[1]);
+  return out_scaling (process_fuzzy_logic_ws (b->track, in, b->ws1));
+}
+
+static uint32_t pass_chain_manual (void *ctx)
+{
+  bench_chain *b = ctx;
+  uint32_t s = 0, i;
+
+  for (i = 0; i < BENCH_GRID; i++)
+  {
+    s += (uint16_t)chain_manual (b, &b->raw[2 * i]);
+  }
+  sink += s;
+  return BENCH_GRID;
+}
+
+static uint32_t pass_chain (void *ctx)
+{
+  bench_chain *b = ctx;
+  uint32_t s = 0, i;
+
+  for (i = 0; i < BENCH_GRID; i++)
+  {
+    s += (uint16_t)process_fuzzy_chain (b->chain, &b->raw[2 * i]);
+  }
+  sink += s;
+  return BENCH_GRID;
+}
+
+/*******************************************************************************
+* цепочка: регулятор линии задаёт курс, регулятор первого порядка его
+* отрабатывает; вручную через масштабирование и цепочкой. line2 - масштабы
+* линии, curve2 - курс в десятых градуса и корневая кривая на входе
+*******************************************************************************/
+static void bench_chain_line (int8_t *grid, const char *tag, int16_t (*out0) (int8_t out),
+                              int8_t (*link) (int16_t x))
+{
+  fuzzy_param line, ts;
+  fuzzy_model heading, track;
+  fuzzy_chain_cfg cfg;
+  fuzzy_chain chain;
+  bench_chain b;
+  int8_t in[LINE_N_IN], in_ts[LINE_N_IN];
+  char name[32];
+  uint32_t i, n_diff = 0;
+  uint32_t rules = LINE_N_RULE + LINE_TS_N_RULE;
+
+  line_controller_param (&line, in);
+  line_controller_ts_param (&ts, in_ts);
+  memset (&b, 0, sizeof (b));
+  if ((fuzzy_compile (&line, &heading) != FUZZY_OK) || (fuzzy_compile (&ts, &track) != FUZZY_OK))
+  {
+    printf ("chain: compile error\n");
+    return;
+  }
+  fuzzy_chain_default (&cfg);
+  cfg.n_in = 2;
+  cfg.n_stage = 2;
+  cfg.stage[0].model = &heading;
+  cfg.stage[0].src[0] = FUZZY_CHAIN_IN (0);
+  cfg.stage[0].scale[0] = in0_scaling;
+  cfg.stage[0].src[1] = FUZZY_CHAIN_IN (1);
+  cfg.stage[0].scale[1] = in1_scaling;
+  cfg.stage[0].out_scale = out0;
+  cfg.stage[1].model = &track;
+  cfg.stage[1].src[0] = FUZZY_CHAIN_OUT (0);
+  cfg.stage[1].scale[0] = link;
+  cfg.stage[1].src[1] = FUZZY_CHAIN_IN (1);
+  cfg.stage[1].scale[1] = in1_scaling;
+  cfg.stage[1].out_scale = out_scaling;
+
+  b.heading = &heading;
+  b.track = &track;
+  b.out0 = out0;
+  b.link = link;
+  b.ws0 = malloc (fuzzy_workspace_size (&heading));
+  b.ws1 = malloc (fuzzy_workspace_size (&track));
+  b.raw = malloc (BENCH_GRID * 2 * sizeof (int16_t));
+  if ((b.ws0 != NULL) && (b.ws1 != NULL) && (b.raw != NULL) &&
+      (fuzzy_chain_init (&cfg, &chain) == FUZZY_OK))
+  {
+    b.chain = &chain;
+    fuzzy_workspace_init (&heading, b.ws0);
+    fuzzy_workspace_init (&track, b.ws1);
+    /// дистанция в см (2 см на единицу), курс в градусах
+    for (i = 0; i < BENCH_GRID; i++)
+    {
+      b.raw[2 * i] = (int16_t)(grid[2 * i] * 2);
+      b.raw[2 * i + 1] = grid[2 * i + 1];
+      n_diff += (process_fuzzy_chain (&chain, &b.raw[2 * i]) != chain_manual (&b, &b.raw[2 * i]));
+    }
+    snprintf (name, sizeof (name), "%s/chain", tag);
+    if (n_diff != 0)
+    {
+      printf ("%s: %u outputs differ from stages by hand\n", name, (unsigned)n_diff);
+    }
+    snprintf (name, sizeof (name), "%s/manual", tag);
+    bench_case ("chain", name, rules, pass_chain_manual, &b);
+    snprintf (name, sizeof (name), "%s/chain", tag);
+    fuzzy_chain_reset_time (&chain);
+    bench_case ("chain", name, rules, pass_chain, &b);
+    fuzzy_chain_print_time (&chain, stdout);
+    fuzzy_chain_free (&chain);
+  }
+  free (b.ws0);
+  free (b.ws1);
+  free (b.raw);
+  fuzzy_model_free (&heading);
+  fuzzy_model_free (&track);
+}
+
+/*******************************************************************************
+* запись результатов
+*******************************************************************************/
+static bool write_csv (const char *path)
+{
+  FILE *f = fopen (path, "w");
+  unsigned i;
+
+  if (f == NULL)
+  {
+    return false;
+  }
+  fprintf (f, "group,name,rules,ns_per_eval,evals_per_s,cycles_per_eval\n");
+  for (i = 0; i < n_rows; i++)
+  {
+    fprintf (f, "%s,%s,%u,%.3f,%.0f,%.2f\n", rows[i].group, rows[i].name, (unsigned)rows[i].rules,
+             rows[i].ns, 1e9 / rows[i].ns, rows[i].cycles);
+  }
+  return fclose (f) == 0;
+}
+
+static bool write_json (const char *path)
+{
+  FILE *f = fopen (path, "w");
+  unsigned i;
+
+  if (f == NULL)
+  {
+    return false;
+  }
+  fprintf (f, "{\n  \"cycles\": %s,\n  \"results\": [\n", BENCH_HAS_CYCLES ? "\"tsc\"" : "null");
+  for (i = 0; i < n_rows; i++)
+  {
+    fprintf (f, "    {\"group\": \"%s\", \"name\": \"%s\", \"rules\": %u, \"ns_per_eval\": %.3f, "
+             "\"evals_per_s\": %.0f, \"cycles_per_eval\": %.2f}%s\n",
+             rows[i].group, rows[i].name, (unsigned)rows[i].rules, rows[i].ns,
+             1e9 / rows[i].ns, rows[i].cycles, (i + 1 < n_rows) ? "," : "");
+  }
+  fprintf (f, "  ]\n}\n");
+  return fclose (f) == 0;
+}
+
+
+int main (int argc, char **argv)
+{
+  static const struct
+  {
+    const char  *name;
+    bench_mf    mf;
+  } mfs[] =
+  {
+    { "cube",       { cube,       0,   10,  0  } },
+    { "triangle",   { triangle,   0,   100, 0  } },
+    { "a_triangle", { a_triangle, 20,  100, 50 } },
+    { "square",     { square,     -10, 50,  0  } },
+    { "trapecia",   { trapecia,   -15, 10,  40 } },
+    { "low",        { low,        -25, 25,  0  } },
+    { "high",       { high,       -5,  55,  0  } },
+  };
+  static const struct
+  {
+    const char  *name;
+    bench_mf16  mf;
+  } mfs16[] =
+  {
+    { "cube16",       { cube16,       0,     2560,  0     } },
+    { "triangle16",   { triangle16,   0,     25600, 0     } },
+    { "a_triangle16", { a_triangle16, 5120,  25600, 12800 } },
+    { "square16",     { square16,     -2560, 12800, 0     } },
+    { "trapecia16",   { trapecia16,   -3840, 2560,  10240 } },
+    { "low16",        { low16,        -6400, 6400,  0     } },
+    { "high16",       { high16,       -1280, 14080, 0     } },
+  };
+  static const uint32_t synth[] = { 10, 30, 100, 300, 1000 };
+  static const uint32_t synth_fcl_rules[] = { 25, 1000, 10000 };
+  static const uint16_t grid_terms[] = { 5, 15, 45, 127 };
+  static const uint32_t fleet_n[] = { 1000, 10000, 100000 };
+  static int8_t grid[BENCH_GRID * 2], out[BENCH_GRID];
+  const char *csv = NULL, *json = NULL;
+  char *text;
+  fuzzy_model model;
+  fuzzy_opt opt;
+  bench_image bi;
+  fuzzy_image img;
+  fuzzy_param param;
+  fuzzy_param16 param16;
+  fuzzy_mf_desc desc;
+  fuzzy_prep prep;
+  bench_ctl16 b16;
+  int8_t in[LINE_N_IN];
+  int16_t in16[LINE_N_IN];
+  char name[32];
+  uint32_t i;
+  unsigned t, cpus = fuzzy_cpu_count ();
+  int a;
+
+  for (a = 1; a < argc; a++)
+  {
+    if ((strcmp (argv[a], "-csv") == 0) && (a + 1 < argc))
+    {
+      csv = argv[++a];
+    }
+    else if ((strcmp (argv[a], "-json") == 0) && (a + 1 < argc))
+    {
+      json = argv[++a];
+    }
+    else if ((strcmp (argv[a], "-ms") == 0) && (a + 1 < argc))
+    {
+      min_ns = strtoull (argv[++a], NULL, 10) * 1000000ULL;
+    }
+    else
+    {
+      printf ("Usage: %s [-csv file] [-json file] [-ms trial_time]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  /// все пары входов int8_t
+  for (i = 0; i < BENCH_GRID; i++)
+  {
+    grid[2 * i] = (int8_t)(i & 0xFF);
+    grid[2 * i + 1] = (int8_t)(i >> 8);
+  }
+
+#if (FUZZY_PROFILE != 0)
+  printf ("# FUZZY_PROFILE build, 1/%u calls sampled\n", 1u << FUZZY_PROFILE_SHIFT);
+#endif
+  printf ("%-12s %-24s %5s %13s %21s %14s\n", "group", "name", "rules", "time", "speed", "cycles");
+  for (i = 0; i < sizeof (mfs) / sizeof (mfs[0]); i++)
+  {
+    bench_case ("mf", mfs[i].name, 0, pass_mf, (void *)&mfs[i].mf);
+  }
+  for (i = 0; i < sizeof (mfs) / sizeof (mfs[0]); i++)
+  {
+    desc.shape = fuzzy_shape_of (mfs[i].mf.func);
+    desc.a = mfs[i].mf.a;
+    desc.b = mfs[i].mf.b;
+    desc.c = mfs[i].mf.c;
+    fuzzy_prepare (&desc, &prep);
+    snprintf (name, sizeof (name), "%s/prep", mfs[i].name);
+    bench_case ("mf", name, 0, pass_prep, &prep);
+  }
+  for (i = 0; i < sizeof (mfs16) / sizeof (mfs16[0]); i++)
+  {
+    bench_case ("mf", mfs16[i].name, 0, pass_mf16, (void *)&mfs16[i].mf);
+  }
+
+  line_controller_param (&param, in);
+  bench_model ("controller", "line", &param, LINE_N_RULE, grid, out);
+  if (fuzzy_optimize (&param, &opt) == FUZZY_OK)
+  {
+    printf ("%-12s %-24s ", "optimizer", "line");
+    fuzzy_opt_print (&opt.report, stdout);
+    bench_model ("optimizer", "line_opt", &opt.param, opt.report.rules_out, grid, out);
+    fuzzy_opt_free (&opt);
+  }
+  for (i = 0, a = 0; i < BENCH_GRID; i++)
+  {
+    in[0] = grid[2 * i];
+    in[1] = grid[2 * i + 1];
+    a += (line_controller_gen (&grid[2 * i]) != process_fuzzy_logic (&param));
+  }
+  if (a != 0)
+  {
+    printf ("line/generated: %d outputs differ from interpreter\n", a);
+  }
+  bench_case ("controller", "line/generated", LINE_N_RULE, pass_gen, grid);
+  bench_mamdani ("defuzz", "line", &param, LINE_N_RULE, line_outset, LINE_N_OUTSET, grid);
+  line_controller_param16 (&param16, in16);
+  b16.param = &param16;
+  b16.in = in16;
+  b16.grid = grid;
+  bench_case ("controller", "line16/interp", LINE_N_RULE, pass_interp16, &b16);
+  bench_ts (grid, out);
+
+  for (i = 0; i < sizeof (synth) / sizeof (synth[0]); i++)
+  {
+    synth_model (synth[i], in, &param);
+    snprintf (name, sizeof (name), "synth%u", (unsigned)synth[i]);
+    bench_model ("synthetic", name, &param, synth[i], grid, out);
+    if (fuzzy_optimize (&param, &opt) == FUZZY_OK)
+    {
+      printf ("%-12s %-24s ", "optimizer", name);
+      fuzzy_opt_print (&opt.report, stdout);
+      fuzzy_opt_free (&opt);
+    }
+    if ((fuzzy_compile (&param, &model) == FUZZY_OK) &&
+        (fuzzy_image_build (&model, NULL, FUZZY_IMAGE_LUT, &bi.image, &bi.size) == FUZZY_OK))
+    {
+      snprintf (name, sizeof (name), "synth%u/compile", (unsigned)synth[i]);
+      bench_case ("startup", name, synth[i], pass_compile, &param);
+      snprintf (name, sizeof (name), "synth%u/image", (unsigned)synth[i]);
+      bench_case ("startup", name, synth[i], pass_image, &bi);
+      free (bi.image);
+    }
+    fuzzy_model_free (&model);
+    free (param.start_ffunc);
+    free (param.start_rule);
+  }
+
+  for (i = 0; i < sizeof (grid_terms) / sizeof (grid_terms[0]); i++)
+  {
+    bench_grid_table (grid_terms[i], grid);
+  }
+
+  line_controller_param (&param, in);
+  if (fuzzy_compile (&param, &model) == FUZZY_OK)
+  {
+    for (i = 0; i < sizeof (fleet_n) / sizeof (fleet_n[0]); i++)
+    {
+      for (t = 1; t < cpus; t *= 2)
+      {
+        bench_fleet (&model, "line", fleet_n[i], t, grid);
+      }
+      bench_fleet (&model, "line", fleet_n[i], cpus, grid);
+    }
+    /// модель образа: без своей памяти, указатели в образ
+    if (fuzzy_image_build (&model, NULL, FUZZY_IMAGE_LUT, &bi.image, &bi.size) == FUZZY_OK)
+    {
+      if (fuzzy_image_open (bi.image, bi.size, &img) == FUZZY_OK)
+      {
+        bench_fleet (&img.model, "image", fleet_n[0], cpus, grid);
+      }
+      free (bi.image);
+    }
+  }
+  fuzzy_model_free (&model);
+
+  bench_chain_line (grid, "line2", out_scaling, in0_scaling);
+  bench_chain_line (grid, "curve2", chain_out_tenth, chain_in_sqrt);
+
+  for (i = 0; i < sizeof (synth_fcl_rules) / sizeof (synth_fcl_rules[0]); i++)
+  {
+    text = synth_fcl (synth_fcl_rules[i]);
+    snprintf (name, sizeof (name), "load%u", (unsigned)synth_fcl_rules[i]);
+    bench_case ("fcl", name, synth_fcl_rules[i], pass_fcl, text);
+    printf ("%-12s %-24s %5u %10.3f ms per load\n", "fcl", name, (unsigned)synth_fcl_rules[i],
+            rows[n_rows - 1].ns / 1e6);
+    free (text);
+  }
+
+  if ((csv && !write_csv (csv)) || (json && !write_json (json)))
+  {
+    printf ("Error output!\n");
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,86 @@
+/*******************************************************************************
+* \file     fuzzy_bake.c
+* \author   Ilya Petrukhin (ilya.petrukhin@gmail.com)
+* \brief    This file provides code for baking two-input controller
+*           into 256x256 output surface
+* \version  2.1
+* \date     2026-10-17
+*******************************************************************************/
+#include  <stdio.h>
+#include  <stdint.h>
+#include  <stdbool.h>
+#include  "fuzzy_logic.h"
+#include  "fuzzy_model.h"
+#include  "fuzzy_bake.h"
+#include  "fuzzy_time.h"
+
+
+/*******************************************************************************
+* Вычисление поверхности выхода регулятора на всём диапазоне входов
+* \brief  Bake the whole input domain of two-input controller
+* \param[in]  model     compiled model with one or two inputs
+* \param[out] surface   baked surface, bake_ns - bake time
+* \return               FUZZY_OK or FUZZY_ERR_PARAM
+*******************************************************************************/
+fuzzy_status fuzzy_bake (fuzzy_model *model, fuzzy_surface *surface)
+{
+  int8_t in[2];
+  int16_t x0, x1;
+  uint64_t t;
+
+  if ((model == NULL) || (surface == NULL) || (model->n_in > 2))
+  {
+    return FUZZY_ERR_PARAM;
+  }
+
+  t = fuzzy_time_ns ();
+  for (x1 = -128; x1 < 128; x1++)
+  {
+    in[1] = (int8_t)x1;
+    for (x0 = -128; x0 < 128; x0++)
+    {
+      in[0] = (int8_t)x0;
+      surface->z[((uint16_t)(uint8_t)x1 << 8) | (uint8_t)x0] =
+        process_fuzzy_logic_compiled (model, in);
+    }
+  }
+  surface->bake_ns = fuzzy_time_ns () - t;
+  surface->mismatch = 0;
+  return FUZZY_OK;
+}
+
+/*******************************************************************************
+* Проверка поверхности по исходному регулятору
+* \brief  Verify baked surface against live process_fuzzy_logic evaluation
+*         in the same order as baking
+* \param[in]  fuzzy     fuzzy parameters, in_array with two inputs
+* \param[out] surface   baked surface, mismatch and verify_ns are updated
+* \return               number of different points, 0 - exact match
+*******************************************************************************/
+uint32_t fuzzy_bake_verify (fuzzy_param *fuzzy, fuzzy_surface *surface)
+{
+  int8_t *in = fuzzy->in_array;
+  int8_t save0 = in[0], save1 = in[1];
+  int16_t x0, x1;
+  uint32_t mismatch = 0;
+  uint64_t t;
+
+  t = fuzzy_time_ns ();
+  for (x1 = -128; x1 < 128; x1++)
+  {
+    in[1] = (int8_t)x1;
+    for (x0 = -128; x0 < 128; x0++)
+    {
+      in[0] = (int8_t)x0;
+      if (process_fuzzy_logic (fuzzy) != fuzzy_surface_eval (surface, in[0], in[1]))
+      {
+        mismatch++;
+      }
+    }
+  }
+  surface->verify_ns = fuzzy_time_ns () - t;
+  surface->mismatch = mismatch;
+  in[0] = save0;
+  in[1] = save1;
+  return mismatch;
+}
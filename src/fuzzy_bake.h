@@ -0,0 +1,55 @@
+/*******************************************************************************
+* \file     fuzzy_bake.h
+* \author   Ilya Petrukhin (ilya.petrukhin@gmail.com)
+* \brief    Baked output surface of two-input fuzzy controller
+* \version  2.1
+* \date     2026-10-17
+*******************************************************************************/
+
+#ifndef _FUZZY_BAKE_H_
+#define _FUZZY_BAKE_H_
+
+#include  <stdint.h>
+#include  <stdbool.h>
+#include  "fuzzy_logic.h"
+#include  "fuzzy_model.h"
+
+/*******************************************************************************
+* Rules to using baked surface
+*******************************************************************************/
+// Two int8_t inputs give only 65536 input points, so whole controller
+// can be evaluated once (at startup or on model change) and then every
+// control tick is one memory load:
+//  static fuzzy_surface surface;     // 64 KiB
+//  fuzzy_bake (&model, &surface);
+//  fuzzy_bake_verify (&fuzzy, &surface);   // option: compare with live evaluation
+//  int8_t temp = fuzzy_surface_eval (&surface, in[0], in[1]);
+// ***************** end of the brief *****************************************
+
+#define FUZZY_SURFACE_SIZE  (256u * 256u)   ///< number of input points
+
+/// Baked output surface
+typedef struct
+{
+  int8_t    z[FUZZY_SURFACE_SIZE];  ///< outputs, index ((uint8_t)in1 << 8) | (uint8_t)in0
+  uint64_t  bake_ns;                ///< bake time, ns
+  uint64_t  verify_ns;              ///< live evaluation time of verification, ns
+  uint32_t  mismatch;               ///< points different from live evaluation
+} fuzzy_surface;
+
+fuzzy_status fuzzy_bake (fuzzy_model *model, fuzzy_surface *surface);        ///< bake surface by compiled model
+uint32_t     fuzzy_bake_verify (fuzzy_param *fuzzy, fuzzy_surface *surface); ///< compare with process_fuzzy_logic
+
+/*************************************************************************
+ * \brief Evaluate controller by baked surface
+ * \param surface   baked surface
+ * \param in0       input 0 (after in0_scaling)
+ * \param in1       input 1 (after in1_scaling)
+ * \return int8_t   output value
+*************************************************************************/
+inline static int8_t fuzzy_surface_eval (const fuzzy_surface *surface, int8_t in0, int8_t in1)
+{
+  return surface->z[((uint16_t)(uint8_t)in1 << 8) | (uint8_t)in0];
+}
+
+#endif  // _FUZZY_BAKE_H_
@@ -0,0 +1,620 @@
+/*******************************************************************************
+* \file     fuzzy_batch.c
+* \author   Ilya Petrukhin (ilya.petrukhin@gmail.com)
+* \brief    This file provides code for batched evaluation of the compiled
+*           fuzzy model with SSE2 / AVX2 kernels and scalar fallback
+* \version  2.1
+* \date     2026-10-17
+*******************************************************************************/
+#include  <stdio.h>
+#include  <stdint.h>
+#include  <stdbool.h>
+#include  <stdlib.h>
+#include  <string.h>
+#include  <pthread.h>
+#include  "fuzzy_logic.h"
+#include  "fuzzy_model.h"
+#include  "fuzzy_batch.h"
+
+#if defined (__GNUC__) && (defined (__x86_64__) || defined (__i386__))
+#define BATCH_X86       (1)
+#include  <immintrin.h>
+#else
+#define BATCH_X86       (0)
+#endif
+
+#define BATCH_LANES_MAX (32)    ///< widest kernel step
+
+/// Batch plan of the fuzzy function
+typedef struct
+{
+  uint8_t       kind;     ///< fuzzy_norm_kind
+  uint8_t       xn;       ///< input parameter number
+  uint8_t       y;        ///< FN_CONST activation
+  int8_t        m;        ///< FN_CUBE median
+  int32_t       d3;       ///< FN_CUBE D_0.5^3
+  int16_t       bl;       ///< FN_TRAP rise: n = x - bl
+  int16_t       dl;       ///< rise span
+  uint16_t      mhl;      ///< rise reciprocal 255 / dl, Q16 high part
+  uint16_t      mll;      ///< rise reciprocal, Q16 low part
+  int16_t       br;       ///< FN_TRAP fall: n = br - x
+  int16_t       dr;       ///< fall span
+  uint16_t      mhr;      ///< fall reciprocal 255 / dr, Q16 high part
+  uint16_t      mlr;      ///< fall reciprocal, Q16 low part
+  const uint8_t *lut;     ///< lookup table or NULL
+  fuzzy         func;     ///< fuzzification function
+  int8_t        a;        ///< first function parameter
+  int8_t        b;        ///< second function parameter
+  int8_t        c;        ///< third function parameter
+} batch_mf;
+
+/// Batch plan of the model
+typedef struct
+{
+  uint16_t            n_mf;   ///< number of fuzzy functions
+  uint16_t            n_rule; ///< number of rules
+  batch_mf            *mf;    ///< fuzzy functions plan [n_mf]
+  const fuzzy_rule_ix *rule;  ///< rules [n_rule]
+} batch_plan;
+
+typedef void (*batch_kernel) (const batch_plan *plan, const int8_t *xs, uint8_t *act, int8_t *out);
+
+/// лучшее ядро процессора: определяется один раз для всех потоков
+static fuzzy_kernel kernel_best = FUZZY_KERNEL_SCALAR;
+static pthread_once_t kernel_once = PTHREAD_ONCE_INIT;
+
+
+/*******************************************************************************
+* обратная величина крутизны фронта Q16
+* \brief  Trapezoid edge parameters: n = x - base (rise) or base - x (fall)
+*         clamped to [0, span], activation = n * 255 / span by Q16 reciprocal
+* \param[in]  base    edge base point
+* \param[in]  span    edge width, 0 - vertical edge
+* \param[in]  rise    true - rising edge, false - falling edge
+* \param[out] b       base for n
+* \param[out] d       span
+* \param[out] mh      reciprocal high part
+* \param[out] ml      reciprocal low part
+*******************************************************************************/
+static void batch_edge (int16_t base, int16_t span, bool rise,
+                        int16_t *b, int16_t *d, uint16_t *mh, uint16_t *ml)
+{
+  uint32_t m;
+
+  if (span == 0)          // vertical edge: n = 1 from the top point
+  {
+    base = rise ? (base - 1) : (base + 1);
+    span = 1;
+  }
+  m = (255UL * 65536UL + span - 1) / span;    // ceil (255 * 2^16 / span)
+  *b = base;
+  *d = span;
+  *mh = (uint16_t)(m >> 16);
+  *ml = (uint16_t)(m & 0xFFFF);
+}
+
+/*******************************************************************************
+* план вычисления функций фуззификации
+* \brief  Build batch plan of the model
+* \param[in]  model   compiled model
+* \param[out] plan    batch plan, mf[] has to be allocated
+*******************************************************************************/
+static void batch_plan_build (const fuzzy_model *model, batch_plan *plan)
+{
+  const fuzzy_mf_desc *d = model->mf;
+  batch_mf *p = plan->mf;
+  fuzzy_norm norm;
+  uint16_t i;
+
+  plan->n_mf = model->n_mf;
+  plan->n_rule = model->n_rule;
+  plan->rule = model->rule;
+  for (i = 0; i < model->n_mf; i++, d++, p++)
+  {
+    memset (p, 0, sizeof (batch_mf));
+    fuzzy_normalize (d, &norm);
+    p->kind = norm.kind;
+    p->xn = d->xn;
+    p->y = norm.y;
+    p->m = norm.m;
+    p->d3 = norm.d3;
+    p->a = d->a;
+    p->b = d->b;
+    p->c = d->c;
+    p->func = (d->shape == FS_CUSTOM) ? model->func[i] : fuzzy_shape_func[d->shape];
+    if (d->lut != FUZZY_NO_LUT)
+    {
+      p->lut = model->lut[d->lut];
+    }
+    if (norm.kind == FN_TRAP)
+    {
+      batch_edge (norm.lo, norm.t0 - norm.lo, true, &p->bl, &p->dl, &p->mhl, &p->mll);
+      batch_edge (norm.hi, norm.hi - norm.t1, false, &p->br, &p->dr, &p->mhr, &p->mlr);
+    }
+  }
+}
+
+/*******************************************************************************
+* функция фуззификации для каждого входа отдельно
+* \brief  Fuzzy function by lookup table or function call, lane by lane
+*******************************************************************************/
+static void batch_func (const batch_mf *p, const int8_t *x, uint8_t *y, unsigned lanes)
+{
+  unsigned l;
+
+  if (p->lut)
+  {
+    for (l = 0; l < lanes; l++)
+    {
+      y[l] = p->lut[(uint8_t)x[l]];
+    }
+  }
+  else
+  {
+    for (l = 0; l < lanes; l++)
+    {
+      y[l] = p->func (x[l], p->a, p->b, p->c);
+    }
+  }
+}
+
+#if BATCH_X86
+/// SSE2 на i386 без -msse2: помощники и ядро SSE2 - под целью sse2
+#if defined (__i386__) && !defined (__SSE2__)
+#define BATCH_SSE2_TARGET (1)
+#pragma GCC push_options
+#pragma GCC target ("sse2")
+#endif
+
+/*******************************************************************************
+* кубическая аппроксимация гаусса по 2 входа
+* \brief  Cube function d3 * 255 / (d3 + |x - m|^3), two lanes per SSE2 step;
+*         double division is exact for these integer ranges
+*******************************************************************************/
+static void batch_cube (const batch_mf *p, const int8_t *x, uint8_t *y, unsigned lanes)
+{
+  __m128d d3 = _mm_set1_pd ((double)p->d3);
+  __m128d d255 = _mm_set1_pd ((double)p->d3 * 255.0);
+  __m128d dx, q;
+  __m128i qi;
+  int32_t dx0, dx1;
+  unsigned l;
+
+  for (l = 0; l < lanes; l += 2)
+  {
+    dx0 = x[l] - p->m;
+    dx1 = x[l + 1] - p->m;
+    dx = _mm_set_pd ((double)(dx1 < 0 ? -dx1 : dx1), (double)(dx0 < 0 ? -dx0 : dx0));
+    q = _mm_div_pd (d255, _mm_add_pd (_mm_mul_pd (_mm_mul_pd (dx, dx), dx), d3));
+    qi = _mm_cvttpd_epi32 (q);
+    y[l]     = (uint8_t)_mm_cvtsi128_si32 (qi);
+    y[l + 1] = (uint8_t)_mm_cvtsi128_si32 (_mm_srli_si128 (qi, 4));
+  }
+}
+
+/*******************************************************************************
+* приведение к чёткости по 4 входа
+* \brief  Weighted average sc / sa with int16_t wrap and lim_s8, 4 lanes per
+*         SSE2 step; double division is exact for int16_t operands
+*******************************************************************************/
+static void batch_defuzz (const int16_t *sa, const int16_t *sc, int8_t *out, unsigned lanes)
+{
+  __m128i a, c, zero, q, one = _mm_set1_epi32 (1);
+  __m128d ql, qh;
+  unsigned l;
+
+  for (l = 0; l < lanes; l += 4)
+  {
+    a = _mm_loadl_epi64 ((const __m128i *)(sa + l));
+    c = _mm_loadl_epi64 ((const __m128i *)(sc + l));
+    a = _mm_srai_epi32 (_mm_unpacklo_epi16 (a, a), 16);
+    c = _mm_srai_epi32 (_mm_unpacklo_epi16 (c, c), 16);
+    zero = _mm_cmpeq_epi32 (a, _mm_setzero_si128 ());
+    a = _mm_or_si128 (a, _mm_and_si128 (zero, one));
+    ql = _mm_div_pd (_mm_cvtepi32_pd (c), _mm_cvtepi32_pd (a));
+    qh = _mm_div_pd (_mm_cvtepi32_pd (_mm_srli_si128 (c, 8)), _mm_cvtepi32_pd (_mm_srli_si128 (a, 8)));
+    q = _mm_unpacklo_epi64 (_mm_cvttpd_epi32 (ql), _mm_cvttpd_epi32 (qh));
+    q = _mm_srai_epi32 (_mm_slli_epi32 (q, 16), 16);      // int16_t ret
+    q = _mm_andnot_si128 (zero, q);
+    q = _mm_packs_epi32 (q, q);
+    q = _mm_max_epi16 (_mm_min_epi16 (q, _mm_set1_epi16 (127)), _mm_set1_epi16 (-127));
+    q = _mm_packs_epi16 (q, q);
+    *(int32_t *)(void *)(out + l) = _mm_cvtsi128_si32 (q);
+  }
+}
+
+/// SSE2 kernel, 16 vectors per step
+#define KERNEL          batch_sse2
+#define KERNEL_EDGE     batch_sse2_edge
+#define VL              (16)
+#define VI              __m128i
+#define V_LOAD(p)       _mm_loadu_si128 ((const __m128i *)(const void *)(p))
+#define V_STORE(p, v)   _mm_storeu_si128 ((__m128i *)(void *)(p), (v))
+#define V_SET8(x)       _mm_set1_epi8 ((char)(x))
+#define V_SET16(x)      _mm_set1_epi16 ((short)(x))
+#define V_ZERO          _mm_setzero_si128 ()
+#define V_MIN_U8        _mm_min_epu8
+#define V_MAX_U8        _mm_max_epu8
+#define V_XOR           _mm_xor_si128
+#define V_ADD16         _mm_add_epi16
+#define V_SUB16         _mm_sub_epi16
+#define V_MIN16         _mm_min_epi16
+#define V_MAX16         _mm_max_epi16
+#define V_MULLO16       _mm_mullo_epi16
+#define V_MULHI_U16     _mm_mulhi_epu16
+#define V_S8_LO(v)      _mm_srai_epi16 (_mm_unpacklo_epi8 ((v), (v)), 8)
+#define V_S8_HI(v)      _mm_srai_epi16 (_mm_unpackhi_epi8 ((v), (v)), 8)
+#define V_U8_LO(v)      _mm_unpacklo_epi8 ((v), _mm_setzero_si128 ())
+#define V_U8_HI(v)      _mm_unpackhi_epi8 ((v), _mm_setzero_si128 ())
+#define V_PACK_U8(a, b) _mm_packus_epi16 ((a), (b))
+
+#include  "fuzzy_batch_kernel.h"
+
+#if defined (BATCH_SSE2_TARGET)
+#pragma GCC pop_options
+#undef BATCH_SSE2_TARGET
+#endif
+
+#undef KERNEL
+#undef KERNEL_EDGE
+#undef VL
+#undef VI
+#undef V_LOAD
+#undef V_STORE
+#undef V_SET8
+#undef V_SET16
+#undef V_ZERO
+#undef V_MIN_U8
+#undef V_MAX_U8
+#undef V_XOR
+#undef V_ADD16
+#undef V_SUB16
+#undef V_MIN16
+#undef V_MAX16
+#undef V_MULLO16
+#undef V_MULHI_U16
+#undef V_S8_LO
+#undef V_S8_HI
+#undef V_U8_LO
+#undef V_U8_HI
+#undef V_PACK_U8
+
+/// AVX2 kernel, 32 vectors per step
+#define KERNEL          batch_avx2
+#define KERNEL_EDGE     batch_avx2_edge
+#define VL              (32)
+#define VI              __m256i
+#define V_LOAD(p)       _mm256_loadu_si256 ((const __m256i *)(const void *)(p))
+#define V_STORE(p, v)   _mm256_storeu_si256 ((__m256i *)(void *)(p), (v))
+#define V_SET8(x)       _mm256_set1_epi8 ((char)(x))
+#define V_SET16(x)      _mm256_set1_epi16 ((short)(x))
+#define V_ZERO          _mm256_setzero_si256 ()
+#define V_MIN_U8        _mm256_min_epu8
+#define V_MAX_U8        _mm256_max_epu8
+#define V_XOR           _mm256_xor_si256
+#define V_ADD16         _mm256_add_epi16
+#define V_SUB16         _mm256_sub_epi16
+#define V_MIN16         _mm256_min_epi16
+#define V_MAX16         _mm256_max_epi16
+#define V_MULLO16       _mm256_mullo_epi16
+#define V_MULHI_U16     _mm256_mulhi_epu16
+#define V_S8_LO(v)      _mm256_cvtepi8_epi16 (_mm256_castsi256_si128 (v))
+#define V_S8_HI(v)      _mm256_cvtepi8_epi16 (_mm256_extracti128_si256 ((v), 1))
+#define V_U8_LO(v)      _mm256_cvtepu8_epi16 (_mm256_castsi256_si128 (v))
+#define V_U8_HI(v)      _mm256_cvtepu8_epi16 (_mm256_extracti128_si256 ((v), 1))
+#define V_PACK_U8(a, b) _mm256_permute4x64_epi64 (_mm256_packus_epi16 ((a), (b)), 0xD8)
+
+#pragma GCC push_options
+#pragma GCC target ("avx2")
+#include  "fuzzy_batch_kernel.h"
+#pragma GCC pop_options
+
+#endif  // BATCH_X86
+
+
+/*******************************************************************************
+* определение ядра по процессору, один раз
+*******************************************************************************/
+static void batch_detect (void)
+{
+#if BATCH_X86
+  __builtin_cpu_init ();
+  if (__builtin_cpu_supports ("avx2"))
+  {
+    kernel_best = FUZZY_KERNEL_AVX2;
+  }
+  else if (__builtin_cpu_supports ("sse2"))
+  {
+    kernel_best = FUZZY_KERNEL_SSE2;
+  }
+#endif
+}
+
+/*******************************************************************************
+* Выбор ядра пакетного вычисления
+* \brief  Kernel for the request: unsupported kernel is replaced by the best
+*         supported one; no global state, the kernel of a batch is fixed
+*         by fuzzy_batch_init
+* \param[in]  kernel  requested kernel, FUZZY_KERNEL_AUTO - best by CPU
+* \return             kernel to use
+*******************************************************************************/
+fuzzy_kernel fuzzy_batch_kernel (fuzzy_kernel kernel)
+{
+  pthread_once (&kernel_once, batch_detect);
+  if ((kernel == FUZZY_KERNEL_AUTO) || (kernel > kernel_best))
+  {
+    kernel = kernel_best;
+  }
+  return kernel;
+}
+
+/*******************************************************************************
+* Название ядра
+* \brief  Kernel name
+* \param[in]  kernel  kernel
+* \return             name string
+*******************************************************************************/
+const char *fuzzy_kernel_name (fuzzy_kernel kernel)
+{
+  switch (kernel)
+  {
+  case FUZZY_KERNEL_SCALAR:
+    return "scalar";
+
+  case FUZZY_KERNEL_SSE2:
+    return "sse2";
+
+  case FUZZY_KERNEL_AVX2:
+    return "avx2";
+
+  case FUZZY_KERNEL_AUTO:
+  default:
+    return "auto";
+  }
+}
+
+/*******************************************************************************
+* Подготовка пакетного вычисления
+* \brief  Select the kernel and build the plan of the model once
+* \param[in]  model   compiled model, has to live with the batch
+* \param[in]  kernel  requested kernel, FUZZY_KERNEL_AUTO - best by CPU
+* \param[out] batch   prepared batch, free with fuzzy_batch_free
+* \return             FUZZY_OK, FUZZY_ERR_PARAM, FUZZY_ERR_MEMORY
+*******************************************************************************/
+fuzzy_status fuzzy_batch_init (const fuzzy_model *model, fuzzy_kernel kernel, fuzzy_batch *batch)
+{
+  size_t ws;
+  batch_plan *plan;
+
+  if ((model == NULL) || (batch == NULL) || (model->mf == NULL))
+  {
+    return FUZZY_ERR_PARAM;
+  }
+  memset (batch, 0, sizeof (fuzzy_batch));
+  batch->model = model;
+  batch->kernel = fuzzy_batch_kernel (kernel);
+  batch->lanes = 1;
+#if BATCH_X86
+  /// ядра - без ссылок вперёд и следствий первого порядка
+  if (!(model->flags & FUZZY_MODEL_FWD) && (model->ts == NULL))
+  {
+    batch->lanes = (batch->kernel == FUZZY_KERNEL_AVX2) ? 32 :
+                   (batch->kernel == FUZZY_KERNEL_SSE2) ? 16 : 1;
+  }
+#endif
+  ws = fuzzy_workspace_size (model);
+  batch->scratch = ws * batch->lanes +
+                   (size_t)model->n_in * batch->lanes + BATCH_LANES_MAX;
+  if (batch->lanes > 1)
+  {
+    plan = malloc (sizeof (batch_plan) + model->n_mf * sizeof (batch_mf));
+    if (plan == NULL)
+    {
+      return FUZZY_ERR_MEMORY;
+    }
+    plan->mf = (batch_mf *)(plan + 1);
+    batch_plan_build (model, plan);
+    batch->plan = plan;
+  }
+  else
+  {
+    batch->kernel = FUZZY_KERNEL_SCALAR;
+  }
+  return FUZZY_OK;
+}
+
+/*******************************************************************************
+* Освобождение пакетного вычисления
+* \brief  Free the plan of the batch
+* \param[in]  batch   prepared batch
+*******************************************************************************/
+void fuzzy_batch_free (fuzzy_batch *batch)
+{
+  if (batch)
+  {
+    free (batch->plan);
+    memset (batch, 0, sizeof (fuzzy_batch));
+  }
+}
+
+/*******************************************************************************
+* пакетное вычисление: строки или столбцы входов
+* \brief  Batch evaluation driver, inputs are rows (inputs != NULL)
+*         or columns (in_cols != NULL), memory of the call is scratch
+*******************************************************************************/
+static void batch_run (const fuzzy_batch *batch, const int8_t *inputs,
+                       const int8_t *const *in_cols, size_t count, int8_t *out, uint8_t *scratch)
+{
+  const fuzzy_model *model = batch->model;
+  size_t ws = fuzzy_workspace_size (model);
+  size_t base, lanes = batch->lanes, n, l;
+  batch_kernel kernel = NULL;
+  uint8_t *act = scratch;
+  int8_t *xs;
+  int8_t tail[BATCH_LANES_MAX];
+  uint16_t k;
+
+#if BATCH_X86
+  if (batch->kernel == FUZZY_KERNEL_AVX2)
+  {
+    kernel = batch_avx2;
+  }
+  else if (batch->kernel == FUZZY_KERNEL_SSE2)
+  {
+    kernel = batch_sse2;
+  }
+#endif
+  xs = (int8_t *)(act + ws * lanes);
+
+  if (kernel == NULL)
+  {
+    /// скалярный вариант: вектор за вектором от начального состояния
+    fuzzy_workspace_init (model, act);
+    for (base = 0; base < count; base++)
+    {
+      for (k = 0; k < model->n_in; k++)
+      {
+        xs[k] = inputs ? inputs[base * model->n_in + k] : in_cols[k][base];
+      }
+      out[base] = process_fuzzy_logic_ws (model, xs, act);
+    }
+    return;
+  }
+  for (base = 0; base < count; base += lanes)
+  {
+    n = (count - base < lanes) ? (count - base) : lanes;
+    for (k = 0; k < model->n_in; k++)
+    {
+      if (inputs)
+      {
+        for (l = 0; l < n; l++)
+        {
+          xs[k * lanes + l] = inputs[(base + l) * model->n_in + k];
+        }
+      }
+      else
+      {
+        memcpy (xs + k * lanes, in_cols[k] + base, n);
+      }
+      memset (xs + k * lanes + n, 0, lanes - n);
+    }
+    kernel (batch->plan, xs, act, (n == lanes) ? (out + base) : tail);
+    if (n < lanes)
+    {
+      memcpy (out + base, tail, n);
+    }
+  }
+}
+
+/*******************************************************************************
+* Пакетное вычисление подготовленной модели
+* \brief  Evaluate count input vectors [count][model->n_in], no allocation
+* \param[in]  batch   prepared batch
+* \param[in]  inputs  input vectors one after another
+* \param[in]  count   number of vectors
+* \param[out] out     output values [count]
+* \param[in]  scratch caller memory of batch->scratch bytes, one per thread
+* \return             FUZZY_OK, FUZZY_ERR_PARAM
+*******************************************************************************/
+fuzzy_status process_fuzzy_batch_ws (const fuzzy_batch *batch, const int8_t *inputs,
+                                     size_t count, int8_t *out, uint8_t *scratch)
+{
+  if ((batch == NULL) || (batch->model == NULL) || (inputs == NULL) || (out == NULL) ||
+      (scratch == NULL))
+  {
+    return FUZZY_ERR_PARAM;
+  }
+  batch_run (batch, inputs, NULL, count, out, scratch);
+  return FUZZY_OK;
+}
+
+/*******************************************************************************
+* Пакетное вычисление подготовленной модели по столбцам входов
+* \brief  Evaluate count input vectors given by columns in_cols[n][count],
+*         no allocation
+* \param[in]  batch   prepared batch
+* \param[in]  in_cols input columns [model->n_in]
+* \param[in]  count   number of vectors
+* \param[out] out     output values [count]
+* \param[in]  scratch caller memory of batch->scratch bytes, one per thread
+* \return             FUZZY_OK, FUZZY_ERR_PARAM
+*******************************************************************************/
+fuzzy_status process_fuzzy_batch_soa_ws (const fuzzy_batch *batch, const int8_t *const *in_cols,
+                                         size_t count, int8_t *out, uint8_t *scratch)
+{
+  if ((batch == NULL) || (batch->model == NULL) || (in_cols == NULL) || (out == NULL) ||
+      (scratch == NULL))
+  {
+    return FUZZY_ERR_PARAM;
+  }
+  batch_run (batch, NULL, in_cols, count, out, scratch);
+  return FUZZY_OK;
+}
+
+/*******************************************************************************
+* разовое пакетное вычисление: подготовка, память вызова, освобождение
+*******************************************************************************/
+static fuzzy_status batch_once (const fuzzy_model *model, const int8_t *inputs,
+                                const int8_t *const *in_cols, size_t count, int8_t *out)
+{
+  fuzzy_batch batch;
+  fuzzy_status st;
+  uint8_t *scratch;
+
+  st = fuzzy_batch_init (model, FUZZY_KERNEL_AUTO, &batch);
+  if (st != FUZZY_OK)
+  {
+    return st;
+  }
+  scratch = malloc (batch.scratch);
+  if (scratch == NULL)
+  {
+    fuzzy_batch_free (&batch);
+    return FUZZY_ERR_MEMORY;
+  }
+  batch_run (&batch, inputs, in_cols, count, out, scratch);
+  free (scratch);
+  fuzzy_batch_free (&batch);
+  return FUZZY_OK;
+}
+
+/*******************************************************************************
+* Пакетное вычисление нечёткого регулятора
+* \brief  Evaluate count input vectors [count][model->n_in]; one-off call,
+*         prepares the plan and allocates the memory of the call, repeated
+*         calls use fuzzy_batch_init and process_fuzzy_batch_ws
+* \param[in]  model   compiled model
+* \param[in]  inputs  input vectors one after another
+* \param[in]  count   number of vectors
+* \param[out] out     output values [count]
+* \return             FUZZY_OK or error status
+*******************************************************************************/
+fuzzy_status process_fuzzy_logic_batch (const fuzzy_model *model, const int8_t *inputs,
+                                        size_t count, int8_t *out)
+{
+  if ((model == NULL) || (inputs == NULL) || (out == NULL))
+  {
+    return FUZZY_ERR_PARAM;
+  }
+  return batch_once (model, inputs, NULL, count, out);
+}
+
+/*******************************************************************************
+* Пакетное вычисление нечёткого регулятора по столбцам входов
+* \brief  Evaluate count input vectors given by columns in_cols[n][count];
+*         one-off call as process_fuzzy_logic_batch
+* \param[in]  model   compiled model
+* \param[in]  in_cols input columns [model->n_in]
+* \param[in]  count   number of vectors
+* \param[out] out     output values [count]
+* \return             FUZZY_OK or error status
+*******************************************************************************/
+fuzzy_status process_fuzzy_logic_batch_soa (const fuzzy_model *model, const int8_t *const *in_cols,
+                                            size_t count, int8_t *out)
+{
+  if ((model == NULL) || (in_cols == NULL) || (out == NULL))
+  {
+    return FUZZY_ERR_PARAM;
+  }
+  return batch_once (model, NULL, in_cols, count, out);
+}
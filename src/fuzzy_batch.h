@@ -0,0 +1,80 @@
+/*******************************************************************************
+* \file     fuzzy_batch.h
+* \author   Ilya Petrukhin (ilya.petrukhin@gmail.com)
+* \brief    Batched (SIMD) evaluation of the compiled fuzzy model
+* \version  2.1
+* \date     2026-10-17
+*******************************************************************************/
+
+#ifndef _FUZZY_BATCH_H_
+#define _FUZZY_BATCH_H_
+
+#include  <stdint.h>
+#include  <stddef.h>
+#include  "fuzzy_logic.h"
+#include  "fuzzy_model.h"
+
+/*******************************************************************************
+* Rules to using batched evaluation
+*******************************************************************************/
+// inputs are count input vectors one after another: [count][model->n_in]
+//  process_fuzzy_logic_batch (&model, inputs, count, out);
+// or by columns (structure of arrays): in_cols[n][count]
+//  process_fuzzy_logic_batch_soa (&model, in_cols, count, out);
+//
+// These calls prepare the plan and allocate memory every time (one-off use).
+// Repeated calls prepare the model once and pass memory of the call:
+//  fuzzy_batch batch;
+//  fuzzy_batch_init (&model, FUZZY_KERNEL_AUTO, &batch);
+//  uint8_t *scratch = malloc (batch.scratch);        // one per thread
+//  process_fuzzy_batch_ws (&batch, inputs, count, out, scratch);
+//  process_fuzzy_batch_soa_ws (&batch, in_cols, count, out, scratch);
+//  free (scratch);
+//  fuzzy_batch_free (&batch);
+//
+// SSE2 / AVX2 kernel is detected once per process; the kernel of a batch is
+// fixed by fuzzy_batch_init (FUZZY_KERNEL_SCALAR, ... to compare kernels),
+// fuzzy_batch_kernel only tells the kernel of the request.
+// Every kernel gives the same results as process_fuzzy_logic_compiled
+// called for each input vector. Models with rules reading results of later
+// rules (FUZZY_MODEL_FWD) keep state between vectors starting from the
+// initial state and are always evaluated one by one.
+// A prepared batch is read-only and may be shared by many threads, each
+// with own scratch.
+// ***************** end of the brief *****************************************
+
+/// Batch evaluation kernels
+typedef enum
+{
+  FUZZY_KERNEL_AUTO = 0,  ///< best kernel supported by CPU
+  FUZZY_KERNEL_SCALAR,    ///< portable scalar code
+  FUZZY_KERNEL_SSE2,      ///< 16 vectors per step
+  FUZZY_KERNEL_AVX2       ///< 32 vectors per step
+} fuzzy_kernel;
+
+/// Prepared batch evaluation of the model
+typedef struct
+{
+  const fuzzy_model *model;   ///< compiled model
+  fuzzy_kernel      kernel;   ///< kernel of the batch
+  uint16_t          lanes;    ///< vectors per kernel step, 1 - scalar
+  size_t            scratch;  ///< memory of the call, bytes
+  void              *plan;    ///< functions plan of the kernel, NULL - scalar
+} fuzzy_batch;
+
+fuzzy_kernel fuzzy_batch_kernel (fuzzy_kernel kernel);   ///< kernel for the request
+const char  *fuzzy_kernel_name (fuzzy_kernel kernel);    ///< kernel name
+
+fuzzy_status fuzzy_batch_init (const fuzzy_model *model, fuzzy_kernel kernel, fuzzy_batch *batch);
+void         fuzzy_batch_free (fuzzy_batch *batch);
+fuzzy_status process_fuzzy_batch_ws (const fuzzy_batch *batch, const int8_t *inputs,
+                                     size_t count, int8_t *out, uint8_t *scratch);
+fuzzy_status process_fuzzy_batch_soa_ws (const fuzzy_batch *batch, const int8_t *const *in_cols,
+                                         size_t count, int8_t *out, uint8_t *scratch);
+
+fuzzy_status process_fuzzy_logic_batch (const fuzzy_model *model, const int8_t *inputs,
+                                        size_t count, int8_t *out);
+fuzzy_status process_fuzzy_logic_batch_soa (const fuzzy_model *model, const int8_t *const *in_cols,
+                                            size_t count, int8_t *out);
+
+#endif  // _FUZZY_BATCH_H_
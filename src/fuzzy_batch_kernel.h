@@ -0,0 +1,145 @@
+/*******************************************************************************
+* \file     fuzzy_batch_kernel.h
+* \author   Ilya Petrukhin (ilya.petrukhin@gmail.com)
+* \brief    SIMD kernel template of the batched evaluation, included by
+*           fuzzy_batch.c once per instruction set with macros:
+*           KERNEL    - kernel function name
+*           VL        - vectors per step (uint8_t lanes)
+*           VI        - vector type
+*           V_LOAD, V_STORE, V_SET8, V_SET16, V_ZERO, V_MIN_U8, V_MAX_U8,
+*           V_XOR, V_ADD16, V_SUB16, V_MIN16, V_MAX16, V_MULLO16,
+*           V_MULHI_U16, V_S8_LO, V_S8_HI, V_U8_LO, V_U8_HI, V_PACK_U8
+*           16-bit halves V_xx_LO / V_xx_HI keep natural lane order
+* \version  2.1
+* \date     2026-10-17
+*******************************************************************************/
+
+/*******************************************************************************
+* крутизна фронта трапеции на VL/2 входах
+* \brief  Trapezoid edge: floor (255 * min (max (n, 0), d) / d) by
+*         Q16 reciprocal m = mh * 65536 + ml, exact for n <= d <= 255
+*******************************************************************************/
+static inline VI KERNEL_EDGE (VI n, VI d, VI mh, VI ml)
+{
+  n = V_MIN16 (V_MAX16 (n, V_ZERO), d);
+  return V_ADD16 (V_MULLO16 (n, mh), V_MULHI_U16 (n, ml));
+}
+
+/*******************************************************************************
+* Вычисление VL входных векторов
+* \brief  Evaluate VL input vectors
+* \param[in]  plan  batch plan of the model
+* \param[in]  xs    inputs by columns [n_in][VL]
+* \param[in]  act   activation vectors [n_mf + n_rule][VL]
+* \param[out] out   outputs [VL]
+*******************************************************************************/
+static void KERNEL (const batch_plan *plan, const int8_t *xs, uint8_t *act, int8_t *out)
+{
+  const batch_mf *p = plan->mf;
+  const fuzzy_rule_ix *r = plan->rule;
+  uint8_t *y = act;
+  VI xv, x0, x1, e0, e1, a, b, alpha, lo, hi, o;
+  VI sa0 = V_ZERO, sa1 = V_ZERO, sc0 = V_ZERO, sc1 = V_ZERO;
+  int16_t sa[VL], sc[VL];
+  uint16_t i;
+  unsigned l;
+
+  /// функции фуззификации
+  for (i = 0; i < plan->n_mf; i++, p++, y += VL)
+  {
+    switch (p->kind)
+    {
+    case FN_TRAP:
+      xv = V_LOAD (xs + p->xn * VL);
+      x0 = V_S8_LO (xv);
+      x1 = V_S8_HI (xv);
+      e0 = V_MIN16 (KERNEL_EDGE (V_SUB16 (x0, V_SET16 (p->bl)), V_SET16 (p->dl),
+                                 V_SET16 (p->mhl), V_SET16 (p->mll)),
+                    KERNEL_EDGE (V_SUB16 (V_SET16 (p->br), x0), V_SET16 (p->dr),
+                                 V_SET16 (p->mhr), V_SET16 (p->mlr)));
+      e1 = V_MIN16 (KERNEL_EDGE (V_SUB16 (x1, V_SET16 (p->bl)), V_SET16 (p->dl),
+                                 V_SET16 (p->mhl), V_SET16 (p->mll)),
+                    KERNEL_EDGE (V_SUB16 (V_SET16 (p->br), x1), V_SET16 (p->dr),
+                                 V_SET16 (p->mhr), V_SET16 (p->mlr)));
+      V_STORE (y, V_PACK_U8 (e0, e1));
+      break;
+
+    case FN_CONST:
+      V_STORE (y, V_SET8 (p->y));
+      break;
+
+    case FN_CUBE:
+      if (p->lut == NULL)
+      {
+        batch_cube (p, xs + p->xn * VL, y, VL);
+        break;
+      }
+      /* fall through */
+    case FN_FUNC:
+    default:
+      batch_func (p, xs + p->xn * VL, y, VL);
+      break;
+    }
+  }
+
+  /// правила нечёткой логики
+  for (i = 0; i < plan->n_rule; i++, r++, y += VL)
+  {
+    a = V_LOAD (act + r->a * VL);
+    b = V_LOAD (act + r->b * VL);
+    switch (r->op)
+    {
+    case F_AND:
+      alpha = V_MIN_U8 (a, b);
+      break;
+
+    case F_OR:
+      alpha = V_MAX_U8 (a, b);
+      break;
+
+    case F_NOT:
+      alpha = V_XOR (a, V_SET8 (0xFF));   // 255 - a
+      break;
+
+    case F_A:
+      alpha = a;
+      break;
+
+    case F_B:
+      alpha = b;
+      break;
+
+    case F_IMP:
+      for (l = 0; l < VL; l++)
+      {
+        y[l] = fuzzy_operator (F_IMP, act[r->a * VL + l], act[r->b * VL + l]);
+      }
+      alpha = V_LOAD (y);
+      break;
+
+    case F_FALSE:
+    default:
+      alpha = V_ZERO;
+      break;
+    }
+    V_STORE (y, alpha);
+
+    if (r->fin)
+    {
+      /// суммы по модулю 2^16, как int16_t в process_fuzzy_logic
+      lo = V_U8_LO (alpha);
+      hi = V_U8_HI (alpha);
+      o = V_SET16 (r->out);
+      sa0 = V_ADD16 (sa0, lo);
+      sa1 = V_ADD16 (sa1, hi);
+      sc0 = V_ADD16 (sc0, V_MULLO16 (lo, o));
+      sc1 = V_ADD16 (sc1, V_MULLO16 (hi, o));
+    }
+  }
+
+  V_STORE ((uint8_t *)sa, sa0);
+  V_STORE ((uint8_t *)(sa + VL / 2), sa1);
+  V_STORE ((uint8_t *)sc, sc0);
+  V_STORE ((uint8_t *)(sc + VL / 2), sc1);
+  batch_defuzz (sa, sc, out, VL);
+}
@@ -0,0 +1,393 @@
+/*******************************************************************************
+* \file     fuzzy_chain.c
+* \author   Ilya Petrukhin (ilya.petrukhin@gmail.com)
+* \brief    This file provides code for the chain of compiled controllers:
+*           fused scaling tables between the stages, stage timing
+* \version  2.1
+* \date     2026-10-17
+*******************************************************************************/
+#include  <stdio.h>
+#include  <stdint.h>
+#include  <stdbool.h>
+#include  <stdlib.h>
+#include  <string.h>
+#include  "fuzzy_logic.h"
+#include  "fuzzy_model.h"
+#include  "fuzzy_chain.h"
+#include  "fuzzy_time.h"
+
+#define ALIGN_UP(x, a)  (((x) + ((a) - 1)) & ~((size_t)(a) - 1))
+
+
+/*******************************************************************************
+* Описание цепочки по умолчанию
+* \brief  Empty chain, every 2^FUZZY_CHAIN_TIME_SHIFT call timed
+* \param[out] cfg   description
+*******************************************************************************/
+void fuzzy_chain_default (fuzzy_chain_cfg *cfg)
+{
+  memset (cfg, 0, sizeof (fuzzy_chain_cfg));
+  cfg->time_shift = FUZZY_CHAIN_TIME_SHIFT;
+}
+
+/*******************************************************************************
+* проверка описания: источники - входы цепочки или предыдущие ступени
+*******************************************************************************/
+static fuzzy_status chain_check (const fuzzy_chain_cfg *cfg)
+{
+  const fuzzy_chain_stage *st;
+  uint16_t s, k, src;
+
+  if ((cfg->n_in == 0) || (cfg->n_in > FUZZY_CHAIN_MAX_IN) ||
+      (cfg->n_stage == 0) || (cfg->n_stage > FUZZY_CHAIN_MAX_STAGE))
+  {
+    return FUZZY_ERR_PARAM;
+  }
+  for (s = 0; s < cfg->n_stage; s++)
+  {
+    st = &cfg->stage[s];
+    if ((st->model == NULL) || (st->model->mf == NULL) || (st->model->n_out == 0) ||
+        (st->model->n_in > FUZZY_CHAIN_MAX_IN))
+    {
+      return FUZZY_ERR_PARAM;
+    }
+    for (k = 0; k < st->model->n_in; k++)
+    {
+      src = st->src[k];
+      if ((src & FUZZY_CHAIN_SRC_OUT) ? ((src & ~FUZZY_CHAIN_SRC_OUT) >= s) : (src >= cfg->n_in))
+      {
+        return FUZZY_ERR_STRUCT;
+      }
+    }
+  }
+  return FUZZY_OK;
+}
+
+/*******************************************************************************
+* номер пары вход / масштаб, новая пара при первой встрече
+*******************************************************************************/
+static uint16_t chain_pair (fuzzy_chain_scale *sc, uint16_t *n, uint16_t src,
+                            int8_t (*scale) (int16_t x))
+{
+  uint16_t i;
+
+  for (i = 0; i < *n; i++)
+  {
+    if ((sc[i].src == src) && (sc[i].scale == scale))
+    {
+      return i;
+    }
+  }
+  sc[i].src = src;
+  sc[i].scale = scale;
+  return (*n)++;
+}
+
+/*******************************************************************************
+* входы ступеней, читающие пару p: позиции в x подряд
+*******************************************************************************/
+static uint16_t chain_dst (const uint16_t *owner, uint16_t n_x, uint16_t p, uint16_t *dst)
+{
+  uint16_t i, n = 0;
+
+  for (i = 0; i < n_x; i++)
+  {
+    if (owner[i] == p)
+    {
+      dst[n++] = i;
+    }
+  }
+  return n;
+}
+
+/*******************************************************************************
+* Создание цепочки регуляторов
+* \brief  Check the description, place the input vectors of the stages one
+*         after another, find the readers of every scaled input and link,
+*         fuse the scaling of the links into tables, allocate the
+*         workspaces of the stages
+* \param[in]  cfg     description of the stages
+* \param[out] chain   chain, free with fuzzy_chain_free
+* \return             FUZZY_OK, FUZZY_ERR_PARAM, FUZZY_ERR_STRUCT (input of a
+*                     stage from the same or a later stage, or out of the
+*                     chain inputs), FUZZY_ERR_MEMORY
+*******************************************************************************/
+fuzzy_status fuzzy_chain_init (const fuzzy_chain_cfg *cfg, fuzzy_chain *chain)
+{
+  /// пары вход / масштаб: входы цепочки и связи (src - ступень источника);
+  /// owner - пара входа ступени, связи с флагом FUZZY_CHAIN_SRC_OUT
+  fuzzy_chain_scale sc[FUZZY_CHAIN_MAX_STAGE * FUZZY_CHAIN_MAX_IN];
+  fuzzy_chain_scale lk[FUZZY_CHAIN_MAX_STAGE * FUZZY_CHAIN_MAX_IN];
+  uint16_t owner[FUZZY_CHAIN_MAX_STAGE * FUZZY_CHAIN_MAX_IN];
+  uint16_t x_off[FUZZY_CHAIN_MAX_STAGE];
+  uint16_t n_scale = 0, n_lk = 0, n_lk_s, n_x = 0;
+  const fuzzy_chain_stage *st;
+  fuzzy_chain_scale *scale;
+  fuzzy_chain_link *link;
+  int16_t (*oval)[256];
+  size_t off_node, off_scale, off_link, off_dst, off_time, off_oval, off_table, off_x, off_y,
+         off_ws, size, ws_size = 0;
+  uint8_t *mem, *ws;
+  uint16_t *dst;
+  int8_t *table;
+  fuzzy_status ret;
+  uint16_t s, k, j;
+  int32_t x, v;
+
+  if ((cfg == NULL) || (chain == NULL))
+  {
+    return FUZZY_ERR_PARAM;
+  }
+  memset (chain, 0, sizeof (fuzzy_chain));
+  ret = chain_check (cfg);
+  if (ret != FUZZY_OK)
+  {
+    return ret;
+  }
+
+  /// входы ступеней подряд; пары входов цепочки
+  for (s = 0; s < cfg->n_stage; s++)
+  {
+    st = &cfg->stage[s];
+    x_off[s] = n_x;
+    for (k = 0; k < st->model->n_in; k++, n_x++)
+    {
+      if (!(st->src[k] & FUZZY_CHAIN_SRC_OUT))
+      {
+        owner[n_x] = chain_pair (sc, &n_scale, st->src[k], st->scale[k]);
+      }
+    }
+    ws_size += ALIGN_UP (fuzzy_workspace_size (st->model), 8);
+  }
+  /// связи подряд по ступеням источника, пара ищется среди связей ступени j
+  for (j = 0; j < cfg->n_stage; j++)
+  {
+    n_lk_s = 0;
+    for (s = j + 1; s < cfg->n_stage; s++)
+    {
+      st = &cfg->stage[s];
+      for (k = 0; k < st->model->n_in; k++)
+      {
+        if (st->src[k] == FUZZY_CHAIN_OUT (j))
+        {
+          owner[x_off[s] + k] = (uint16_t)(FUZZY_CHAIN_SRC_OUT |
+                                           (n_lk + chain_pair (lk + n_lk, &n_lk_s, j, st->scale[k])));
+        }
+      }
+    }
+    n_lk += n_lk_s;
+  }
+
+  /// один блок памяти: ступени, масштабы, связи, читатели, времена, таблицы,
+  /// входы ступеней, выходы, рабочие области
+  off_node  = 0;
+  off_scale = ALIGN_UP (off_node + cfg->n_stage * sizeof (fuzzy_chain_node), 8);
+  off_link  = ALIGN_UP (off_scale + n_scale * sizeof (fuzzy_chain_scale), 8);
+  off_dst   = ALIGN_UP (off_link + n_lk * sizeof (fuzzy_chain_link), 8);
+  off_time  = ALIGN_UP (off_dst + n_x * sizeof (uint16_t), 8);
+  off_oval  = ALIGN_UP (off_time + (cfg->n_stage + 1u) * sizeof (fuzzy_chain_time), 8);
+  off_table = off_oval + cfg->n_stage * 256 * sizeof (int16_t);
+  off_x     = off_table + (size_t)n_lk * 256;
+  off_y     = off_x + n_x;
+  off_ws    = ALIGN_UP (off_y + cfg->n_stage, 8);
+  size      = off_ws + ws_size;
+
+  mem = calloc (1, size);
+  if (mem == NULL)
+  {
+    return FUZZY_ERR_MEMORY;
+  }
+  chain->node = (fuzzy_chain_node *)(mem + off_node);
+  scale       = (fuzzy_chain_scale *)(mem + off_scale);
+  link        = (fuzzy_chain_link *)(mem + off_link);
+  dst         = (uint16_t *)(mem + off_dst);
+  chain->time = (fuzzy_chain_time *)(mem + off_time);
+  oval        = (int16_t (*)[256])(mem + off_oval);
+  table       = (int8_t *)(mem + off_table);
+  chain->x    = (int8_t *)(mem + off_x);
+  chain->y    = (int8_t *)(mem + off_y);
+  ws          = mem + off_ws;
+
+  for (s = 0; s < cfg->n_stage; s++)
+  {
+    st = &cfg->stage[s];
+    /// выход ступени: масштабированное значение
+    for (x = INT8_MIN; x <= INT8_MAX; x++)
+    {
+      oval[s][(uint8_t)x] = st->out_scale ? st->out_scale ((int8_t)x) : (int16_t)x;
+    }
+    chain->node[s].model = st->model;
+    chain->node[s].in    = chain->x + x_off[s];
+    chain->node[s].ws    = ws;
+    fuzzy_workspace_init (st->model, ws);
+    ws += ALIGN_UP (fuzzy_workspace_size (st->model), 8);
+  }
+  /// входы цепочки: читатели каждой пары
+  for (j = 0; j < n_scale; j++)
+  {
+    scale[j].src   = sc[j].src;
+    scale[j].scale = sc[j].scale;
+    scale[j].dst   = dst;
+    scale[j].n_dst = chain_dst (owner, n_x, j, dst);
+    dst += scale[j].n_dst;
+  }
+  /// связи: масштаб выхода источника и масштаб входа одной таблицей
+  for (j = 0; j < n_lk; j++, table += 256)
+  {
+    s = lk[j].src;
+    for (x = INT8_MIN; x <= INT8_MAX; x++)
+    {
+      v = oval[s][(uint8_t)x];
+      table[(uint8_t)x] = lk[j].scale ? lk[j].scale ((int16_t)v) : lim_s8 ((int16_t)v);
+    }
+    link[j].table = table;
+    link[j].dst   = dst;
+    link[j].n_dst = chain_dst (owner, n_x, (uint16_t)(FUZZY_CHAIN_SRC_OUT | j), dst);
+    dst += link[j].n_dst;
+    if (chain->node[s].n_link++ == 0)
+    {
+      chain->node[s].link = &link[j];
+    }
+  }
+
+  chain->n_in    = cfg->n_in;
+  chain->n_stage = cfg->n_stage;
+  chain->n_scale = n_scale;
+  chain->n_x     = n_x;
+  chain->scale   = scale;
+  chain->timing  = cfg->time_shift < 64;
+  chain->mask    = chain->timing ? ((1ULL << cfg->time_shift) - 1u) : 0;
+  chain->oval    = (const int16_t (*)[256])oval;
+  chain->mem     = mem;
+  return FUZZY_OK;
+}
+
+/*******************************************************************************
+* время ступени
+*******************************************************************************/
+static inline void chain_time_add (fuzzy_chain_time *t, uint64_t ns)
+{
+  t->sampled++;
+  t->sum_ns += ns;
+  t->max_ns = (ns > t->max_ns) ? ns : t->max_ns;
+}
+
+/*******************************************************************************
+* Реализация цепочки нечетких регуляторов
+* \brief  Evaluate all stages in order, outputs of the stages to chain->y
+* \param[in] chain     chain
+* \param[in] in_array  raw inputs of the chain [chain->n_in]
+* \return Output of the last stage after its output scaling
+*******************************************************************************/
+int16_t process_fuzzy_chain (fuzzy_chain *chain, const int16_t *in_array)
+{
+  const fuzzy_chain_scale *sc = chain->scale;
+  const fuzzy_chain_node *node = chain->node;
+  const fuzzy_chain_link *l;
+  int8_t *x = chain->x;
+  int8_t *y = chain->y;
+  uint64_t t0 = 0, t = 0, now;
+  bool timed = chain->timing && ((chain->calls++ & chain->mask) == 0);
+  uint16_t s, k, d;
+  int8_t v;
+
+  if (timed)
+  {
+    t0 = t = fuzzy_time_ns ();
+  }
+  /// входы цепочки: один раз на вызов, сразу во входы читающих ступеней
+  for (k = 0; k < chain->n_scale; k++, sc++)
+  {
+    v = sc->scale ? sc->scale (in_array[sc->src]) : lim_s8 (in_array[sc->src]);
+    for (d = 0; d < sc->n_dst; d++)
+    {
+      x[sc->dst[d]] = v;
+    }
+  }
+  for (s = 0; s < chain->n_stage; s++, node++)
+  {
+    /// ступень читает свои входы на месте
+    y[s] = process_fuzzy_logic_ws (node->model, node->in, node->ws);
+    /// связи: слитая таблица масштабов, сразу во входы следующих ступеней
+    for (k = 0, l = node->link; k < node->n_link; k++, l++)
+    {
+      v = l->table[(uint8_t)y[s]];
+      for (d = 0; d < l->n_dst; d++)
+      {
+        x[l->dst[d]] = v;
+      }
+    }
+    if (timed)
+    {
+      now = fuzzy_time_ns ();
+      chain_time_add (&chain->time[s], now - t);
+      t = now;
+    }
+  }
+  if (timed)
+  {
+    chain_time_add (&chain->time[chain->n_stage], t - t0);
+  }
+  return chain->oval[chain->n_stage - 1][(uint8_t)y[chain->n_stage - 1]];
+}
+
+/*******************************************************************************
+* Печать времени ступеней
+* \brief  Mean and max time of every stage and of the whole chain
+* \param[in]  chain   chain
+* \param[in]  f       output stream
+*******************************************************************************/
+void fuzzy_chain_print_time (const fuzzy_chain *chain, FILE *f)
+{
+  const fuzzy_chain_time *t;
+  uint16_t s;
+
+  if ((chain == NULL) || (chain->mem == NULL))
+  {
+    return;
+  }
+  fprintf (f, "# stage\trules\tsampled\tmean ns\tmax ns\n");
+  for (s = 0; s <= chain->n_stage; s++)
+  {
+    t = &chain->time[s];
+    if (s < chain->n_stage)
+    {
+      fprintf (f, "%u\t%u", (unsigned)s, (unsigned)chain->node[s].model->n_rule);
+    }
+    else
+    {
+      fprintf (f, "chain\t-");
+    }
+    fprintf (f, "\t%llu\t%.1f\t%llu\n", (unsigned long long)t->sampled,
+             t->sampled ? (double)t->sum_ns / (double)t->sampled : 0.0,
+             (unsigned long long)t->max_ns);
+  }
+}
+
+/*******************************************************************************
+* Сброс времени ступеней
+* \brief  Clear the stage times, e.g. after warm-up calls
+* \param[in]  chain   chain
+*******************************************************************************/
+void fuzzy_chain_reset_time (fuzzy_chain *chain)
+{
+  if (chain && chain->mem)
+  {
+    memset (chain->time, 0, (chain->n_stage + 1u) * sizeof (fuzzy_chain_time));
+    chain->calls = 0;
+  }
+}
+
+/*******************************************************************************
+* Удаление цепочки
+* \brief  Free the chain
+* \param[in]  chain   chain
+*******************************************************************************/
+void fuzzy_chain_free (fuzzy_chain *chain)
+{
+  if (chain)
+  {
+    free (chain->mem);
+    memset (chain, 0, sizeof (fuzzy_chain));
+  }
+}
@@ -0,0 +1,167 @@
+/*******************************************************************************
+* \file     fuzzy_chain.h
+* \author   Ilya Petrukhin (ilya.petrukhin@gmail.com)
+* \brief    Chain of compiled fuzzy controllers: output of one stage is the
+*           input of the next by fused scaling tables, whole chain per call
+* \version  2.1
+* \date     2026-10-17
+*******************************************************************************/
+
+#ifndef _FUZZY_CHAIN_H_
+#define _FUZZY_CHAIN_H_
+
+#include  <stdio.h>
+#include  <stdint.h>
+#include  <stdbool.h>
+#include  "fuzzy_logic.h"
+#include  "fuzzy_model.h"
+
+/*******************************************************************************
+* Rules to using chain
+*******************************************************************************/
+// 1. Describe the stages in the order of evaluation, source of every
+// input of the stage is an input of the chain (raw int16_t value) or the
+// output of an earlier stage:
+//  fuzzy_chain_cfg cfg;
+//  fuzzy_chain_default (&cfg);
+//  cfg.n_in = 2;                                   // dist_err, course
+//  cfg.n_stage = 2;
+//  cfg.stage[0].model = &heading;                  // -> target course
+//  cfg.stage[0].src[0] = FUZZY_CHAIN_IN (0);
+//  cfg.stage[0].scale[0] = in0_scaling;            // NULL - lim_s8
+//  cfg.stage[0].src[1] = FUZZY_CHAIN_IN (1);
+//  cfg.stage[0].scale[1] = in1_scaling;
+//  cfg.stage[0].out_scale = out_scaling;           // NULL - no scaling
+//  cfg.stage[1].model = &track;                    // -> rudder
+//  cfg.stage[1].src[0] = FUZZY_CHAIN_OUT (0);
+//  cfg.stage[1].scale[0] = course_scaling;
+//  cfg.stage[1].src[1] = FUZZY_CHAIN_IN (1);
+//  cfg.stage[1].scale[1] = in1_scaling;
+//
+// 2. Build and evaluate:
+//  fuzzy_chain chain;
+//  fuzzy_chain_init (&cfg, &chain);
+//  int16_t raw[2] = { dist_err, course };
+//  int16_t rudder = process_fuzzy_chain (&chain, raw);   // last stage, scaled
+//  int8_t course_set = chain.y[0];                       // stage output
+//  fuzzy_chain_free (&chain);
+//
+// Link from the output of stage s to an input of a later stage is a
+// 256-byte table scale (out_scale (y)) built by fuzzy_chain_init, so the
+// output goes to the next stage without int16_t value and scaling calls.
+// Inputs of the chain are scaled by cfg scale functions (lim_s8 if NULL)
+// once per call, also when several stages read them. The input vectors of
+// all stages are one int8_t vector x, stage s reads its inputs in place
+// (x + offset of s); a scaled input or a linked output is computed once and
+// written to every input that reads it, no other buffer between the
+// stages. Every stage is evaluated by process_fuzzy_logic_ws with own
+// workspace; output 0 of the model only.
+//
+// 3. Stage time: every 2^cfg.time_shift call is timed stage by stage
+// (the model and its links), FUZZY_CHAIN_TIME_OFF - never:
+//  fuzzy_chain_print_time (&chain, stdout);
+//  fuzzy_chain_reset_time (&chain);
+//
+// Models are shared and have to live while the chain is in use; one chain
+// per caller (thread), models with rules reading later rules keep the
+// state in the workspace of the stage.
+// ***************** end of the brief *****************************************
+
+#define FUZZY_CHAIN_MAX_STAGE   (8)       ///< max stages
+#define FUZZY_CHAIN_MAX_IN      (8)       ///< max inputs of the chain and of a stage
+#define FUZZY_CHAIN_SRC_OUT     (0x8000u) ///< source flag: output of the stage
+#define FUZZY_CHAIN_TIME_SHIFT  (8)       ///< default: every 256th call timed
+#define FUZZY_CHAIN_TIME_OFF    (0xFFu)   ///< calls are not timed
+
+#define FUZZY_CHAIN_IN(i)       ((uint16_t)(i))                         ///< input i of the chain
+#define FUZZY_CHAIN_OUT(s)      ((uint16_t)(FUZZY_CHAIN_SRC_OUT | (s))) ///< output of stage s
+
+/// Stage description
+typedef struct
+{
+  const fuzzy_model *model;                           ///< compiled model
+  uint16_t          src[FUZZY_CHAIN_MAX_IN];          ///< source of input k
+  int8_t            (*scale[FUZZY_CHAIN_MAX_IN]) (int16_t x);  ///< input scaling, NULL - lim_s8
+  int16_t           (*out_scale) (int8_t out);        ///< output scaling, NULL - none
+} fuzzy_chain_stage;
+
+/// Chain description
+typedef struct
+{
+  uint16_t          n_in;                             ///< inputs of the chain
+  uint16_t          n_stage;                          ///< stages
+  uint8_t           time_shift;                       ///< every 2^shift call timed
+  fuzzy_chain_stage stage[FUZZY_CHAIN_MAX_STAGE];     ///< stages in order of evaluation
+} fuzzy_chain_cfg;
+
+/// Input of the chain scaled once per call
+typedef struct
+{
+  uint16_t        src;                  ///< input of the chain
+  int8_t          (*scale) (int16_t x); ///< scaling, NULL - lim_s8
+  uint16_t        n_dst;                ///< stage inputs reading it
+  const uint16_t  *dst;                 ///< their positions in x [n_dst]
+} fuzzy_chain_scale;
+
+/// Link from the output of the stage: fused scaling table and its readers
+typedef struct
+{
+  const int8_t    *table;               ///< scale (out_scale (y)) [256]
+  uint16_t        n_dst;                ///< stage inputs reading it
+  const uint16_t  *dst;                 ///< their positions in x [n_dst]
+} fuzzy_chain_link;
+
+/// Stage time of the timed calls
+typedef struct
+{
+  uint64_t  sampled;      ///< timed calls
+  uint64_t  sum_ns;       ///< sum of the stage times
+  uint64_t  max_ns;       ///< slowest
+} fuzzy_chain_time;
+
+/// Evaluated stage
+typedef struct
+{
+  const fuzzy_model       *model;   ///< compiled model
+  const int8_t            *in;      ///< input vector in x [model->n_in]
+  uint8_t                 *ws;      ///< workspace
+  const fuzzy_chain_link  *link;    ///< links from the output [n_link]
+  uint16_t                n_link;   ///< links from the output
+} fuzzy_chain_node;
+
+/// Chain of controllers
+typedef struct
+{
+  uint16_t          n_in;       ///< inputs of the chain
+  uint16_t          n_stage;    ///< stages
+  uint16_t          n_scale;    ///< scaled inputs of the chain
+  uint16_t          n_x;        ///< inputs of all stages
+  bool              timing;     ///< calls are timed
+  uint64_t          mask;       ///< timed call: (calls & mask) == 0
+  uint64_t          calls;      ///< calls from init
+  const fuzzy_chain_scale *scale;   ///< scaled inputs [n_scale]
+  fuzzy_chain_node  *node;      ///< stages [n_stage]
+  int8_t            *x;         ///< input vectors of the stages one after another [n_x]
+  int8_t            *y;         ///< output of stage s [n_stage]
+  const int16_t     (*oval)[256];   ///< scaled output of stage s: oval[s][(uint8_t)y]
+  fuzzy_chain_time  *time;      ///< stage times [n_stage + 1], the last - whole chain
+  void              *mem;       ///< memory block
+} fuzzy_chain;
+
+/*******************************************************************************
+* масштабированный выход ступени s
+* \brief  Output of stage s of the last call after its output scaling
+*******************************************************************************/
+inline static int16_t fuzzy_chain_out (const fuzzy_chain *chain, uint16_t s)
+{
+  return chain->oval[s][(uint8_t)chain->y[s]];
+}
+
+void         fuzzy_chain_default (fuzzy_chain_cfg *cfg);
+fuzzy_status fuzzy_chain_init (const fuzzy_chain_cfg *cfg, fuzzy_chain *chain);
+int16_t      process_fuzzy_chain (fuzzy_chain *chain, const int16_t *in_array);
+void         fuzzy_chain_print_time (const fuzzy_chain *chain, FILE *f);
+void         fuzzy_chain_reset_time (fuzzy_chain *chain);
+void         fuzzy_chain_free (fuzzy_chain *chain);
+
+#endif  // _FUZZY_CHAIN_H_
@@ -0,0 +1,428 @@
+/*******************************************************************************
+* \file     fuzzy_codegen.c
+* \author   Ilya Petrukhin (ilya.petrukhin@gmail.com)
+* \brief    This file provides code for generation of straight-line C code
+*           of the compiled fuzzy model
+* \version  2.1
+* \date     2026-10-17
+*******************************************************************************/
+#include  <stdio.h>
+#include  <stdint.h>
+#include  <stdbool.h>
+#include  <stdlib.h>
+#include  <string.h>
+#include  "fuzzy_logic.h"
+#include  "fuzzy_model.h"
+#include  "fuzzy_codegen.h"
+
+/// function names of shapes for direct calls
+static const char *const shape_name[FS_CUSTOM] =
+{
+  [FS_NONE]       = NULL,
+  [FS_CUBE]       = "cube",
+  [FS_TRIANGLE]   = "triangle",
+  [FS_A_TRIANGLE] = "a_triangle",
+  [FS_SQUARE]     = "square",
+  [FS_TRAPECIA]   = "trapecia",
+  [FS_LOW]        = "low",
+  [FS_HIGH]       = "high",
+};
+
+/// one branch of the function: condition (NULL - otherwise) and value
+typedef struct
+{
+  char  cond[64];
+  char  expr[96];
+} gen_case;
+
+
+/*******************************************************************************
+* фронт v * 255 / d для v = 0..v_max умножением и сдвигом
+* \brief  Write ramp value v * 255 / d, v = 0..v_max, as multiply and shift
+*         when some constant is exact for every v, else as division
+* \param[out] expr    C expression
+* \param[in]  v       C expression of v >= 0
+* \param[in]  d       constant slope > 0
+* \param[in]  v_max   max v
+*******************************************************************************/
+static void gen_ramp (char *expr, size_t size, const char *v, int32_t d, int32_t v_max)
+{
+  uint64_t k;
+  int32_t i;
+  uint32_t s;
+  bool exact;
+
+  for (s = 0; s < 32; s++)
+  {
+    k = (((uint64_t)255 << s) + (uint64_t)d - 1) / (uint64_t)d;    // ceil (255 * 2^s / d)
+    if ((uint64_t)v_max * k > 0xFFFFFFFFu)
+    {
+      break;
+    }
+    exact = true;
+    for (i = 0; (i <= v_max) && exact; i++)
+    {
+      exact = ((((uint64_t)i * k) >> s) == (uint64_t)(i * 255 / d));
+    }
+    if (exact)
+    {
+      if (s == 0)
+      {
+        snprintf (expr, size, "(uint8_t)((uint32_t)(%s) * %uu)", v, (unsigned)k);
+      }
+      else
+      {
+        snprintf (expr, size, "(uint8_t)(((uint32_t)(%s) * %uu) >> %u)", v, (unsigned)k, (unsigned)s);
+      }
+      return;
+    }
+  }
+  snprintf (expr, size, "(uint8_t)(((%s) * 255) / %d)", v, (int)d);
+}
+
+/*******************************************************************************
+* выражение x - c без двойных знаков
+*******************************************************************************/
+static void gen_sub (char *s, size_t size, const char *x, int32_t c)
+{
+  if (c == 0)
+  {
+    snprintf (s, size, "%s", x);
+  }
+  else if (c < 0)
+  {
+    snprintf (s, size, "%s + %d", x, (int)-c);
+  }
+  else
+  {
+    snprintf (s, size, "%s - %d", x, (int)c);
+  }
+}
+
+/*******************************************************************************
+* код функции фуззификации по нормальной форме
+*******************************************************************************/
+static void gen_mf (FILE *f, const fuzzy_mf_desc *mf, uint16_t n)
+{
+  fuzzy_norm norm;
+  gen_case c[4];
+  char x[8], v[32];
+  unsigned n_case = 0, k;
+  int32_t lo, hi;
+
+  fuzzy_normalize (mf, &norm);
+  snprintf (x, sizeof (x), "x%u", (unsigned)mf->xn);
+  fprintf (f, "  /// %u: %s (%d, %d, %d)\n", (unsigned)n,
+           (mf->shape == FS_NONE) ? "const" : shape_name[mf->shape], mf->a, mf->b, mf->c);
+
+  switch (norm.kind)
+  {
+  case FN_CONST:
+    fprintf (f, "  m%u = %u;\n", (unsigned)n, (unsigned)norm.y);
+    return;
+
+  case FN_CUBE:
+    gen_sub (v, sizeof (v), x, norm.m);
+    fprintf (f, "  dx = (%s < %d) ? (%d - %s) : (%s);\n", x, norm.m, norm.m, x, v);
+    fprintf (f, "  m%u = (uint8_t)(%ld / (dx * dx * dx + %ld));\n", (unsigned)n,
+             (long)norm.d3 * 255, (long)norm.d3);
+    return;
+
+  case FN_FUNC:
+    fprintf (f, "  m%u = %s (%s, %d, %d, %d);\n", (unsigned)n, shape_name[mf->shape],
+             x, mf->a, mf->b, mf->c);
+    return;
+
+  case FN_TRAP:
+  default:
+    break;
+  }
+
+  /// ветви трапеции, невозможные на диапазоне int8_t, опускаются
+  if ((norm.lo > -128) || (norm.hi < 127))
+  {
+    if ((norm.lo > -128) && (norm.hi < 127))
+    {
+      snprintf (c[n_case].cond, sizeof (c[0].cond), "(%s < %d) || (%s > %d)", x, norm.lo, x, norm.hi);
+    }
+    else if (norm.lo > -128)
+    {
+      snprintf (c[n_case].cond, sizeof (c[0].cond), "%s < %d", x, norm.lo);
+    }
+    else
+    {
+      snprintf (c[n_case].cond, sizeof (c[0].cond), "%s > %d", x, norm.hi);
+    }
+    snprintf (c[n_case++].expr, sizeof (c[0].expr), "0");
+  }
+  lo = (norm.lo > -128) ? norm.lo : -128;
+  if ((norm.t0 > lo) && (norm.t0 > -128))
+  {
+    snprintf (c[n_case].cond, sizeof (c[0].cond), "%s < %d", x, norm.t0);
+    gen_sub (v, sizeof (v), x, norm.lo);
+    gen_ramp (c[n_case++].expr, sizeof (c[0].expr), v, norm.t0 - norm.lo, norm.t0 - 1 - norm.lo);
+  }
+  hi = (norm.hi < 127) ? norm.hi : 127;
+  if ((norm.t1 >= -128) && (norm.t1 >= norm.t0))
+  {
+    snprintf (c[n_case].cond, sizeof (c[0].cond), "%s <= %d", x, norm.t1);
+    snprintf (c[n_case++].expr, sizeof (c[0].expr), "255");
+  }
+  if ((norm.t1 < hi) && (norm.hi > norm.t1))
+  {
+    c[n_case].cond[0] = 0;
+    snprintf (v, sizeof (v), "%d - %s", norm.hi, x);
+    gen_ramp (c[n_case++].expr, sizeof (c[0].expr), v, norm.hi - norm.t1, norm.hi - norm.t1 - 1);
+  }
+
+  if (n_case == 1)
+  {
+    fprintf (f, "  m%u = %s;\n", (unsigned)n, c[0].expr);
+    return;
+  }
+  for (k = 0; k < n_case; k++)
+  {
+    if (k == 0)
+    {
+      fprintf (f, "  if (%s)\n", c[k].cond);
+    }
+    else if (k + 1 < n_case)
+    {
+      fprintf (f, "  else if (%s)\n", c[k].cond);
+    }
+    else
+    {
+      fprintf (f, "  else\n");
+    }
+    fprintf (f, "  {\n    m%u = %s;\n  }\n", (unsigned)n, c[k].expr);
+  }
+}
+
+/*******************************************************************************
+* имя активации: функция m<n> или правило r<n>
+*******************************************************************************/
+static const char *act_name (const fuzzy_model *model, uint16_t ix, char *s, size_t size)
+{
+  if (ix < model->n_mf)
+  {
+    snprintf (s, size, "m%u", (unsigned)ix);
+  }
+  else
+  {
+    snprintf (s, size, "r%u", (unsigned)(ix - model->n_mf));
+  }
+  return s;
+}
+
+/*******************************************************************************
+* Генерация кода модели
+* \brief  Write C function "int8_t name (const int8_t *in_array)" equal to
+*         process_fuzzy_logic_compiled of the model
+* \param[in]  model   compiled model
+* \param[in]  name    function name
+* \param[in]  path    output file
+* \return             FUZZY_OK, FUZZY_ERR_PARAM for FS_CUSTOM functions,
+*                     FUZZY_ERR_STRUCT for first-order consequents, FUZZY_ERR_FILE
+*******************************************************************************/
+fuzzy_status fuzzy_codegen (const fuzzy_model *model, const char *name, const char *path)
+{
+  const fuzzy_rule_ix *r;
+  uint8_t *used, *live;
+  char a[16], b[16];
+  bool fwd, cube = false, any_fin = false, changed;
+  fuzzy_norm norm;
+  uint16_t i, k, n_x = 0;
+  FILE *f;
+
+  if ((model == NULL) || (name == NULL) || (path == NULL) || (model->mf == NULL))
+  {
+    return FUZZY_ERR_PARAM;
+  }
+  if (model->ts != NULL)
+  {
+    return FUZZY_ERR_STRUCT;              // constant outputs only
+  }
+  used = calloc (model->n_mf + model->n_rule, 1);
+  if (used == NULL)
+  {
+    return FUZZY_ERR_MEMORY;
+  }
+  live = used + model->n_mf;
+  fwd = (model->flags & FUZZY_MODEL_FWD) != 0;
+
+  /// живые правила: конечные и читаемые живыми; used и live - один массив
+  /// по индексу активации, для FUZZY_MODEL_FWD проходы до неподвижной точки
+  for (i = 0; i < model->n_rule; i++)
+  {
+    live[i] = model->rule[i].fin;
+    any_fin |= (model->rule[i].fin != 0);
+  }
+  do
+  {
+    changed = false;
+    for (i = model->n_rule; i-- > 0; )
+    {
+      r = &model->rule[i];
+      if (!live[i])
+      {
+        continue;
+      }
+      if ((r->op != F_B) && (r->op != F_FALSE) && !used[r->a])
+      {
+        used[r->a] = 1;
+        changed = true;
+      }
+      if (((r->op == F_AND) || (r->op == F_OR) || (r->op == F_IMP) || (r->op == F_B)) && !used[r->b])
+      {
+        used[r->b] = 1;
+        changed = true;
+      }
+    }
+  } while (fwd && changed);
+  for (i = 0; i < model->n_mf; i++)
+  {
+    if (used[i] && (model->mf[i].shape == FS_CUSTOM))
+    {
+      free (used);
+      return FUZZY_ERR_PARAM;
+    }
+    if (used[i] && (model->mf[i].shape == FS_CUBE))
+    {
+      cube = true;
+    }
+  }
+  f = fopen (path, "w");
+  if (f == NULL)
+  {
+    free (used);
+    return FUZZY_ERR_FILE;
+  }
+
+  fprintf (f, "/*******************************************************************************\n"
+              "* \\file     %s\n"
+              "* \\brief    Fuzzy controller %s: %u functions, %u rules\n"
+              "*           Generated by fuzzy_codegen, do not edit\n"
+              "*******************************************************************************/\n"
+              "#include  <stdint.h>\n"
+              "#include  <stdbool.h>\n"
+              "#include  \"fuzzy_logic.h\"\n\n\n",
+           strrchr (path, '/') ? strrchr (path, '/') + 1 : path, name,
+           (unsigned)model->n_mf, (unsigned)model->n_rule);
+  fprintf (f, "int8_t %s (const int8_t *in_array)\n{\n", name);
+
+  /// переменные: входы, функции, правила, суммы
+  for (i = 0; i < model->n_in; i++)
+  {
+    for (k = 0; k < model->n_mf; k++)
+    {
+      fuzzy_normalize (&model->mf[k], &norm);
+      if (used[k] && (model->mf[k].xn == i) && (norm.kind != FN_CONST))
+      {
+        break;
+      }
+    }
+    if (k < model->n_mf)
+    {
+      n_x++;
+      fprintf (f, "  int32_t x%u = in_array[%u];\n", (unsigned)i, (unsigned)i);
+    }
+  }
+  if (n_x == 0)
+  {
+    fprintf (f, "  (void)in_array;\n");
+  }
+  if (cube)
+  {
+    fprintf (f, "  int32_t dx;\n");
+  }
+  for (i = 0; i < model->n_mf; i++)
+  {
+    if (used[i])
+    {
+      fprintf (f, "  uint8_t m%u;\n", (unsigned)i);
+    }
+  }
+  for (i = 0; i < model->n_rule; i++)
+  {
+    if (!live[i])
+    {
+      continue;
+    }
+    if (fwd)
+    {
+      fprintf (f, "  static uint8_t r%u = %u;\n", (unsigned)i, (unsigned)model->act0[model->n_mf + i]);
+    }
+    else
+    {
+      fprintf (f, "  uint8_t r%u;\n", (unsigned)i);
+    }
+  }
+  fprintf (f, "  int16_t summ_alpha_c = 0;\n  int16_t summ_alpha = 0;\n\n");
+
+  /// функции фуззификации
+  for (i = 0; i < model->n_mf; i++)
+  {
+    if (used[i])
+    {
+      gen_mf (f, &model->mf[i], i);
+    }
+  }
+  fprintf (f, "\n");
+
+  /// правила с операторами, выбранными при генерации
+  for (i = 0, r = model->rule; i < model->n_rule; i++, r++)
+  {
+    if (!live[i])
+    {
+      continue;
+    }
+    act_name (model, r->a, a, sizeof (a));
+    act_name (model, r->b, b, sizeof (b));
+    switch ((strcmp (a, b) == 0) && ((r->op == F_AND) || (r->op == F_OR)) ? F_A : r->op)
+    {
+    case F_AND:
+      fprintf (f, "  r%u = (%s < %s) ? %s : %s;\n", (unsigned)i, a, b, a, b);
+      break;
+    case F_OR:
+      fprintf (f, "  r%u = (%s > %s) ? %s : %s;\n", (unsigned)i, a, b, a, b);
+      break;
+    case F_NOT:
+      fprintf (f, "  r%u = (uint8_t)(255 - %s);\n", (unsigned)i, a);
+      break;
+    case F_IMP:
+      fprintf (f, "  r%u = fuzzy_operator (F_IMP, %s, %s);\n", (unsigned)i, a, b);
+      break;
+    case F_A:
+      fprintf (f, "  r%u = %s;\n", (unsigned)i, a);
+      break;
+    case F_B:
+      fprintf (f, "  r%u = %s;\n", (unsigned)i, b);
+      break;
+    case F_FALSE:
+    default:
+      fprintf (f, "  r%u = 0;\n", (unsigned)i);
+      break;
+    }
+    if (r->fin)
+    {
+      if (r->out != 0)
+      {
+        fprintf (f, "  summ_alpha_c += r%u * (%d);\n", (unsigned)i, r->out);
+      }
+      fprintf (f, "  summ_alpha += r%u;\n", (unsigned)i);
+    }
+  }
+
+  /// приведение к четкости
+  if (any_fin)
+  {
+    fprintf (f, "\n  if (summ_alpha == 0)\n  {\n    return 0;\n  }\n"
+                "  return lim_s8 ((int16_t)(summ_alpha_c / summ_alpha));\n}\n");
+  }
+  else
+  {
+    fprintf (f, "\n  (void)summ_alpha_c;\n  (void)summ_alpha;\n  return 0;\n}\n");
+  }
+  free (used);
+  return (fclose (f) == 0) ? FUZZY_OK : FUZZY_ERR_FILE;
+}
@@ -0,0 +1,43 @@
+/*******************************************************************************
+* \file     fuzzy_codegen.h
+* \author   Ilya Petrukhin (ilya.petrukhin@gmail.com)
+* \brief    Generator of straight-line C code of the compiled fuzzy model
+* \version  2.1
+* \date     2026-10-17
+*******************************************************************************/
+
+#ifndef _FUZZY_CODEGEN_H_
+#define _FUZZY_CODEGEN_H_
+
+#include  <stdint.h>
+#include  <stdbool.h>
+#include  "fuzzy_logic.h"
+#include  "fuzzy_model.h"
+
+/*******************************************************************************
+* Rules to using code generator
+*******************************************************************************/
+// Compile the model and write one C function for it:
+//  fuzzy_compile (&fuzzy, &model);
+//  fuzzy_codegen (&model, "line_controller_gen", "src/line_controller_gen.c");
+// then build the file with the project and call
+//  int8_t temp = line_controller_gen (in);
+// (tools/fuzzy_gen.c does it for the line controller).
+//
+// Generated code:
+// - functions by their normal form (fuzzy_normalize) with constant
+//   parameters; ramp division by constant slope is replaced by multiply
+//   and shift, checked at generation on every input of the ramp;
+//   functions with irregular parameters are direct calls of the shape;
+// - rules whose result is neither final nor read by other rules and
+//   functions not used by the rest are not evaluated;
+// - rule operators resolved at generation, no switch, no function pointers;
+// - the same int16_t sums as process_fuzzy_logic, so the result is equal.
+// Models with FS_CUSTOM functions are not supported (FUZZY_ERR_PARAM).
+// FUZZY_MODEL_FWD models keep rule results in static variables, the
+// generated function is not reentrant then.
+// ***************** end of the brief *****************************************
+
+fuzzy_status fuzzy_codegen (const fuzzy_model *model, const char *name, const char *path);
+
+#endif  // _FUZZY_CODEGEN_H_
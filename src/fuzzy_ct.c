@@ -0,0 +1,268 @@
+/*******************************************************************************
+* \file     fuzzy_ct.c
+* \author   Ilya Petrukhin (ilya.petrukhin@gmail.com)
+* \brief    This file provides code for the constant-time evaluation of the
+*           compiled model: tables, masks and fixed-step division instead of
+*           input-dependent branches
+* \version  2.1
+* \date     2026-10-17
+*******************************************************************************/
+#include  <stdint.h>
+#include  <stdbool.h>
+#include  <stdlib.h>
+#include  <string.h>
+#include  "fuzzy_logic.h"
+#include  "fuzzy_model.h"
+#include  "fuzzy_ct.h"
+
+#define ALIGN_UP(x, a)  (((x) + ((a) - 1)) & ~((size_t)(a) - 1))
+
+/// маска: все единицы при c != 0
+#define CT_MASK(c)      ct_mask ((c) != 0)
+
+/// значение скрыто от оптимизатора: маски не превращаются обратно в ветвления
+#if defined (__GNUC__)
+#define CT_BARRIER(x)   __asm__ ("" : "+r" (x))
+#else
+#define CT_BARRIER(x)   ((void)0)
+#endif
+
+
+/*******************************************************************************
+* маска условия: 0 или все единицы
+*******************************************************************************/
+static inline uint32_t ct_mask (uint32_t c)
+{
+  uint32_t m = -c;
+
+  CT_BARRIER (m);
+  return m;
+}
+
+/*******************************************************************************
+* min / max / ограничения масками
+*******************************************************************************/
+static inline int32_t ct_min (int32_t a, int32_t b)
+{
+  return b ^ ((a ^ b) & (int32_t)CT_MASK (a < b));
+}
+
+static inline int32_t ct_max (int32_t a, int32_t b)
+{
+  return a ^ ((a ^ b) & (int32_t)CT_MASK (a < b));
+}
+
+/*******************************************************************************
+* деление с отсечением к нулю за 16 шагов, |n| <= 32768, 0 < |d| <= 32768
+* \brief  n / d as C division of int16 operands, the same steps for any operands
+*******************************************************************************/
+static inline int32_t ct_div (int32_t n, int32_t d)
+{
+  uint32_t sn = CT_MASK (n < 0), sd = CT_MASK (d < 0), s = sn ^ sd;
+  uint32_t un = ((uint32_t)n ^ sn) - sn;
+  uint32_t ud = ((uint32_t)d ^ sd) - sd;
+  uint32_t q = 0, r = 0, m;
+  int i;
+
+  for (i = 16; i-- > 0; )
+  {
+    r = (r << 1) | ((un >> i) & 1u);
+    m = CT_MASK (r >= ud);
+    r -= ud & m;
+    q |= (m & 1u) << i;
+  }
+  return (int32_t)((q ^ s) - s);
+}
+
+/*******************************************************************************
+* результат правила: все операторы, выбор масками правила
+* \brief  fuzzy_operator without branches
+*******************************************************************************/
+static inline uint8_t ct_operator (const fuzzy_ct *ct, const fuzzy_ct_rule *r, bool imp,
+                                   uint32_t a, uint32_t b)
+{
+  uint32_t mn, alpha;
+  int32_t v;
+
+  mn = (uint32_t)ct_min ((int32_t)a, (int32_t)b);
+  alpha = (mn & r->m_and) | ((a ^ b ^ mn) & r->m_or) | ((255 - a) & r->m_not) |
+          (a & r->m_a) | (b & r->m_b);
+  if (imp)    // модель, не вход
+  {
+    /// F_IMP: (b * 255) / a в int16_t, затем lim_u8; a == 0 - 255
+    v = (int32_t)(((uint64_t)(b * 255u) * ct->recip[a]) >> 24);
+    v = ct_min (v, 255) & ~(int32_t)CT_MASK (v > INT16_MAX);
+    v |= (int32_t)(CT_MASK (a == 0) & 255u);
+    alpha |= (uint32_t)v & r->m_imp;
+  }
+  return (uint8_t)alpha;
+}
+
+/*******************************************************************************
+* следствие первого порядка без ветвлений
+* \brief  fuzzy_ts_eval with limits by masks
+*******************************************************************************/
+static inline int16_t ct_ts_eval (const fuzzy_ts *ts, const int8_t *in_array)
+{
+  int32_t s = (int32_t)ts->k0 * (1 << FUZZY_TS_SHIFT) + (1 << (FUZZY_TS_SHIFT - 1));
+  uint8_t i;
+
+  for (i = 0; i < ts->n; i++)
+  {
+    s += (int32_t)ts->k[i] * in_array[i];
+  }
+  s >>= FUZZY_TS_SHIFT;
+  s = ct_max (ct_min (s, INT16_MAX), INT16_MIN);
+  return (int16_t)ct_max (ct_min (s, 127), -127);
+}
+
+/*******************************************************************************
+* Подготовка вычисления с постоянным временем
+* \brief  Build function tables and copy the rules of the compiled model
+* \param[in]  model   compiled model
+* \param[out] ct      state, free with fuzzy_ct_free
+* \return             FUZZY_OK, FUZZY_ERR_PARAM, FUZZY_ERR_MEMORY
+*******************************************************************************/
+fuzzy_status fuzzy_ct_init (const fuzzy_model *model, fuzzy_ct *ct)
+{
+  fuzzy_ct_rule *rule;
+  uint8_t (*lut)[256];
+  uint32_t *recip;
+  size_t n_mf, n_rule, off_lut, off_rule, off_ts, off_recip, off_xn, off_ws, size;
+  uint8_t *mem, *xn, op;
+  unsigned i, x;
+
+  if ((model == NULL) || (ct == NULL) || (model->mf == NULL))
+  {
+    return FUZZY_ERR_PARAM;
+  }
+  memset (ct, 0, sizeof (fuzzy_ct));
+  n_mf = model->n_mf;
+  n_rule = model->n_rule;
+
+  /// один блок памяти: таблицы, правила, следствия, обратные, активации
+  off_lut   = 0;
+  off_rule  = ALIGN_UP (off_lut + n_mf * 256, 8);
+  off_ts    = ALIGN_UP (off_rule + n_rule * sizeof (fuzzy_ct_rule), 8);
+  off_recip = ALIGN_UP (off_ts + (model->ts ? n_rule * sizeof (fuzzy_ts) : 0), 8);
+  off_xn    = off_recip + 256 * sizeof (uint32_t);
+  off_ws    = off_xn + n_mf;
+  size      = off_ws + fuzzy_workspace_size (model);
+
+  mem = malloc (size ? size : 1);
+  if (mem == NULL)
+  {
+    return FUZZY_ERR_MEMORY;
+  }
+  lut   = (uint8_t (*)[256])(mem + off_lut);
+  rule  = (fuzzy_ct_rule *)(mem + off_rule);
+  recip = (uint32_t *)(mem + off_recip);
+  xn    = mem + off_xn;
+
+  for (i = 0; i < n_mf; i++)
+  {
+    xn[i] = model->mf[i].xn;
+    for (x = 0; x < 256; x++)
+    {
+      lut[i][x] = fuzzy_mf_eval (model, (uint16_t)i, (int8_t)x);
+    }
+  }
+  /// оператор - маски выбора, F_FALSE и неизвестные - все маски нулевые
+  memset (rule, 0, n_rule * sizeof (fuzzy_ct_rule));
+  for (i = 0; i < n_rule; i++)
+  {
+    op = model->rule[i].op;
+    rule[i].a     = model->rule[i].a;
+    rule[i].b     = model->rule[i].b;
+    rule[i].m_and = (op == F_AND) ? 0xFF : 0;
+    rule[i].m_or  = (op == F_OR) ? 0xFF : 0;
+    rule[i].m_not = (op == F_NOT) ? 0xFF : 0;
+    rule[i].m_imp = (op == F_IMP) ? 0xFF : 0;
+    rule[i].m_a   = (op == F_A) ? 0xFF : 0;
+    rule[i].m_b   = (op == F_B) ? 0xFF : 0;
+    rule[i].m_fin = model->rule[i].fin ? 0xFF : 0;
+    rule[i].out   = model->rule[i].out;
+    ct->imp |= (op == F_IMP);
+  }
+  if (model->ts)
+  {
+    memcpy (mem + off_ts, model->ts, n_rule * sizeof (fuzzy_ts));
+    ct->ts = (const fuzzy_ts *)(mem + off_ts);
+  }
+  /// (n * recip[a]) >> 24 == n / a для n <= 255 * 255
+  recip[0] = 0;
+  for (i = 1; i < 256; i++)
+  {
+    recip[i] = (1u << 24) / i + 1u;
+  }
+  memcpy (mem + off_ws, model->act0, fuzzy_workspace_size (model));
+
+  ct->n_in   = model->n_in;
+  ct->n_mf   = (uint16_t)n_mf;
+  ct->n_rule = (uint16_t)n_rule;
+  ct->lut    = (const uint8_t (*)[256])lut;
+  ct->xn     = xn;
+  ct->rule   = rule;
+  ct->recip  = recip;
+  ct->ws     = mem + off_ws;
+  ct->mem    = mem;
+  return FUZZY_OK;
+}
+
+/*******************************************************************************
+* Реализация нечеткого регулятора с постоянным временем
+* \brief Fuzzy logic controller without input-dependent branches,
+*        bit-identical to process_fuzzy_logic_compiled
+* \param[in] ct        constant-time state
+* \param[in] in_array  input values array [ct->n_in]
+* \return Output control value
+*******************************************************************************/
+int8_t process_fuzzy_logic_ct (fuzzy_ct *ct, const int8_t *in_array)
+{
+  const fuzzy_ct_rule *r = ct->rule;
+  const fuzzy_ts *ts = ct->ts;
+  uint8_t *ws = ct->ws;
+  uint8_t *y = ws + ct->n_mf;
+  uint16_t n_mf = ct->n_mf, n_rule = ct->n_rule;
+  int16_t summ_alpha_c = 0;
+  int16_t summ_alpha = 0;
+  int32_t alpha, out, fin, nz, ret;
+  bool imp = ct->imp;
+  uint16_t i;
+
+  /// функции фуззификации: одна выборка из таблицы на функцию
+  for (i = 0; i < n_mf; i++)
+  {
+    ws[i] = ct->lut[i][(uint8_t)in_array[ct->xn[i]]];
+  }
+
+  /// все правила, конечные - по маске; imp / ts - вид модели, не вход
+  for (i = 0; i < n_rule; i++, r++)
+  {
+    alpha = ct_operator (ct, r, imp, ws[r->a], ws[r->b]);
+    y[i] = (uint8_t)alpha;
+    out = ts ? ct_ts_eval (&ts[i], in_array) : r->out;
+    fin = (int8_t)r->m_fin;
+    summ_alpha_c += (int16_t)((alpha * out) & fin);
+    summ_alpha += (int16_t)(alpha & fin);
+  }
+
+  /// центр тяжести: деление всегда, делитель 0 заменён на 1, результат 0
+  nz = (int32_t)CT_MASK (summ_alpha != 0);
+  ret = ct_div (summ_alpha_c, summ_alpha | (~nz & 1)) & nz;
+  return (int8_t)ct_max (ct_min ((int16_t)ret, 127), -127);
+}
+
+/*******************************************************************************
+* Освобождение состояния
+* \brief  Free constant-time state
+* \param[in]  ct  state
+*******************************************************************************/
+void fuzzy_ct_free (fuzzy_ct *ct)
+{
+  if (ct)
+  {
+    free (ct->mem);
+    memset (ct, 0, sizeof (fuzzy_ct));
+  }
+}
@@ -0,0 +1,85 @@
+/*******************************************************************************
+* \file     fuzzy_ct.h
+* \author   Ilya Petrukhin (ilya.petrukhin@gmail.com)
+* \brief    Constant-time evaluation of the compiled fuzzy model: the same
+*           instructions for any input, for a hard per-tick time budget
+* \version  2.1
+* \date     2026-10-17
+*******************************************************************************/
+
+#ifndef _FUZZY_CT_H_
+#define _FUZZY_CT_H_
+
+#include  <stdint.h>
+#include  <stdbool.h>
+#include  "fuzzy_logic.h"
+#include  "fuzzy_model.h"
+
+/*******************************************************************************
+* Rules to using constant-time evaluation
+*******************************************************************************/
+//  fuzzy_ct ct;
+//  if (fuzzy_ct_init (&model, &ct) == FUZZY_OK)
+//  {
+//    int8_t temp = process_fuzzy_logic_ct (&ct, in);
+//  }
+//  fuzzy_ct_free (&ct);
+//
+// process_fuzzy_logic_ct has no branch depending on the input:
+// - every fuzzy function is a 256-byte table built by fuzzy_ct_init
+//   (n_mf * 256 bytes), one load per function;
+// - every rule computes all operators and selects the result by masks of
+//   the rule, min / max / limits by masks, F_IMP b * 255 / a by Q24
+//   reciprocal table (only in models with F_IMP rules);
+// - every rule is accumulated, final flag as mask; first-order consequents
+//   are evaluated for every rule;
+// - centroid division is 16 fixed steps of shift and subtract, divisor 0
+//   selected by mask, no hardware divide (data-dependent on many CPUs and
+//   a library call on MCUs without divider).
+// Loops and the remaining branches depend only on the model (sizes, F_IMP
+// rules, first-order consequents), so the time is the same for any input
+// up to cache effects; check the listing of the target compiler.
+// Result is bit-identical to process_fuzzy_logic_compiled, models with
+// rules reading later rules (FUZZY_MODEL_FWD) keep the state in ct.ws
+// as the compiled model does.
+// FS_CUSTOM functions have to depend only on x and parameters.
+// One state per caller (thread), the model is not needed after init.
+// Worst-case input search and report: fuzzy_wcet.h.
+// ***************** end of the brief *****************************************
+
+/// Rule of constant-time evaluation: operator as select masks
+typedef struct
+{
+  uint16_t  a;          ///< operand a activation index
+  uint16_t  b;          ///< operand b activation index
+  uint8_t   m_and;      ///< 0xFF - F_AND
+  uint8_t   m_or;       ///< 0xFF - F_OR
+  uint8_t   m_not;      ///< 0xFF - F_NOT
+  uint8_t   m_imp;      ///< 0xFF - F_IMP
+  uint8_t   m_a;        ///< 0xFF - F_A
+  uint8_t   m_b;        ///< 0xFF - F_B
+  uint8_t   m_fin;      ///< 0xFF - final rule
+  int8_t    out;        ///< output fuzzy value
+} fuzzy_ct_rule;
+
+/// Constant-time evaluation state
+typedef struct
+{
+  uint16_t              n_in;     ///< inputs
+  uint16_t              n_mf;     ///< fuzzy functions
+  uint16_t              n_rule;   ///< rules
+  bool                  imp;      ///< some rule is F_IMP
+  const uint8_t         (*lut)[256];  ///< activation of function i, value x: lut[i][(uint8_t)x]
+  const uint8_t         *xn;      ///< input of function [n_mf]
+  const fuzzy_ct_rule   *rule;    ///< rules [n_rule]
+  const fuzzy_ts        *ts;      ///< first-order consequents [n_rule], NULL - constant outputs
+  const uint32_t        *recip;   ///< 2^24 / a + 1, a = 1..255, [256]
+  uint8_t               *ws;      ///< activation vector [n_mf + n_rule]
+  void                  *mem;     ///< owned memory block
+} fuzzy_ct;
+
+fuzzy_status fuzzy_ct_init (const fuzzy_model *model, fuzzy_ct *ct);
+int8_t       process_fuzzy_logic_ct (fuzzy_ct *ct, const int8_t *in_array);
+void         fuzzy_ct_free (fuzzy_ct *ct);
+
+#endif  // _FUZZY_CT_H_
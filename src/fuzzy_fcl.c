@@ -0,0 +1,1065 @@
+/*******************************************************************************
+* \file     fuzzy_fcl.c
+* \author   Ilya Petrukhin (ilya.petrukhin@gmail.com)
+* \brief    This file provides code for loading of fuzzy controllers
+*           from FCL (IEC 61131-7) text
+* \version  2.1
+* \date     2026-10-17
+*******************************************************************************/
+#include  <stdio.h>
+#include  <stdint.h>
+#include  <stdbool.h>
+#include  <stdlib.h>
+#include  <string.h>
+#include  <ctype.h>
+#include  "fuzzy_logic.h"
+#include  "fuzzy_model.h"
+#include  "fuzzy_fcl.h"
+
+#define ALIGN_UP(x, a)  (((x) + ((a) - 1)) & ~((size_t)(a) - 1))
+
+#define FCL_MAX_IN      (256)           ///< inputs, fuzzy_funct.xn
+#define FCL_MAX_POINT   (8)             ///< points of the term
+#define FCL_RULE        (0x80000000u)   ///< operand is a rule result
+#define FCL_NO_OUT      (0xFFFFu)       ///< variable is an input
+
+/// Token
+typedef enum
+{
+  TK_END = 0,     ///< end of text
+  TK_ID,          ///< name or keyword
+  TK_NUM,         ///< number
+  TK_ASSIGN,      ///< :=
+  TK_COLON,       ///< :
+  TK_SEMI,        ///< ;
+  TK_LPAR,        ///< (
+  TK_RPAR,        ///< )
+  TK_COMMA,       ///< ,
+  TK_RANGE,       ///< ..
+  TK_BAD          ///< invalid symbol
+} fcl_tok;
+
+/// Variable
+typedef struct
+{
+  char      name[FUZZY_FCL_NAME];
+  uint16_t  n;        ///< input number
+  uint16_t  out;      ///< output number, FCL_NO_OUT - input
+} fcl_var;
+
+/// Term of the variable
+typedef struct
+{
+  char      name[FUZZY_FCL_NAME];
+  uint16_t  var;      ///< variable index
+  int32_t   val;      ///< input - function index, output - singleton value
+} fcl_term;
+
+/// Rule of the list before linking
+typedef struct
+{
+  uint32_t  a, b;     ///< operands: function index or FCL_RULE | rule index
+  uint8_t   op;       ///< fuzzy_op
+  bool      fin;      ///< final rule
+  int8_t    out;      ///< output 0 value
+  uint32_t  cq;       ///< first consequent
+  uint8_t   n_cq;     ///< consequents, 0 - out to the output 0
+} fcl_rule;
+
+/// Parser state
+typedef struct
+{
+  const char    *p;             ///< text position
+  unsigned      line;           ///< line of the position
+  fcl_tok       tok;            ///< current token
+  unsigned      tok_line;       ///< line of the current token
+  char          id[FUZZY_FCL_NAME];   ///< name of TK_ID
+  int32_t       num;            ///< integer part of TK_NUM
+  bool          exact;          ///< TK_NUM has no fraction
+  fcl_var       *var;
+  uint32_t      n_var, cap_var;
+  uint16_t      n_in, n_out;
+  fcl_term      *term;
+  uint32_t      n_term, cap_term;
+  fuzzy_funct   *ff;
+  uint32_t      n_ff, cap_ff;
+  fcl_rule      *rule;
+  uint32_t      n_rule, cap_rule;
+  fuzzy_conseq  *cq;
+  uint32_t      n_cq, cap_cq;
+  bool          no_mem;         ///< out of memory
+} fcl_parser;
+
+/// Shapes given by name
+static const struct
+{
+  const char  *name;
+  fuzzy       func;
+} fcl_shapes[] =
+{
+  { "cube",       cube       },
+  { "triangle",   triangle   },
+  { "a_triangle", a_triangle },
+  { "square",     square     },
+  { "trapecia",   trapecia   },
+  { "low",        low        },
+  { "high",       high       },
+};
+
+
+/*******************************************************************************
+* сравнение ключевого слова без учёта регистра
+*******************************************************************************/
+static bool kw_eq (const char *s, const char *kw)
+{
+  while (*s && (toupper ((unsigned char)*s) == *kw))
+  {
+    s++;
+    kw++;
+  }
+  return (*s == 0) && (*kw == 0);
+}
+
+/*******************************************************************************
+* следующая лексема, комментарии (* *) и // пропускаются
+*******************************************************************************/
+static void next (fcl_parser *ps)
+{
+  const char *p = ps->p;
+  uint32_t n;
+
+  for (;;)
+  {
+    while (isspace ((unsigned char)*p))
+    {
+      ps->line += (*p++ == '\n');
+    }
+    if ((p[0] == '(') && (p[1] == '*'))
+    {
+      for (p += 2; *p && !((p[0] == '*') && (p[1] == ')')); p++)
+      {
+        ps->line += (*p == '\n');
+      }
+      p += (*p) ? 2 : 0;
+    }
+    else if ((p[0] == '/') && (p[1] == '/'))
+    {
+      while (*p && (*p != '\n'))
+      {
+        p++;
+      }
+    }
+    else
+    {
+      break;
+    }
+  }
+
+  ps->tok_line = ps->line;
+  if (*p == 0)
+  {
+    ps->tok = TK_END;
+  }
+  else if (isalpha ((unsigned char)*p) || (*p == '_'))
+  {
+    for (n = 0; isalnum ((unsigned char)*p) || (*p == '_'); p++, n++)
+    {
+      if (n < FUZZY_FCL_NAME - 1)
+      {
+        ps->id[n] = *p;
+      }
+    }
+    ps->id[(n < FUZZY_FCL_NAME) ? n : 0] = 0;    // слишком длинное имя - пустое
+    ps->tok = (n < FUZZY_FCL_NAME) ? TK_ID : TK_BAD;
+  }
+  else if (isdigit ((unsigned char)*p) || ((*p == '-') && isdigit ((unsigned char)p[1])))
+  {
+    bool neg = (*p == '-');
+
+    p += neg;
+    ps->num = 0;
+    ps->exact = true;
+    ps->tok = TK_NUM;
+    for (; isdigit ((unsigned char)*p); p++)
+    {
+      if (ps->num > 99999)
+      {
+        ps->tok = TK_BAD;
+      }
+      else
+      {
+        ps->num = ps->num * 10 + (*p - '0');
+      }
+    }
+    if ((p[0] == '.') && isdigit ((unsigned char)p[1]))
+    {
+      for (p++; isdigit ((unsigned char)*p); p++)
+      {
+        ps->exact &= (*p == '0');
+      }
+    }
+    ps->num = neg ? -ps->num : ps->num;
+  }
+  else if ((p[0] == ':') && (p[1] == '='))
+  {
+    ps->tok = TK_ASSIGN;
+    p += 2;
+  }
+  else if ((p[0] == '.') && (p[1] == '.'))
+  {
+    ps->tok = TK_RANGE;
+    p += 2;
+  }
+  else
+  {
+    switch (*p++)
+    {
+    case ':': ps->tok = TK_COLON; break;
+    case ';': ps->tok = TK_SEMI;  break;
+    case '(': ps->tok = TK_LPAR;  break;
+    case ')': ps->tok = TK_RPAR;  break;
+    case ',': ps->tok = TK_COMMA; break;
+    default:  ps->tok = TK_BAD;   break;
+    }
+  }
+  ps->p = p;
+}
+
+/*******************************************************************************
+* ожидаемая лексема / ключевое слово, с переходом к следующей
+*******************************************************************************/
+static bool accept (fcl_parser *ps, fcl_tok tok)
+{
+  if (ps->tok != tok)
+  {
+    return false;
+  }
+  next (ps);
+  return true;
+}
+
+static bool accept_kw (fcl_parser *ps, const char *kw)
+{
+  if ((ps->tok != TK_ID) || !kw_eq (ps->id, kw))
+  {
+    return false;
+  }
+  next (ps);
+  return true;
+}
+
+/*******************************************************************************
+* целое число в диапазоне
+*******************************************************************************/
+static bool accept_int (fcl_parser *ps, int32_t min, int32_t max, int32_t *v)
+{
+  if ((ps->tok != TK_NUM) || !ps->exact || (ps->num < min) || (ps->num > max))
+  {
+    return false;
+  }
+  *v = ps->num;
+  next (ps);
+  return true;
+}
+
+/*******************************************************************************
+* "KEY : VALUE ;" или "KEY := VALUE ;" с одним допустимым значением
+*******************************************************************************/
+static bool accept_setting (fcl_parser *ps, fcl_tok tok, const char *v1, const char *v2)
+{
+  if (!accept (ps, tok) || (ps->tok != TK_ID) ||
+      !(kw_eq (ps->id, v1) || ((v2 != NULL) && kw_eq (ps->id, v2))))
+  {
+    return false;
+  }
+  next (ps);
+  return accept (ps, TK_SEMI);
+}
+
+/*******************************************************************************
+* добавление элемента в растущий массив
+*******************************************************************************/
+static void *grow (fcl_parser *ps, void **arr, uint32_t *n, uint32_t *cap, size_t size)
+{
+  void *p;
+
+  if (*n == *cap)
+  {
+    p = realloc (*arr, ((*cap) ? 2 * (size_t)*cap : 16) * size);
+    if (p == NULL)
+    {
+      ps->no_mem = true;
+      return NULL;
+    }
+    *arr = p;
+    *cap = (*cap) ? 2 * *cap : 16;
+  }
+  p = (uint8_t *)*arr + (size_t)(*n)++ * size;
+  memset (p, 0, size);
+  return p;
+}
+
+/*******************************************************************************
+* поиск переменной и терма по имени
+*******************************************************************************/
+static fcl_var *find_var (fcl_parser *ps, const char *name)
+{
+  uint32_t i;
+
+  for (i = 0; i < ps->n_var; i++)
+  {
+    if (strcmp (ps->var[i].name, name) == 0)
+    {
+      return &ps->var[i];
+    }
+  }
+  return NULL;
+}
+
+static fcl_term *find_term (fcl_parser *ps, uint32_t var, const char *name)
+{
+  uint32_t i;
+
+  for (i = 0; i < ps->n_term; i++)
+  {
+    if ((ps->term[i].var == var) && (strcmp (ps->term[i].name, name) == 0))
+    {
+      return &ps->term[i];
+    }
+  }
+  return NULL;
+}
+
+/*******************************************************************************
+* VAR_INPUT / VAR_OUTPUT: "name : type ;" до END_VAR
+*******************************************************************************/
+static bool parse_vars (fcl_parser *ps, bool out)
+{
+  fcl_var *v;
+
+  while (!accept_kw (ps, "END_VAR"))
+  {
+    if ((ps->tok != TK_ID) || find_var (ps, ps->id) ||
+        (out ? (ps->n_out >= FUZZY_MAX_OUT) : (ps->n_in >= FCL_MAX_IN)))
+    {
+      return false;
+    }
+    v = grow (ps, (void **)&ps->var, &ps->n_var, &ps->cap_var, sizeof (fcl_var));
+    if (v == NULL)
+    {
+      return false;
+    }
+    strcpy (v->name, ps->id);
+    v->n = out ? 0 : ps->n_in++;
+    v->out = out ? ps->n_out++ : FCL_NO_OUT;
+    next (ps);
+    if (!accept (ps, TK_COLON) || !accept (ps, TK_ID) || !accept (ps, TK_SEMI))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+/*******************************************************************************
+* "RANGE := (min .. max) ;" - проверяется и не используется
+*******************************************************************************/
+static bool parse_range (fcl_parser *ps)
+{
+  int32_t min, max;
+
+  return accept (ps, TK_ASSIGN) && accept (ps, TK_LPAR) &&
+         accept_int (ps, -128, 127, &min) && accept (ps, TK_RANGE) &&
+         accept_int (ps, min, 127, &max) && accept (ps, TK_RPAR) && accept (ps, TK_SEMI);
+}
+
+/*******************************************************************************
+* ломаная по точкам -> одна из семи функций
+* \param[in]  x, y    points, y 0 / 1, x not decreasing
+* \param[in]  n       number of points
+* \param[out] ff      function and parameters
+* \return             true - the shape is one of the functions
+*******************************************************************************/
+static bool points_shape (const int32_t *x, const int32_t *y, uint32_t n, fuzzy_funct *ff)
+{
+  int32_t c;
+
+  /// горизонтальные участки по краям заданы продолжением крайних точек
+  while ((n > 2) && (y[0] == y[1]))
+  {
+    x++;
+    y++;
+    n--;
+  }
+  while ((n > 2) && (y[n - 1] == y[n - 2]))
+  {
+    n--;
+  }
+
+  if ((n == 2) && (x[0] < x[1]) && (y[0] != y[1]))
+  {
+    ff->func = (y[0] != 0) ? low : high;
+    ff->a = (int8_t)x[0];
+    ff->b = (int8_t)x[1];
+    return true;
+  }
+  if ((n == 3) && (y[0] == 0) && (y[1] == 1) && (y[2] == 0) && (x[0] < x[1]) && (x[1] < x[2]) &&
+      (x[1] - x[0] <= 127) && (x[2] - x[1] <= 127))
+  {
+    ff->func = (x[1] - x[0] == x[2] - x[1]) ? triangle : a_triangle;
+    ff->a = (int8_t)x[1];
+    ff->b = (int8_t)(x[1] - x[0]);
+    ff->c = (int8_t)(x[2] - x[1]);
+    return true;
+  }
+  if ((n == 4) && (y[0] == 0) && (y[1] == 1) && (y[2] == 1) && (y[3] == 0) &&
+      (x[1] - x[0] == x[3] - x[2]) && (x[1] <= x[2]) && (((x[0] + x[3]) & 1) == 0) &&
+      (((x[2] - x[1]) & 1) == 0) && (x[3] - x[0] <= 254))
+  {
+    c = (x[0] + x[3]) / 2;
+    ff->func = (x[0] == x[1]) ? square : trapecia;
+    ff->a = (int8_t)c;
+    ff->b = (int8_t)((x[0] == x[1]) ? (x[3] - c) : (x[2] - c));
+    ff->c = (int8_t)((x[0] == x[1]) ? 0 : (x[3] - c));
+    return x[0] < x[3];
+  }
+  return false;
+}
+
+/*******************************************************************************
+* FUZZIFY name: термы - функции фуззификации входа
+*******************************************************************************/
+static bool parse_fuzzify (fcl_parser *ps)
+{
+  int32_t x[FCL_MAX_POINT], y[FCL_MAX_POINT], p[3] = {0, 0, 0};
+  fcl_var *v;
+  fcl_term *t;
+  fuzzy_funct *ff;
+  uint32_t n, k;
+
+  if ((ps->tok != TK_ID) || ((v = find_var (ps, ps->id)) == NULL) || (v->out != FCL_NO_OUT))
+  {
+    return false;
+  }
+  next (ps);
+  while (!accept_kw (ps, "END_FUZZIFY"))
+  {
+    if (accept_kw (ps, "RANGE"))
+    {
+      if (!parse_range (ps))
+      {
+        return false;
+      }
+      continue;
+    }
+    if (!accept_kw (ps, "TERM") || (ps->tok != TK_ID) ||
+        find_term (ps, (uint32_t)(v - ps->var), ps->id))
+    {
+      return false;
+    }
+    t = grow (ps, (void **)&ps->term, &ps->n_term, &ps->cap_term, sizeof (fcl_term));
+    ff = grow (ps, (void **)&ps->ff, &ps->n_ff, &ps->cap_ff, sizeof (fuzzy_funct));
+    if ((t == NULL) || (ff == NULL))
+    {
+      return false;
+    }
+    strcpy (t->name, ps->id);
+    t->var = (uint16_t)(v - ps->var);
+    t->val = (int32_t)(ps->n_ff - 1);
+    ff->xn = (uint8_t)v->n;
+    next (ps);
+    if (!accept (ps, TK_ASSIGN))
+    {
+      return false;
+    }
+
+    if (ps->tok == TK_ID)
+    {
+      /// функция по имени: shape (a, b, c)
+      for (k = 0; (k < sizeof (fcl_shapes) / sizeof (fcl_shapes[0])) &&
+                  (strcmp (ps->id, fcl_shapes[k].name) != 0); k++)
+      {
+      }
+      if (k == sizeof (fcl_shapes) / sizeof (fcl_shapes[0]))
+      {
+        return false;
+      }
+      ff->func = fcl_shapes[k].func;
+      next (ps);
+      if (!accept (ps, TK_LPAR))
+      {
+        return false;
+      }
+      n = 0;
+      do
+      {
+        if ((n == 3) || !accept_int (ps, -128, 127, &p[n++]))
+        {
+          return false;
+        }
+      } while (accept (ps, TK_COMMA));
+      ff->a = (int8_t)p[0];
+      ff->b = (int8_t)p[1];
+      ff->c = (int8_t)p[2];
+      if (!accept (ps, TK_RPAR))
+      {
+        return false;
+      }
+    }
+    else
+    {
+      /// ломаная (x, y) ...
+      for (n = 0; ps->tok == TK_LPAR; n++)
+      {
+        if ((n == FCL_MAX_POINT) || !accept (ps, TK_LPAR) || !accept_int (ps, -128, 127, &x[n]) ||
+            !accept (ps, TK_COMMA) || !accept_int (ps, 0, 1, &y[n]) || !accept (ps, TK_RPAR) ||
+            ((n > 0) && (x[n] < x[n - 1])))
+        {
+          return false;
+        }
+      }
+      if (!points_shape (x, y, n, ff))
+      {
+        return false;
+      }
+    }
+    if (!accept (ps, TK_SEMI))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+/*******************************************************************************
+* DEFUZZIFY name: термы - синглтоны выхода
+*******************************************************************************/
+static bool parse_defuzzify (fcl_parser *ps)
+{
+  fcl_var *v;
+  fcl_term *t;
+  int32_t val;
+  uint32_t var;
+
+  if ((ps->tok != TK_ID) || ((v = find_var (ps, ps->id)) == NULL) || (v->out == FCL_NO_OUT))
+  {
+    return false;
+  }
+  var = (uint32_t)(v - ps->var);
+  next (ps);
+  while (!accept_kw (ps, "END_DEFUZZIFY"))
+  {
+    if (accept_kw (ps, "TERM"))
+    {
+      if ((ps->tok != TK_ID) || find_term (ps, var, ps->id))
+      {
+        return false;
+      }
+      t = grow (ps, (void **)&ps->term, &ps->n_term, &ps->cap_term, sizeof (fcl_term));
+      if (t == NULL)
+      {
+        return false;
+      }
+      strcpy (t->name, ps->id);
+      t->var = (uint16_t)var;
+      next (ps);
+      if (!accept (ps, TK_ASSIGN) || !accept_int (ps, -127, 127, &t->val) || !accept (ps, TK_SEMI))
+      {
+        return false;
+      }
+    }
+    else if (accept_kw (ps, "METHOD"))
+    {
+      if (!accept_setting (ps, TK_COLON, "COGS", NULL))
+      {
+        return false;
+      }
+    }
+    else if (accept_kw (ps, "ACCU"))
+    {
+      if (!accept_setting (ps, TK_COLON, "SUM", NULL))
+      {
+        return false;
+      }
+    }
+    else if (accept_kw (ps, "DEFAULT"))
+    {
+      if (!accept (ps, TK_ASSIGN) || !accept_int (ps, 0, 0, &val) || !accept (ps, TK_SEMI))
+      {
+        return false;
+      }
+    }
+    else if (!accept_kw (ps, "RANGE") || !parse_range (ps))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+/*******************************************************************************
+* новое правило списка
+*******************************************************************************/
+static bool add_rule (fcl_parser *ps, uint32_t a, fuzzy_op op, uint32_t b, uint32_t *ret)
+{
+  fcl_rule *r = grow (ps, (void **)&ps->rule, &ps->n_rule, &ps->cap_rule, sizeof (fcl_rule));
+
+  if (r == NULL)
+  {
+    return false;
+  }
+  r->a = a;
+  r->op = (uint8_t)op;
+  r->b = b;
+  *ret = FCL_RULE | (ps->n_rule - 1);
+  return true;
+}
+
+static bool parse_or (fcl_parser *ps, uint32_t *ret);
+
+/*******************************************************************************
+* NOT x | ( условие ) | var IS [NOT] term
+*******************************************************************************/
+static bool parse_factor (fcl_parser *ps, uint32_t *ret)
+{
+  fcl_var *v;
+  fcl_term *t;
+  bool neg;
+
+  if (accept_kw (ps, "NOT"))
+  {
+    return parse_factor (ps, ret) && add_rule (ps, *ret, F_NOT, *ret, ret);
+  }
+  if (accept (ps, TK_LPAR))
+  {
+    return parse_or (ps, ret) && accept (ps, TK_RPAR);
+  }
+  if ((ps->tok != TK_ID) || ((v = find_var (ps, ps->id)) == NULL) || (v->out != FCL_NO_OUT))
+  {
+    return false;
+  }
+  next (ps);
+  if (!accept_kw (ps, "IS"))
+  {
+    return false;
+  }
+  neg = accept_kw (ps, "NOT");
+  if ((ps->tok != TK_ID) || ((t = find_term (ps, (uint32_t)(v - ps->var), ps->id)) == NULL))
+  {
+    return false;
+  }
+  next (ps);
+  *ret = (uint32_t)t->val;
+  return !neg || add_rule (ps, *ret, F_NOT, *ret, ret);
+}
+
+/*******************************************************************************
+* x AND y ..., x OR y ... - левая ассоциативность, AND старше OR
+*******************************************************************************/
+static bool parse_and (fcl_parser *ps, uint32_t *ret)
+{
+  uint32_t b;
+
+  if (!parse_factor (ps, ret))
+  {
+    return false;
+  }
+  while (accept_kw (ps, "AND"))
+  {
+    if (!parse_factor (ps, &b) || !add_rule (ps, *ret, F_AND, b, ret))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool parse_or (fcl_parser *ps, uint32_t *ret)
+{
+  uint32_t b;
+
+  if (!parse_and (ps, ret))
+  {
+    return false;
+  }
+  while (accept_kw (ps, "OR"))
+  {
+    if (!parse_and (ps, &b) || !add_rule (ps, *ret, F_OR, b, ret))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+/*******************************************************************************
+* RULE n : IF условие THEN var IS term {, var IS term} ;
+*******************************************************************************/
+static bool parse_rule (fcl_parser *ps)
+{
+  fuzzy_conseq cq[FUZZY_MAX_OUT], *c;
+  fcl_var *v;
+  fcl_term *t;
+  fcl_rule *r;
+  uint32_t top, n_rule, k, n = 0;
+
+  if ((!accept (ps, TK_NUM) && !accept (ps, TK_ID)) || !accept (ps, TK_COLON) ||
+      !accept_kw (ps, "IF"))
+  {
+    return false;
+  }
+  n_rule = ps->n_rule;
+  if (!parse_or (ps, &top) || !accept_kw (ps, "THEN"))
+  {
+    return false;
+  }
+  /// условие из одной функции - правило F_A
+  if ((ps->n_rule == n_rule) && !add_rule (ps, top, F_A, top, &top))
+  {
+    return false;
+  }
+
+  do
+  {
+    if ((ps->tok != TK_ID) || ((v = find_var (ps, ps->id)) == NULL) || (v->out == FCL_NO_OUT))
+    {
+      return false;
+    }
+    next (ps);
+    if (!accept_kw (ps, "IS") || (ps->tok != TK_ID) ||
+        ((t = find_term (ps, (uint32_t)(v - ps->var), ps->id)) == NULL))
+    {
+      return false;
+    }
+    next (ps);
+    for (k = 0; k < n; k++)
+    {
+      if (cq[k].on == v->out)
+      {
+        return false;
+      }
+    }
+    cq[n].on = (uint8_t)v->out;
+    cq[n++].out = (int8_t)t->val;
+  } while (accept (ps, TK_COMMA));
+  if (!accept (ps, TK_SEMI))
+  {
+    return false;
+  }
+
+  r = &ps->rule[top & ~FCL_RULE];
+  r->fin = true;
+  if ((n == 1) && (cq[0].on == 0))
+  {
+    r->out = cq[0].out;
+    return true;
+  }
+  r->cq = ps->n_cq;
+  r->n_cq = (uint8_t)n;
+  for (k = 0; k < n; k++)
+  {
+    c = grow (ps, (void **)&ps->cq, &ps->n_cq, &ps->cap_cq, sizeof (fuzzy_conseq));
+    if (c == NULL)
+    {
+      return false;
+    }
+    *c = cq[k];
+  }
+  return true;
+}
+
+/*******************************************************************************
+* RULEBLOCK name: операторы и правила
+*******************************************************************************/
+static bool parse_ruleblock (fcl_parser *ps)
+{
+  if (!accept (ps, TK_ID))
+  {
+    return false;
+  }
+  while (!accept_kw (ps, "END_RULEBLOCK"))
+  {
+    if (accept_kw (ps, "RULE"))
+    {
+      if (!parse_rule (ps))
+      {
+        return false;
+      }
+    }
+    else if (accept_kw (ps, "AND"))
+    {
+      if (!accept_setting (ps, TK_COLON, "MIN", NULL))
+      {
+        return false;
+      }
+    }
+    else if (accept_kw (ps, "OR"))
+    {
+      if (!accept_setting (ps, TK_COLON, "MAX", NULL))
+      {
+        return false;
+      }
+    }
+    else if (accept_kw (ps, "ACT"))
+    {
+      if (!accept_setting (ps, TK_COLON, "MIN", "PROD"))
+      {
+        return false;
+      }
+    }
+    else if (!accept_kw (ps, "ACCU") || !accept_setting (ps, TK_COLON, "SUM", NULL))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+/*******************************************************************************
+* FUNCTION_BLOCK [name] ... END_FUNCTION_BLOCK
+*******************************************************************************/
+static bool parse_block (fcl_parser *ps)
+{
+  bool ok;
+
+  next (ps);
+  if (!accept_kw (ps, "FUNCTION_BLOCK"))
+  {
+    return false;
+  }
+  if ((ps->tok == TK_ID) && !kw_eq (ps->id, "VAR_INPUT") && !kw_eq (ps->id, "VAR_OUTPUT"))
+  {
+    next (ps);
+  }
+  while (!accept_kw (ps, "END_FUNCTION_BLOCK"))
+  {
+    if (accept_kw (ps, "VAR_INPUT"))
+    {
+      ok = parse_vars (ps, false);
+    }
+    else if (accept_kw (ps, "VAR_OUTPUT"))
+    {
+      ok = parse_vars (ps, true);
+    }
+    else if (accept_kw (ps, "FUZZIFY"))
+    {
+      ok = parse_fuzzify (ps);
+    }
+    else if (accept_kw (ps, "DEFUZZIFY"))
+    {
+      ok = parse_defuzzify (ps);
+    }
+    else if (accept_kw (ps, "RULEBLOCK"))
+    {
+      ok = parse_ruleblock (ps);
+    }
+    else
+    {
+      ok = false;
+    }
+    if (!ok)
+    {
+      return false;
+    }
+  }
+  /// после блока только комментарии; пустой регулятор не вычисляется
+  return (ps->tok == TK_END) && (ps->n_ff > 0) && (ps->n_rule > 0);
+}
+
+/*******************************************************************************
+* списки функций и правил в одном блоке памяти
+*******************************************************************************/
+static fuzzy_status fcl_link (const fcl_parser *ps, fuzzy_fcl *fcl)
+{
+  fuzzy_funct *ff;
+  fuzzy_rules *r;
+  fuzzy_conseq *cq;
+  char (*in_name)[FUZZY_FCL_NAME];
+  char (*out_name)[FUZZY_FCL_NAME];
+  const fcl_rule *s;
+  size_t off_ff, off_rule, off_cq, off_name, off_in, size;
+  uint8_t *mem;
+  uint32_t i;
+
+  off_ff   = 0;
+  off_rule = ALIGN_UP (off_ff + ps->n_ff * sizeof (fuzzy_funct), sizeof (void *));
+  off_cq   = ALIGN_UP (off_rule + ps->n_rule * sizeof (fuzzy_rules), sizeof (void *));
+  off_name = off_cq + ps->n_cq * sizeof (fuzzy_conseq);
+  off_in   = off_name + (size_t)(ps->n_in + ps->n_out) * FUZZY_FCL_NAME;
+  size     = ALIGN_UP (off_in + ps->n_in + 1, sizeof (void *));
+  mem = calloc (1, size);
+  if (mem == NULL)
+  {
+    return FUZZY_ERR_MEMORY;
+  }
+  ff       = (fuzzy_funct *)(mem + off_ff);
+  r        = (fuzzy_rules *)(mem + off_rule);
+  cq       = (fuzzy_conseq *)(mem + off_cq);
+  in_name  = (char (*)[FUZZY_FCL_NAME])(mem + off_name);
+  out_name = in_name + ps->n_in;
+
+  for (i = 0; i < ps->n_ff; i++)
+  {
+    ff[i] = ps->ff[i];
+    ff[i].next = &ff[(i + 1) % ps->n_ff];
+  }
+  for (i = 0; i < ps->n_rule; i++)
+  {
+    s = &ps->rule[i];
+    r[i].a    = (s->a & FCL_RULE) ? &r[s->a & ~FCL_RULE].y : &ff[s->a].y;
+    r[i].op   = (fuzzy_op)s->op;
+    r[i].b    = (s->b & FCL_RULE) ? &r[s->b & ~FCL_RULE].y : &ff[s->b].y;
+    r[i].fin  = s->fin;
+    r[i].out  = s->out;
+    r[i].next = &r[(i + 1) % ps->n_rule];
+    r[i].conseq   = (s->n_cq != 0) ? &cq[s->cq] : NULL;
+    r[i].n_conseq = s->n_cq;
+  }
+  if (ps->n_cq != 0)
+  {
+    memcpy (cq, ps->cq, ps->n_cq * sizeof (fuzzy_conseq));
+  }
+  for (i = 0; i < ps->n_var; i++)
+  {
+    if (ps->var[i].out == FCL_NO_OUT)
+    {
+      strcpy (in_name[ps->var[i].n], ps->var[i].name);
+    }
+    else
+    {
+      strcpy (out_name[ps->var[i].out], ps->var[i].name);
+    }
+  }
+
+  fcl->in                 = (int8_t *)(mem + off_in);
+  fcl->param.in_array     = fcl->in;
+  fcl->param.start_ffunc  = ff;
+  fcl->param.start_rule   = r;
+  fcl->n_in               = ps->n_in;
+  fcl->n_out              = (uint8_t)ps->n_out;
+  fcl->n_ffunc            = (uint16_t)ps->n_ff;
+  fcl->n_rule             = ps->n_rule;
+  fcl->in_name            = (const char (*)[FUZZY_FCL_NAME])in_name;
+  fcl->out_name           = (const char (*)[FUZZY_FCL_NAME])out_name;
+  fcl->mem                = mem;
+  return FUZZY_OK;
+}
+
+/*******************************************************************************
+* Разбор текста FCL
+* \brief  Build fuzzy functions and rules lists from FCL text
+* \param[in]  text    FCL text
+* \param[out] fcl     controller, free with fuzzy_fcl_free
+* \param[out] line    line of the error (option, may be NULL), 0 - no line
+* \return             FUZZY_OK, FUZZY_ERR_SYNTAX, FUZZY_ERR_SIZE for more
+*                     than 0xFFFF functions, FUZZY_ERR_MEMORY
+*******************************************************************************/
+fuzzy_status fuzzy_fcl_parse (const char *text, fuzzy_fcl *fcl, unsigned *line)
+{
+  fcl_parser ps;
+  fuzzy_status ret;
+
+  if (line)
+  {
+    *line = 0;
+  }
+  if ((text == NULL) || (fcl == NULL))
+  {
+    return FUZZY_ERR_PARAM;
+  }
+  memset (fcl, 0, sizeof (fuzzy_fcl));
+  memset (&ps, 0, sizeof (ps));
+  ps.p = text;
+  ps.line = 1;
+
+  if (!parse_block (&ps))
+  {
+    ret = ps.no_mem ? FUZZY_ERR_MEMORY : FUZZY_ERR_SYNTAX;
+    if (line && !ps.no_mem)
+    {
+      *line = ps.tok_line;
+    }
+  }
+  else if (ps.n_ff > 0xFFFFu)
+  {
+    ret = FUZZY_ERR_SIZE;
+  }
+  else
+  {
+    ret = fcl_link (&ps, fcl);
+  }
+  free (ps.var);
+  free (ps.term);
+  free (ps.ff);
+  free (ps.rule);
+  free (ps.cq);
+  return ret;
+}
+
+/*******************************************************************************
+* Чтение файла FCL
+* \brief  Load FCL file, see fuzzy_fcl_parse
+* \param[in]  path    file name
+* \param[out] fcl     controller, free with fuzzy_fcl_free
+* \param[out] line    line of the error (option, may be NULL), 0 - no line
+* \return             FUZZY_OK, FUZZY_ERR_FILE or fuzzy_fcl_parse status
+*******************************************************************************/
+fuzzy_status fuzzy_fcl_load (const char *path, fuzzy_fcl *fcl, unsigned *line)
+{
+  fuzzy_status ret;
+  char *text;
+  long size;
+  FILE *f;
+
+  if (line)
+  {
+    *line = 0;
+  }
+  if ((path == NULL) || (fcl == NULL))
+  {
+    return FUZZY_ERR_PARAM;
+  }
+  memset (fcl, 0, sizeof (fuzzy_fcl));
+  f = fopen (path, "rb");
+  if (f == NULL)
+  {
+    return FUZZY_ERR_FILE;
+  }
+  if ((fseek (f, 0, SEEK_END) != 0) || ((size = ftell (f)) < 0) || (fseek (f, 0, SEEK_SET) != 0))
+  {
+    fclose (f);
+    return FUZZY_ERR_FILE;
+  }
+  text = malloc ((size_t)size + 1);
+  if (text == NULL)
+  {
+    fclose (f);
+    return FUZZY_ERR_MEMORY;
+  }
+  if (fread (text, 1, (size_t)size, f) != (size_t)size)
+  {
+    free (text);
+    fclose (f);
+    return FUZZY_ERR_FILE;
+  }
+  fclose (f);
+  text[size] = 0;
+
+  ret = fuzzy_fcl_parse (text, fcl, line);
+  free (text);
+  return ret;
+}
+
+/*******************************************************************************
+* Освобождение памяти регулятора
+* \brief  Free lists memory of the loaded controller
+* \param[in]  fcl     controller
+*******************************************************************************/
+void fuzzy_fcl_free (fuzzy_fcl *fcl)
+{
+  if (fcl)
+  {
+    free (fcl->mem);
+    memset (fcl, 0, sizeof (fuzzy_fcl));
+  }
+}
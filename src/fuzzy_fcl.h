@@ -0,0 +1,81 @@
+/*******************************************************************************
+* \file     fuzzy_fcl.h
+* \author   Ilya Petrukhin (ilya.petrukhin@gmail.com)
+* \brief    Loader of fuzzy controllers in FCL (IEC 61131-7) text
+* \version  2.1
+* \date     2026-10-17
+*******************************************************************************/
+
+#ifndef _FUZZY_FCL_H_
+#define _FUZZY_FCL_H_
+
+#include  <stdint.h>
+#include  <stdbool.h>
+#include  "fuzzy_logic.h"
+#include  "fuzzy_model.h"
+
+/*******************************************************************************
+* Rules to using FCL loader
+*******************************************************************************/
+// 1. Describe the controller in FCL, values are integers of the scaled
+// range +-127 as for MAKE_FFUNC / MAKE_RULE (see line.fcl):
+//  FUNCTION_BLOCK line
+//  VAR_INPUT   distance : REAL; course : REAL;   END_VAR
+//  VAR_OUTPUT  turn : REAL;                      END_VAR
+//  FUZZIFY distance
+//    TERM zero := (-10, 0) (-1, 1) (1, 1) (10, 0);   (* points *)
+//    TERM far  := cube (0, 10);                      (* shape (a, b, c) *)
+//  END_FUZZIFY
+//  DEFUZZIFY turn
+//    TERM left := 4;                                 (* singleton *)
+//    METHOD : COGS;
+//  END_DEFUZZIFY
+//  RULEBLOCK No1
+//    AND : MIN;
+//    RULE 1 : IF distance IS zero AND NOT (course IS far) THEN turn IS left;
+//  END_RULEBLOCK
+//  END_FUNCTION_BLOCK
+//
+// 2. Load it and use fcl.param as the parameters made by the macros:
+//  fuzzy_fcl fcl;
+//  unsigned line;
+//  if (fuzzy_fcl_load ("line.fcl", &fcl, &line) != FUZZY_OK)
+//  {
+//    error in the line...
+//  }
+//  fcl.in[0] = in0_scaling (in_err);     // VAR_INPUT order
+//  int8_t temp = process_fuzzy_logic (&fcl.param);
+//  fuzzy_compile (&fcl.param, &model);   // or any compiled engine
+//  fuzzy_fcl_free (&fcl);                // after the model is freed
+//
+// Point lists must be one of the seven shapes: 2 points - low / high,
+// 3 points 0-1-0 - triangle / a_triangle, 4 points 0-1-1-0 - symmetric
+// trapecia or square; flat end points are dropped. Other shapes (cube)
+// are given by name. Every AND / OR / NOT of the condition is one rule of
+// the list, the last one is final; several THEN outputs give consequents
+// of several outputs (VAR_OUTPUT order). Supported settings are those of
+// the engine: AND : MIN, OR : MAX, ACT : MIN | PROD, ACCU : SUM,
+// METHOD : COGS, DEFAULT := 0. Keywords are not case sensitive, names are.
+// ***************** end of the brief *****************************************
+
+#define FUZZY_FCL_NAME    (32)        ///< max name length with the terminator
+
+/// Controller loaded from FCL
+typedef struct
+{
+  fuzzy_param   param;        ///< lists and input array for process_fuzzy_logic
+  int8_t        *in;          ///< input array [n_in], param.in_array
+  uint16_t      n_in;         ///< input variables
+  uint8_t       n_out;        ///< output variables
+  uint16_t      n_ffunc;      ///< fuzzy functions (input terms)
+  uint32_t      n_rule;       ///< rules of the list
+  const char    (*in_name)[FUZZY_FCL_NAME];   ///< input names [n_in]
+  const char    (*out_name)[FUZZY_FCL_NAME];  ///< output names [n_out]
+  void          *mem;         ///< owned memory block
+} fuzzy_fcl;
+
+fuzzy_status fuzzy_fcl_parse (const char *text, fuzzy_fcl *fcl, unsigned *line);  ///< FCL text
+fuzzy_status fuzzy_fcl_load (const char *path, fuzzy_fcl *fcl, unsigned *line);   ///< FCL file
+void         fuzzy_fcl_free (fuzzy_fcl *fcl);                                    ///< free lists memory
+
+#endif  // _FUZZY_FCL_H_
@@ -0,0 +1,249 @@
+/*******************************************************************************
+* \file     fuzzy_fleet.c
+* \author   Ilya Petrukhin (ilya.petrukhin@gmail.com)
+* \brief    This file provides code for the fleet of controller instances
+*           evaluated per tick by the thread pool
+* \version  2.1
+* \date     2026-10-17
+*******************************************************************************/
+#include  <stdint.h>
+#include  <stdbool.h>
+#include  <stdlib.h>
+#include  <string.h>
+#include  "fuzzy_logic.h"
+#include  "fuzzy_model.h"
+#include  "fuzzy_batch.h"
+#include  "fuzzy_pool.h"
+#include  "fuzzy_fleet.h"
+#include  "fuzzy_time.h"
+
+#define ALIGN_UP(x, a)  (((x) + ((a) - 1)) & ~((size_t)(a) - 1))
+
+
+/*******************************************************************************
+* задание исполнителя: instances [begin, end)
+* \brief  Evaluate the chunk of instances by columns
+*******************************************************************************/
+static void fleet_task (void *arg, size_t begin, size_t end, unsigned worker)
+{
+  fuzzy_fleet *fleet = arg;
+  uint16_t n_in = fleet->model->n_in;
+  const int8_t **cols = fleet->cols + (size_t)worker * n_in;
+  fuzzy_status res;
+  uint16_t k;
+
+  for (k = 0; k < n_in; k++)
+  {
+    cols[k] = fleet->in + k * fleet->stride + begin;
+  }
+  res = process_fuzzy_batch_soa_ws (&fleet->batch, cols, end - begin, fleet->out + begin,
+                                    fleet->scratch + (size_t)worker * fleet->scratch_size);
+  // первая ошибка исполнителя за такт
+  if ((res != FUZZY_OK) && (fleet->status[worker] == FUZZY_OK))
+  {
+    fleet->status[worker] = res;
+  }
+}
+
+/*******************************************************************************
+* сравнение времён тактов для qsort
+*******************************************************************************/
+static int fleet_cmp (const void *a, const void *b)
+{
+  uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+
+  return (x > y) - (x < y);
+}
+
+/*******************************************************************************
+* Создание флота экземпляров регулятора
+* \brief  Register n instances against the compiled model
+* \param[in]  model     compiled model, shared, has to live with the fleet
+* \param[in]  n         number of instances
+* \param[in]  threads   workers with the caller, 0 - one per CPU
+* \param[in]  chunk     instances per take, 0 - FUZZY_FLEET_CHUNK
+* \param[out] fleet     fleet, inputs and outputs are zero, free with
+*                       fuzzy_fleet_free
+* \return               FUZZY_OK, FUZZY_ERR_PARAM, FUZZY_ERR_STRUCT (rules
+*                       read later rules), FUZZY_ERR_MEMORY, status of
+*                       fuzzy_batch_init
+*******************************************************************************/
+fuzzy_status fuzzy_fleet_init (const fuzzy_model *model, size_t n, unsigned threads,
+                               size_t chunk, fuzzy_fleet *fleet)
+{
+  size_t stride, off_in, off_out, off_hist, off_cols, off_status, off_scratch, size;
+  unsigned workers;
+  fuzzy_status res;
+  uint8_t *mem;
+
+  if (fleet == NULL)
+  {
+    return FUZZY_ERR_PARAM;
+  }
+  memset (fleet, 0, sizeof (fuzzy_fleet));
+  if ((model == NULL) || (model->mf == NULL) || (n == 0) || (model->n_out == 0))
+  {
+    return FUZZY_ERR_PARAM;
+  }
+  if (model->flags & FUZZY_MODEL_FWD)
+  {
+    return FUZZY_ERR_STRUCT;
+  }
+
+  /// план модели один на флот, память вызова у каждого исполнителя своя
+  res = fuzzy_batch_init (model, FUZZY_KERNEL_AUTO, &fleet->batch);
+  if (res != FUZZY_OK)
+  {
+    return res;
+  }
+  fleet->pool = fuzzy_pool_create (threads);
+  if (fleet->pool == NULL)
+  {
+    fuzzy_batch_free (&fleet->batch);
+    return FUZZY_ERR_MEMORY;
+  }
+  workers = fuzzy_pool_size (fleet->pool);
+  fleet->scratch_size = ALIGN_UP (fleet->batch.scratch, FUZZY_FLEET_ALIGN);
+
+  stride   = ALIGN_UP (n, FUZZY_FLEET_ALIGN);
+  off_in   = 0;
+  off_out  = off_in + (size_t)model->n_in * stride;
+  off_hist = ALIGN_UP (off_out + stride, FUZZY_FLEET_ALIGN);
+  off_cols = ALIGN_UP (off_hist + FUZZY_FLEET_HIST * sizeof (uint64_t), FUZZY_FLEET_ALIGN);
+  off_status = ALIGN_UP (off_cols + (size_t)workers * (model->n_in ? model->n_in : 1) *
+                        sizeof (int8_t *), FUZZY_FLEET_ALIGN);
+  off_scratch = ALIGN_UP (off_status + (size_t)workers * sizeof (fuzzy_status), FUZZY_FLEET_ALIGN);
+  size     = off_scratch + (size_t)workers * fleet->scratch_size;
+
+  fleet->mem = calloc (1, size + FUZZY_FLEET_ALIGN);
+  if (fleet->mem == NULL)
+  {
+    fuzzy_pool_destroy (fleet->pool);
+    fuzzy_batch_free (&fleet->batch);
+    memset (fleet, 0, sizeof (fuzzy_fleet));
+    return FUZZY_ERR_MEMORY;
+  }
+  mem = (uint8_t *)ALIGN_UP ((uintptr_t)fleet->mem, FUZZY_FLEET_ALIGN);
+
+  fleet->model  = model;
+  fleet->n      = n;
+  fleet->stride = stride;
+  fleet->chunk  = chunk ? chunk : FUZZY_FLEET_CHUNK;
+  fleet->in     = (int8_t *)(mem + off_in);
+  fleet->out    = (int8_t *)(mem + off_out);
+  fleet->hist   = (uint64_t *)(mem + off_hist);
+  fleet->cols   = (const int8_t **)(mem + off_cols);
+  fleet->status = (fuzzy_status *)(mem + off_status);
+  fleet->workers = workers;
+  fleet->scratch = mem + off_scratch;
+  return FUZZY_OK;
+}
+
+/*******************************************************************************
+* Такт флота
+* \brief  Evaluate all instances: output of instance i to fleet->out[i],
+*         tick time to the latency history
+* \param[in]  fleet   fleet with the inputs of the tick
+* \return             FUZZY_OK, FUZZY_ERR_PARAM, first error of the workers
+*                     (outputs of their failed chunks are not valid)
+*******************************************************************************/
+fuzzy_status fuzzy_fleet_tick (fuzzy_fleet *fleet)
+{
+  uint64_t t;
+  unsigned w;
+
+  if ((fleet == NULL) || (fleet->mem == NULL))
+  {
+    return FUZZY_ERR_PARAM;
+  }
+  for (w = 0; w < fleet->workers; w++)
+  {
+    fleet->status[w] = FUZZY_OK;
+  }
+  t = fuzzy_time_ns ();
+  fleet->stolen += fuzzy_pool_run_local (fleet->pool, fleet_task, fleet, fleet->n, fleet->chunk);
+  fleet->hist[fleet->ticks % FUZZY_FLEET_HIST] = fuzzy_time_ns () - t;
+  fleet->ticks++;
+  for (w = 0; w < fleet->workers; w++)
+  {
+    if (fleet->status[w] != FUZZY_OK)
+    {
+      return fleet->status[w];
+    }
+  }
+  return FUZZY_OK;
+}
+
+/*******************************************************************************
+* Статистика времени тактов
+* \brief  Tick latency percentiles of the last FUZZY_FLEET_HIST ticks
+* \param[in]  fleet   fleet
+* \param[out] st      statistics, zero without ticks
+*******************************************************************************/
+void fuzzy_fleet_get_stats (const fuzzy_fleet *fleet, fuzzy_fleet_stats *st)
+{
+  uint64_t *t, sum = 0;
+  uint32_t n, i;
+
+  memset (st, 0, sizeof (fuzzy_fleet_stats));
+  if ((fleet == NULL) || (fleet->mem == NULL) || (fleet->ticks == 0))
+  {
+    return;
+  }
+  n = (fleet->ticks < FUZZY_FLEET_HIST) ? (uint32_t)fleet->ticks : FUZZY_FLEET_HIST;
+  st->ticks  = fleet->ticks;
+  st->n_hist = n;
+  st->stolen = fleet->stolen;
+
+  t = malloc (n * sizeof (uint64_t));
+  if (t == NULL)
+  {
+    return;
+  }
+  memcpy (t, fleet->hist, n * sizeof (uint64_t));
+  qsort (t, n, sizeof (uint64_t), fleet_cmp);
+  for (i = 0; i < n; i++)
+  {
+    sum += t[i];
+  }
+  // nearest rank: smallest time not less than p of the ticks
+  st->p50_ns  = t[(n * 500u + 999) / 1000 - 1];
+  st->p90_ns  = t[(n * 900u + 999) / 1000 - 1];
+  st->p99_ns  = t[(n * 990u + 999) / 1000 - 1];
+  st->p999_ns = t[(n * 999u + 999) / 1000 - 1];
+  st->min_ns  = t[0];
+  st->max_ns  = t[n - 1];
+  st->mean_ns = (double)sum / n;
+  st->per_sec = (sum != 0) ? fleet->n * 1e9 / st->mean_ns : 0.0;
+  free (t);
+}
+
+/*******************************************************************************
+* Сброс статистики
+* \brief  Start the latency history again, e.g. after warm-up ticks
+* \param[in]  fleet   fleet
+*******************************************************************************/
+void fuzzy_fleet_reset_stats (fuzzy_fleet *fleet)
+{
+  if (fleet)
+  {
+    fleet->ticks = 0;
+    fleet->stolen = 0;
+  }
+}
+
+/*******************************************************************************
+* Удаление флота
+* \brief  Stop the workers and free the fleet
+* \param[in]  fleet   fleet
+*******************************************************************************/
+void fuzzy_fleet_free (fuzzy_fleet *fleet)
+{
+  if (fleet)
+  {
+    fuzzy_pool_destroy (fleet->pool);
+    fuzzy_batch_free (&fleet->batch);
+    free (fleet->mem);
+    memset (fleet, 0, sizeof (fuzzy_fleet));
+  }
+}
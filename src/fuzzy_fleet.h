@@ -0,0 +1,117 @@
+/*******************************************************************************
+* \file     fuzzy_fleet.h
+* \author   Ilya Petrukhin (ilya.petrukhin@gmail.com)
+* \brief    Fleet of controller instances sharing one compiled fuzzy model:
+*           inputs and outputs by columns, all instances per tick
+* \version  2.1
+* \date     2026-10-17
+*******************************************************************************/
+
+#ifndef _FUZZY_FLEET_H_
+#define _FUZZY_FLEET_H_
+
+#include  <stdint.h>
+#include  <stddef.h>
+#include  "fuzzy_logic.h"
+#include  "fuzzy_model.h"
+#include  "fuzzy_batch.h"
+#include  "fuzzy_pool.h"
+
+/*******************************************************************************
+* Rules to using fleet
+*******************************************************************************/
+// 1. Register n instances of the controller against the compiled model,
+// workers of the pool (0 - one per CPU), instances per take (0 - default):
+//  fuzzy_fleet fleet;
+//  fuzzy_fleet_init (&model, 10000, 0, 0, &fleet);
+//
+// 2. Every tick write the inputs of the instances by columns, evaluate
+// all instances, read the outputs:
+//  int8_t *dist = fuzzy_fleet_in (&fleet, 0);   // input 0 of instance i: dist[i]
+//  int8_t *course = fuzzy_fleet_in (&fleet, 1);
+//  ...
+//  fuzzy_fleet_tick (&fleet);
+//  fleet.out[i] ...
+//
+// 3. Latency of the last FUZZY_FLEET_HIST ticks (fuzzy_fleet_reset_stats
+// starts again, e.g. after warm-up):
+//  fuzzy_fleet_stats st;
+//  fuzzy_fleet_get_stats (&fleet, &st);
+//  printf ("p50 %llu p99 %llu ns\n", st.p50_ns, st.p99_ns);
+//  fuzzy_fleet_free (&fleet);
+//
+// Columns are aligned to FUZZY_FLEET_ALIGN bytes. The instances are split
+// into one contiguous range per worker, so the same instances stay on the
+// same core from tick to tick; a worker done with its range steals chunks
+// of the others (fuzzy_pool_run_local). The batch plan of the model is
+// prepared once by fuzzy_fleet_init, every worker has own batch memory, so
+// a tick does not allocate; results are the same as the compiled model
+// called for every instance. Models of images (fuzzy_image_map) are
+// accepted as compiled ones. Output 0 of the model only.
+// Models with rules reading later rules (FUZZY_MODEL_FWD) keep state
+// between calls and are rejected with FUZZY_ERR_STRUCT.
+// fuzzy_fleet_tick returns the first error of the workers (outputs of
+// the failed chunks are not valid), the tick time is recorded anyway.
+// One fleet is ticked by one thread at a time, the model is shared and
+// has to live while the fleet is in use.
+// ***************** end of the brief *****************************************
+
+#define FUZZY_FLEET_HIST    (1024)    ///< ticks kept for the latency percentiles
+#define FUZZY_FLEET_ALIGN   (64)      ///< alignment of the columns, bytes
+#define FUZZY_FLEET_CHUNK   (1024)    ///< default instances per take
+
+/// Tick latency of the fleet
+typedef struct
+{
+  uint64_t  ticks;        ///< ticks from init or reset
+  uint32_t  n_hist;       ///< ticks in the percentiles
+  uint64_t  p50_ns;       ///< median tick time
+  uint64_t  p90_ns;       ///< 90th percentile
+  uint64_t  p99_ns;       ///< 99th percentile
+  uint64_t  p999_ns;      ///< 99.9th percentile
+  uint64_t  min_ns;       ///< fastest tick
+  uint64_t  max_ns;       ///< slowest tick
+  double    mean_ns;      ///< mean tick time
+  double    per_sec;      ///< instances per second at the mean tick time
+  uint64_t  stolen;       ///< chunks done outside the own range, from init or reset
+} fuzzy_fleet_stats;
+
+/// Fleet of controller instances
+typedef struct
+{
+  const fuzzy_model *model;   ///< shared model
+  size_t        n;            ///< instances
+  size_t        stride;       ///< column length, n rounded up to FUZZY_FLEET_ALIGN
+  size_t        chunk;        ///< instances per take
+  int8_t        *in;          ///< input k of instance i: in[k * stride + i]
+  int8_t        *out;         ///< output of instance i: out[i]
+  fuzzy_pool    *pool;        ///< workers
+  const int8_t  **cols;       ///< column pointers of the chunk, [workers][n_in]
+  fuzzy_status  *status;      ///< first error of worker w in the tick, [workers]
+  unsigned      workers;      ///< workers of the pool with the caller
+  fuzzy_batch   batch;        ///< prepared batch of the model
+  uint8_t       *scratch;     ///< batch memory of worker w: scratch + w * scratch_size
+  size_t        scratch_size; ///< batch memory per worker, aligned
+  uint64_t      *hist;        ///< tick times, ring [FUZZY_FLEET_HIST]
+  uint64_t      ticks;        ///< ticks from init or reset
+  uint64_t      stolen;       ///< chunks done outside the own range
+  void          *mem;         ///< memory block
+} fuzzy_fleet;
+
+/*******************************************************************************
+* столбец входа k
+* \brief  Column of input k: value of instance i is fuzzy_fleet_in (fleet, k)[i]
+*******************************************************************************/
+inline static int8_t *fuzzy_fleet_in (fuzzy_fleet *fleet, uint16_t k)
+{
+  return fleet->in + k * fleet->stride;
+}
+
+fuzzy_status fuzzy_fleet_init (const fuzzy_model *model, size_t n, unsigned threads,
+                               size_t chunk, fuzzy_fleet *fleet);
+fuzzy_status fuzzy_fleet_tick (fuzzy_fleet *fleet);
+void         fuzzy_fleet_get_stats (const fuzzy_fleet *fleet, fuzzy_fleet_stats *st);
+void         fuzzy_fleet_reset_stats (fuzzy_fleet *fleet);
+void         fuzzy_fleet_free (fuzzy_fleet *fleet);
+
+#endif  // _FUZZY_FLEET_H_
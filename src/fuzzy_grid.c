@@ -0,0 +1,698 @@
+/*******************************************************************************
+* \file     fuzzy_grid.c
+* \author   Ilya Petrukhin (ilya.petrukhin@gmail.com)
+* \brief    This file provides code for the rule table (Sugeno matrix)
+*           evaluation visiting only the cells of active terms
+* \version  2.1
+* \date     2026-10-17
+*******************************************************************************/
+#include  <stdio.h>
+#include  <stdint.h>
+#include  <stdbool.h>
+#include  <stdlib.h>
+#include  <string.h>
+#include  "fuzzy_logic.h"
+#include  "fuzzy_model.h"
+#include  "fuzzy_grid.h"
+
+#define ALIGN_UP(x, a)  (((x) + ((a) - 1)) & ~((size_t)(a) - 1))
+
+#define SET_WORDS       (4)     ///< 256-bit term set
+
+/// условие правила по входам: OR термов каждого входа
+typedef struct
+{
+  bool      valid;                          ///< expression is a table condition
+  uint8_t   mask;                           ///< dimensions of the condition
+  uint64_t  set[FUZZY_GRID_MAX_DIM][SET_WORDS];  ///< terms of every dimension
+} grid_form;
+
+
+/*******************************************************************************
+* построение таблицы по термам и условиям правил
+* \param[in]  mu_tab  activations of terms [n_term total][256], index (uint8_t)x
+* \param[in]  set_off terms of rule r, dimension d: set[set_off[r * n_dim + d]..]
+*******************************************************************************/
+static fuzzy_status grid_build (fuzzy_grid *grid, uint8_t n_dim, const uint8_t *xn,
+                                const uint16_t *n_term, const uint8_t (*mu_tab)[256],
+                                uint32_t n_rule, const uint32_t *set_off, const uint8_t *set,
+                                const int8_t *out)
+{
+  uint32_t (*act_off)[257];
+  fuzzy_grid_act *act;
+  uint32_t *cell_off, *cell_rule, *g_set_off, *pos;
+  uint32_t t[FUZZY_GRID_MAX_DIM], c, r;
+  uint8_t *g_set, *single, *mu, *mem;
+  int8_t *g_out;
+  size_t n_mu = 0, n_act = 0, n_cr = 0, n_cell = 1, n_set, box;
+  size_t off_act, off_cell, off_cr, off_so, off_set, off_single, off_out, off_mu, off_stamp, size;
+  unsigned d, x, k;
+  int i;
+
+  if ((n_dim == 0) || (n_dim > FUZZY_GRID_MAX_DIM))
+  {
+    return FUZZY_ERR_STRUCT;
+  }
+  for (d = n_dim; d-- > 0; )
+  {
+    if ((n_term[d] == 0) || (n_term[d] > FUZZY_GRID_MAX_TERM))
+    {
+      return FUZZY_ERR_SIZE;
+    }
+    grid->stride[d] = (uint32_t)n_cell;
+    n_cell *= n_term[d];
+    if (n_cell > FUZZY_GRID_MAX_CELL)
+    {
+      return FUZZY_ERR_SIZE;
+    }
+  }
+  for (d = 0; d < n_dim; d++)
+  {
+    grid->xn[d] = xn[d];
+    grid->n_term[d] = n_term[d];
+    grid->base[d] = (uint16_t)n_mu;
+    n_mu += n_term[d];
+    for (k = 0; k < n_term[d]; k++)
+    {
+      for (x = 0; x < 256; x++)
+      {
+        n_act += (mu_tab[grid->base[d] + k][x] != 0);
+      }
+    }
+  }
+  /// ячейки каждого правила: произведение множеств термов
+  for (r = 0; r < n_rule; r++)
+  {
+    box = 1;
+    for (d = 0; d < n_dim; d++)
+    {
+      box *= set_off[r * n_dim + d + 1] - set_off[r * n_dim + d];
+    }
+    n_cr += box;
+    if (n_cr > 0xFFFFFFFFu)
+    {
+      return FUZZY_ERR_SIZE;
+    }
+  }
+  n_set = set_off[n_rule * n_dim];
+
+  /// один блок памяти
+  off_act    = (size_t)n_dim * 257 * sizeof (uint32_t);
+  off_cell   = ALIGN_UP (off_act + n_act * sizeof (fuzzy_grid_act), sizeof (uint32_t));
+  off_cr     = off_cell + (n_cell + 1) * sizeof (uint32_t);
+  off_so     = off_cr + n_cr * sizeof (uint32_t);
+  off_set    = off_so + ((size_t)n_rule * n_dim + 1) * sizeof (uint32_t);
+  off_single = off_set + n_set;
+  off_out    = off_single + n_rule;
+  off_mu     = off_out + n_rule;
+  off_stamp  = ALIGN_UP (off_mu + n_mu, sizeof (uint32_t));
+  size       = off_stamp + (size_t)n_rule * sizeof (uint32_t);
+  mem = calloc (1, size);
+  pos = calloc (n_cell, sizeof (uint32_t));
+  if ((mem == NULL) || (pos == NULL))
+  {
+    free (mem);
+    free (pos);
+    return FUZZY_ERR_MEMORY;
+  }
+  act_off   = (uint32_t (*)[257])mem;
+  act       = (fuzzy_grid_act *)(mem + off_act);
+  cell_off  = (uint32_t *)(mem + off_cell);
+  cell_rule = (uint32_t *)(mem + off_cr);
+  g_set_off = (uint32_t *)(mem + off_so);
+  g_set     = mem + off_set;
+  single    = mem + off_single;
+  g_out     = (int8_t *)(mem + off_out);
+  mu        = mem + off_mu;
+
+  /// активные термы каждого значения входа
+  n_act = 0;
+  for (d = 0; d < n_dim; d++)
+  {
+    for (x = 0; x < 256; x++)
+    {
+      act_off[d][x] = (uint32_t)n_act;
+      for (k = 0; k < n_term[d]; k++)
+      {
+        if (mu_tab[grid->base[d] + k][x] != 0)
+        {
+          act[n_act].term = (uint8_t)k;
+          act[n_act++].mu = mu_tab[grid->base[d] + k][x];
+        }
+      }
+    }
+    act_off[d][256] = (uint32_t)n_act;
+  }
+
+  /// правила ячеек: перебор произведения множеств каждого правила
+  for (i = 0; i < 2; i++)
+  {
+    for (r = 0; r < n_rule; r++)
+    {
+      memset (t, 0, sizeof (t));
+      do
+      {
+        c = 0;
+        for (d = 0; d < n_dim; d++)
+        {
+          c += set[set_off[r * n_dim + d] + t[d]] * grid->stride[d];
+        }
+        if (i == 0)
+        {
+          cell_off[c + 1]++;
+        }
+        else
+        {
+          cell_rule[cell_off[c] + pos[c]++] = r;
+        }
+        for (d = n_dim; d-- > 0; )
+        {
+          if (++t[d] < set_off[r * n_dim + d + 1] - set_off[r * n_dim + d])
+          {
+            break;
+          }
+          t[d] = 0;
+        }
+      } while (d < n_dim);
+    }
+    for (c = 0; (i == 0) && (c < n_cell); c++)
+    {
+      cell_off[c + 1] += cell_off[c];
+    }
+  }
+  free (pos);
+
+  for (r = 0; r < n_rule; r++)
+  {
+    single[r] = 1;
+    for (d = 0; d < n_dim; d++)
+    {
+      single[r] &= (set_off[r * n_dim + d + 1] - set_off[r * n_dim + d]) == 1;
+    }
+  }
+  memcpy (g_set_off, set_off, ((size_t)n_rule * n_dim + 1) * sizeof (uint32_t));
+  memcpy (g_set, set, n_set);
+  memcpy (g_out, out, n_rule);
+
+  grid->n_dim     = n_dim;
+  grid->n_cell    = (uint32_t)n_cell;
+  grid->n_rule    = n_rule;
+  grid->act_off   = (const uint32_t (*)[257])act_off;
+  grid->act       = act;
+  grid->cell_off  = cell_off;
+  grid->cell_rule = cell_rule;
+  grid->set_off   = g_set_off;
+  grid->set       = g_set;
+  grid->single    = single;
+  grid->out       = g_out;
+  grid->mu        = mu;
+  grid->stamp     = (uint32_t *)(mem + off_stamp);
+  grid->mem       = mem;
+  return FUZZY_OK;
+}
+
+/*******************************************************************************
+* условие функции или правила по условиям операндов
+*******************************************************************************/
+static void grid_combine (grid_form *f, const grid_form *a, const grid_form *b, uint8_t op)
+{
+  unsigned d;
+
+  memset (f, 0, sizeof (grid_form));
+  switch (op)
+  {
+  case F_A:
+    *f = *a;
+    return;
+
+  case F_B:
+    *f = *b;
+    return;
+
+  case F_OR:
+    /// OR термов одного входа
+    if (a->valid && b->valid && (a->mask == b->mask) && ((a->mask & (a->mask - 1)) == 0))
+    {
+      *f = *a;
+      for (d = 0; d < FUZZY_GRID_MAX_DIM; d++)
+      {
+        f->set[d][0] |= b->set[d][0];
+        f->set[d][1] |= b->set[d][1];
+        f->set[d][2] |= b->set[d][2];
+        f->set[d][3] |= b->set[d][3];
+      }
+    }
+    return;
+
+  case F_AND:
+    /// AND разных входов, один вход - одно и то же условие
+    if (!a->valid || !b->valid)
+    {
+      return;
+    }
+    for (d = 0; d < FUZZY_GRID_MAX_DIM; d++)
+    {
+      if ((a->mask & b->mask & (1u << d)) && (memcmp (a->set[d], b->set[d], sizeof (a->set[d])) != 0))
+      {
+        return;
+      }
+    }
+    *f = *a;
+    f->mask |= b->mask;
+    for (d = 0; d < FUZZY_GRID_MAX_DIM; d++)
+    {
+      if (b->mask & (1u << d))
+      {
+        memcpy (f->set[d], b->set[d], sizeof (f->set[d]));
+      }
+    }
+    return;
+
+  default:
+    return;     // NOT, IMP, FALSE
+  }
+}
+
+/*******************************************************************************
+* Таблица правил по модели
+* \brief  Rule table of the compiled model: terms of every input, final
+*         rules as AND of inputs with term or OR of terms per input
+* \param[in]  model   compiled model, not needed after the call
+* \param[out] grid    table, free with fuzzy_grid_free
+* \return             FUZZY_OK, FUZZY_ERR_STRUCT - rules are not a table,
+*                     or error status
+*******************************************************************************/
+fuzzy_status fuzzy_grid_init (const fuzzy_model *model, fuzzy_grid *grid)
+{
+  grid_form *form = NULL;
+  int16_t *term_of = NULL;
+  uint16_t *mf_of = NULL;
+  uint8_t (*mu_tab)[256] = NULL;
+  uint32_t *set_off = NULL;
+  uint8_t *set = NULL;
+  int8_t *out = NULL;
+  int16_t remap[FUZZY_GRID_MAX_DIM][256];
+  uint16_t n_term[FUZZY_GRID_MAX_DIM] = {0}, n_used[FUZZY_GRID_MAX_DIM] = {0};
+  uint8_t xn[FUZZY_GRID_MAX_DIM];
+  uint8_t dim_of[256];
+  const fuzzy_mf_desc *m, *q;
+  const fuzzy_rule_ix *r;
+  size_t n_act;
+  uint32_t i, j, n_rule = 0, n_set = 0, base;
+  uint8_t n_dim = 0, all;
+  unsigned d, t;
+  fuzzy_status st = FUZZY_ERR_STRUCT;
+
+  if ((grid == NULL) || (model == NULL) || (model->mf == NULL))
+  {
+    return FUZZY_ERR_PARAM;
+  }
+  memset (grid, 0, sizeof (fuzzy_grid));
+  if ((model->flags & FUZZY_MODEL_FWD) || (model->n_out > 1) || (model->ts != NULL))
+  {
+    return FUZZY_ERR_STRUCT;
+  }
+  n_act = (size_t)model->n_mf + model->n_rule;
+  form = calloc (n_act, sizeof (grid_form));
+  term_of = malloc (model->n_mf * sizeof (int16_t));
+  mf_of = malloc ((size_t)FUZZY_GRID_MAX_DIM * 256 * sizeof (uint16_t));
+  if ((form == NULL) || (term_of == NULL) || (mf_of == NULL))
+  {
+    st = FUZZY_ERR_MEMORY;
+    goto exit;
+  }
+
+  /// термы: одинаковые функции входа - один терм
+  memset (dim_of, 0xFF, sizeof (dim_of));
+  for (i = 0; i < model->n_mf; i++)
+  {
+    m = &model->mf[i];
+    term_of[i] = -1;
+    if (m->shape == FS_NONE)
+    {
+      continue;                               // constant is not a term
+    }
+    if (dim_of[m->xn] == 0xFF)
+    {
+      if (n_dim == FUZZY_GRID_MAX_DIM)
+      {
+        goto exit;
+      }
+      xn[n_dim] = m->xn;
+      dim_of[m->xn] = n_dim++;
+    }
+    d = dim_of[m->xn];
+    for (t = 0; t < n_term[d]; t++)
+    {
+      q = &model->mf[mf_of[d * 256 + t]];
+      if ((q->shape == m->shape) && (q->a == m->a) && (q->b == m->b) && (q->c == m->c) &&
+          ((m->shape != FS_CUSTOM) || (model->func[mf_of[d * 256 + t]] == model->func[i])))
+      {
+        break;
+      }
+    }
+    if (t == n_term[d])
+    {
+      if (t == 256)
+      {
+        st = FUZZY_ERR_SIZE;
+        goto exit;
+      }
+      mf_of[d * 256 + n_term[d]++] = (uint16_t)i;
+    }
+    term_of[i] = (int16_t)t;
+    form[i].valid = true;
+    form[i].mask = (uint8_t)(1u << d);
+    form[i].set[d][t >> 6] = 1ull << (t & 63);
+  }
+
+  /// условия правил в порядке списка, конечные правила - полные
+  all = (uint8_t)((1u << n_dim) - 1u);
+  for (i = 0, r = model->rule; i < model->n_rule; i++, r++)
+  {
+    grid_combine (&form[model->n_mf + i], &form[r->a], &form[r->b], r->op);
+    if (r->fin)
+    {
+      if (!form[model->n_mf + i].valid || (form[model->n_mf + i].mask != all))
+      {
+        goto exit;
+      }
+      n_rule++;
+    }
+  }
+  if ((n_rule == 0) || (n_dim == 0))
+  {
+    goto exit;
+  }
+
+  /// только термы конечных правил, номера по порядку
+  memset (remap, 0xFF, sizeof (remap));
+  for (i = 0, r = model->rule; i < model->n_rule; i++, r++)
+  {
+    for (d = 0; r->fin && (d < n_dim); d++)
+    {
+      for (t = 0; t < n_term[d]; t++)
+      {
+        if ((form[model->n_mf + i].set[d][t >> 6] >> (t & 63)) & 1u)
+        {
+          n_set++;
+          remap[d][t] = 0;
+        }
+      }
+    }
+  }
+  for (d = 0; d < n_dim; d++)
+  {
+    for (t = 0; t < n_term[d]; t++)
+    {
+      if (remap[d][t] == 0)
+      {
+        remap[d][t] = (int16_t)n_used[d]++;
+      }
+    }
+  }
+
+  mu_tab = malloc ((size_t)n_dim * 256 * 256);
+  set_off = malloc (((size_t)n_rule * n_dim + 1) * sizeof (uint32_t));
+  set = malloc (n_set);
+  out = malloc (n_rule);
+  if ((mu_tab == NULL) || (set_off == NULL) || (set == NULL) || (out == NULL))
+  {
+    st = FUZZY_ERR_MEMORY;
+    goto exit;
+  }
+  for (d = 0, base = 0; d < n_dim; base += n_used[d++])
+  {
+    for (t = 0; t < n_term[d]; t++)
+    {
+      for (j = 0; (remap[d][t] >= 0) && (j < 256); j++)
+      {
+        mu_tab[base + remap[d][t]][j] = fuzzy_mf_eval (model, mf_of[d * 256 + t], (int8_t)j);
+      }
+    }
+  }
+  n_set = 0;
+  n_rule = 0;
+  for (i = 0, r = model->rule; i < model->n_rule; i++, r++)
+  {
+    if (!r->fin)
+    {
+      continue;
+    }
+    for (d = 0; d < n_dim; d++)
+    {
+      set_off[n_rule * n_dim + d] = n_set;
+      for (t = 0; t < n_term[d]; t++)
+      {
+        if ((form[model->n_mf + i].set[d][t >> 6] >> (t & 63)) & 1u)
+        {
+          set[n_set++] = (uint8_t)remap[d][t];
+        }
+      }
+    }
+    out[n_rule++] = r->out;
+  }
+  set_off[n_rule * n_dim] = n_set;
+  st = grid_build (grid, n_dim, xn, n_used, (const uint8_t (*)[256])mu_tab, n_rule, set_off, set, out);
+
+exit:
+  free (form);
+  free (term_of);
+  free (mf_of);
+  free (mu_tab);
+  free (set_off);
+  free (set);
+  free (out);
+  return st;
+}
+
+/*******************************************************************************
+* Таблица правил, заданная термами и таблицей следствий
+* \brief  Rule table given directly: term partitions per input and table of
+*         consequents, cell c = sum of term[d] * stride[d], the last input
+*         is the fastest index
+* \param[in]  n_dim   inputs of the table, up to FUZZY_GRID_MAX_DIM
+* \param[in]  xn      input number of every dimension [n_dim]
+* \param[in]  n_term  terms of every dimension [n_dim]
+* \param[in]  term    terms of all dimensions in order, shapes FS_NONE..FS_HIGH
+* \param[in]  table   output fuzzy value of every cell, FUZZY_GRID_EMPTY - no rule
+* \param[out] grid    table, free with fuzzy_grid_free
+* \return             FUZZY_OK or error status
+*******************************************************************************/
+fuzzy_status fuzzy_grid_table (uint8_t n_dim, const uint8_t *xn, const uint16_t *n_term,
+                               const fuzzy_mf_desc *term, const int8_t *table,
+                               fuzzy_grid *grid)
+{
+  uint8_t (*mu_tab)[256];
+  uint32_t *set_off;
+  uint8_t *set;
+  int8_t *out;
+  size_t n_cell = 1, n_mu = 0, c, rem, i;
+  uint32_t n_rule = 0;
+  unsigned d, x;
+  fuzzy_status st;
+
+  if ((grid == NULL) || (xn == NULL) || (n_term == NULL) || (term == NULL) || (table == NULL) ||
+      (n_dim == 0) || (n_dim > FUZZY_GRID_MAX_DIM))
+  {
+    return FUZZY_ERR_PARAM;
+  }
+  memset (grid, 0, sizeof (fuzzy_grid));
+  for (d = 0; d < n_dim; d++)
+  {
+    if ((n_term[d] == 0) || (n_term[d] > FUZZY_GRID_MAX_TERM) ||
+        ((n_cell *= n_term[d]) > FUZZY_GRID_MAX_CELL))
+    {
+      return FUZZY_ERR_SIZE;
+    }
+    n_mu += n_term[d];
+  }
+  for (i = 0; i < n_mu; i++)
+  {
+    if (term[i].shape >= FS_CUSTOM)
+    {
+      return FUZZY_ERR_PARAM;                 // no function pointer
+    }
+  }
+  for (c = 0; c < n_cell; c++)
+  {
+    n_rule += (table[c] != FUZZY_GRID_EMPTY);
+  }
+
+  mu_tab = malloc (n_mu * 256);
+  set_off = malloc (((size_t)n_rule * n_dim + 1) * sizeof (uint32_t));
+  set = malloc ((size_t)n_rule * n_dim + 1);
+  out = malloc ((size_t)n_rule + 1);
+  if ((mu_tab == NULL) || (set_off == NULL) || (set == NULL) || (out == NULL))
+  {
+    st = FUZZY_ERR_MEMORY;
+    goto exit;
+  }
+  for (i = 0; i < n_mu; i++)
+  {
+    for (x = 0; x < 256; x++)
+    {
+      mu_tab[i][x] = (term[i].shape == FS_NONE) ? term[i].y0 :
+                     fuzzy_shape_func[term[i].shape] ((int8_t)x, term[i].a, term[i].b, term[i].c);
+    }
+  }
+  /// правило ячейки: AND одного терма каждого входа
+  n_rule = 0;
+  for (c = 0; c < n_cell; c++)
+  {
+    if (table[c] == FUZZY_GRID_EMPTY)
+    {
+      continue;
+    }
+    for (d = n_dim, rem = c; d-- > 0; rem /= n_term[d])
+    {
+      set_off[n_rule * n_dim + d] = n_rule * n_dim + d;
+      set[n_rule * n_dim + d] = (uint8_t)(rem % n_term[d]);
+    }
+    out[n_rule++] = table[c];
+  }
+  set_off[n_rule * n_dim] = n_rule * n_dim;
+  st = grid_build (grid, n_dim, xn, n_term, (const uint8_t (*)[256])mu_tab, n_rule, set_off, set, out);
+
+exit:
+  free (mu_tab);
+  free (set_off);
+  free (set);
+  free (out);
+  return st;
+}
+
+/*******************************************************************************
+* Освобождение памяти таблицы
+* \brief  Free rule table memory
+* \param[in]  grid    rule table
+*******************************************************************************/
+void fuzzy_grid_free (fuzzy_grid *grid)
+{
+  if (grid)
+  {
+    free (grid->mem);
+    memset (grid, 0, sizeof (fuzzy_grid));
+  }
+}
+
+/// активация правила с OR термов: min по входам max по термам
+static uint8_t grid_alpha (const fuzzy_grid *grid, uint32_t r)
+{
+  const uint32_t *so = &grid->set_off[r * grid->n_dim];
+  uint8_t alpha = 255, m, y;
+  unsigned d;
+  uint32_t k;
+
+  for (d = 0; d < grid->n_dim; d++)
+  {
+    m = 0;
+    for (k = so[d]; k < so[d + 1]; k++)
+    {
+      y = grid->mu[grid->base[d] + grid->set[k]];
+      m = (y > m) ? y : m;
+    }
+    alpha = (m < alpha) ? m : alpha;
+  }
+  return alpha;
+}
+
+/*******************************************************************************
+* Нечеткий регулятор по таблице правил
+* \brief  Fuzzy logic controller by the rule table: only cells of active
+*         terms are visited, every rule once per call. Bit-identical to
+*         process_fuzzy_logic_compiled of the source model
+* \param[in]  grid      rule table
+* \param[in]  in_array  input values array
+* \return               output control value
+*******************************************************************************/
+int8_t process_fuzzy_logic_grid (fuzzy_grid *grid, const int8_t *in_array)
+{
+  const fuzzy_grid_act *a[FUZZY_GRID_MAX_DIM], *e[FUZZY_GRID_MAX_DIM], *p[FUZZY_GRID_MAX_DIM];
+  const fuzzy_grid_act *s;
+  int16_t summ_alpha_c = 0;
+  int16_t summ_alpha = 0;
+  int16_t ret;
+  uint32_t c, k, r, n_visit = 0, n_cell = 0;
+  uint8_t alpha, m;
+  unsigned d, n_dim = grid->n_dim;
+
+  /// активные термы; нет ни одного на входе - ни одно правило не активно
+  for (d = 0; d < n_dim; d++)
+  {
+    k = (uint8_t)in_array[grid->xn[d]];
+    a[d] = p[d] = grid->act + grid->act_off[d][k];
+    e[d] = grid->act + grid->act_off[d][k + 1];
+    if (a[d] == e[d])
+    {
+      grid->n_visit = grid->n_cell_visit = 0;
+      return 0;
+    }
+  }
+  if (++grid->gen == 0)
+  {
+    memset (grid->stamp, 0, grid->n_rule * sizeof (uint32_t));
+    grid->gen = 1;
+  }
+  for (d = 0; d < n_dim; d++)
+  {
+    for (s = a[d]; s < e[d]; s++)
+    {
+      grid->mu[grid->base[d] + s->term] = s->mu;
+    }
+  }
+
+  /// ячейки произведения активных термов
+  do
+  {
+    c = 0;
+    m = 255;
+    for (d = 0; d < n_dim; d++)
+    {
+      c += p[d]->term * grid->stride[d];
+      m = (p[d]->mu < m) ? p[d]->mu : m;
+    }
+    n_cell++;
+    for (k = grid->cell_off[c]; k < grid->cell_off[c + 1]; k++)
+    {
+      r = grid->cell_rule[k];
+      if (grid->stamp[r] == grid->gen)
+      {
+        continue;
+      }
+      grid->stamp[r] = grid->gen;
+      n_visit++;
+      alpha = grid->single[r] ? m : grid_alpha (grid, r);
+      summ_alpha_c += (alpha * (int16_t)grid->out[r]);
+      summ_alpha += alpha;
+    }
+    for (d = n_dim; d-- > 0; )
+    {
+      if (++p[d] < e[d])
+      {
+        break;
+      }
+      p[d] = a[d];
+    }
+  } while (d < n_dim);
+
+  for (d = 0; d < n_dim; d++)
+  {
+    for (s = a[d]; s < e[d]; s++)
+    {
+      grid->mu[grid->base[d] + s->term] = 0;
+    }
+  }
+  grid->n_visit = n_visit;
+  grid->n_cell_visit = n_cell;
+
+  if (summ_alpha == 0)
+  {
+    ret = 0;
+  }
+  else
+  {
+    ret = summ_alpha_c / summ_alpha;
+  }
+  return lim_s8 (ret);
+}
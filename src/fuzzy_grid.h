@@ -0,0 +1,103 @@
+/*******************************************************************************
+* \file     fuzzy_grid.h
+* \author   Ilya Petrukhin (ilya.petrukhin@gmail.com)
+* \brief    Rule table (Sugeno matrix) of the fuzzy controller: term
+*           partitions per input and table of consequents
+* \version  2.1
+* \date     2026-10-17
+*******************************************************************************/
+
+#ifndef _FUZZY_GRID_H_
+#define _FUZZY_GRID_H_
+
+#include  <stdint.h>
+#include  <stdbool.h>
+#include  "fuzzy_logic.h"
+#include  "fuzzy_model.h"
+
+/*******************************************************************************
+* Rules to using rule table
+*******************************************************************************/
+// 1. Rule table from the compiled model, when the rules allow it:
+//  fuzzy_grid grid;
+//  if (fuzzy_grid_init (&model, &grid) == FUZZY_OK)
+//  {
+//    int8_t temp = process_fuzzy_logic_grid (&grid, in);
+//    printf ("%u cells, %u rules visited\n", grid.n_cell_visit, grid.n_visit);
+//  }
+//  fuzzy_grid_free (&grid);
+// FUZZY_ERR_STRUCT - the rules are not a table, use other engines.
+//
+// Every final rule has to be AND of inputs, every input of the model in
+// the rule once, input condition - a term or OR of terms of this input:
+//  IF d_r2 AND (t_zero OR t_r1 OR t_r2) THEN TURN_H_LEFT
+// F_A / F_B and intermediate rules are followed; NOT, IMP, FALSE, OR of
+// different inputs, AND of different terms of one input - not a table.
+// Up to FUZZY_GRID_MAX_DIM inputs, FUZZY_GRID_MAX_TERM terms per input,
+// one output only, FUZZY_MODEL_FWD models are not tables.
+//
+// 2. Rule table given directly: terms of every input and the table of
+// consequents, the last input is the fastest index of the table,
+// FUZZY_GRID_EMPTY - cell without rule:
+//  static const uint8_t xn[2] = { 0, 1 };
+//  static const uint16_t n_term[2] = { 5, 5 };
+//  static const fuzzy_mf_desc term[10] = { { FS_TRIANGLE, 0, -60, 40, 0 }, ... };
+//  static const int8_t table[5][5] = { ... };
+//  fuzzy_grid_table (2, xn, n_term, term, &table[0][0], &grid);
+//
+// Evaluation: active terms of every input with their activations are taken
+// from per-input lists indexed by x (built once), only cells of active
+// terms are visited (usually 2 x 2), rules of the cell are evaluated once
+// per call. Cost depends on the overlap of the terms, not on the table
+// size. Result is bit-identical to process_fuzzy_logic_compiled.
+// FS_CUSTOM functions have to depend only on x and parameters.
+// One state per caller (thread), the model is not needed after init.
+// ***************** end of the brief *****************************************
+
+#define FUZZY_GRID_MAX_DIM    (4)           ///< max inputs of the table
+#define FUZZY_GRID_MAX_TERM   (255)         ///< max terms of one input
+#define FUZZY_GRID_MAX_CELL   (1u << 20)    ///< max cells of the table
+#define FUZZY_GRID_EMPTY      (INT8_MIN)    ///< table cell without rule
+
+/// Active term of the input value
+typedef struct
+{
+  uint8_t   term;       ///< term number of the input
+  uint8_t   mu;         ///< activation 1..255
+} fuzzy_grid_act;
+
+/// Rule table and evaluation state
+typedef struct
+{
+  uint8_t               n_dim;                      ///< inputs of the table
+  uint8_t               xn[FUZZY_GRID_MAX_DIM];     ///< input number of the dimension
+  uint16_t              n_term[FUZZY_GRID_MAX_DIM]; ///< terms of the dimension
+  uint16_t              base[FUZZY_GRID_MAX_DIM];   ///< first term of the dimension in mu
+  uint32_t              stride[FUZZY_GRID_MAX_DIM]; ///< cell index step of the dimension
+  uint32_t              n_cell;     ///< cells of the table
+  uint32_t              n_rule;     ///< rules of the table
+  const uint32_t        (*act_off)[257];  ///< active terms of dimension d, value x: act[act_off[d][(uint8_t)x]..]
+  const fuzzy_grid_act  *act;       ///< active terms grouped by dimension and value
+  const uint32_t        *cell_off;  ///< rules of cell c: cell_rule[cell_off[c]..cell_off[c + 1])
+  const uint32_t        *cell_rule; ///< rule numbers grouped by cell
+  const uint32_t        *set_off;   ///< terms of rule r, dimension d: set[set_off[r * n_dim + d]..]
+  const uint8_t         *set;       ///< term numbers of the rule conditions
+  const uint8_t         *single;    ///< 1 - one term per input, activation is min of the cell
+  const int8_t          *out;       ///< output fuzzy value of the rule [n_rule]
+  uint8_t               *mu;        ///< term activations, zero outside call
+  uint32_t              *stamp;     ///< call number of the last visit of the rule
+  uint32_t              gen;        ///< call number
+  uint32_t              n_visit;    ///< rules visited by the last call
+  uint32_t              n_cell_visit; ///< cells visited by the last call
+  void                  *mem;       ///< owned memory block
+} fuzzy_grid;
+
+fuzzy_status fuzzy_grid_init (const fuzzy_model *model, fuzzy_grid *grid);   ///< table of the rules
+fuzzy_status fuzzy_grid_table (uint8_t n_dim, const uint8_t *xn, const uint16_t *n_term,
+                               const fuzzy_mf_desc *term, const int8_t *table,
+                               fuzzy_grid *grid);                           ///< table given directly
+void         fuzzy_grid_free (fuzzy_grid *grid);                            ///< free table memory
+
+int8_t process_fuzzy_logic_grid (fuzzy_grid *grid, const int8_t *in_array);
+
+#endif  // _FUZZY_GRID_H_
@@ -0,0 +1,483 @@
+/*******************************************************************************
+* \file     fuzzy_image.c
+* \author   Ilya Petrukhin (ilya.petrukhin@gmail.com)
+* \brief    This file provides code for saving the compiled fuzzy model
+*           as binary image and using the image in place
+* \version  2.1
+* \date     2026-10-17
+*******************************************************************************/
+#include  <stdio.h>
+#include  <stdint.h>
+#include  <stdbool.h>
+#include  <stdlib.h>
+#include  <string.h>
+#include  <stddef.h>
+#include  "fuzzy_logic.h"
+#include  "fuzzy_model.h"
+#include  "fuzzy_bake.h"
+#include  "fuzzy_image.h"
+
+#if defined (_WIN32)
+#include  <windows.h>
+#else
+#include  <fcntl.h>
+#include  <unistd.h>
+#include  <sys/mman.h>
+#include  <sys/stat.h>
+#endif
+
+#define ALIGN_UP(x, a)  (((x) + ((a) - 1)) & ~((size_t)(a) - 1))
+
+#define IMAGE_ALIGN     (8u)          ///< section alignment
+#define IMAGE_SUM_FROM  (offsetof (fuzzy_image_hdr, checksum) + sizeof (uint32_t))
+
+
+/*******************************************************************************
+* контрольная сумма FNV-1a
+*******************************************************************************/
+static uint32_t image_checksum (const uint8_t *p, size_t n)
+{
+  uint32_t h = 2166136261u;
+
+  while (n--)
+  {
+    h = (h ^ *p++) * 16777619u;
+  }
+  return h;
+}
+
+/*******************************************************************************
+* секция [off, off + len) внутри образа и выровнена
+*******************************************************************************/
+static bool image_section (const fuzzy_image_hdr *h, uint32_t off, size_t len)
+{
+  return (off >= sizeof (fuzzy_image_hdr)) && ((off % IMAGE_ALIGN) == 0) &&
+         (len <= h->size) && (off <= h->size - len);
+}
+
+/*******************************************************************************
+* индексы функций, правил и следствий в пределах модели
+*******************************************************************************/
+static bool image_indexes (const fuzzy_model *m, uint32_t n_cq)
+{
+  uint32_t n_act = (uint32_t)m->n_mf + m->n_rule;
+  uint32_t i;
+
+  for (i = 0; i < m->n_mf; i++)
+  {
+    if ((m->mf[i].shape >= FS_CUSTOM) || (m->mf[i].xn >= m->n_in) ||
+        ((m->mf[i].lut != FUZZY_NO_LUT) && (m->mf[i].lut >= m->n_lut)))
+    {
+      return false;
+    }
+  }
+  for (i = 0; i < m->n_rule; i++)
+  {
+    if ((m->rule[i].a >= n_act) || (m->rule[i].b >= n_act) ||
+        ((m->cq_off != NULL) && (m->cq_off[i] > m->cq_off[i + 1])))
+    {
+      return false;
+    }
+  }
+  if ((m->cq_off != NULL) && ((m->cq_off[0] != 0) || (m->cq_off[m->n_rule] != n_cq)))
+  {
+    return false;
+  }
+  for (i = 0; (m->cq != NULL) && (i < n_cq); i++)
+  {
+    if (m->cq[i].on >= m->n_out)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+/*******************************************************************************
+* Образ модели в памяти
+* \brief  Build binary image of the compiled model
+* \param[in]  model     compiled model without FS_CUSTOM functions
+* \param[in]  surface   baked surface to keep in the image or NULL
+* \param[in]  opt       FUZZY_IMAGE_LUT - lookup tables of all functions
+* \param[out] image     image, free by caller
+* \param[out] size      image size
+* \return               FUZZY_OK, FUZZY_ERR_PARAM, FUZZY_ERR_SIZE, FUZZY_ERR_MEMORY,
+*                       FUZZY_ERR_STRUCT for first-order consequents
+*******************************************************************************/
+fuzzy_status fuzzy_image_build (const fuzzy_model *model, const fuzzy_surface *surface,
+                                uint32_t opt, void **image, size_t *size)
+{
+  fuzzy_image_hdr *h;
+  fuzzy_mf_desc *mf;
+  uint8_t (*lut)[256];
+  uint8_t *mem;
+  size_t n_act, n_cq = 0, n_lut = 0, off, total;
+  size_t off_mf, off_rule, off_cq_off = 0, off_cq = 0, off_lut = 0, off_act0, off_surface = 0;
+  uint16_t i;
+  int16_t x;
+
+  if ((model == NULL) || (model->mf == NULL) || (image == NULL) || (size == NULL) ||
+      ((surface != NULL) && (model->n_in > 2)))
+  {
+    return FUZZY_ERR_PARAM;
+  }
+  if (model->ts != NULL)
+  {
+    return FUZZY_ERR_STRUCT;              // image format has no first-order consequents
+  }
+  for (i = 0; i < model->n_mf; i++)
+  {
+    if (model->mf[i].shape == FS_CUSTOM)
+    {
+      return FUZZY_ERR_PARAM;
+    }
+    n_lut += (opt & FUZZY_IMAGE_LUT) ? (model->mf[i].shape != FS_NONE) : 0;
+  }
+  n_lut = (opt & FUZZY_IMAGE_LUT) ? n_lut : model->n_lut;
+  n_act = (size_t)model->n_mf + model->n_rule;
+  if (model->cq_off != NULL)
+  {
+    n_cq = model->cq_off[model->n_rule];
+  }
+
+  /// секции по порядку, каждая с выравниванием
+  off = ALIGN_UP (sizeof (fuzzy_image_hdr), IMAGE_ALIGN);
+  off_mf = off;
+  off = ALIGN_UP (off + model->n_mf * sizeof (fuzzy_mf_desc), IMAGE_ALIGN);
+  off_rule = off;
+  off = ALIGN_UP (off + model->n_rule * sizeof (fuzzy_rule_ix), IMAGE_ALIGN);
+  if (model->cq_off != NULL)
+  {
+    off_cq_off = off;
+    off = ALIGN_UP (off + ((size_t)model->n_rule + 1) * sizeof (uint32_t), IMAGE_ALIGN);
+    off_cq = off;
+    off = ALIGN_UP (off + n_cq * sizeof (fuzzy_conseq), IMAGE_ALIGN);
+  }
+  if (n_lut != 0)
+  {
+    off_lut = off;
+    off += n_lut * 256;
+  }
+  off_act0 = off;
+  off = ALIGN_UP (off + n_act, IMAGE_ALIGN);
+  if (surface != NULL)
+  {
+    off_surface = off;
+    off = ALIGN_UP (off + sizeof (fuzzy_surface), IMAGE_ALIGN);
+  }
+  total = off;
+  if (total > UINT32_MAX)
+  {
+    return FUZZY_ERR_SIZE;
+  }
+  mem = calloc (1, total);
+  if (mem == NULL)
+  {
+    return FUZZY_ERR_MEMORY;
+  }
+
+  h = (fuzzy_image_hdr *)mem;
+  h->magic       = FUZZY_IMAGE_MAGIC;
+  h->version     = FUZZY_IMAGE_VERSION;
+  h->hdr_size    = sizeof (fuzzy_image_hdr);
+  h->order       = FUZZY_IMAGE_ORDER;
+  h->size        = (uint32_t)total;
+  h->mf_size     = sizeof (fuzzy_mf_desc);
+  h->rule_size   = sizeof (fuzzy_rule_ix);
+  h->n_in        = model->n_in;
+  h->n_mf        = model->n_mf;
+  h->n_rule      = model->n_rule;
+  h->n_lut       = (uint16_t)n_lut;
+  h->flags       = model->flags;
+  h->n_out       = model->n_out;
+  h->n_cq        = (uint32_t)n_cq;
+  h->off_mf      = (uint32_t)off_mf;
+  h->off_rule    = (uint32_t)off_rule;
+  h->off_cq_off  = (uint32_t)off_cq_off;
+  h->off_cq      = (uint32_t)off_cq;
+  h->off_lut     = (uint32_t)off_lut;
+  h->off_act0    = (uint32_t)off_act0;
+  h->off_surface = (uint32_t)off_surface;
+
+  mf = (fuzzy_mf_desc *)(mem + off_mf);
+  memcpy (mf, model->mf, model->n_mf * sizeof (fuzzy_mf_desc));
+  memcpy (mem + off_rule, model->rule, model->n_rule * sizeof (fuzzy_rule_ix));
+  if (model->cq_off != NULL)
+  {
+    memcpy (mem + off_cq_off, model->cq_off, ((size_t)model->n_rule + 1) * sizeof (uint32_t));
+    memcpy (mem + off_cq, model->cq, n_cq * sizeof (fuzzy_conseq));
+  }
+  lut = (uint8_t (*)[256])(mem + off_lut);
+  if (opt & FUZZY_IMAGE_LUT)
+  {
+    /// таблица каждой функции на всём диапазоне входа
+    for (i = 0, n_lut = 0; i < model->n_mf; i++)
+    {
+      mf[i].lut = FUZZY_NO_LUT;
+      if (mf[i].shape != FS_NONE)
+      {
+        for (x = -128; x < 128; x++)
+        {
+          lut[n_lut][(uint8_t)x] = fuzzy_mf_eval (model, i, (int8_t)x);
+        }
+        mf[i].lut = (uint16_t)n_lut++;
+      }
+    }
+  }
+  else if (n_lut != 0)
+  {
+    memcpy (lut, model->lut, n_lut * 256);
+  }
+  memcpy (mem + off_act0, model->act0, n_act);
+  if (surface != NULL)
+  {
+    memcpy (mem + off_surface, surface, sizeof (fuzzy_surface));
+  }
+  h->checksum = image_checksum (mem + IMAGE_SUM_FROM, total - IMAGE_SUM_FROM);
+
+  *image = mem;
+  *size = total;
+  return FUZZY_OK;
+}
+
+/*******************************************************************************
+* Запись образа модели в файл
+* \brief  Save binary image of the compiled model, see fuzzy_image_build
+* \param[in]  model     compiled model
+* \param[in]  surface   baked surface or NULL
+* \param[in]  opt       FUZZY_IMAGE_xxx options
+* \param[in]  path      file name
+* \return               FUZZY_OK, FUZZY_ERR_FILE or fuzzy_image_build status
+*******************************************************************************/
+fuzzy_status fuzzy_image_save (const fuzzy_model *model, const fuzzy_surface *surface,
+                               uint32_t opt, const char *path)
+{
+  fuzzy_status ret;
+  void *image;
+  size_t size;
+  FILE *f;
+
+  if (path == NULL)
+  {
+    return FUZZY_ERR_PARAM;
+  }
+  ret = fuzzy_image_build (model, surface, opt, &image, &size);
+  if (ret != FUZZY_OK)
+  {
+    return ret;
+  }
+  f = fopen (path, "wb");
+  if (f == NULL)
+  {
+    free (image);
+    return FUZZY_ERR_FILE;
+  }
+  if (fwrite (image, 1, size, f) != size)
+  {
+    ret = FUZZY_ERR_FILE;
+  }
+  if (fclose (f) != 0)
+  {
+    ret = FUZZY_ERR_FILE;
+  }
+  free (image);
+  return ret;
+}
+
+/*******************************************************************************
+* Модель из образа без копирования
+* \brief  Check image header, section bounds and indexes of functions,
+*         rules and consequents (one pass, no allocation), set model
+*         pointers into the image
+* \param[in]  base    image, aligned to 8 bytes, must outlive the model
+* \param[in]  size    bytes available at base
+* \param[out] img     opened image
+* \return             FUZZY_OK, FUZZY_ERR_PARAM, FUZZY_ERR_IMAGE
+*******************************************************************************/
+fuzzy_status fuzzy_image_open (const void *base, size_t size, fuzzy_image *img)
+{
+  const fuzzy_image_hdr *h = base;
+  const uint8_t *p = base;
+  fuzzy_model *m;
+  size_t n_act;
+
+  if ((base == NULL) || (img == NULL) || (((uintptr_t)base % IMAGE_ALIGN) != 0))
+  {
+    return FUZZY_ERR_PARAM;
+  }
+  memset (img, 0, sizeof (fuzzy_image));
+  if ((size < sizeof (fuzzy_image_hdr)) || (h->magic != FUZZY_IMAGE_MAGIC) ||
+      (h->version != FUZZY_IMAGE_VERSION) || (h->hdr_size != sizeof (fuzzy_image_hdr)) ||
+      (h->order != FUZZY_IMAGE_ORDER) || (h->size > size) ||
+      (h->mf_size != sizeof (fuzzy_mf_desc)) || (h->rule_size != sizeof (fuzzy_rule_ix)) ||
+      (h->n_mf == 0) || (h->n_rule == 0) || (h->n_out == 0) || (h->n_out > FUZZY_MAX_OUT))
+  {
+    return FUZZY_ERR_IMAGE;
+  }
+  n_act = (size_t)h->n_mf + h->n_rule;
+  if (!image_section (h, h->off_mf, h->n_mf * sizeof (fuzzy_mf_desc)) ||
+      !image_section (h, h->off_rule, h->n_rule * sizeof (fuzzy_rule_ix)) ||
+      !image_section (h, h->off_act0, n_act) ||
+      ((h->off_cq_off != 0) &&
+       (!image_section (h, h->off_cq_off, ((size_t)h->n_rule + 1) * sizeof (uint32_t)) ||
+        !image_section (h, h->off_cq, h->n_cq * sizeof (fuzzy_conseq)))) ||
+      ((h->n_lut != 0) && !image_section (h, h->off_lut, (size_t)h->n_lut * 256)) ||
+      ((h->off_surface != 0) && !image_section (h, h->off_surface, sizeof (fuzzy_surface))))
+  {
+    return FUZZY_ERR_IMAGE;
+  }
+
+  m = &img->model;
+  m->n_in   = h->n_in;
+  m->n_mf   = h->n_mf;
+  m->n_rule = h->n_rule;
+  m->n_lut  = h->n_lut;
+  m->flags  = h->flags;
+  m->n_out  = h->n_out;
+  m->mf     = (const fuzzy_mf_desc *)(p + h->off_mf);
+  m->rule   = (const fuzzy_rule_ix *)(p + h->off_rule);
+  m->cq_off = (h->off_cq_off != 0) ? (const uint32_t *)(p + h->off_cq_off) : NULL;
+  m->cq     = (h->off_cq_off != 0) ? (const fuzzy_conseq *)(p + h->off_cq) : NULL;
+  m->lut    = (h->n_lut != 0) ? (const uint8_t (*)[256])(p + h->off_lut) : NULL;
+  m->act0   = p + h->off_act0;
+  if (!image_indexes (m, h->n_cq))
+  {
+    memset (img, 0, sizeof (fuzzy_image));
+    return FUZZY_ERR_IMAGE;
+  }
+  img->surface = (h->off_surface != 0) ? (const fuzzy_surface *)(p + h->off_surface) : NULL;
+  img->base = base;
+  img->size = h->size;
+  return FUZZY_OK;
+}
+
+/*******************************************************************************
+* Проверка образа
+* \brief  Open the image and check the checksum, reads the whole image
+* \param[in]  base    image
+* \param[in]  size    bytes available at base
+* \return             FUZZY_OK, FUZZY_ERR_PARAM, FUZZY_ERR_IMAGE
+*******************************************************************************/
+fuzzy_status fuzzy_image_verify (const void *base, size_t size)
+{
+  const fuzzy_image_hdr *h = base;
+  fuzzy_image img;
+  fuzzy_status ret;
+
+  ret = fuzzy_image_open (base, size, &img);
+  if (ret != FUZZY_OK)
+  {
+    return ret;
+  }
+  if (image_checksum ((const uint8_t *)base + IMAGE_SUM_FROM, h->size - IMAGE_SUM_FROM) != h->checksum)
+  {
+    return FUZZY_ERR_IMAGE;
+  }
+  return FUZZY_OK;
+}
+
+/*******************************************************************************
+* Отображение файла образа в память
+* \brief  Map image file read only and open it in place
+* \param[in]  path    file name
+* \param[out] img     opened image, close with fuzzy_image_unmap
+* \return             FUZZY_OK, FUZZY_ERR_FILE or fuzzy_image_open status
+*******************************************************************************/
+fuzzy_status fuzzy_image_map (const char *path, fuzzy_image *img)
+{
+  fuzzy_status ret;
+  void *view;
+  size_t size;
+
+  if ((path == NULL) || (img == NULL))
+  {
+    return FUZZY_ERR_PARAM;
+  }
+  memset (img, 0, sizeof (fuzzy_image));
+#if defined (_WIN32)
+  {
+    HANDLE file, mapping;
+    LARGE_INTEGER len;
+
+    file = CreateFileA (path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                        FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+      return FUZZY_ERR_FILE;
+    }
+    if (!GetFileSizeEx (file, &len) || (len.QuadPart == 0))
+    {
+      CloseHandle (file);
+      return FUZZY_ERR_FILE;
+    }
+    size = (size_t)len.QuadPart;
+    mapping = CreateFileMappingA (file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle (file);
+    if (mapping == NULL)
+    {
+      return FUZZY_ERR_FILE;
+    }
+    view = MapViewOfFile (mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle (mapping);
+    if (view == NULL)
+    {
+      return FUZZY_ERR_FILE;
+    }
+  }
+#else
+  {
+    struct stat st;
+    int fd;
+
+    fd = open (path, O_RDONLY);
+    if (fd < 0)
+    {
+      return FUZZY_ERR_FILE;
+    }
+    if ((fstat (fd, &st) != 0) || (st.st_size <= 0))
+    {
+      close (fd);
+      return FUZZY_ERR_FILE;
+    }
+    size = (size_t)st.st_size;
+    view = mmap (NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close (fd);
+    if (view == MAP_FAILED)
+    {
+      return FUZZY_ERR_FILE;
+    }
+  }
+#endif
+
+  ret = fuzzy_image_open (view, size, img);
+  if (ret != FUZZY_OK)
+  {
+#if defined (_WIN32)
+    UnmapViewOfFile (view);
+#else
+    munmap (view, size);
+#endif
+    return ret;
+  }
+  img->map = view;
+  img->size = size;
+  return FUZZY_OK;
+}
+
+/*******************************************************************************
+* Закрытие отображения файла образа
+* \brief  Unmap image file mapped by fuzzy_image_map
+* \param[in]  img     image
+*******************************************************************************/
+void fuzzy_image_unmap (fuzzy_image *img)
+{
+  if (img && img->map)
+  {
+#if defined (_WIN32)
+    UnmapViewOfFile (img->map);
+#else
+    munmap (img->map, img->size);
+#endif
+    memset (img, 0, sizeof (fuzzy_image));
+  }
+}
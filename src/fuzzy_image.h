@@ -0,0 +1,109 @@
+/*******************************************************************************
+* \file     fuzzy_image.h
+* \author   Ilya Petrukhin (ilya.petrukhin@gmail.com)
+* \brief    Binary image of the compiled fuzzy model, used in place
+* \version  2.1
+* \date     2026-10-17
+*******************************************************************************/
+
+#ifndef _FUZZY_IMAGE_H_
+#define _FUZZY_IMAGE_H_
+
+#include  <stdint.h>
+#include  <stdbool.h>
+#include  <stddef.h>
+#include  "fuzzy_logic.h"
+#include  "fuzzy_model.h"
+#include  "fuzzy_bake.h"
+
+/*******************************************************************************
+* Rules to using binary image
+*******************************************************************************/
+// 1. Compile the model once and save the image, option with lookup tables
+// of all functions and the baked surface of two-input controller:
+//  fuzzy_bake (&model, &surface);
+//  fuzzy_image_save (&model, &surface, FUZZY_IMAGE_LUT, "line.fzim");
+//
+// 2. At startup map the file (mmap / MapViewOfFile, read only) and use
+// the model in place, open checks the header, the section bounds and every
+// index of functions, rules and consequents (one pass, no allocation), so
+// a corrupt image is refused before an engine reads it:
+//  fuzzy_image img;
+//  if (fuzzy_image_map ("line.fzim", &img) != FUZZY_OK)
+//  {
+//    error...
+//  }
+//  int8_t temp = process_fuzzy_logic_ws (&img.model, in, ws);
+//  int8_t temp = fuzzy_surface_eval (img.surface, in[0], in[1]);  // if saved
+//  fuzzy_image_unmap (&img);
+// Image in memory (flash, shared memory) is opened by fuzzy_image_open,
+// the base has to be aligned to 8 bytes. The model of the image has no
+// default workspace: engines with caller workspace only (process_fuzzy_logic_ws,
+// batch, incremental, sparse ...). fuzzy_image_verify checks the checksum
+// also, it reads the whole image.
+// Lookup tables of FUZZY_IMAGE_LUT are used by every build: a function with
+// a table is evaluated by one indexed load, also without FUZZY_LUT_MASK.
+//
+// Layout: header fuzzy_image_hdr, then sections at 8-byte aligned offsets
+// from the image base: fuzzy_mf_desc[n_mf], fuzzy_rule_ix[n_rule],
+// uint32_t cq_off[n_rule + 1] and fuzzy_conseq[n_cq] of several outputs,
+// uint8_t lut[n_lut][256], uint8_t act0[n_mf + n_rule], fuzzy_surface.
+// Offset 0 - no section. Structures are stored as in memory, the image is
+// valid on the machine with the same byte order and structure sizes.
+// Models with FS_CUSTOM functions can not be saved (function pointers).
+// ***************** end of the brief *****************************************
+
+#define FUZZY_IMAGE_MAGIC     (0x4D495A46u)   ///< "FZIM"
+#define FUZZY_IMAGE_VERSION   (1)             ///< format version
+#define FUZZY_IMAGE_ORDER     (0x01020304u)   ///< byte order mark
+
+#define FUZZY_IMAGE_LUT       (0x01u)         ///< save option: lookup tables of all functions
+
+/// Image header
+typedef struct
+{
+  uint32_t  magic;        ///< FUZZY_IMAGE_MAGIC
+  uint16_t  version;      ///< FUZZY_IMAGE_VERSION
+  uint16_t  hdr_size;     ///< sizeof (fuzzy_image_hdr)
+  uint32_t  order;        ///< FUZZY_IMAGE_ORDER in the machine byte order
+  uint32_t  size;         ///< image size, bytes
+  uint32_t  checksum;     ///< FNV-1a of the image after this field
+  uint8_t   mf_size;      ///< sizeof (fuzzy_mf_desc)
+  uint8_t   rule_size;    ///< sizeof (fuzzy_rule_ix)
+  uint16_t  n_in;         ///< model fields
+  uint16_t  n_mf;
+  uint16_t  n_rule;
+  uint16_t  n_lut;
+  uint16_t  flags;
+  uint16_t  n_out;
+  uint16_t  reserved;
+  uint32_t  n_cq;         ///< consequents of several outputs
+  uint32_t  off_mf;       ///< section offsets from the image base
+  uint32_t  off_rule;
+  uint32_t  off_cq_off;
+  uint32_t  off_cq;
+  uint32_t  off_lut;
+  uint32_t  off_act0;
+  uint32_t  off_surface;
+} fuzzy_image_hdr;
+
+/// Opened image
+typedef struct
+{
+  fuzzy_model         model;      ///< model, pointers into the image
+  const fuzzy_surface *surface;   ///< baked surface or NULL
+  const void          *base;      ///< image
+  size_t              size;       ///< image size
+  void                *map;       ///< mapping of fuzzy_image_map
+} fuzzy_image;
+
+fuzzy_status fuzzy_image_build (const fuzzy_model *model, const fuzzy_surface *surface,
+                                uint32_t opt, void **image, size_t *size);   ///< image in memory
+fuzzy_status fuzzy_image_save (const fuzzy_model *model, const fuzzy_surface *surface,
+                               uint32_t opt, const char *path);             ///< image file
+fuzzy_status fuzzy_image_open (const void *base, size_t size, fuzzy_image *img);  ///< use image in place
+fuzzy_status fuzzy_image_verify (const void *base, size_t size);           ///< check the checksum
+fuzzy_status fuzzy_image_map (const char *path, fuzzy_image *img);          ///< map image file
+void         fuzzy_image_unmap (fuzzy_image *img);                          ///< unmap image file
+
+#endif  // _FUZZY_IMAGE_H_
@@ -0,0 +1,276 @@
+/*******************************************************************************
+* \file     fuzzy_incr.c
+* \author   Ilya Petrukhin (ilya.petrukhin@gmail.com)
+* \brief    This file provides code for incremental evaluation of the
+*           compiled fuzzy model driven by changed inputs
+* \version  2.1
+* \date     2026-10-17
+*******************************************************************************/
+#include  <stdio.h>
+#include  <stdint.h>
+#include  <stdbool.h>
+#include  <stdlib.h>
+#include  <string.h>
+#include  "fuzzy_logic.h"
+#include  "fuzzy_model.h"
+#include  "fuzzy_incr.h"
+
+#define ALIGN_UP(x, a)  (((x) + ((a) - 1)) & ~((size_t)(a) - 1))
+
+
+/*******************************************************************************
+* Построение графа зависимостей и состояния
+* \brief  Build dependency graph input -> fuzzy functions -> rules
+*         (CSR arrays) and incremental evaluation state
+* \param[in]  model   compiled model, must outlive the state
+* \param[out] inc     state, free with fuzzy_incr_free
+* \return             FUZZY_OK or error status
+*******************************************************************************/
+fuzzy_status fuzzy_incr_init (const fuzzy_model *model, fuzzy_incr *inc)
+{
+  uint16_t *in_off, *in_mf, *dep;
+  uint32_t *dep_off;
+  size_t n_in, n_mf, n_rule, n_act, n_dep, i;
+  size_t off_dep_off, off_in_off, off_in_mf, off_dep, off_act, off_dirty, off_in, size;
+  uint8_t *mem;
+
+  if ((model == NULL) || (inc == NULL) || (model->mf == NULL))
+  {
+    return FUZZY_ERR_PARAM;
+  }
+  if (model->ts != NULL)
+  {
+    return FUZZY_ERR_STRUCT;              // outputs depend on inputs
+  }
+  memset (inc, 0, sizeof (fuzzy_incr));
+  n_in = model->n_in;
+  n_mf = model->n_mf;
+  n_rule = model->n_rule;
+  n_act = n_mf + n_rule;
+  n_dep = fuzzy_dep_count (model);
+
+  /// один блок памяти: смещения, списки, активации, флаги, входы
+  off_dep_off = 0;
+  off_in_off  = off_dep_off + (n_act + 1) * sizeof (uint32_t);
+  off_in_mf   = off_in_off + (n_in + 1) * sizeof (uint16_t);
+  off_dep     = off_in_mf + n_mf * sizeof (uint16_t);
+  off_act     = off_dep + n_dep * sizeof (uint16_t);
+  off_dirty   = off_act + n_act;
+  off_in      = off_dirty + n_rule;
+  size        = ALIGN_UP (off_in + n_in, sizeof (void *));
+  mem = calloc (1, size);
+  if (mem == NULL)
+  {
+    return FUZZY_ERR_MEMORY;
+  }
+  dep_off = (uint32_t *)(mem + off_dep_off);
+  in_off  = (uint16_t *)(mem + off_in_off);
+  in_mf   = (uint16_t *)(mem + off_in_mf);
+  dep     = (uint16_t *)(mem + off_dep);
+
+  /// вход -> функции фуззификации: подсчёт, смещения, заполнение
+  for (i = 0; i < n_mf; i++)
+  {
+    in_off[model->mf[i].xn + 1]++;
+  }
+  for (i = 0; i < n_in; i++)
+  {
+    in_off[i + 1] += in_off[i];
+  }
+  for (i = 0; i < n_mf; i++)
+  {
+    in_mf[in_off[model->mf[i].xn]++] = (uint16_t)i;
+  }
+  for (i = n_in; i > 0; i--)
+  {
+    in_off[i] = in_off[i - 1];
+  }
+  in_off[0] = 0;
+
+  /// активация -> правила, читающие её
+  fuzzy_dep_build (model, dep_off, dep);
+
+  inc->model   = model;
+  inc->in_off  = in_off;
+  inc->in_mf   = in_mf;
+  inc->dep_off = dep_off;
+  inc->dep     = dep;
+  inc->act     = mem + off_act;
+  inc->dirty   = mem + off_dirty;
+  inc->in      = (int8_t *)(mem + off_in);
+  inc->mem     = mem;
+  fuzzy_incr_reset (inc);
+  return FUZZY_OK;
+}
+
+/*******************************************************************************
+* Сброс состояния
+* \brief  Restore initial activations, next call evaluates the model in full
+* \param[in]  inc     state
+*******************************************************************************/
+void fuzzy_incr_reset (fuzzy_incr *inc)
+{
+  fuzzy_workspace_init (inc->model, inc->act);
+  inc->valid = false;
+}
+
+/*******************************************************************************
+* Освобождение памяти состояния
+* \brief  Free incremental state memory
+* \param[in]  inc     state
+*******************************************************************************/
+void fuzzy_incr_free (fuzzy_incr *inc)
+{
+  if (inc)
+  {
+    free (inc->mem);
+    memset (inc, 0, sizeof (fuzzy_incr));
+  }
+}
+
+/*******************************************************************************
+* отметить правила, читающие активацию k
+*******************************************************************************/
+static inline void mark_deps (fuzzy_incr *inc, uint32_t k, uint32_t *lo, uint32_t *hi)
+{
+  uint32_t j, rule;
+
+  for (j = inc->dep_off[k]; j < inc->dep_off[k + 1]; j++)
+  {
+    rule = inc->dep[j];
+    inc->dirty[rule] = 1;
+    if (rule < *lo)
+    {
+      *lo = rule;
+    }
+    if (rule >= *hi)
+    {
+      *hi = rule + 1;
+    }
+  }
+}
+
+/*******************************************************************************
+* Полное вычисление модели в состояние
+*******************************************************************************/
+static void incr_full (fuzzy_incr *inc, const int8_t *in_array)
+{
+  const fuzzy_model *model = inc->model;
+  const fuzzy_rule_ix *r = model->rule;
+  uint8_t *act = inc->act;
+  uint8_t *y = act + model->n_mf;
+  uint8_t alpha;
+  uint16_t i;
+
+  inc->summ_alpha_c = 0;
+  inc->summ_alpha = 0;
+  for (i = 0; i < model->n_mf; i++)
+  {
+    act[i] = fuzzy_mf_eval (model, i, in_array[model->mf[i].xn]);
+  }
+  for (i = 0; i < model->n_rule; i++, r++)
+  {
+    alpha = fuzzy_operator (r->op, act[r->a], act[r->b]);
+    y[i] = alpha;
+    if (r->fin)
+    {
+      inc->summ_alpha_c += (int32_t)alpha * r->out;
+      inc->summ_alpha += alpha;
+    }
+  }
+  memcpy (inc->in, in_array, model->n_in);
+  inc->n_mf_eval += model->n_mf;
+  inc->n_rule_eval += model->n_rule;
+  inc->valid = true;
+}
+
+/*******************************************************************************
+* Инкрементальное вычисление нечеткого регулятора
+* \brief Fuzzy logic controller recomputing only functions and rules which
+*        depend on inputs changed since the previous call, bit-identical
+*        to process_fuzzy_logic_compiled
+* \param[in] inc       incremental state
+* \param[in] in_array  input values array [model->n_in]
+* \return Output control value
+*******************************************************************************/
+int8_t process_fuzzy_logic_incr (fuzzy_incr *inc, const int8_t *in_array)
+{
+  const fuzzy_model *model = inc->model;
+  const fuzzy_rule_ix *r;
+  uint8_t *act = inc->act;
+  uint16_t n_mf = model->n_mf;
+  uint32_t lo = model->n_rule, hi = 0, i, j, k;
+  int16_t summ_alpha_c, summ_alpha, ret;
+  uint8_t alpha;
+  int16_t diff;
+
+  if (model->flags & FUZZY_MODEL_FWD)
+  {
+    return process_fuzzy_logic_ws (model, in_array, act);
+  }
+
+  if (!inc->valid)
+  {
+    incr_full (inc, in_array);
+  }
+  else
+  {
+    /// функции фуззификации изменившихся входов
+    for (i = 0; i < model->n_in; i++)
+    {
+      if (in_array[i] == inc->in[i])
+      {
+        continue;
+      }
+      inc->in[i] = in_array[i];
+      for (j = inc->in_off[i]; j < inc->in_off[i + 1]; j++)
+      {
+        k = inc->in_mf[j];
+        alpha = fuzzy_mf_eval (model, (uint16_t)k, in_array[i]);
+        inc->n_mf_eval++;
+        if (alpha != act[k])
+        {
+          act[k] = alpha;
+          mark_deps (inc, k, &lo, &hi);
+        }
+      }
+    }
+
+    /// затронутые правила по порядку списка, поправка сумм на разность
+    for (i = lo; i < hi; i++)
+    {
+      if (!inc->dirty[i])
+      {
+        continue;
+      }
+      inc->dirty[i] = 0;
+      r = &model->rule[i];
+      alpha = fuzzy_operator (r->op, act[r->a], act[r->b]);
+      inc->n_rule_eval++;
+      diff = (int16_t)alpha - act[n_mf + i];
+      if (diff != 0)
+      {
+        act[n_mf + i] = alpha;
+        if (r->fin)
+        {
+          inc->summ_alpha_c += (int32_t)diff * r->out;
+          inc->summ_alpha += diff;
+        }
+        mark_deps (inc, n_mf + i, &lo, &hi);
+      }
+    }
+  }
+
+  /// суммы по модулю 2^16, как в process_fuzzy_logic_ws
+  summ_alpha_c = (int16_t)inc->summ_alpha_c;
+  summ_alpha = (int16_t)inc->summ_alpha;
+  if (summ_alpha == 0)
+  {
+    ret = 0;
+  }
+  else
+  {
+    ret = summ_alpha_c / summ_alpha;
+  }
+  return lim_s8 (ret);
+}
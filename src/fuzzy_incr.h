@@ -0,0 +1,67 @@
+/*******************************************************************************
+* \file     fuzzy_incr.h
+* \author   Ilya Petrukhin (ilya.petrukhin@gmail.com)
+* \brief    Incremental evaluation of the compiled fuzzy model: only
+*           functions and rules depending on changed inputs are recomputed
+* \version  2.1
+* \date     2026-10-17
+*******************************************************************************/
+
+#ifndef _FUZZY_INCR_H_
+#define _FUZZY_INCR_H_
+
+#include  <stdint.h>
+#include  <stdbool.h>
+#include  "fuzzy_logic.h"
+#include  "fuzzy_model.h"
+
+/*******************************************************************************
+* Rules to using incremental evaluation
+*******************************************************************************/
+// The state keeps last inputs, activations and defuzzification sums:
+//  fuzzy_incr inc;
+//  fuzzy_incr_init (&model, &inc);
+//  ...each control tick:
+//  int8_t temp = process_fuzzy_logic_incr (&inc, in);
+//  ...
+//  fuzzy_incr_free (&inc);
+//
+// Inputs are compared with the previous call. For each changed input only
+// its fuzzy functions are recomputed; rules reading a changed activation
+// (directly or through other rules, e.g. rule_04 <- rule_03) are
+// recomputed in list order, and summ_alpha_c / summ_alpha are corrected
+// by the difference of the rule contribution. Unchanged input - no work.
+// Result is bit-identical to process_fuzzy_logic_compiled.
+//
+// FUZZY_MODEL_FWD models (rule reads result of itself or later rule)
+// depend on the previous call, not only on inputs, and are evaluated in
+// full by process_fuzzy_logic_ws with the state workspace.
+// One state per caller (thread); the model is only read.
+// ***************** end of the brief *****************************************
+
+/// Incremental evaluation state
+typedef struct
+{
+  const fuzzy_model *model;     ///< compiled model
+  const uint16_t    *in_off;    ///< functions of input n: in_mf[in_off[n]..in_off[n + 1])
+  const uint16_t    *in_mf;     ///< function numbers grouped by input [n_mf]
+  const uint32_t    *dep_off;   ///< rules reading activation k: dep[dep_off[k]..dep_off[k + 1])
+  const uint16_t    *dep;       ///< rule numbers grouped by operand activation
+  uint8_t           *act;       ///< activation vector [n_mf + n_rule]
+  uint8_t           *dirty;     ///< rule has to be recomputed [n_rule]
+  int8_t            *in;        ///< inputs of the previous call [n_in]
+  int32_t           summ_alpha_c; ///< sum alpha * out of final rules
+  int32_t           summ_alpha;   ///< sum alpha of final rules
+  bool              valid;      ///< state corresponds to in[]
+  uint32_t          n_mf_eval;  ///< statistics: fuzzy functions evaluated
+  uint32_t          n_rule_eval;  ///< statistics: rules evaluated
+  void              *mem;       ///< owned memory block
+} fuzzy_incr;
+
+fuzzy_status fuzzy_incr_init (const fuzzy_model *model, fuzzy_incr *inc);  ///< build dependency graph and state
+void         fuzzy_incr_reset (fuzzy_incr *inc);                           ///< next call evaluates in full
+void         fuzzy_incr_free (fuzzy_incr *inc);                            ///< free state memory
+
+int8_t process_fuzzy_logic_incr (fuzzy_incr *inc, const int8_t *in_array);
+
+#endif  // _FUZZY_INCR_H_
@@ -11,6 +11,7 @@
 #include  <stdbool.h>
 #include  <string.h>
 #include  "fuzzy_logic.h"
+#include  "fuzzy_prof.h"
 
 #define MIN(a,b)  ((a) < (b) ? (a) : (b))
 #define MAX(a,b)  ((a) > (b) ? (a) : (b))
@@ -311,6 +312,35 @@ return lim_u8 (ret);
 
 
 
+/*******************************************************************************
+* следствие правила для выхода on
+* \brief  Consequent of the rule for the output on
+* \param[in]  r     rule
+* \param[in]  on    output number
+* \param[out] out   output fuzzy value
+* \return           true if the rule has consequent for the output
+*******************************************************************************/
+static inline bool rule_out (const fuzzy_rules *r, uint8_t on, int8_t *out)
+{
+  uint8_t k;
+
+  if (r->conseq == NULL)
+  {
+    *out = r->out;
+    return on == 0;
+  }
+  for (k = 0; k < r->n_conseq; k++)
+  {
+    if (r->conseq[k].on == on)
+    {
+      *out = r->conseq[k].out;
+      return true;
+    }
+  }
+  return false;
+}
+
+
 /*******************************************************************************
 * Реализация нечеткого регулятора согласно правил fuzzy_param *fuzzy
 * \brief Fuzzy logic controller by rules fuzzy_param *fuzzy
@@ -328,8 +358,10 @@ int8_t process_fuzzy_logic (fuzzy_param *fuzzy)
   int16_t summ_alpha = 0;
   int16_t alpha, a, b, ret;
   int8_t *in_array;
+  int8_t out;
   bool start;
   
+  FUZZY_PROF_START ();
   /// получить результаты функций фуззификации
   f1 = f = fuzzy->start_ffunc;
   in_array = fuzzy->in_array;
@@ -343,6 +375,7 @@ int8_t process_fuzzy_logic (fuzzy_param *fuzzy)
     start = false;
     f = f->next;
   }
+  FUZZY_PROF_MARK (FUZZY_STAGE_FUZZIFY);
   
   /// цикл по правилам нечёткой логики
   r1 = r = fuzzy->start_rule;
@@ -352,65 +385,26 @@ int8_t process_fuzzy_logic (fuzzy_param *fuzzy)
     a = *(r->a);
     b = *(r->b);
     /// применяем логические операторы
-    switch (r->op)
-    {
-    case F_AND:
-      alpha = MIN (a, b);
-      break;
-      
-    case F_OR:
-      alpha = MAX (a, b);
-      break;
-      
-    case F_NOT:
-      alpha = 255 - a;
-      break;
-      
-    case F_IMP:
-      if (a == 0)
-      {
-        alpha = 255;
-      }
-      else
-      {
-        if (a)
-        {
-          alpha = (b * (int16_t)255) / a;
-          alpha = lim_u8 (alpha);
-        }
-        else
-        {
-          alpha = 255;
-        }
-      }
-      break;
-      
-    case F_A:
-      alpha = a;
-      break;
-      
-    case F_B:
-      alpha = b;
-      break;
-      
-    case F_FALSE:
-    default:
-      alpha = 0;
-      break;
-    }
+    alpha = fuzzy_operator (r->op, a, b);
     r->y = alpha;
 
-    if (r->fin)  // если это конечное выражение
+    out = r->out;
+    if (r->fin && ((r->conseq == NULL) || rule_out (r, 0, &out)))  // если это конечное выражение
     {
+      if ((r->ts != NULL) && (r->conseq == NULL) && (alpha != 0))
+      {
+        out = fuzzy_ts_eval (r->ts, in_array);  // следствие первого порядка
+      }
       /// числитель и знаменатель для дискретного варианта 
       /// центроидного метода приведения к четкости
-      summ_alpha_c += (alpha * (int16_t)r->out); // / 255;
+      summ_alpha_c += (alpha * (int16_t)out); // / 255;
       summ_alpha += alpha;
     }
     /// вычисляем следующее правило
     r = r->next;
     start = false;
   }
+  FUZZY_PROF_MARK (FUZZY_STAGE_RULES);
 
   /// вычисляем воздействие на объект управления
   if (summ_alpha == 0)
@@ -421,7 +415,87 @@ int8_t process_fuzzy_logic (fuzzy_param *fuzzy)
   {
     ret = summ_alpha_c / summ_alpha;
   }
+  FUZZY_PROF_MARK (FUZZY_STAGE_DEFUZZ);
+  FUZZY_PROF_LISTS (fuzzy);
   return lim_s8 (ret);
 }
 
+/*******************************************************************************
+* Нечеткий регулятор с несколькими выходами: одна фуззификация, один проход
+* правил, отдельный центроид каждого выхода
+* \brief Fuzzy logic controller with several outputs by rules fuzzy_param
+*        *fuzzy: fuzzification and rules once, centroid per output
+* \param[in]  fuzzy   fuzzy parameters
+* \param[out] out     output control values [n_out]
+* \param[in]  n_out   number of outputs, up to FUZZY_MAX_OUT
+*******************************************************************************/
+void process_fuzzy_logic_mo (fuzzy_param *fuzzy, int8_t *out, uint8_t n_out)
+{
+  fuzzy_funct *f, *f1;
+  fuzzy_rules *r, *r1;
+  int16_t summ_alpha_c[FUZZY_MAX_OUT] = {0};
+  int16_t summ_alpha[FUZZY_MAX_OUT] = {0};
+  int16_t alpha, ret;
+  int8_t *in_array;
+  uint8_t k, on;
+  bool start;
 
+  if (n_out > FUZZY_MAX_OUT)
+  {
+    n_out = FUZZY_MAX_OUT;
+  }
+
+  /// получить результаты функций фуззификации
+  f1 = f = fuzzy->start_ffunc;
+  in_array = fuzzy->in_array;
+  start = true;
+  while ((f != f1) || start)
+  {
+    if (f->func)
+    {
+      f->y = f->func (in_array[f->xn], f->a, f->b, f->c);
+    }
+    start = false;
+    f = f->next;
+  }
+
+  /// цикл по правилам нечёткой логики
+  r1 = r = fuzzy->start_rule;
+  start = true;
+  while ((r != r1) || start)
+  {
+    alpha = fuzzy_operator (r->op, *(r->a), *(r->b));
+    r->y = alpha;
+
+    if (r->fin)  // если это конечное выражение
+    {
+      if (r->conseq == NULL)
+      {
+        ret = ((r->ts == NULL) || (alpha == 0)) ? r->out : fuzzy_ts_eval (r->ts, in_array);
+        summ_alpha_c[0] += (alpha * ret);
+        summ_alpha[0] += alpha;
+      }
+      else
+      {
+        for (k = 0; k < r->n_conseq; k++)
+        {
+          on = r->conseq[k].on;
+          if (on < n_out)
+          {
+            summ_alpha_c[on] += (alpha * (int16_t)r->conseq[k].out);
+            summ_alpha[on] += alpha;
+          }
+        }
+      }
+    }
+    r = r->next;
+    start = false;
+  }
+
+  /// воздействия на объект управления
+  for (on = 0; on < n_out; on++)
+  {
+    ret = (summ_alpha[on] == 0) ? 0 : summ_alpha_c[on] / summ_alpha[on];
+    out[on] = lim_s8 (ret);
+  }
+}
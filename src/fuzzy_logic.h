@@ -76,6 +76,25 @@
 //  int8_t temp = process_fuzzy_logic (&fuzzy)
 //  int16_t out = out_scaling (temp);
 //
+// 6. Several output variables (option): rule gives consequents
+// {output number, value} for one or more outputs, instead of "output"
+//          name,          A,          OPER,     B,         fin,    next rule,   consequents
+//MAKE_RULE_MO (rule_low,  mu_low,     F_OR,     d_zero,    true,   rule_plow,   {0, OUT_VERY_LOW}, {1, SPEED_LOW});
+// Rules made by MAKE_RULE give "output" to the output 0. One pass of
+// fuzzification and rules, separate centroid of every output:
+//  int8_t out[2];
+//  process_fuzzy_logic_mo (&fuzzy, out, 2);
+// process_fuzzy_logic returns the output 0.
+//
+// 7. First-order Takagi-Sugeno consequent (option): output of the rule is
+// a linear function of the inputs, out = k0 + (k[0] * in[0] + ...) / 256,
+// rounded and limited by lim_s8, coefficients Q8 (256 = 1.0):
+//          name,          A,          OPER,     B,         fin,    next rule,   k0,   k[0], k[1]
+//MAKE_RULE_TS (rule_zero, mu_zero,    F_AND,    d_zero,    true,   rule_low,    0,    -64,  -128);
+// The centroid is the same weighted average, a few rules with slopes give
+// the smooth surface of many constant rules. Output 0 only, rules with
+// consequents of several outputs have no first-order consequent.
+//
 // ***************** end of the brief *****************************************
    
 /// Fuzzy logic operators
@@ -108,6 +127,26 @@ typedef struct
   extern fuzzy_funct next;   \
 	fuzzy_funct name = {ffunc, x, a, b, c, 0, &next}
 
+#define FUZZY_MAX_OUT   (8)   ///< max output variables
+
+/// Consequent of the rule for one output variable
+typedef struct
+{
+  uint8_t   on;       ///< output number 0..FUZZY_MAX_OUT-1
+  int8_t    out;      ///< output fuzzy value
+} fuzzy_conseq;
+
+#define FUZZY_TS_MAX_IN (3)   ///< inputs of the first-order consequent
+#define FUZZY_TS_SHIFT  (8)   ///< coefficients of the first-order consequent, Q8
+
+/// First-order Takagi-Sugeno consequent: out = k0 + sum (k[i] * in[i]) / 2^FUZZY_TS_SHIFT
+typedef struct
+{
+  int8_t    k0;                     ///< constant output fuzzy value
+  uint8_t   n;                      ///< inputs of the sum in[0..n)
+  int16_t   k[FUZZY_TS_MAX_IN];     ///< Q8 coefficients of the inputs
+} fuzzy_ts;
+
 /// Fuzzy rule control structure
 typedef struct 
 {
@@ -118,6 +157,9 @@ typedef struct
   uint8_t       y;        ///< fuzzy function result value
   int8_t        out;      ///< output fuzzy value
   void          *next;    ///< next rule pointer
+  const fuzzy_conseq *conseq; ///< consequents of several outputs, NULL - out to the output 0
+  uint8_t       n_conseq; ///< number of consequents
+  const fuzzy_ts *ts;     ///< first-order consequent of the output 0, NULL - constant out
 } fuzzy_rules; 
 
 /// Fuzzy parameters control structure
@@ -130,7 +172,19 @@ typedef struct
    
 #define MAKE_RULE(name, a, op, b, fin, out, next) \
   extern fuzzy_rules next;   \
-	fuzzy_rules name = {&((a).y), op, &((b).y), fin, 0, out, &next}
+	fuzzy_rules name = {&((a).y), op, &((b).y), fin, 0, out, &next, 0, 0, 0}
+
+#define MAKE_RULE_MO(name, a, op, b, fin, next, ...) \
+  extern fuzzy_rules next;   \
+  static const fuzzy_conseq name##_conseq[] = {__VA_ARGS__}; \
+  fuzzy_rules name = {&((a).y), op, &((b).y), fin, 0, 0, &next, name##_conseq, \
+                      sizeof (name##_conseq) / sizeof (fuzzy_conseq), 0}
+
+#define MAKE_RULE_TS(name, a, op, b, fin, next, k0, ...) \
+  extern fuzzy_rules next;   \
+  static const fuzzy_ts name##_ts = {k0, sizeof ((int16_t[]){__VA_ARGS__}) / sizeof (int16_t), \
+                                     {__VA_ARGS__}}; \
+  fuzzy_rules name = {&((a).y), op, &((b).y), fin, 0, k0, &next, 0, 0, &name##_ts}
 
 
 /// Prototypes fuzzyfication input functions parameter x
@@ -147,10 +201,13 @@ int8_t  in1_scaling (int16_t in2);  ///< user scaling input 2 value to the limit
 int16_t out_scaling (int8_t out);   ///< user scaling output value +-127 to the control value
 
 int8_t process_fuzzy_logic (fuzzy_param *fuzzy);
+void   process_fuzzy_logic_mo (fuzzy_param *fuzzy, int8_t *out, uint8_t n_out);
 
 
 inline static uint8_t   lim_u8  (int16_t x);
 inline static int8_t    lim_s8  (int16_t x);
+inline static uint8_t   fuzzy_operator (fuzzy_op op, uint8_t a, uint8_t b);
+inline static int8_t    fuzzy_ts_eval  (const fuzzy_ts *ts, const int8_t *in_array);
 
 /*************************************************************************
  * \brief Limitation fuzzy result value by 0..1 e.g. 0..255
@@ -190,6 +247,88 @@ inline static int8_t lim_s8 (int16_t x)
   return (int8_t)x;
 }
 
+/*************************************************************************
+ * \brief Fuzzy logic operator between two activations
+ *        shared by all evaluation engines
+ * \param op        logic operator
+ * \param a         operand a 0..255
+ * \param b         operand b 0..255
+ * \return uint8_t  rule activation 0..255
+*************************************************************************/
+inline static uint8_t fuzzy_operator (fuzzy_op op, uint8_t a, uint8_t b)
+{
+  int16_t alpha;
+
+  switch (op)
+  {
+  case F_AND:
+    alpha = (a < b) ? a : b;
+    break;
+    
+  case F_OR:
+    alpha = (a > b) ? a : b;
+    break;
+    
+  case F_NOT:
+    alpha = 255 - a;
+    break;
+    
+  case F_IMP:
+    if (a == 0)
+    {
+      alpha = 255;
+    }
+    else
+    {
+      alpha = ((int16_t)b * (int16_t)255) / a;
+      alpha = lim_u8 (alpha);
+    }
+    break;
+    
+  case F_A:
+    alpha = a;
+    break;
+    
+  case F_B:
+    alpha = b;
+    break;
+    
+  case F_FALSE:
+  default:
+    alpha = 0;
+    break;
+  }
+  return (uint8_t)alpha;
+}
+
+
+
+/*************************************************************************
+ * \brief First-order consequent of the rule, shared by all evaluation
+ *        engines: rounded to nearest, limited by lim_s8
+ * \param ts        consequent
+ * \param in_array  input values
+ * \return int8_t   output fuzzy value
+*************************************************************************/
+inline static int8_t fuzzy_ts_eval (const fuzzy_ts *ts, const int8_t *in_array)
+{
+  int32_t s = (int32_t)ts->k0 * (1 << FUZZY_TS_SHIFT) + (1 << (FUZZY_TS_SHIFT - 1));
+  uint8_t i;
 
+  for (i = 0; i < ts->n; i++)
+  {
+    s += (int32_t)ts->k[i] * in_array[i];
+  }
+  s >>= FUZZY_TS_SHIFT;
+  if (s < INT16_MIN)
+  {
+    s = INT16_MIN;
+  }
+  else if (s > INT16_MAX)
+  {
+    s = INT16_MAX;
+  }
+  return lim_s8 ((int16_t)s);
+}
 
 #endif  // _FUZZY_LOGIC_H_
@@ -0,0 +1,259 @@
+/*******************************************************************************
+* \file     fuzzy_logic16.c
+* \author   Ilya Petrukhin (ilya.petrukhin@gmail.com)
+* \brief    This file provides code for 16-bit fixed point fuzzy logic
+*           functions
+* \version  2.1
+* \date     2026-10-17
+*******************************************************************************/
+#include  <stdio.h>
+#include  <stdint.h>
+#include  <stdbool.h>
+#include  "fuzzy_logic.h"
+#include  "fuzzy_logic16.h"
+
+
+/*******************************************************************************
+* фронт функции n / d, 0 <= n <= d, d <= 65535
+*******************************************************************************/
+static inline uint16_t ramp16 (int32_t n, int32_t d)
+{
+  return (uint16_t)(((uint32_t)n * FUZZY16_ONE) / (uint32_t)d);
+}
+
+/*******************************************************************************
+* кубическая аппроксимация гаусса, p1=M, p2=D_0.5
+* \brief  Cubic approximation of Gauss function
+* \param[in]  x   input value
+* \param[in]  p1  Median
+* \param[in]  p2  +-Delta 0.5
+* \return         output value y = D^3 / (D^3 + abs (x - p1)^3) 0-65535
+*******************************************************************************/
+uint16_t cube16 (int16_t x, int16_t p1, int16_t p2, int16_t p3)
+{
+  uint64_t d3, dx3;
+  uint32_t d, dx;
+
+  (void)p3;
+  d = (p2 < 0) ? (uint32_t)(-(int32_t)p2) : (uint32_t)p2;
+  dx = (x < p1) ? (uint32_t)(p1 - x) : (uint32_t)(x - p1);
+  d3 = (uint64_t)d * d * d;
+  dx3 = (uint64_t)dx * dx * dx;
+  if (d3 + dx3 == 0)
+  {
+    return FUZZY16_ONE;
+  }
+  return (uint16_t)((d3 * FUZZY16_ONE) / (d3 + dx3));
+}
+
+/*******************************************************************************
+* симметричная треугольная функция p1=center, p1+p2=max, p1-p2=min _/\_
+* \brief  Symmetric triangle function _/\_
+* \param[in]  x   input value
+* \param[in]  p1  Center
+* \param[in]  p2  Delta
+* \return         output value
+*******************************************************************************/
+uint16_t triangle16 (int16_t x, int16_t p1, int16_t p2, int16_t p3)
+{
+  (void)p3;
+  return a_triangle16 (x, p1, p2, p2);
+}
+
+/*******************************************************************************
+* Несимметричная треугольная функция p1=center, p1+p3=max, p1-p2=min _/\_
+* \brief  Asymmetric triangle function _/\_
+* \param[in]  x   input value
+* \param[in]  p1  Center
+* \param[in]  p2  Delta min
+* \param[in]  p3  Delta max
+* \return         output value
+*******************************************************************************/
+uint16_t a_triangle16 (int16_t x, int16_t p1, int16_t p2, int16_t p3)
+{
+  int32_t min = (int32_t)p1 - p2;
+  int32_t max = (int32_t)p1 + p3;
+
+  /// protection p2, p3
+  if ((p2 <= 0) || (p3 <= 0) || (x < min) || (x > max))
+  {
+    return 0;
+  }
+  if (x < p1)
+  {
+    return ramp16 (x - min, p2);
+  }
+  return ramp16 (max - x, p3);
+}
+
+/*******************************************************************************
+* симметричная прямоугольная функция p1=center, p1+p2=max, p1-p2=min _|~|_
+* \brief  Symmetric square function _|~|_
+* \param[in]  x   input value
+* \param[in]  p1  Center
+* \param[in]  p2  Delta
+* \return         output value
+*******************************************************************************/
+uint16_t square16 (int16_t x, int16_t p1, int16_t p2, int16_t p3)
+{
+  (void)p3;
+  if ((x >= (int32_t)p1 - p2) && (x <= (int32_t)p1 + p2))
+  {
+    return FUZZY16_ONE;
+  }
+  return 0;
+}
+
+/*******************************************************************************
+* симметричная трапециональная функция p1=center, p1+p2=max, p1-p2=min _/~\_
+* основание p1+p3=max, p1-p3=min
+* \brief  Symmetric trapecial function _/~\_
+* \param[in]  x   input value
+* \param[in]  p1  Center
+* \param[in]  p2  p1 + p2 = top max, p1 - p2 = top min
+* \param[in]  p3  p1 + p3 = base max, p1 - p3 = base min
+* \return         output value
+*******************************************************************************/
+uint16_t trapecia16 (int16_t x, int16_t p1, int16_t p2, int16_t p3)
+{
+  int32_t min = (int32_t)p1 - p2;
+  int32_t max = (int32_t)p1 + p2;
+  int32_t min2 = (int32_t)p1 - p3;
+  int32_t max2 = (int32_t)p1 + p3;
+
+  if ((x < min2) || (x > max2))
+  {
+    return 0;
+  }
+  if ((x >= min) && (x <= max))
+  {
+    return FUZZY16_ONE;
+  }
+  if (x < min)
+  {
+    return (min > min2) ? ramp16 (x - min2, min - min2) : FUZZY16_ONE;
+  }
+  return (max2 > max) ? ramp16 (max2 - x, max2 - max) : FUZZY16_ONE;
+}
+
+/*******************************************************************************
+* несимметричная функция минимума p1=min p2=max ~\_
+* \brief  Asymmetric minimum function ~\_
+* \param[in]  x   input value
+* \param[in]  p1  min
+* \param[in]  p2  max
+* \return         output value
+*******************************************************************************/
+uint16_t low16 (int16_t x, int16_t p1, int16_t p2, int16_t p3)
+{
+  int16_t temp;
+
+  (void)p3;
+  if (p1 > p2)  // swap p1, p2
+  {
+    temp = p1;
+    p1 = p2;
+    p2 = temp;
+  }
+  if (x < p1)
+  {
+    return FUZZY16_ONE;
+  }
+  if (x > p2)
+  {
+    return 0;
+  }
+  return (p2 > p1) ? ramp16 (p2 - x, (int32_t)p2 - p1) : FUZZY16_ONE;
+}
+
+/*******************************************************************************
+* несимметричная функция максимума p1=min p2=max _/~
+* \brief  Asymmetric maximum function _/~
+* \param[in]  x   input value
+* \param[in]  p1  min
+* \param[in]  p2  max
+* \return         output value
+*******************************************************************************/
+uint16_t high16 (int16_t x, int16_t p1, int16_t p2, int16_t p3)
+{
+  int16_t temp;
+
+  (void)p3;
+  if (p1 > p2)  // swap p1, p2
+  {
+    temp = p1;
+    p1 = p2;
+    p2 = temp;
+  }
+  if (x < p1)
+  {
+    return 0;
+  }
+  if (x > p2)
+  {
+    return FUZZY16_ONE;
+  }
+  return (p2 > p1) ? ramp16 (x - p1, (int32_t)p2 - p1) : FUZZY16_ONE;
+}
+
+
+/*******************************************************************************
+* Реализация 16-разрядного нечеткого регулятора согласно правил fuzzy_param16
+* \brief 16-bit fuzzy logic controller by rules fuzzy_param16 *fuzzy
+* \param[in] fuzzy->in_array - input values +-32767
+* \return Output control value +-32767
+*******************************************************************************/
+int16_t process_fuzzy_logic16 (fuzzy_param16 *fuzzy)
+{
+  fuzzy_funct16 *f, *f1;
+  fuzzy_rules16 *r, *r1;
+  int32_t summ_alpha_c = 0;
+  uint32_t summ_alpha = 0;
+  int32_t ret;
+  uint16_t alpha;
+  int16_t *in_array;
+  bool start;
+
+  /// получить результаты функций фуззификации
+  f1 = f = fuzzy->start_ffunc;
+  in_array = fuzzy->in_array;
+  start = true;
+  while ((f != f1) || start)
+  {
+    if (f->func)
+    {
+      f->y = f->func (in_array[f->xn], f->a, f->b, f->c);
+    }
+    start = false;
+    f = f->next;
+  }
+
+  /// цикл по правилам нечёткой логики
+  r1 = r = fuzzy->start_rule;
+  start = true;
+  while ((r != r1) || start)
+  {
+    alpha = fuzzy_operator16 (r->op, *(r->a), *(r->b));
+    r->y = alpha;
+
+    if (r->fin)  // если это конечное выражение
+    {
+      /// слагаемые alpha * out / 65536 с округлением, без переполнения
+      summ_alpha_c += ((int32_t)alpha * r->out + 0x8000) >> 16;
+      summ_alpha += alpha;
+    }
+    r = r->next;
+    start = false;
+  }
+
+  /// вычисляем воздействие на объект управления
+  if (summ_alpha == 0)
+  {
+    ret = 0;
+  }
+  else
+  {
+    ret = (int32_t)(((int64_t)summ_alpha_c * 65536) / (int64_t)summ_alpha);
+  }
+  return lim_s16 (ret);
+}
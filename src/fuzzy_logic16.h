@@ -0,0 +1,186 @@
+/*******************************************************************************
+* \file     fuzzy_logic16.h
+* \author   Ilya Petrukhin (ilya.petrukhin@gmail.com)
+* \brief    16-bit fixed point fuzzy logic: int16_t inputs and outputs,
+*           uint16_t memberships, 32-bit defuzzification accumulators
+* \version  2.1
+* \date     2026-10-17
+*******************************************************************************/
+
+#ifndef _FUZZY_LOGIC16_H_
+#define _FUZZY_LOGIC16_H_
+
+#include  <stdint.h>
+#include  <stdbool.h>
+#include  "fuzzy_logic.h"
+
+/*******************************************************************************
+* Rules to using 16-bit fuzzy functions library
+*******************************************************************************/
+// The same steps as for fuzzy_logic.h with the 16-bit types:
+// 1. Input values in the range +-32767 (scale +-1.0f, Q15)
+// 2. Output values in the range +-32767 (Q15)
+// 3. Fuzzy functions, membership 0..65535 (1.0 = 65535):
+//  MAKE_FFUNC16 (mu_zero, trapecia16, 0, IN_ZERO, IN_Z_TOP, IN_Z_BTN, mu_low);
+// 4. Rules with the same operators fuzzy_op:
+//  MAKE_RULE16 (rule_zero, mu_zero, F_AND, d_zero, true, OUT_ZERO, rule_low);
+// 5. fuzzy_param16 fuzzy = { .in_array = in, .start_ffunc = &mu_zero,
+//                            .start_rule = &rule_zero };
+//  int16_t out = process_fuzzy_logic16 (&fuzzy);
+//
+// Function parameters are computed in 32 bits, so break points like
+// p1 - p2 do not wrap as int8_t ones do.
+// Defuzzification: summ_alpha (uint32_t) = sum of alpha, summ_alpha_c
+// (int32_t) = sum of round (alpha * out / 65536), result
+// summ_alpha_c * 65536 / summ_alpha. No overflow up to 32768 final rules;
+// rounding error of the result is below n_fin * 32768 / summ_alpha LSB,
+// i.e. below n_fin / 2 LSB when at least one rule is fully fired.
+// ***************** end of the brief *****************************************
+
+#define FUZZY16_ONE     (65535u)    ///< membership 1.0
+
+typedef uint16_t (*fuzzy16) (int16_t x, int16_t p1, int16_t p2, int16_t p3);
+
+/// 16-bit fuzzy logic function
+typedef struct
+{
+  fuzzy16   func;     ///< fuzzification function pointer
+  uint8_t   xn;       ///< input parameter number
+  int16_t   a;        ///< first function parameter
+  int16_t   b;        ///< second function parameter
+  int16_t   c;        ///< third function parameter
+  uint16_t  y;        ///< fuzzification output value
+  void      *next;    ///< next fuzzy function pointer
+} fuzzy_funct16;
+
+#define MAKE_FFUNC16(name, ffunc, x, a, b, c, next) \
+  extern fuzzy_funct16 next;   \
+  fuzzy_funct16 name = {ffunc, x, a, b, c, 0, &next}
+
+/// 16-bit fuzzy rule control structure
+typedef struct
+{
+  uint16_t      *a;       ///< operand a pointer
+  fuzzy_op      op;       ///< logic operator between a and b
+  uint16_t      *b;       ///< operand b pointer
+  bool          fin;      ///< flag final complex logic function
+  uint16_t      y;        ///< fuzzy function result value
+  int16_t       out;      ///< output fuzzy value
+  void          *next;    ///< next rule pointer
+} fuzzy_rules16;
+
+#define MAKE_RULE16(name, a, op, b, fin, out, next) \
+  extern fuzzy_rules16 next;   \
+  fuzzy_rules16 name = {&((a).y), op, &((b).y), fin, 0, out, &next}
+
+/// 16-bit fuzzy parameters control structure
+typedef struct
+{
+  int16_t         *in_array;    ///< pointer input values array
+  fuzzy_rules16   *start_rule;  ///< pointer to the first fuzzy rule
+  fuzzy_funct16   *start_ffunc; ///< pointer to the first fuzzy function
+} fuzzy_param16;
+
+
+/// Prototypes fuzzyfication input functions parameter x, output 0..65535
+uint16_t cube16       (int16_t x, int16_t p1, int16_t p2, int16_t p3);  ///< Gauss cubic approximation, p1=M, p2=D_0.5
+uint16_t triangle16   (int16_t x, int16_t p1, int16_t p2, int16_t p3);  ///< symmetric triangle p1=center, p1-p2=min, p1+p2=max _/\_
+uint16_t a_triangle16 (int16_t x, int16_t p1, int16_t p2, int16_t p3);  ///< asymmetric triangle p1=center, p1-p2=min, p1+p3=max _/\_
+uint16_t square16     (int16_t x, int16_t p1, int16_t p2, int16_t p3);  ///< symmetric square p1=center, p1-p2=min, p1+p2=max _|~|_
+uint16_t trapecia16   (int16_t x, int16_t p1, int16_t p2, int16_t p3);  ///< symmetric trapecia p1=center, p1+p2=top, p1+p3=bottom _/~\_
+uint16_t low16        (int16_t x, int16_t p1, int16_t p2, int16_t p3);  ///< asymmetric low p1=min p2=max ~\_
+uint16_t high16       (int16_t x, int16_t p1, int16_t p2, int16_t p3);  ///< asymmetric high p1=min p2=max _/~
+
+int16_t process_fuzzy_logic16 (fuzzy_param16 *fuzzy);
+
+
+/*************************************************************************
+ * \brief Limitation fuzzy result value by 0..1 e.g. 0..65535
+ * \param x         input
+ * \return uint16_t limitation result
+*************************************************************************/
+inline static uint16_t lim_u16 (int32_t x)
+{
+  if (x < 0)
+  {
+    x = 0;
+  }
+  else if (x > (int32_t)FUZZY16_ONE)
+  {
+    x = FUZZY16_ONE;
+  }
+  return (uint16_t)x;
+}
+
+/*************************************************************************
+ * \brief Limitation in/out value by +-1 e.g. +-32767
+ * \param x         input
+ * \return int16_t  limitation output
+*************************************************************************/
+inline static int16_t lim_s16 (int32_t x)
+{
+  if (x < -32767)
+  {
+    x = -32767;
+  }
+  else if (x > 32767)
+  {
+    x = 32767;
+  }
+  return (int16_t)x;
+}
+
+/*************************************************************************
+ * \brief 16-bit fuzzy logic operator between two activations
+ * \param op        logic operator
+ * \param a         operand a 0..65535
+ * \param b         operand b 0..65535
+ * \return uint16_t rule activation 0..65535
+*************************************************************************/
+inline static uint16_t fuzzy_operator16 (fuzzy_op op, uint16_t a, uint16_t b)
+{
+  uint32_t alpha;
+
+  switch (op)
+  {
+  case F_AND:
+    alpha = (a < b) ? a : b;
+    break;
+
+  case F_OR:
+    alpha = (a > b) ? a : b;
+    break;
+
+  case F_NOT:
+    alpha = FUZZY16_ONE - a;
+    break;
+
+  case F_IMP:
+    if (a == 0)
+    {
+      alpha = FUZZY16_ONE;
+    }
+    else
+    {
+      alpha = ((uint32_t)b * FUZZY16_ONE) / a;
+      alpha = (alpha > FUZZY16_ONE) ? FUZZY16_ONE : alpha;
+    }
+    break;
+
+  case F_A:
+    alpha = a;
+    break;
+
+  case F_B:
+    alpha = b;
+    break;
+
+  case F_FALSE:
+  default:
+    alpha = 0;
+    break;
+  }
+  return (uint16_t)alpha;
+}
+
+#endif  // _FUZZY_LOGIC16_H_
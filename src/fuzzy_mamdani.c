@@ -0,0 +1,251 @@
+/*******************************************************************************
+* \file     fuzzy_mamdani.c
+* \author   Ilya Petrukhin (ilya.petrukhin@gmail.com)
+* \brief    This file provides code for Mamdani centroid defuzzification
+*           with output fuzzy sets
+* \version  2.1
+* \date     2026-10-17
+*******************************************************************************/
+#include  <stdio.h>
+#include  <stdint.h>
+#include  <stdbool.h>
+#include  <stdlib.h>
+#include  <string.h>
+#include  "fuzzy_logic.h"
+#include  "fuzzy_model.h"
+#include  "fuzzy_mamdani.h"
+
+#define ALIGN_UP(x, a)  (((x) + ((a) - 1)) & ~((size_t)(a) - 1))
+
+
+/*******************************************************************************
+* Таблицы выходных множеств
+* \brief  Build membership, clipped area and moment tables of output sets
+*         and map final rules to their sets by the rule output value
+* \param[in]  model   compiled model, must outlive the tables
+* \param[in]  set     output sets [n_set]
+* \param[in]  n_set   number of sets, up to FUZZY_MAX_OUTSET
+* \param[out] md      tables, free with fuzzy_mamdani_free
+* \return             FUZZY_OK, FUZZY_ERR_PARAM for invalid or repeated sets,
+*                     FUZZY_ERR_OPERAND if final rule output has no set,
+*                     FUZZY_ERR_STRUCT for first-order consequents
+*******************************************************************************/
+fuzzy_status fuzzy_mamdani_init (const fuzzy_model *model, const fuzzy_outset *set,
+                                 uint8_t n_set, fuzzy_mamdani *md)
+{
+  uint8_t set_of[256];
+  uint8_t (*tab)[256];
+  int32_t (*area)[256];
+  int32_t (*moment)[256];
+  uint8_t *rule_set, *order, *mem;
+  int8_t *lo, *hi;
+  size_t off_area, off_moment, off_tab, off_rule, off_order, off_lo, off_hi, size;
+  uint32_t k, j, level, mu;
+  int16_t y;
+  uint8_t temp;
+  bool empty;
+
+  if ((model == NULL) || (set == NULL) || (md == NULL) || (model->mf == NULL) ||
+      (n_set == 0) || (n_set > FUZZY_MAX_OUTSET))
+  {
+    return FUZZY_ERR_PARAM;
+  }
+  if (model->ts != NULL)
+  {
+    return FUZZY_ERR_STRUCT;              // output set is selected by constant out
+  }
+  memset (md, 0, sizeof (fuzzy_mamdani));
+  memset (set_of, FUZZY_NO_SET, sizeof (set_of));
+  for (k = 0; k < n_set; k++)
+  {
+    if ((set[k].func == NULL) || (set_of[(uint8_t)set[k].out] != FUZZY_NO_SET))
+    {
+      return FUZZY_ERR_PARAM;
+    }
+    set_of[(uint8_t)set[k].out] = (uint8_t)k;
+  }
+
+  /// один блок памяти: площади, моменты, функции, правила, порядок, носители
+  off_area   = 0;
+  off_moment = off_area + n_set * 256 * sizeof (int32_t);
+  off_tab    = off_moment + n_set * 256 * sizeof (int32_t);
+  off_rule   = off_tab + n_set * 256;
+  off_order  = off_rule + model->n_rule;
+  off_lo     = off_order + n_set;
+  off_hi     = off_lo + n_set;
+  size       = ALIGN_UP (off_hi + n_set, sizeof (void *));
+  mem = calloc (1, size);
+  if (mem == NULL)
+  {
+    return FUZZY_ERR_MEMORY;
+  }
+  area     = (int32_t (*)[256])(mem + off_area);
+  moment   = (int32_t (*)[256])(mem + off_moment);
+  tab      = (uint8_t (*)[256])(mem + off_tab);
+  rule_set = mem + off_rule;
+  order    = mem + off_order;
+  lo       = (int8_t *)(mem + off_lo);
+  hi       = (int8_t *)(mem + off_hi);
+
+  /// выходное множество каждого конечного правила
+  for (j = 0; j < model->n_rule; j++)
+  {
+    rule_set[j] = FUZZY_NO_SET;
+    if (model->rule[j].fin)
+    {
+      rule_set[j] = set_of[(uint8_t)model->rule[j].out];
+      if (rule_set[j] == FUZZY_NO_SET)
+      {
+        free (mem);
+        return FUZZY_ERR_OPERAND;
+      }
+    }
+  }
+
+  for (k = 0; k < n_set; k++)
+  {
+    /// функция принадлежности и носитель
+    lo[k] = 1;            // пустой носитель lo > hi
+    hi[k] = 0;
+    empty = true;
+    for (y = -128; y < 128; y++)
+    {
+      tab[k][(uint8_t)y] = set[k].func ((int8_t)y, set[k].a, set[k].b, set[k].c);
+      if (tab[k][(uint8_t)y] != 0)
+      {
+        if (empty)
+        {
+          lo[k] = (int8_t)y;
+          empty = false;
+        }
+        hi[k] = (int8_t)y;
+      }
+    }
+    /// площадь и момент множества, срезанного на каждом уровне
+    for (level = 0; level < 256; level++)
+    {
+      for (y = -128; y < 128; y++)
+      {
+        mu = tab[k][(uint8_t)y];
+        mu = (mu < level) ? mu : level;
+        area[k][level] += (int32_t)mu;
+        moment[k][level] += (int32_t)mu * y;
+      }
+    }
+    order[k] = (uint8_t)k;
+  }
+
+  /// множества по возрастанию нижней границы носителя
+  for (k = 1; k < n_set; k++)
+  {
+    for (j = k; (j > 0) && (lo[order[j - 1]] > lo[order[j]]); j--)
+    {
+      temp = order[j];
+      order[j] = order[j - 1];
+      order[j - 1] = temp;
+    }
+  }
+
+  md->model    = model;
+  md->n_set    = n_set;
+  md->rule_set = rule_set;
+  md->order    = order;
+  md->lo       = lo;
+  md->hi       = hi;
+  md->tab      = (const uint8_t (*)[256])tab;
+  md->area     = (const int32_t (*)[256])area;
+  md->moment   = (const int32_t (*)[256])moment;
+  md->mem      = mem;
+  return FUZZY_OK;
+}
+
+/*******************************************************************************
+* Освобождение памяти таблиц
+* \brief  Free Mamdani tables memory
+* \param[in]  md      tables
+*******************************************************************************/
+void fuzzy_mamdani_free (fuzzy_mamdani *md)
+{
+  if (md)
+  {
+    free (md->mem);
+    memset (md, 0, sizeof (fuzzy_mamdani));
+  }
+}
+
+/*******************************************************************************
+* Нечеткий регулятор с центроидом выходных множеств Мамдани
+* \brief Fuzzy logic controller with Mamdani defuzzification: sets clipped
+*        by rule activations, max aggregation, integer centroid
+* \param[in] md        Mamdani tables
+* \param[in] in_array  input values array [model->n_in]
+* \param[in] ws        workspace [fuzzy_workspace_size]
+* \return Output control value
+*******************************************************************************/
+int8_t process_fuzzy_logic_mamdani (const fuzzy_mamdani *md, const int8_t *in_array, uint8_t *ws)
+{
+  const fuzzy_model *model = md->model;
+  const uint8_t *y_rule = ws + model->n_mf;
+  uint8_t level[FUZZY_MAX_OUTSET] = {0};
+  uint8_t act[FUZZY_MAX_OUTSET];
+  uint32_t n_act = 0, i, j, k;
+  int32_t summ_mu = 0, summ_mu_y = 0, s, m, v;
+  int16_t covered = -129, done = -129, y, end;
+
+  fuzzy_model_activate (model, in_array, ws);
+
+  /// уровень среза множества - максимум активаций его правил
+  for (i = 0; i < model->n_rule; i++)
+  {
+    k = md->rule_set[i];
+    if ((k != FUZZY_NO_SET) && (y_rule[i] > level[k]))
+    {
+      level[k] = y_rule[i];
+    }
+  }
+
+  /// сумма площадей и моментов срезанных множеств
+  for (i = 0; i < md->n_set; i++)
+  {
+    k = md->order[i];
+    if ((level[k] != 0) && (md->lo[k] <= md->hi[k]))
+    {
+      act[n_act++] = (uint8_t)k;
+      summ_mu += md->area[k][level[k]];
+      summ_mu_y += md->moment[k][level[k]];
+    }
+  }
+
+  /// в точках пересечения носителей сумма заменяется максимумом
+  for (i = 0; i < n_act; i++)
+  {
+    k = act[i];
+    if (md->lo[k] <= covered)
+    {
+      end = (md->hi[k] < covered) ? md->hi[k] : covered;
+      for (y = (md->lo[k] > done) ? md->lo[k] : (done + 1); y <= end; y++)
+      {
+        s = 0;
+        m = 0;
+        for (j = 0; j < n_act; j++)
+        {
+          v = md->tab[act[j]][(uint8_t)y];
+          v = (v < level[act[j]]) ? v : level[act[j]];
+          s += v;
+          m = (v > m) ? v : m;
+        }
+        summ_mu += m - s;
+        summ_mu_y += (m - s) * y;
+      }
+      done = (end > done) ? end : done;
+    }
+    covered = (md->hi[k] > covered) ? md->hi[k] : covered;
+  }
+
+  /// центр тяжести
+  if (summ_mu == 0)
+  {
+    return 0;
+  }
+  return lim_s8 ((int16_t)(summ_mu_y / summ_mu));
+}
@@ -0,0 +1,80 @@
+/*******************************************************************************
+* \file     fuzzy_mamdani.h
+* \author   Ilya Petrukhin (ilya.petrukhin@gmail.com)
+* \brief    Mamdani centroid defuzzification with output fuzzy sets
+* \version  2.1
+* \date     2026-10-17
+*******************************************************************************/
+
+#ifndef _FUZZY_MAMDANI_H_
+#define _FUZZY_MAMDANI_H_
+
+#include  <stdint.h>
+#include  <stdbool.h>
+#include  "fuzzy_logic.h"
+#include  "fuzzy_model.h"
+
+/*******************************************************************************
+* Rules to using Mamdani defuzzification
+*******************************************************************************/
+// 1. Define output fuzzy sets on the output range +-127 with the same
+// functions as inputs. Rule "output" value selects the set, so the rules
+// of the singleton controller are used without changes:
+//  static const fuzzy_outset sets[] =
+//  {
+//  //  out,            func,       a,      b,    c
+//    { OUT_LOW,        triangle,   -13,    13,   0 },
+//    { OUT_ZERO,       triangle,   0,      13,   0 },
+//    { OUT_HIGH,       triangle,   13,     13,   0 },
+//  };
+//  fuzzy_mamdani md;
+//  fuzzy_mamdani_init (&model, sets, 3, &md);
+//
+// 2. Evaluate with the workspace as process_fuzzy_logic_ws:
+//  int8_t temp = process_fuzzy_logic_mamdani (&md, in, ws);
+//
+// Every set is clipped by the max activation of its rules, sets are
+// aggregated by max, output is the integer centroid
+// sum (y * mu(y)) / sum (mu(y)) over y = -128..127, truncated to zero.
+// fuzzy_mamdani_init keeps for every set its membership table and the
+// area and moment of the set clipped at every level 0..255. A call adds
+// the tables of the active sets and walks only the points where two or
+// more active sets overlap, replacing their sum by max. The result is
+// equal to the centroid over all 256 points.
+// ***************** end of the brief *****************************************
+
+#define FUZZY_MAX_OUTSET  (32)      ///< max output sets
+#define FUZZY_NO_SET      (0xFFu)   ///< rule without output set
+
+/// Output fuzzy set
+typedef struct
+{
+  int8_t    out;      ///< rule output value selecting the set
+  fuzzy     func;     ///< fuzzification function over the output range
+  int8_t    a;        ///< first function parameter
+  int8_t    b;        ///< second function parameter
+  int8_t    c;        ///< third function parameter
+} fuzzy_outset;
+
+/// Mamdani defuzzification tables
+typedef struct
+{
+  const fuzzy_model *model;     ///< compiled model
+  uint8_t           n_set;      ///< number of output sets
+  const uint8_t     *rule_set;  ///< output set of final rule [n_rule], FUZZY_NO_SET
+  const uint8_t     *order;     ///< sets sorted by support low bound [n_set]
+  const int8_t      *lo;        ///< support low bound [n_set]
+  const int8_t      *hi;        ///< support high bound [n_set]
+  const uint8_t     (*tab)[256];    ///< membership of set, index (uint8_t)y
+  const int32_t     (*area)[256];   ///< sum min (level, mu) of set, index level
+  const int32_t     (*moment)[256]; ///< sum y * min (level, mu) of set, index level
+  void              *mem;       ///< owned memory block
+} fuzzy_mamdani;
+
+fuzzy_status fuzzy_mamdani_init (const fuzzy_model *model, const fuzzy_outset *set,
+                                 uint8_t n_set, fuzzy_mamdani *md);   ///< output set tables
+void         fuzzy_mamdani_free (fuzzy_mamdani *md);                  ///< free tables memory
+
+int8_t process_fuzzy_logic_mamdani (const fuzzy_mamdani *md, const int8_t *in_array, uint8_t *ws);
+
+#endif  // _FUZZY_MAMDANI_H_
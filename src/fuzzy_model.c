@@ -0,0 +1,862 @@
+/*******************************************************************************
+* \file     fuzzy_model.c
+* \author   Ilya Petrukhin (ilya.petrukhin@gmail.com)
+* \brief    This file provides code for compiling fuzzy_param lists
+*           into the flat, index based model
+* \version  2.1
+* \date     2026-10-17
+*******************************************************************************/
+#include  <stdio.h>
+#include  <stdint.h>
+#include  <stdbool.h>
+#include  <stdlib.h>
+#include  <string.h>
+#include  "fuzzy_logic.h"
+#include  "fuzzy_model.h"
+#include  "fuzzy_prof.h"
+
+#define ALIGN_UP(x, a)  (((x) + ((a) - 1)) & ~((size_t)(a) - 1))
+
+/// function of this shape is evaluated by lookup table
+#define LUT_WANTED(shape) (((shape) != FS_NONE) && (FUZZY_LUT_MASK & FUZZY_LUT (shape)))
+
+/// prepared functions of the model
+#define PREP_SIZE(n_mf)   ((FUZZY_PREPARED != 0) ? (n_mf) * sizeof (fuzzy_prep) : 0)
+
+/// fuzzification functions by shape
+const fuzzy fuzzy_shape_func[FS_CUSTOM] =
+{
+  [FS_NONE]       = NULL,
+  [FS_CUBE]       = cube,
+  [FS_TRIANGLE]   = triangle,
+  [FS_A_TRIANGLE] = a_triangle,
+  [FS_SQUARE]     = square,
+  [FS_TRAPECIA]   = trapecia,
+  [FS_LOW]        = low,
+  [FS_HIGH]       = high,
+};
+
+/// address of the activation value and its index, for operand lookup
+typedef struct
+{
+  const uint8_t *addr;
+  uint16_t      n;
+} act_addr;
+
+
+/*******************************************************************************
+* сравнение адресов для сортировки и поиска операндов
+* \brief  Compare activation addresses for qsort / bsearch
+*******************************************************************************/
+static int act_addr_cmp (const void *p1, const void *p2)
+{
+  const act_addr *a1 = p1;
+  const act_addr *a2 = p2;
+
+  if (a1->addr < a2->addr)
+  {
+    return -1;
+  }
+  return (a1->addr > a2->addr) ? 1 : 0;
+}
+
+/*******************************************************************************
+* поиск индекса активации по адресу операнда
+* \brief  Find activation index of the rule operand pointer
+* \param[in]  map   sorted address map
+* \param[in]  n     map size
+* \param[in]  addr  operand pointer
+* \param[out] ix    activation index
+* \return           true if operand found
+*******************************************************************************/
+static bool act_find (const act_addr *map, size_t n, const uint8_t *addr, uint16_t *ix)
+{
+  act_addr key = {addr, 0};
+  const act_addr *found = bsearch (&key, map, n, sizeof (act_addr), act_addr_cmp);
+
+  if (found == NULL)
+  {
+    return false;
+  }
+  *ix = found->n;
+  return true;
+}
+
+/*******************************************************************************
+* определение формы функции фуззификации
+* \brief  Shape of the fuzzification function
+* \param[in]  func  fuzzification function pointer
+* \return           shape, FS_CUSTOM for user functions
+*******************************************************************************/
+fuzzy_shape fuzzy_shape_of (fuzzy func)
+{
+  uint8_t shape;
+
+  if (func == NULL)
+  {
+    return FS_NONE;
+  }
+  for (shape = FS_CUBE; shape < FS_CUSTOM; shape++)
+  {
+    if (func == fuzzy_shape_func[shape])
+    {
+      return (fuzzy_shape)shape;
+    }
+  }
+  return FS_CUSTOM;
+}
+
+/*******************************************************************************
+* Компиляция кольцевых списков функций и правил в плоскую модель
+* \brief  Compile circular fuzzy_funct / fuzzy_rules lists into the flat model
+*         Current y values are copied into the activation vector, so rules
+*         which read results of later rules behave as in process_fuzzy_logic
+* \param[in]  param   fuzzy parameters with the first function and rule
+* \param[out] model   compiled model, free with fuzzy_model_free
+* \return             FUZZY_OK or error status
+*******************************************************************************/
+fuzzy_status fuzzy_compile (const fuzzy_param *param, fuzzy_model *model)
+{
+  fuzzy_funct *f;
+  fuzzy_rules *r;
+  fuzzy_mf_desc *mf;
+  fuzzy_rule_ix *rule;
+  fuzzy *func;
+  act_addr *map;
+  uint32_t *cq_off;
+  fuzzy_conseq *cq;
+  fuzzy_ts *ts;
+  size_t n_mf = 0, n_rule = 0, n_lut = 0, n_cq = 0, n_act, i, k;
+  size_t off_mf, off_rule, off_cq_off, off_cq, off_ts, off_prep, off_lut, off_act0, off_act, size;
+  uint8_t (*lut)[256];
+  fuzzy_prep *prep;
+  int16_t x;
+  uint8_t *mem, *act0;
+  uint16_t n_in = 0, n_out = 1;
+  uint8_t seen;
+  bool custom = false, mimo = false, first = false;
+
+  if ((param == NULL) || (model == NULL) ||
+      (param->start_ffunc == NULL) || (param->start_rule == NULL))
+  {
+    return FUZZY_ERR_PARAM;
+  }
+  memset (model, 0, sizeof (fuzzy_model));
+
+  /// подсчёт функций и правил, проверка замкнутости списков
+  f = param->start_ffunc;
+  do
+  {
+    if (f == NULL)
+    {
+      return FUZZY_ERR_LINK;
+    }
+    if (n_mf >= FUZZY_MAX_ACT)
+    {
+      return FUZZY_ERR_SIZE;
+    }
+    if (fuzzy_shape_of (f->func) == FS_CUSTOM)
+    {
+      custom = true;
+    }
+    if (LUT_WANTED (fuzzy_shape_of (f->func)))
+    {
+      n_lut++;
+    }
+    n_mf++;
+    f = f->next;
+  } while (f != param->start_ffunc);
+
+  r = param->start_rule;
+  do
+  {
+    if ((r == NULL) || (n_mf + n_rule >= FUZZY_MAX_ACT))
+    {
+      return (r == NULL) ? FUZZY_ERR_LINK : FUZZY_ERR_SIZE;
+    }
+    if (r->conseq != NULL)
+    {
+      /// выходы в пределах FUZZY_MAX_OUT, не более одного следствия на выход
+      seen = 0;
+      for (k = 0; k < r->n_conseq; k++)
+      {
+        if ((r->conseq[k].on >= FUZZY_MAX_OUT) || (seen & (1u << r->conseq[k].on)))
+        {
+          return FUZZY_ERR_PARAM;
+        }
+        seen |= 1u << r->conseq[k].on;
+        if (r->conseq[k].on >= n_out)
+        {
+          n_out = r->conseq[k].on + 1;
+        }
+      }
+      n_cq += r->fin ? r->n_conseq : 0;
+      mimo = true;
+    }
+    else
+    {
+      n_cq += r->fin ? 1 : 0;
+    }
+    if (r->ts != NULL)
+    {
+      /// следствие первого порядка только выхода 0
+      if ((r->conseq != NULL) || (r->ts->n > FUZZY_TS_MAX_IN))
+      {
+        return FUZZY_ERR_PARAM;
+      }
+      if (r->ts->n > n_in)
+      {
+        n_in = r->ts->n;
+      }
+      first = true;
+    }
+    n_rule++;
+    r = r->next;
+  } while (r != param->start_rule);
+  n_act = n_mf + n_rule;
+
+  /// один блок памяти: функции, правила, таблицы, активации, указатели
+  off_mf   = 0;
+  off_rule = ALIGN_UP (off_mf + n_mf * sizeof (fuzzy_mf_desc), sizeof (void *));
+  off_cq_off = ALIGN_UP (off_rule + n_rule * sizeof (fuzzy_rule_ix), sizeof (void *));
+  off_cq   = off_cq_off + (mimo ? (n_rule + 1) * sizeof (uint32_t) : 0);
+  off_ts   = ALIGN_UP (off_cq + (mimo ? n_cq * sizeof (fuzzy_conseq) : 0), sizeof (void *));
+  off_prep = ALIGN_UP (off_ts + (first ? n_rule * sizeof (fuzzy_ts) : 0), sizeof (void *));
+  off_lut  = ALIGN_UP (off_prep + PREP_SIZE (n_mf), sizeof (void *));
+  off_act0 = off_lut + n_lut * 256;
+  off_act  = off_act0 + n_act;
+  size     = ALIGN_UP (off_act + n_act, sizeof (void *));
+  mem = calloc (1, size + (custom ? n_mf * sizeof (fuzzy) : 0));
+  map = malloc (n_act * sizeof (act_addr));
+  if ((mem == NULL) || (map == NULL))
+  {
+    free (mem);
+    free (map);
+    return FUZZY_ERR_MEMORY;
+  }
+  mf   = (fuzzy_mf_desc *)(mem + off_mf);
+  rule = (fuzzy_rule_ix *)(mem + off_rule);
+  cq_off = mimo ? (uint32_t *)(mem + off_cq_off) : NULL;
+  cq = mimo ? (fuzzy_conseq *)(mem + off_cq) : NULL;
+  ts = first ? (fuzzy_ts *)(mem + off_ts) : NULL;
+  prep = (FUZZY_PREPARED != 0) ? (fuzzy_prep *)(mem + off_prep) : NULL;
+  lut  = (uint8_t (*)[256])(mem + off_lut);
+  func = custom ? (fuzzy *)(mem + size) : NULL;
+  act0 = mem + off_act0;
+  model->act = mem + off_act;
+  n_lut = 0;
+
+  /// дескрипторы функций фуззификации
+  f = param->start_ffunc;
+  for (i = 0; i < n_mf; i++)
+  {
+    mf[i].shape = fuzzy_shape_of (f->func);
+    mf[i].xn    = f->xn;
+    mf[i].a     = f->a;
+    mf[i].b     = f->b;
+    mf[i].c     = f->c;
+    mf[i].y0    = f->y;
+    mf[i].lut   = FUZZY_NO_LUT;
+    if (LUT_WANTED (mf[i].shape))
+    {
+      /// таблица значений функции на всём диапазоне входа
+      for (x = -128; x < 128; x++)
+      {
+        lut[n_lut][(uint8_t)x] = f->func ((int8_t)x, f->a, f->b, f->c);
+      }
+      mf[i].lut = n_lut++;
+    }
+    if (prep)
+    {
+      fuzzy_prepare (&mf[i], &prep[i]);
+    }
+    if (func)
+    {
+      func[i] = f->func;
+    }
+    if (f->xn >= n_in)
+    {
+      n_in = f->xn + 1;
+    }
+    act0[i] = f->y;
+    map[i].addr = &f->y;
+    map[i].n    = i;
+    f = f->next;
+  }
+
+  r = param->start_rule;
+  for (i = 0; i < n_rule; i++)
+  {
+    act0[n_mf + i] = r->y;
+    map[n_mf + i].addr = &r->y;
+    map[n_mf + i].n    = n_mf + i;
+    r = r->next;
+  }
+  qsort (map, n_act, sizeof (act_addr), act_addr_cmp);
+
+  /// правила как тройки индексов
+  r = param->start_rule;
+  for (i = 0; i < n_rule; i++)
+  {
+    if (!act_find (map, n_act, r->a, &rule[i].a) ||
+        !act_find (map, n_act, r->b, &rule[i].b))
+    {
+      free (mem);
+      free (map);
+      memset (model, 0, sizeof (fuzzy_model));
+      return FUZZY_ERR_OPERAND;
+    }
+    rule[i].op  = r->op;
+    rule[i].fin = r->fin;
+    rule[i].out = r->out;
+    if (r->conseq != NULL)
+    {
+      /// для вычислителей одного выхода - следствие выхода 0
+      rule[i].fin = false;
+      rule[i].out = 0;
+      for (k = 0; k < r->n_conseq; k++)
+      {
+        if (r->conseq[k].on == 0)
+        {
+          rule[i].fin = r->fin;
+          rule[i].out = r->conseq[k].out;
+        }
+      }
+    }
+    if (ts)
+    {
+      /// правило без наклонов: постоянное следствие k0
+      if (r->ts != NULL)
+      {
+        ts[i] = *r->ts;
+      }
+      ts[i].k0 = (r->ts != NULL) ? r->ts->k0 : rule[i].out;
+    }
+    if (mimo)
+    {
+      /// следствия всех выходов конечных правил
+      cq_off[i + 1] = cq_off[i];
+      if (r->fin && (r->conseq != NULL))
+      {
+        memcpy (&cq[cq_off[i]], r->conseq, r->n_conseq * sizeof (fuzzy_conseq));
+        cq_off[i + 1] += r->n_conseq;
+      }
+      else if (r->fin)
+      {
+        cq[cq_off[i]].on = 0;
+        cq[cq_off[i]].out = r->out;
+        cq_off[i + 1]++;
+      }
+    }
+    if ((rule[i].a >= n_mf + i) || (rule[i].b >= n_mf + i))
+    {
+      model->flags |= FUZZY_MODEL_FWD;
+    }
+    r = r->next;
+  }
+  free (map);
+
+  model->n_in   = n_in;
+  model->n_mf   = n_mf;
+  model->n_rule = n_rule;
+  model->n_lut  = n_lut;
+  model->mf     = mf;
+  model->rule   = rule;
+  model->n_out  = n_out;
+  model->cq_off = cq_off;
+  model->cq     = cq;
+  model->ts     = ts;
+  model->func   = func;
+  model->lut    = (const uint8_t (*)[256])lut;
+  model->prep   = prep;
+  model->act0   = act0;
+  model->mem    = mem;
+  memcpy (model->act, act0, n_act);
+  return FUZZY_OK;
+}
+
+/*******************************************************************************
+* Освобождение памяти модели
+* \brief  Free compiled model memory
+* \param[in]  model   compiled model
+*******************************************************************************/
+void fuzzy_model_free (fuzzy_model *model)
+{
+  if (model)
+  {
+    free (model->mem);
+    memset (model, 0, sizeof (fuzzy_model));
+  }
+}
+
+/*******************************************************************************
+* Приведение функции фуззификации к нормальной форме
+* \brief  Normal form of the fuzzification function, reproduces the function
+*         bit-for-bit including int8_t wrap of its break points; parameters
+*         which wrap or give irregular shape are FN_FUNC
+* \param[in]  mf      fuzzy function descriptor
+* \param[out] norm    normal form
+*******************************************************************************/
+void fuzzy_normalize (const fuzzy_mf_desc *mf, fuzzy_norm *norm)
+{
+  int16_t p1 = mf->a, p2 = mf->b, p3 = mf->c, temp;
+  int8_t min, max, min2, max2;
+
+  memset (norm, 0, sizeof (fuzzy_norm));
+  norm->kind = FN_TRAP;
+  switch (mf->shape)
+  {
+  case FS_CUBE:
+    if (p2 == -128)                   // -p2 doesn't fit int8_t
+    {
+      norm->kind = FN_FUNC;
+      break;
+    }
+    temp = (p2 < 0) ? -p2 : p2;
+    norm->d3 = (int32_t)temp * temp * temp;
+    if (norm->d3 == 0)                // 255 at median only
+    {
+      norm->lo = norm->t0 = norm->t1 = norm->hi = p1;
+    }
+    else
+    {
+      norm->kind = FN_CUBE;
+      norm->m = (int8_t)p1;
+    }
+    break;
+
+  case FS_TRIANGLE:
+    p3 = p2;
+    /* fall through */
+  case FS_A_TRIANGLE:
+    if ((p2 == 0) || (p3 == 0) ||
+        ((mf->shape == FS_TRIANGLE) && (p2 < 0) && (p1 - p2 <= 127) && (p1 + p2 >= -128)))
+    {
+      norm->kind = FN_CONST;          // protection or empty range
+    }
+    else if ((p2 > 0) && (p3 > 0) && (p1 - p2 >= -128) && (p1 + p3 <= 127))
+    {
+      norm->lo = p1 - p2;
+      norm->t0 = norm->t1 = p1;
+      norm->hi = p1 + p3;
+    }
+    else
+    {
+      norm->kind = FN_FUNC;
+    }
+    break;
+
+  case FS_SQUARE:
+    if (p1 - p2 > p1 + p2)
+    {
+      norm->kind = FN_CONST;
+    }
+    else
+    {
+      norm->lo = norm->t0 = p1 - p2;
+      norm->t1 = norm->hi = p1 + p2;
+    }
+    break;
+
+  case FS_TRAPECIA:
+    min  = (int8_t)(p1 - p2);
+    max  = (int8_t)(p1 + p2);
+    min2 = (int8_t)(p1 - p3);
+    max2 = (int8_t)(p1 + p3);
+    if ((min2 <= min) && (min <= max) && (max <= max2))
+    {
+      norm->lo = min2;
+      norm->t0 = min;
+      norm->t1 = max;
+      norm->hi = max2;
+    }
+    else
+    {
+      norm->kind = FN_FUNC;
+    }
+    break;
+
+  case FS_LOW:
+  case FS_HIGH:
+    if (p1 > p2)                      // swap p1, p2
+    {
+      temp = p1;
+      p1 = p2;
+      p2 = temp;
+    }
+    if (mf->shape == FS_LOW)
+    {
+      norm->lo = norm->t0 = -256;
+      norm->t1 = p1;
+      norm->hi = p2;
+    }
+    else
+    {
+      norm->lo = p1;
+      norm->t0 = p2;
+      norm->t1 = norm->hi = 256;
+    }
+    break;
+
+  case FS_NONE:
+    norm->kind = FN_CONST;
+    norm->y = mf->y0;
+    break;
+
+  case FS_CUSTOM:
+  default:
+    norm->kind = FN_FUNC;
+    break;
+  }
+}
+
+/*******************************************************************************
+* Подготовка функции фуззификации без деления
+* \brief  Prepared form of the fuzzification function: normal form with
+*         reciprocal slopes, bit-identical to the function. For 0 <= v < d
+*         <= 255 the error of k = ceil (255 * 2^16 / d) is below 255 / 2^16,
+*         less than the distance 1 / d of v * 255 / d to the next integer
+* \param[in]  mf      fuzzy function descriptor
+* \param[out] prep    prepared function
+*******************************************************************************/
+void fuzzy_prepare (const fuzzy_mf_desc *mf, fuzzy_prep *prep)
+{
+  fuzzy_norm norm;
+
+  fuzzy_normalize (mf, &norm);
+  memset (prep, 0, sizeof (fuzzy_prep));
+  prep->kind = norm.kind;
+  prep->y    = norm.y;
+  switch (norm.kind)
+  {
+  case FN_TRAP:
+    prep->lo = norm.lo;
+    prep->t0 = norm.t0;
+    prep->t1 = norm.t1;
+    prep->hi = norm.hi;
+    if (norm.t0 > norm.lo)
+    {
+      prep->k0 = ((255u << FUZZY_PREP_SHIFT) + (uint32_t)(norm.t0 - norm.lo) - 1u) /
+                 (uint32_t)(norm.t0 - norm.lo);
+    }
+    if (norm.hi > norm.t1)
+    {
+      prep->k1 = ((255u << FUZZY_PREP_SHIFT) + (uint32_t)(norm.hi - norm.t1) - 1u) /
+                 (uint32_t)(norm.hi - norm.t1);
+    }
+    break;
+
+  case FN_CUBE:
+    prep->lo = norm.m;
+    prep->k0 = (uint32_t)norm.d3 * 255u;
+    prep->k1 = (uint32_t)norm.d3;
+    break;
+
+  default:
+    break;
+  }
+}
+
+/*******************************************************************************
+* Число связей операнд -> правило
+* \brief  Number of links activation -> rule reading it (operands a == b
+*         counted once), size of dep for fuzzy_dep_build
+* \param[in]  model   compiled model
+* \return             number of links
+*******************************************************************************/
+size_t fuzzy_dep_count (const fuzzy_model *model)
+{
+  size_t n_dep = 0, i;
+
+  for (i = 0; i < model->n_rule; i++)
+  {
+    n_dep += (model->rule[i].a == model->rule[i].b) ? 1 : 2;
+  }
+  return n_dep;
+}
+
+/*******************************************************************************
+* Граф зависимостей активация -> правила
+* \brief  Rules reading activation k: dep[dep_off[k]..dep_off[k + 1]),
+*         in list order (CSR arrays)
+* \param[in]  model     compiled model
+* \param[out] dep_off   offsets [n_mf + n_rule + 1]
+* \param[out] dep       rule numbers [fuzzy_dep_count]
+*******************************************************************************/
+void fuzzy_dep_build (const fuzzy_model *model, uint32_t *dep_off, uint16_t *dep)
+{
+  const fuzzy_rule_ix *r;
+  size_t n_act = (size_t)model->n_mf + model->n_rule, i;
+
+  memset (dep_off, 0, (n_act + 1) * sizeof (uint32_t));
+  for (i = 0, r = model->rule; i < model->n_rule; i++, r++)
+  {
+    dep_off[r->a + 1]++;
+    if (r->b != r->a)
+    {
+      dep_off[r->b + 1]++;
+    }
+  }
+  for (i = 0; i < n_act; i++)
+  {
+    dep_off[i + 1] += dep_off[i];
+  }
+  for (i = 0, r = model->rule; i < model->n_rule; i++, r++)
+  {
+    dep[dep_off[r->a]++] = (uint16_t)i;
+    if (r->b != r->a)
+    {
+      dep[dep_off[r->b]++] = (uint16_t)i;
+    }
+  }
+  for (i = n_act; i > 0; i--)
+  {
+    dep_off[i] = dep_off[i - 1];
+  }
+  dep_off[0] = 0;
+}
+
+/*******************************************************************************
+* Размер рабочей области вычисления
+* \brief  Workspace size of the model in bytes (activation vector)
+* \param[in]  model   compiled model
+* \return             workspace size
+*******************************************************************************/
+size_t fuzzy_workspace_size (const fuzzy_model *model)
+{
+  return (size_t)model->n_mf + model->n_rule;
+}
+
+/*******************************************************************************
+* Начальное состояние рабочей области
+* \brief  Copy initial activations (y values at compile time) into workspace
+*         Required only for FUZZY_MODEL_FWD models, where rules read results
+*         of the previous call
+* \param[in]  model   compiled model
+* \param[out] ws      workspace [fuzzy_workspace_size]
+*******************************************************************************/
+void fuzzy_workspace_init (const fuzzy_model *model, uint8_t *ws)
+{
+  memcpy (ws, model->act0, fuzzy_workspace_size (model));
+}
+
+#if (FUZZY_LUT_MASK == 0)
+/*******************************************************************************
+* функции фуззификации модели с таблицами образа (FUZZY_IMAGE_LUT) в сборке
+* без FUZZY_LUT_MASK: отдельно, цикл модели без таблиц не меняется
+*******************************************************************************/
+static void model_fuzzify_lut (const fuzzy_model *model, const int8_t *in_array, uint8_t *ws)
+{
+  const fuzzy_mf_desc *mf = model->mf;
+  uint16_t i;
+
+  for (i = 0; i < model->n_mf; i++, mf++)
+  {
+    ws[i] = fuzzy_mf_eval (model, i, in_array[mf->xn]);   // таблица, если есть
+  }
+}
+#endif
+
+/*******************************************************************************
+* функции фуззификации модели в рабочую область
+*******************************************************************************/
+static inline void model_fuzzify (const fuzzy_model *model, const int8_t *in_array, uint8_t *ws)
+{
+  const fuzzy_mf_desc *mf = model->mf;
+  uint16_t n_mf = model->n_mf;
+  uint16_t i;
+
+#if (FUZZY_LUT_MASK == 0)
+  if (model->n_lut != 0)
+  {
+    model_fuzzify_lut (model, in_array, ws);
+    return;
+  }
+#endif
+  for (i = 0; i < n_mf; i++, mf++)
+  {
+#if (FUZZY_LUT_MASK != 0)
+    if (mf->lut != FUZZY_NO_LUT)
+    {
+      ws[i] = model->lut[mf->lut][(uint8_t)in_array[mf->xn]];
+      continue;
+    }
+#endif
+#if (FUZZY_PREPARED != 0)
+    if ((model->prep != NULL) && (model->prep[i].kind != FN_FUNC))
+    {
+      ws[i] = fuzzy_prep_eval (&model->prep[i], in_array[mf->xn]);
+      continue;
+    }
+#endif
+    if ((mf->shape - 1u) < (FS_CUSTOM - 1u))   // FS_CUBE..FS_HIGH
+    {
+      ws[i] = fuzzy_shape_func[mf->shape] (in_array[mf->xn], mf->a, mf->b, mf->c);
+    }
+    else
+    {
+      ws[i] = fuzzy_mf_eval (model, i, in_array[mf->xn]);
+    }
+  }
+}
+
+/*******************************************************************************
+* Реализация нечеткого регулятора по скомпилированной модели
+* \brief Fuzzy logic controller by the compiled model, bit-identical
+*        to process_fuzzy_logic on the same fuzzy_param
+* \param[in] model     compiled model
+* \param[in] in_array  input values array [model->n_in]
+* \return Output control value
+*******************************************************************************/
+int8_t process_fuzzy_logic_compiled (fuzzy_model *model, const int8_t *in_array)
+{
+  return process_fuzzy_logic_ws (model, in_array, model->act);
+}
+
+/*******************************************************************************
+* Реализация нечеткого регулятора с рабочей областью вызывающего
+* \brief Reentrant fuzzy logic controller: the model is only read, all
+*        intermediate results go to the caller workspace, so one model can be
+*        evaluated from many threads, each with its own workspace
+* \param[in] model     compiled model
+* \param[in] in_array  input values array [model->n_in]
+* \param[in] ws        workspace [fuzzy_workspace_size]
+* \return Output control value
+*******************************************************************************/
+int8_t process_fuzzy_logic_ws (const fuzzy_model *model, const int8_t *in_array, uint8_t *ws)
+{
+  const fuzzy_rule_ix *r = model->rule;
+  const fuzzy_ts *ts = model->ts;
+  uint8_t *y = ws + model->n_mf;
+  uint16_t n_rule = model->n_rule;
+  int16_t summ_alpha_c = 0;
+  int16_t summ_alpha = 0;
+  int16_t alpha, out, ret;
+  uint16_t i;
+
+  FUZZY_PROF_START ();
+  /// получить результаты функций фуззификации
+  model_fuzzify (model, in_array, ws);
+  FUZZY_PROF_MARK (FUZZY_STAGE_FUZZIFY);
+
+  /// цикл по правилам нечёткой логики
+  if (ts == NULL)
+  {
+    for (i = 0; i < n_rule; i++, r++)
+    {
+      alpha = fuzzy_operator (r->op, ws[r->a], ws[r->b]);
+      y[i] = alpha;
+
+      if (r->fin)  // если это конечное выражение
+      {
+        summ_alpha_c += (alpha * (int16_t)r->out);
+        summ_alpha += alpha;
+      }
+    }
+  }
+  else
+  {
+    /// следствия первого порядка только сработавших правил
+    for (i = 0; i < n_rule; i++, r++)
+    {
+      alpha = fuzzy_operator (r->op, ws[r->a], ws[r->b]);
+      y[i] = alpha;
+
+      if (r->fin && (alpha != 0))
+      {
+        out = fuzzy_ts_eval (&ts[i], in_array);
+        summ_alpha_c += (alpha * out);
+        summ_alpha += alpha;
+      }
+    }
+  }
+  FUZZY_PROF_MARK (FUZZY_STAGE_RULES);
+
+  /// вычисляем воздействие на объект управления
+  if (summ_alpha == 0)
+  {
+    ret = 0;
+  }
+  else
+  {
+    ret = summ_alpha_c / summ_alpha;
+  }
+  FUZZY_PROF_MARK (FUZZY_STAGE_DEFUZZ);
+  FUZZY_PROF_ACTS (ws, model->n_mf, y, n_rule);
+  return lim_s8 (ret);
+}
+
+/*******************************************************************************
+* Активации функций и правил без приведения к четкости
+* \brief Evaluate fuzzy functions and rules into the workspace without
+*        defuzzification, for defuzzifiers other than the singleton one
+* \param[in]  model     compiled model
+* \param[in]  in_array  input values array [model->n_in]
+* \param[in]  ws        workspace [fuzzy_workspace_size]
+*******************************************************************************/
+void fuzzy_model_activate (const fuzzy_model *model, const int8_t *in_array, uint8_t *ws)
+{
+  const fuzzy_rule_ix *r = model->rule;
+  uint8_t *y = ws + model->n_mf;
+  uint16_t n_rule = model->n_rule;
+  uint16_t i;
+
+  model_fuzzify (model, in_array, ws);
+  for (i = 0; i < n_rule; i++, r++)
+  {
+    y[i] = fuzzy_operator (r->op, ws[r->a], ws[r->b]);
+  }
+}
+
+/*******************************************************************************
+* Нечеткий регулятор с несколькими выходами по скомпилированной модели
+* \brief Fuzzy logic controller with model->n_out outputs: fuzzification
+*        and rules once, centroid per output; output 0 is equal to
+*        process_fuzzy_logic_ws
+* \param[in]  model     compiled model
+* \param[in]  in_array  input values array [model->n_in]
+* \param[in]  ws        workspace [fuzzy_workspace_size]
+* \param[out] out       output control values [model->n_out]
+*******************************************************************************/
+void process_fuzzy_logic_mimo (const fuzzy_model *model, const int8_t *in_array, uint8_t *ws, int8_t *out)
+{
+  const fuzzy_rule_ix *r = model->rule;
+  const fuzzy_conseq *c, *c_end;
+  uint8_t *y = ws + model->n_mf;
+  uint16_t n_rule = model->n_rule;
+  int16_t summ_alpha_c[FUZZY_MAX_OUT] = {0};
+  int16_t summ_alpha[FUZZY_MAX_OUT] = {0};
+  int16_t alpha, value, ret;
+  uint16_t i;
+
+  if (model->cq_off == NULL)
+  {
+    out[0] = process_fuzzy_logic_ws (model, in_array, ws);
+    return;
+  }
+
+  /// получить результаты функций фуззификации
+  model_fuzzify (model, in_array, ws);
+
+  /// цикл по правилам нечёткой логики, суммы каждого выхода
+  for (i = 0; i < n_rule; i++, r++)
+  {
+    alpha = fuzzy_operator (r->op, ws[r->a], ws[r->b]);
+    y[i] = alpha;
+
+    c_end = &model->cq[model->cq_off[i + 1]];
+    for (c = &model->cq[model->cq_off[i]]; c < c_end; c++)
+    {
+      value = ((model->ts == NULL) || (c->on != 0)) ? c->out : fuzzy_ts_eval (&model->ts[i], in_array);
+      summ_alpha_c[c->on] += (alpha * value);
+      summ_alpha[c->on] += alpha;
+    }
+  }
+
+  /// воздействия на объект управления
+  for (i = 0; i < model->n_out; i++)
+  {
+    ret = (summ_alpha[i] == 0) ? 0 : summ_alpha_c[i] / summ_alpha[i];
+    out[i] = lim_s8 (ret);
+  }
+}
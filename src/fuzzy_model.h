@@ -0,0 +1,338 @@
+/*******************************************************************************
+* \file     fuzzy_model.h
+* \author   Ilya Petrukhin (ilya.petrukhin@gmail.com)
+* \brief    Compiled (flat, index based) fuzzy logic model
+* \version  2.1
+* \date     2026-10-17
+*******************************************************************************/
+
+#ifndef _FUZZY_MODEL_H_
+#define _FUZZY_MODEL_H_
+
+#include  <stdint.h>
+#include  <stdbool.h>
+#include  <stddef.h>
+#include  "fuzzy_logic.h"
+
+/*******************************************************************************
+* Rules to using compiled model
+*******************************************************************************/
+// 1. Build fuzzy functions and rules with MAKE_FFUNC / MAKE_RULE as usual
+//
+// 2. Compile the circular lists into the flat model once:
+//  fuzzy_model model;
+//  if (fuzzy_compile (&fuzzy, &model) != FUZZY_OK)
+//  {
+//    error...
+//  }
+//
+// 3. Evaluate with the same input array as process_fuzzy_logic:
+//  int8_t temp = process_fuzzy_logic_compiled (&model, in);
+//
+// Activation vector layout: [0..n_mf) - fuzzy functions in list order,
+// [n_mf..n_mf+n_rule) - rules in list order. Rule operands are indexes
+// into this vector, so evaluation is a straight loop over dense arrays.
+//
+// 4. Optional lookup tables: define FUZZY_LUT_MASK at build time as set of
+// shape bits, e.g. -DFUZZY_LUT_MASK=FUZZY_LUT_ALL or
+// -DFUZZY_LUT_MASK="(FUZZY_LUT(FS_CUBE) | FUZZY_LUT(FS_TRIANGLE))".
+// fuzzy_compile builds 256-byte table per function of these shapes and
+// fuzzification becomes one indexed load: RAM 256 bytes per function.
+// Every build uses the table of a function when it has one, so tables of
+// binary images saved with FUZZY_IMAGE_LUT work without the mask too.
+//
+// 5. Reentrant evaluation: the model is not changed by evaluation, every
+// caller (thread) passes own workspace of fuzzy_workspace_size bytes:
+//  uint8_t ws[fuzzy_workspace_size (&model)];   // or malloc
+//  fuzzy_workspace_init (&model, ws);           // FUZZY_MODEL_FWD models only
+//  int8_t temp = process_fuzzy_logic_ws (&model, in, ws);
+// process_fuzzy_logic_compiled uses the workspace inside the model and is
+// not reentrant.
+//
+// 6. Several outputs (rules made by MAKE_RULE_MO): all model->n_out
+// outputs by one pass, every engine of one output gives the output 0:
+//  int8_t out[FUZZY_MAX_OUT];
+//  process_fuzzy_logic_mimo (&model, in, ws, out);
+//
+// 7. Prepared functions without division (RAM 20 bytes per function instead
+// of 256-byte table): define FUZZY_PREPARED=1 at build time, fuzzy_compile
+// keeps fuzzy_prep of every function: parameters normalized once (swap of
+// low / high, int8_t wrap, protections), ramps v * 255 / d replaced by
+// (v * k) >> 16 with k = ceil (255 * 2^16 / d). Exact for every d <= 255,
+// activations are bit-identical to the functions. Cube keeps one division
+// by d^3 + |x - m|^3 (depends on x), d^3 * 255 is precomputed. Functions
+// with irregular parameters (FN_FUNC) and FS_CUSTOM are called as before;
+// models of binary images have no prepared functions. Tables of
+// FUZZY_LUT_MASK shapes go first.
+//  fuzzy_prep prep;                            // or by hand, any build
+//  fuzzy_prepare (&model.mf[n], &prep);
+//  uint8_t y = fuzzy_prep_eval (&prep, x);     // prep.kind != FN_FUNC
+//
+// 8. First-order consequents (rules made by MAKE_RULE_TS): model->ts keeps
+// the consequent of every rule, constant rules as k0 = out without slopes.
+// Compiled, reentrant, MIMO (output 0), batch (scalar path), sparse and
+// reference engines give the same output as process_fuzzy_logic; the
+// other engines need constant outputs and return FUZZY_ERR_STRUCT.
+// ***************** end of the brief *****************************************
+
+#define FUZZY_MAX_ACT     (0xFFFFu)   ///< max activations (functions + rules)
+#define FUZZY_NO_LUT      (0xFFFFu)   ///< function has no lookup table
+
+#define FUZZY_LUT(shape)  (1u << (shape))   ///< LUT mask bit of the shape
+#define FUZZY_LUT_ALL     (0x1FEu)          ///< all shapes FS_CUBE..FS_CUSTOM
+
+#ifndef FUZZY_LUT_MASK
+#define FUZZY_LUT_MASK    (0u)              ///< shapes evaluated by lookup tables
+#endif
+
+#ifndef FUZZY_PREPARED
+#define FUZZY_PREPARED    (0)               ///< 1 - prepared functions without division
+#endif
+
+#define FUZZY_PREP_SHIFT  (16)              ///< fixed point of prepared slopes, Q16.16
+
+/// Status of the model building functions
+typedef enum
+{
+  FUZZY_OK = 0,         ///< success
+  FUZZY_ERR_PARAM,      ///< invalid argument
+  FUZZY_ERR_LINK,       ///< function or rule list is not circular
+  FUZZY_ERR_OPERAND,    ///< rule operand is not a function or rule result
+  FUZZY_ERR_SIZE,       ///< model too big for index width
+  FUZZY_ERR_MEMORY,     ///< out of memory
+  FUZZY_ERR_FILE,       ///< file open, read or write error
+  FUZZY_ERR_SYNTAX,     ///< syntax error in text description
+  FUZZY_ERR_IMAGE,      ///< invalid binary image or checksum
+  FUZZY_ERR_STRUCT      ///< rules have not the structure required by the engine
+} fuzzy_status;
+
+/// Fuzzification function shapes known to the compiler
+typedef enum
+{
+  FS_NONE = 0,          ///< no function, activation is constant y0
+  FS_CUBE,              ///< cube
+  FS_TRIANGLE,          ///< triangle
+  FS_A_TRIANGLE,        ///< a_triangle
+  FS_SQUARE,            ///< square
+  FS_TRAPECIA,          ///< trapecia
+  FS_LOW,               ///< low
+  FS_HIGH,              ///< high
+  FS_CUSTOM             ///< user function, called through func[]
+} fuzzy_shape;
+
+/// Fuzzification function descriptor
+typedef struct
+{
+  uint8_t   shape;      ///< fuzzy_shape
+  uint8_t   xn;         ///< input parameter number
+  int8_t    a;          ///< first function parameter
+  int8_t    b;          ///< second function parameter
+  int8_t    c;          ///< third function parameter
+  uint8_t   y0;         ///< constant activation for FS_NONE
+  uint16_t  lut;        ///< lookup table number or FUZZY_NO_LUT
+} fuzzy_mf_desc;
+
+/// Rule as index triple into the activation vector
+typedef struct
+{
+  uint16_t  a;          ///< operand a activation index
+  uint16_t  b;          ///< operand b activation index
+  uint8_t   op;         ///< fuzzy_op
+  uint8_t   fin;        ///< final rule flag
+  int8_t    out;        ///< output fuzzy value
+  uint8_t   reserved;   ///< alignment
+} fuzzy_rule_ix;
+
+/// Normal form kinds of the fuzzification function
+typedef enum
+{
+  FN_CONST = 0,         ///< constant activation y
+  FN_TRAP,              ///< trapezoid lo <= t0 <= t1 <= hi
+  FN_CUBE,              ///< cube with median m and d3 = D_0.5^3 > 0
+  FN_FUNC               ///< irregular parameters, only the function itself
+} fuzzy_norm_kind;
+
+/// Normal form of the fuzzification function, bit-identical to the function
+/// FN_TRAP: 0 outside [lo, hi], 255 on [t0, t1], (x - lo) * 255 / (t0 - lo)
+/// on [lo, t0), (hi - x) * 255 / (hi - t1) on (t1, hi]; lo == t0 or
+/// t1 == hi - vertical edge
+typedef struct
+{
+  uint8_t   kind;       ///< fuzzy_norm_kind
+  uint8_t   y;          ///< FN_CONST activation
+  int8_t    m;          ///< FN_CUBE median
+  int16_t   lo;         ///< FN_TRAP left base
+  int16_t   t0;         ///< FN_TRAP left top
+  int16_t   t1;         ///< FN_TRAP right top
+  int16_t   hi;         ///< FN_TRAP right base
+  int32_t   d3;         ///< FN_CUBE D_0.5^3
+} fuzzy_norm;
+
+/// Prepared fuzzification function: normal form with reciprocal slopes
+/// FN_TRAP: ramps (x - lo) * k0 >> 16 on [lo, t0), (hi - x) * k1 >> 16 on (t1, hi]
+/// FN_CUBE: k0 / (|x - lo|^3 + k1), k0 = d3 * 255, k1 = d3, lo - median
+typedef struct
+{
+  uint8_t   kind;       ///< fuzzy_norm_kind
+  uint8_t   y;          ///< FN_CONST activation
+  int16_t   lo;         ///< left base (FN_CUBE median)
+  int16_t   t0;         ///< left top
+  int16_t   t1;         ///< right top
+  int16_t   hi;         ///< right base
+  uint32_t  k0;         ///< left slope ceil (255 * 2^16 / (t0 - lo)), FN_CUBE d3 * 255
+  uint32_t  k1;         ///< right slope ceil (255 * 2^16 / (hi - t1)), FN_CUBE d3
+} fuzzy_prep;
+
+#define FUZZY_MODEL_FWD   (0x01u)   ///< some rule reads result of itself or later rule
+
+/// Compiled fuzzy model
+typedef struct
+{
+  uint16_t              n_in;     ///< number of inputs (max xn + 1)
+  uint16_t              n_mf;     ///< number of fuzzy functions
+  uint16_t              n_rule;   ///< number of rules
+  uint16_t              n_lut;    ///< number of lookup tables
+  uint16_t              flags;    ///< FUZZY_MODEL_xxx
+  uint16_t              n_out;    ///< number of outputs
+  const fuzzy_mf_desc   *mf;      ///< fuzzy function descriptors [n_mf]
+  const fuzzy_rule_ix   *rule;    ///< rules [n_rule], fin / out - output 0
+  const uint32_t        *cq_off;  ///< consequents of final rule i: cq[cq_off[i]..cq_off[i + 1]), NULL - one output
+  const fuzzy_conseq    *cq;      ///< consequents of final rules
+  const fuzzy_ts        *ts;      ///< first-order consequents of output 0 [n_rule], NULL - constant out only
+  const fuzzy           *func;    ///< function pointers for FS_CUSTOM [n_mf]
+  const uint8_t         (*lut)[256]; ///< lookup tables [n_lut], index (uint8_t)x
+  const fuzzy_prep      *prep;    ///< prepared functions [n_mf], NULL - not built
+  const uint8_t         *act0;    ///< initial activation vector [n_mf + n_rule]
+  uint8_t               *act;     ///< default workspace of process_fuzzy_logic_compiled
+  void                  *mem;     ///< owned memory block
+} fuzzy_model;
+
+
+fuzzy_status fuzzy_compile (const fuzzy_param *param, fuzzy_model *model);  ///< compile lists into the flat model
+void         fuzzy_model_free (fuzzy_model *model);                         ///< free compiled model memory
+fuzzy_shape  fuzzy_shape_of (fuzzy func);                                   ///< shape of fuzzification function
+void         fuzzy_normalize (const fuzzy_mf_desc *mf, fuzzy_norm *norm);   ///< normal form of fuzzy function
+void         fuzzy_prepare (const fuzzy_mf_desc *mf, fuzzy_prep *prep);     ///< prepared fuzzy function
+
+extern const fuzzy fuzzy_shape_func[FS_CUSTOM];   ///< fuzzification function of the shape
+
+size_t fuzzy_dep_count (const fuzzy_model *model);                        ///< rule operand links
+void   fuzzy_dep_build (const fuzzy_model *model, uint32_t *dep_off, uint16_t *dep); ///< activation -> rules graph
+
+size_t fuzzy_workspace_size (const fuzzy_model *model);                   ///< workspace size in bytes
+void   fuzzy_workspace_init (const fuzzy_model *model, uint8_t *ws);       ///< initial workspace state
+
+int8_t process_fuzzy_logic_compiled (fuzzy_model *model, const int8_t *in_array);
+int8_t process_fuzzy_logic_ws (const fuzzy_model *model, const int8_t *in_array, uint8_t *ws);
+void   fuzzy_model_activate (const fuzzy_model *model, const int8_t *in_array, uint8_t *ws);
+void   process_fuzzy_logic_mimo (const fuzzy_model *model, const int8_t *in_array, uint8_t *ws, int8_t *out);
+
+
+/*************************************************************************
+ * \brief Evaluate prepared fuzzification function: one multiply and
+ *        shift on the ramps, no division (FN_FUNC has to be evaluated
+ *        by the function)
+ * \param prep      prepared function
+ * \param x         input value
+ * \return uint8_t  activation 0..255
+*************************************************************************/
+inline static uint8_t fuzzy_prep_eval (const fuzzy_prep *prep, int8_t x)
+{
+  uint32_t dx;
+
+  switch (prep->kind)
+  {
+  case FN_TRAP:
+    if ((x < prep->lo) || (x > prep->hi))
+    {
+      return 0;
+    }
+    if (x < prep->t0)
+    {
+      return (uint8_t)(((uint32_t)(x - prep->lo) * prep->k0) >> FUZZY_PREP_SHIFT);
+    }
+    if (x <= prep->t1)
+    {
+      return 255;
+    }
+    return (uint8_t)(((uint32_t)(prep->hi - x) * prep->k1) >> FUZZY_PREP_SHIFT);
+
+  case FN_CUBE:
+    dx = (uint32_t)((x < prep->lo) ? (prep->lo - x) : (x - prep->lo));
+    return (uint8_t)(prep->k0 / (dx * dx * dx + prep->k1));
+
+  case FN_CONST:
+  default:
+    return prep->y;
+  }
+}
+
+/*************************************************************************
+ * \brief Evaluate one fuzzification function descriptor
+ * \param model     compiled model
+ * \param n         fuzzy function number
+ * \param x         input value
+ * \return uint8_t  activation 0..255
+*************************************************************************/
+inline static uint8_t fuzzy_mf_eval (const fuzzy_model *model, uint16_t n, int8_t x)
+{
+  const fuzzy_mf_desc *d = &model->mf[n];
+  fuzzy func;
+
+  if (d->lut != FUZZY_NO_LUT)
+  {
+    return model->lut[d->lut][(uint8_t)x];
+  }
+#if (FUZZY_PREPARED != 0)
+  if ((model->prep != NULL) && (model->prep[n].kind != FN_FUNC))
+  {
+    return fuzzy_prep_eval (&model->prep[n], x);
+  }
+#endif
+  if (d->shape == FS_NONE)
+  {
+    return d->y0;
+  }
+  func = (d->shape == FS_CUSTOM) ? model->func[n] : fuzzy_shape_func[d->shape];
+  return func (x, d->a, d->b, d->c);
+}
+
+/*************************************************************************
+ * \brief Evaluate normal form of the fuzzification function
+ *        (FN_FUNC has to be evaluated by fuzzy_mf_eval)
+ * \param norm      normal form
+ * \param x         input value
+ * \return uint8_t  activation 0..255
+*************************************************************************/
+inline static uint8_t fuzzy_norm_eval (const fuzzy_norm *norm, int8_t x)
+{
+  int32_t dx;
+
+  switch (norm->kind)
+  {
+  case FN_TRAP:
+    if ((x < norm->lo) || (x > norm->hi))
+    {
+      return 0;
+    }
+    if (x < norm->t0)
+    {
+      return (uint8_t)(((x - norm->lo) * 255) / (norm->t0 - norm->lo));
+    }
+    if (x <= norm->t1)
+    {
+      return 255;
+    }
+    return (uint8_t)(((norm->hi - x) * 255) / (norm->hi - norm->t1));
+
+  case FN_CUBE:
+    dx = (x < norm->m) ? (norm->m - x) : (x - norm->m);
+    return (uint8_t)((norm->d3 * 255) / (dx * dx * dx + norm->d3));
+
+  case FN_CONST:
+  default:
+    return norm->y;
+  }
+}
+
+#endif  // _FUZZY_MODEL_H_
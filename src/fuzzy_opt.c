@@ -0,0 +1,480 @@
+/*******************************************************************************
+* \file     fuzzy_opt.c
+* \author   Ilya Petrukhin (ilya.petrukhin@gmail.com)
+* \brief    This file provides code for the optimizer of the rule base:
+*           common subexpressions, constant folding, dead rules
+* \version  2.1
+* \date     2026-10-17
+*******************************************************************************/
+#include  <stdio.h>
+#include  <stdint.h>
+#include  <stdbool.h>
+#include  <stdlib.h>
+#include  <string.h>
+#include  "fuzzy_logic.h"
+#include  "fuzzy_model.h"
+#include  "fuzzy_opt.h"
+
+#define ALIGN_UP(x, a)  (((x) + ((a) - 1)) & ~((size_t)(a) - 1))
+
+/// значение: индекс активации >= 0 или константа c как -(c + 1)
+#define VAL_CONST(c)    (-(int32_t)(c) - 1)
+#define IS_CONST(v)     ((v) < 0)
+#define CONST_OF(v)     ((uint8_t)(-(v) - 1))
+
+#define NO_OWNER        (-1)
+#define NO_FOLD         (INT32_MIN)       ///< fold: rule needs a node
+
+/// узел графа после оптимизации
+typedef struct
+{
+  int32_t   a;          ///< operand value
+  int32_t   b;          ///< operand value
+  int32_t   owner;      ///< source rule giving the consequents, NO_OWNER - intermediate
+  uint8_t   op;         ///< fuzzy_op
+  bool      emit;       ///< rule is in the result
+  bool      live;       ///< read by the result
+} opt_node;
+
+/// таблица свёртки одинаковых выражений
+typedef struct
+{
+  uint64_t  *key;
+  int32_t   *val;
+  size_t    mask;
+} opt_hash;
+
+
+/*******************************************************************************
+* поиск ключа, вставка при отсутствии
+* \return значение найденного ключа или v вставленного
+*******************************************************************************/
+static int32_t hash_find (opt_hash *h, uint64_t key, int32_t v)
+{
+  size_t i = (size_t)((key * 0x9E3779B97F4A7C15ull) >> 32) & h->mask;
+
+  while (h->key[i] != 0)
+  {
+    if (h->key[i] == key)
+    {
+      return h->val[i];
+    }
+    i = (i + 1) & h->mask;
+  }
+  h->key[i] = key;
+  h->val[i] = v;
+  return v;
+}
+
+/// ключ функции: форма, вход, параметры (ключ 0 - пустая ячейка)
+static inline uint64_t mf_key (const fuzzy_mf_desc *d)
+{
+  return ((uint64_t)d->shape << 32) | ((uint64_t)d->xn << 24) | ((uint64_t)(uint8_t)d->a << 16) |
+         ((uint64_t)(uint8_t)d->b << 8) | (uint8_t)d->c;
+}
+
+/// ключ правила: оператор и значения операндов
+static inline uint64_t rule_key (uint8_t op, int32_t a, int32_t b)
+{
+  return (1ull << 63) | ((uint64_t)op << 48) | ((uint64_t)(uint32_t)(a + 256) << 24) |
+         (uint32_t)(b + 256);
+}
+
+/*******************************************************************************
+* свёртка оператора над значениями операндов
+* \return значение правила или NO_FOLD, если нужен узел
+*******************************************************************************/
+static int32_t fold (const opt_node *node, uint8_t op, int32_t *a, int32_t *b, uint32_t n_mf)
+{
+  int32_t t;
+
+  if (IS_CONST (*a) && IS_CONST (*b))
+  {
+    return VAL_CONST (fuzzy_operator ((fuzzy_op)op, CONST_OF (*a), CONST_OF (*b)));
+  }
+  switch (op)
+  {
+  case F_A:
+    return *a;
+
+  case F_B:
+    return *b;
+
+  case F_NOT:
+    if (IS_CONST (*a))
+    {
+      return VAL_CONST (255 - CONST_OF (*a));
+    }
+    if (((uint32_t)*a >= n_mf) && (node[*a].op == F_NOT))
+    {
+      return node[*a].a;                    // NOT (NOT a) = a
+    }
+    *b = *a;                                // b is not read
+    return NO_FOLD;
+
+  case F_AND:
+  case F_OR:
+    if (*a == *b)
+    {
+      return *a;
+    }
+    if (*a > *b)                            // a op b = b op a
+    {
+      t = *a;
+      *a = *b;
+      *b = t;
+    }
+    if (IS_CONST (*a))                      // constant first
+    {
+      if (CONST_OF (*a) == ((op == F_AND) ? 0 : 255))
+      {
+        return *a;
+      }
+      if (CONST_OF (*a) == ((op == F_AND) ? 255 : 0))
+      {
+        return *b;
+      }
+    }
+    return NO_FOLD;
+
+  case F_IMP:
+    if (IS_CONST (*a) && (CONST_OF (*a) == 0))
+    {
+      return VAL_CONST (255);
+    }
+    return NO_FOLD;
+
+  case F_FALSE:
+  default:
+    return VAL_CONST (0);
+  }
+}
+
+/*******************************************************************************
+* Оптимизация правил
+* \brief  Optimize the rule base: identical functions and rules computed
+*         once, constant folding, final rules of activation 0 and rules and
+*         functions not read by the final rules removed. Outputs of the
+*         result are the same as of the source on every input
+* \param[in]  src     source fuzzy parameters
+* \param[out] opt     optimized lists and report, free with fuzzy_opt_free
+* \return             FUZZY_OK or error status
+*******************************************************************************/
+fuzzy_status fuzzy_optimize (const fuzzy_param *src, fuzzy_opt *opt)
+{
+  fuzzy_opt_report *rep;
+  fuzzy_model model;
+  fuzzy_status st;
+  opt_node *node;
+  opt_hash hash;
+  int32_t *val, *ix, v, a, b;
+  int32_t cix[256];
+  fuzzy_funct *nf;
+  fuzzy_rules *nr;
+  fuzzy_conseq *ncq;
+  fuzzy_ts *nts;
+  const fuzzy_rule_ix *r;
+  size_t n_act, n_nf, n_nr, n_cq, off_nr, off_cq, off_ts, k;
+  uint32_t n_mf, i, cq_a, cq_b;
+  uint8_t *mem;
+  bool fwd, fin;
+
+  if ((src == NULL) || (opt == NULL))
+  {
+    return FUZZY_ERR_PARAM;
+  }
+  memset (opt, 0, sizeof (fuzzy_opt));
+  st = fuzzy_compile (src, &model);
+  if (st != FUZZY_OK)
+  {
+    return st;
+  }
+  n_mf = model.n_mf;
+  n_act = (size_t)model.n_mf + model.n_rule;
+  fwd = (model.flags & FUZZY_MODEL_FWD) != 0;
+  rep = &opt->report;
+  rep->rules_in = model.n_rule;
+  rep->ffunc_in = model.n_mf;
+  rep->fwd = fwd;
+
+  k = 1;
+  while (k < 2 * n_act)
+  {
+    k <<= 1;
+  }
+  hash.mask = k - 1;
+  hash.key = calloc (k, sizeof (uint64_t));
+  hash.val = malloc (k * sizeof (int32_t));
+  node = calloc (n_act, sizeof (opt_node));
+  val = malloc (n_act * sizeof (int32_t));
+  ix = malloc (n_act * sizeof (int32_t));
+  if ((hash.key == NULL) || (hash.val == NULL) || (node == NULL) || (val == NULL) || (ix == NULL))
+  {
+    st = FUZZY_ERR_MEMORY;
+    goto exit;
+  }
+
+  /// функции: константы и одинаковые функции
+  for (i = 0; i < n_mf; i++)
+  {
+    node[i].owner = NO_OWNER;
+    if (fwd || (model.mf[i].shape == FS_CUSTOM))
+    {
+      val[i] = (int32_t)i;
+    }
+    else if (model.mf[i].shape == FS_NONE)
+    {
+      val[i] = VAL_CONST (model.mf[i].y0);
+    }
+    else
+    {
+      val[i] = hash_find (&hash, mf_key (&model.mf[i]), (int32_t)i);
+      rep->ffunc_cse += (val[i] != (int32_t)i);
+    }
+  }
+
+  /// правила в порядке списка: операнды уже свёрнуты
+  for (i = 0, r = model.rule; i < model.n_rule; i++, r++)
+  {
+    k = n_mf + i;
+    node[k].owner = NO_OWNER;
+    node[k].op = r->op;
+    fin = (model.cq_off != NULL) ? (model.cq_off[i + 1] > model.cq_off[i]) : r->fin;
+    if (fwd)
+    {
+      node[k].a = r->a;
+      node[k].b = r->b;
+      node[k].emit = true;
+      node[k].owner = fin ? (int32_t)i : NO_OWNER;
+      val[k] = (int32_t)k;
+      continue;
+    }
+
+    a = val[r->a];
+    b = val[r->b];
+    v = fold (node, r->op, &a, &b, n_mf);
+    if (v != NO_FOLD)
+    {
+      rep->folded++;
+    }
+    else
+    {
+      v = hash_find (&hash, rule_key (r->op, a, b), (int32_t)k);
+      rep->cse += (v != (int32_t)k);
+    }
+    val[k] = v;
+    if (v == (int32_t)k)
+    {
+      node[k].a = a;
+      node[k].b = b;
+      node[k].emit = true;                  // kept if live
+    }
+    if (!fin)
+    {
+      continue;
+    }
+
+    /// конечное правило: вклад в центроид
+    if (IS_CONST (v) && (CONST_OF (v) == 0))
+    {
+      rep->zero++;
+      node[k].emit = false;
+    }
+    else if ((v >= (int32_t)n_mf) && node[v].emit && (node[v].owner == NO_OWNER))
+    {
+      rep->promoted += (v != (int32_t)k);
+      node[v].owner = (int32_t)i;           // the rule itself or equal intermediate rule
+    }
+    else
+    {
+      node[k].op = F_A;                     // activation of equal rule or constant
+      node[k].a = node[k].b = v;
+      node[k].emit = true;
+      node[k].owner = (int32_t)i;
+    }
+  }
+
+  /// живые узлы: конечные правила и всё, что они читают
+  for (k = n_act; k-- > n_mf; )
+  {
+    if (node[k].emit && (fwd || (node[k].owner != NO_OWNER) || node[k].live))
+    {
+      node[k].live = true;
+      if (!IS_CONST (node[k].a))
+      {
+        node[node[k].a].live = true;
+      }
+      if (!IS_CONST (node[k].b))
+      {
+        node[node[k].b].live = true;
+      }
+    }
+    else if (node[k].emit)
+    {
+      rep->dead++;
+    }
+  }
+
+  /// номера в новых списках, константы - функции FS_NONE
+  memset (cix, 0xFF, sizeof (cix));
+  n_nf = n_nr = n_cq = 0;
+  for (k = 0; k < n_act; k++)
+  {
+    ix[k] = -1;
+    if ((k < n_mf) ? (fwd || node[k].live) : node[k].live)
+    {
+      ix[k] = (int32_t)((k < n_mf) ? n_nf++ : n_nr++);
+      if ((k >= n_mf) && (node[k].owner != NO_OWNER) && (model.cq_off != NULL))
+      {
+        n_cq += model.cq_off[node[k].owner + 1] - model.cq_off[node[k].owner];
+      }
+    }
+  }
+  for (k = n_mf; k < n_act; k++)
+  {
+    if (node[k].live && IS_CONST (node[k].a) && (cix[CONST_OF (node[k].a)] < 0))
+    {
+      cix[CONST_OF (node[k].a)] = (int32_t)n_nf++;
+    }
+    if (node[k].live && IS_CONST (node[k].b) && (cix[CONST_OF (node[k].b)] < 0))
+    {
+      cix[CONST_OF (node[k].b)] = (int32_t)n_nf++;
+    }
+  }
+  if (n_nf == 0)
+  {
+    cix[0] = (int32_t)n_nf++;               // lists are not empty
+  }
+
+  /// один блок памяти: функции, правила, следствия
+  off_nr = ALIGN_UP (n_nf * sizeof (fuzzy_funct), sizeof (void *));
+  off_cq = ALIGN_UP (off_nr + (n_nr + (n_nr == 0)) * sizeof (fuzzy_rules), sizeof (void *));
+  off_ts = ALIGN_UP (off_cq + n_cq * sizeof (fuzzy_conseq), sizeof (void *));
+  mem = calloc (1, off_ts + ((model.ts != NULL) ? n_nr * sizeof (fuzzy_ts) : 0));
+  if (mem == NULL)
+  {
+    st = FUZZY_ERR_MEMORY;
+    goto exit;
+  }
+  nf = (fuzzy_funct *)mem;
+  nr = (fuzzy_rules *)(mem + off_nr);
+  ncq = (fuzzy_conseq *)(mem + off_cq);
+  nts = (fuzzy_ts *)(mem + off_ts);
+
+  for (i = 0; i < 256; i++)
+  {
+    if (cix[i] >= 0)
+    {
+      nf[cix[i]].y = (uint8_t)i;            // func NULL - constant y
+    }
+  }
+  for (k = 0; k < n_mf; k++)
+  {
+    if (ix[k] >= 0)
+    {
+      nf[ix[k]].func = (model.mf[k].shape == FS_NONE) ? NULL :
+                       ((model.mf[k].shape == FS_CUSTOM) ? model.func[k] : fuzzy_shape_func[model.mf[k].shape]);
+      nf[ix[k]].xn = model.mf[k].xn;
+      nf[ix[k]].a  = model.mf[k].a;
+      nf[ix[k]].b  = model.mf[k].b;
+      nf[ix[k]].c  = model.mf[k].c;
+      nf[ix[k]].y  = model.act0[k];
+    }
+  }
+  for (k = 0; k < n_nf; k++)
+  {
+    nf[k].next = &nf[(k + 1) % n_nf];
+  }
+
+#define OPERAND(v)  (IS_CONST (v) ? &nf[cix[CONST_OF (v)]].y : \
+                     (((size_t)(v) < n_mf) ? &nf[ix[v]].y : &nr[ix[v]].y))
+  n_cq = 0;
+  for (k = n_mf; k < n_act; k++)
+  {
+    if (ix[k] < 0)
+    {
+      continue;
+    }
+    nr[ix[k]].a  = OPERAND (node[k].a);
+    nr[ix[k]].b  = OPERAND (node[k].b);
+    nr[ix[k]].op = (fuzzy_op)node[k].op;
+    nr[ix[k]].y  = model.act0[k];
+    if (node[k].owner != NO_OWNER)
+    {
+      nr[ix[k]].fin = true;
+      nr[ix[k]].out = model.rule[node[k].owner].out;
+      if ((model.ts != NULL) && (model.ts[node[k].owner].n != 0))
+      {
+        nts[ix[k]] = model.ts[node[k].owner];
+        nr[ix[k]].ts = &nts[ix[k]];
+      }
+      if (model.cq_off != NULL)
+      {
+        cq_a = model.cq_off[node[k].owner];
+        cq_b = model.cq_off[node[k].owner + 1];
+        memcpy (&ncq[n_cq], &model.cq[cq_a], (cq_b - cq_a) * sizeof (fuzzy_conseq));
+        nr[ix[k]].conseq = &ncq[n_cq];
+        nr[ix[k]].n_conseq = (uint8_t)(cq_b - cq_a);
+        n_cq += cq_b - cq_a;
+      }
+    }
+  }
+#undef OPERAND
+  if (n_nr == 0)
+  {
+    nr[0].a = nr[0].b = &nf[0].y;           // nothing fires: one rule of 0
+    nr[0].op = F_FALSE;
+    n_nr = 1;
+  }
+  for (k = 0; k < n_nr; k++)
+  {
+    nr[k].next = &nr[(k + 1) % n_nr];
+  }
+
+  opt->param.in_array    = src->in_array;
+  opt->param.start_ffunc = nf;
+  opt->param.start_rule  = nr;
+  opt->mem = mem;
+  rep->rules_out = (uint32_t)n_nr;
+  rep->ffunc_out = (uint32_t)n_nf;
+  st = FUZZY_OK;
+
+exit:
+  free (hash.key);
+  free (hash.val);
+  free (node);
+  free (val);
+  free (ix);
+  fuzzy_model_free (&model);
+  return st;
+}
+
+/*******************************************************************************
+* Освобождение памяти списков
+* \brief  Free optimized lists memory
+* \param[in]  opt     optimized rule base
+*******************************************************************************/
+void fuzzy_opt_free (fuzzy_opt *opt)
+{
+  if (opt)
+  {
+    free (opt->mem);
+    memset (opt, 0, sizeof (fuzzy_opt));
+  }
+}
+
+/*******************************************************************************
+* Печать отчёта
+* \brief  Print what the optimizer removed
+* \param[in]  report  optimizer report
+* \param[in]  f       output file
+*******************************************************************************/
+void fuzzy_opt_print (const fuzzy_opt_report *report, FILE *f)
+{
+  fprintf (f, "Optimized rules %u -> %u (common %u, folded %u, zero %u, dead %u, promoted %u), "
+           "functions %u -> %u (common %u)%s\n",
+           (unsigned)report->rules_in, (unsigned)report->rules_out, (unsigned)report->cse,
+           (unsigned)report->folded, (unsigned)report->zero, (unsigned)report->dead,
+           (unsigned)report->promoted, (unsigned)report->ffunc_in, (unsigned)report->ffunc_out,
+           (unsigned)report->ffunc_cse, report->fwd ? ", FWD rules copied" : "");
+}
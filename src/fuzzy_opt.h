@@ -0,0 +1,83 @@
+/*******************************************************************************
+* \file     fuzzy_opt.h
+* \author   Ilya Petrukhin (ilya.petrukhin@gmail.com)
+* \brief    Optimizer of the rule base: common subexpressions, constant
+*           folding, dead rules and functions
+* \version  2.1
+* \date     2026-10-17
+*******************************************************************************/
+
+#ifndef _FUZZY_OPT_H_
+#define _FUZZY_OPT_H_
+
+#include  <stdio.h>
+#include  <stdint.h>
+#include  <stdbool.h>
+#include  "fuzzy_logic.h"
+#include  "fuzzy_model.h"
+
+/*******************************************************************************
+* Rules to using optimizer
+*******************************************************************************/
+// 1. Optimize the lists once, use opt.param as the parameters made by the
+// macros (the input array is the same as of the source):
+//  fuzzy_opt opt;
+//  if (fuzzy_optimize (&fuzzy, &opt) != FUZZY_OK)
+//  {
+//    error...
+//  }
+//  fuzzy_opt_print (&opt.report, stdout);     // rules 25 -> 24 ...
+//  int8_t temp = process_fuzzy_logic (&opt.param);
+//  fuzzy_compile (&opt.param, &model);         // or any compiled engine
+//  fuzzy_opt_free (&opt);                      // after the model is freed
+//
+// 2. Passes on the rule graph (compiled model of the source):
+//  - identical functions (shape, input, parameters) and rules (operator,
+//    operands, AND / OR operands in any order) are computed once;
+//  - F_A / F_B / F_FALSE, NOT (NOT a), a AND a, a OR a, operators with
+//    constant operands (FS_NONE functions, folded rules) are folded;
+//  - final rules with constant 0 activation are removed, they add nothing
+//    to the centroid sums;
+//  - intermediate rules and functions not read by the final rules are
+//    removed; a final rule equal to an intermediate one makes it final.
+// Final rules with the same output are not merged: the centroid adds the
+// activations, the rule activation is limited by 255, so merging would
+// change the output. Outputs of every engine are the same on the whole
+// input domain (sums are int16_t, order of the addition does not matter).
+// Activations y of the removed rules are not computed any more.
+// First-order consequents (MAKE_RULE_TS) are copied with their final rules.
+//
+// FUZZY_MODEL_FWD rule bases (rules read results of the previous call)
+// are copied as is. Constant activation needed by a kept rule is given
+// by FS_NONE function (func NULL, y constant).
+// ***************** end of the brief *****************************************
+
+/// Optimizer report
+typedef struct
+{
+  uint32_t  rules_in;     ///< rules of the source
+  uint32_t  rules_out;    ///< rules of the result
+  uint32_t  ffunc_in;     ///< fuzzy functions of the source
+  uint32_t  ffunc_out;    ///< fuzzy functions of the result
+  uint32_t  cse;          ///< rules equal to earlier rules
+  uint32_t  folded;       ///< rules folded to operand or constant
+  uint32_t  zero;         ///< final rules with constant 0 activation
+  uint32_t  dead;         ///< intermediate rules not read by final rules
+  uint32_t  promoted;     ///< final rules moved onto equal intermediate rules
+  uint32_t  ffunc_cse;    ///< functions equal to earlier functions
+  bool      fwd;          ///< FUZZY_MODEL_FWD, copied as is
+} fuzzy_opt_report;
+
+/// Optimized rule base
+typedef struct
+{
+  fuzzy_param       param;    ///< lists for process_fuzzy_logic / fuzzy_compile
+  fuzzy_opt_report  report;   ///< what was removed
+  void              *mem;     ///< owned memory block
+} fuzzy_opt;
+
+fuzzy_status fuzzy_optimize (const fuzzy_param *src, fuzzy_opt *opt);      ///< optimized lists
+void         fuzzy_opt_free (fuzzy_opt *opt);                              ///< free lists memory
+void         fuzzy_opt_print (const fuzzy_opt_report *report, FILE *f);    ///< print report
+
+#endif  // _FUZZY_OPT_H_
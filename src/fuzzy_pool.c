@@ -0,0 +1,378 @@
+/*******************************************************************************
+* \file     fuzzy_pool.c
+* \author   Ilya Petrukhin (ilya.petrukhin@gmail.com)
+* \brief    This file provides code for the persistent worker thread pool
+* \version  2.1
+* \date     2026-10-17
+*******************************************************************************/
+#include  <stdint.h>
+#include  <stdbool.h>
+#include  <stdlib.h>
+#include  <pthread.h>
+#include  "fuzzy_pool.h"
+
+#if defined (_WIN32)
+#include  <windows.h>
+#else
+#include  <unistd.h>
+#endif
+
+#define POOL_MAX_THREADS  (256)
+#define POOL_LINE         (64)        ///< cache line, ranges of workers do not share it
+
+/// Range of items of the worker
+typedef struct
+{
+  size_t    next;       ///< next free item, atomic
+  size_t    end;        ///< end of the range
+  uint8_t   pad[POOL_LINE - 2 * sizeof (size_t)];
+} pool_range;
+
+/// Worker thread pool
+struct fuzzy_pool
+{
+  unsigned          n;          ///< number of workers with the caller
+  pthread_t         *thread;    ///< worker threads [n - 1]
+  pthread_mutex_t   lock;       ///< protects job fields below
+  pthread_cond_t    start;      ///< new job or stop
+  pthread_cond_t    done;       ///< last worker finished the job
+  uint32_t          job;        ///< job sequence number
+  unsigned          busy;       ///< workers still in the job
+  bool              stop;       ///< pool is destroyed
+  fuzzy_pool_task   task;       ///< current task
+  void              *arg;       ///< current task argument
+  size_t            count;      ///< number of items
+  size_t            chunk;      ///< items per take
+  size_t            next;       ///< next free item, atomic
+  bool              local;      ///< per-worker ranges with stealing
+  pool_range        *range;     ///< ranges of workers [n]
+  size_t            stolen;     ///< chunks done outside the own range, atomic
+};
+
+/// Start parameters of the worker
+typedef struct
+{
+  fuzzy_pool  *pool;
+  unsigned    worker;
+} pool_worker;
+
+
+/*******************************************************************************
+* Число процессоров
+* \brief  Number of online CPUs
+* \return             CPUs, at least 1
+*******************************************************************************/
+unsigned fuzzy_cpu_count (void)
+{
+#if defined (_WIN32)
+  SYSTEM_INFO si;
+
+  GetSystemInfo (&si);
+  return (si.dwNumberOfProcessors > 0) ? (unsigned)si.dwNumberOfProcessors : 1;
+#else
+  long n = sysconf (_SC_NPROCESSORS_ONLN);
+
+  return (n > 0) ? (unsigned)n : 1;
+#endif
+}
+
+/*******************************************************************************
+* обработка кусков задания до исчерпания
+* \brief  Take chunks of the current job until all are taken
+*******************************************************************************/
+static void pool_work (fuzzy_pool *pool, unsigned worker)
+{
+  size_t begin, end;
+
+  for (;;)
+  {
+    begin = __atomic_fetch_add (&pool->next, pool->chunk, __ATOMIC_RELAXED);
+    if (begin >= pool->count)
+    {
+      break;
+    }
+    end = (pool->count - begin < pool->chunk) ? pool->count : begin + pool->chunk;
+    pool->task (pool->arg, begin, end, worker);
+  }
+}
+
+/*******************************************************************************
+* обработка своего диапазона, затем диапазонов следующих исполнителей
+* \brief  Take chunks of the own range, then steal from the other ranges
+*******************************************************************************/
+static void pool_work_local (fuzzy_pool *pool, unsigned worker)
+{
+  pool_range *r;
+  size_t begin, end, stolen = 0;
+  unsigned i;
+
+  for (i = 0; i < pool->n; i++)
+  {
+    r = &pool->range[(worker + i) % pool->n];
+    for (;;)
+    {
+      begin = __atomic_fetch_add (&r->next, pool->chunk, __ATOMIC_RELAXED);
+      if (begin >= r->end)
+      {
+        break;
+      }
+      end = (r->end - begin < pool->chunk) ? r->end : begin + pool->chunk;
+      pool->task (pool->arg, begin, end, worker);
+      stolen += (i != 0);
+    }
+  }
+  if (stolen != 0)
+  {
+    __atomic_fetch_add (&pool->stolen, stolen, __ATOMIC_RELAXED);
+  }
+}
+
+/*******************************************************************************
+* поток исполнителя
+* \brief  Worker thread: wait for a job, work, report
+*******************************************************************************/
+static void *pool_thread (void *param)
+{
+  pool_worker *w = param;
+  fuzzy_pool *pool = w->pool;
+  unsigned worker = w->worker;
+  uint32_t job = 0;
+
+  free (w);
+  pthread_mutex_lock (&pool->lock);
+  for (;;)
+  {
+    while (!pool->stop && (pool->job == job))
+    {
+      pthread_cond_wait (&pool->start, &pool->lock);
+    }
+    if (pool->stop)
+    {
+      break;
+    }
+    job = pool->job;
+    pthread_mutex_unlock (&pool->lock);
+
+    if (pool->local)
+    {
+      pool_work_local (pool, worker);
+    }
+    else
+    {
+      pool_work (pool, worker);
+    }
+
+    pthread_mutex_lock (&pool->lock);
+    if (--pool->busy == 0)
+    {
+      pthread_cond_signal (&pool->done);
+    }
+  }
+  pthread_mutex_unlock (&pool->lock);
+  return NULL;
+}
+
+/*******************************************************************************
+* Создание пула потоков
+* \brief  Create thread pool
+* \param[in]  threads   number of workers with the caller, 0 - CPU count
+* \return               pool or NULL on error
+*******************************************************************************/
+fuzzy_pool *fuzzy_pool_create (unsigned threads)
+{
+  fuzzy_pool *pool;
+  pool_worker *w;
+  unsigned i;
+
+  if (threads == 0)
+  {
+    threads = fuzzy_cpu_count ();
+  }
+  if (threads > POOL_MAX_THREADS)
+  {
+    threads = POOL_MAX_THREADS;
+  }
+  pool = calloc (1, sizeof (fuzzy_pool));
+  if (pool == NULL)
+  {
+    return NULL;
+  }
+  pool->thread = calloc (threads, sizeof (pthread_t));
+  pool->range = calloc (threads, sizeof (pool_range));
+  if ((pool->thread == NULL) || (pool->range == NULL))
+  {
+    free (pool->thread);
+    free (pool->range);
+    free (pool);
+    return NULL;
+  }
+  pthread_mutex_init (&pool->lock, NULL);
+  pthread_cond_init (&pool->start, NULL);
+  pthread_cond_init (&pool->done, NULL);
+
+  pool->n = 1;
+  for (i = 1; i < threads; i++)
+  {
+    w = malloc (sizeof (pool_worker));
+    if (w == NULL)
+    {
+      break;
+    }
+    w->pool = pool;
+    w->worker = i;
+    if (pthread_create (&pool->thread[i - 1], NULL, pool_thread, w) != 0)
+    {
+      free (w);
+      break;
+    }
+    pool->n++;
+  }
+  return pool;
+}
+
+/*******************************************************************************
+* Число исполнителей
+* \brief  Number of workers with the caller
+* \param[in]  pool  thread pool
+* \return           workers
+*******************************************************************************/
+unsigned fuzzy_pool_size (const fuzzy_pool *pool)
+{
+  return pool ? pool->n : 1;
+}
+
+/*******************************************************************************
+* Параллельное выполнение задания
+* \brief  Run task on items [0, count) by chunks, return when all are done
+* \param[in]  pool    thread pool, NULL - run in the caller thread
+* \param[in]  task    task function
+* \param[in]  arg     task argument
+* \param[in]  count   number of items
+* \param[in]  chunk   items per take, 0 - count / (8 * workers)
+*******************************************************************************/
+void fuzzy_pool_run (fuzzy_pool *pool, fuzzy_pool_task task, void *arg,
+                     size_t count, size_t chunk)
+{
+  if (count == 0)
+  {
+    return;
+  }
+  if ((pool == NULL) || (pool->n == 1))
+  {
+    task (arg, 0, count, 0);
+    return;
+  }
+  if (chunk == 0)
+  {
+    chunk = count / (8 * pool->n) + 1;
+  }
+
+  pthread_mutex_lock (&pool->lock);
+  pool->task  = task;
+  pool->arg   = arg;
+  pool->count = count;
+  pool->chunk = chunk;
+  pool->next  = 0;
+  pool->local = false;
+  pool->busy  = pool->n - 1;
+  pool->job++;
+  pthread_cond_broadcast (&pool->start);
+  pthread_mutex_unlock (&pool->lock);
+
+  pool_work (pool, 0);
+
+  pthread_mutex_lock (&pool->lock);
+  while (pool->busy != 0)
+  {
+    pthread_cond_wait (&pool->done, &pool->lock);
+  }
+  pthread_mutex_unlock (&pool->lock);
+}
+
+/*******************************************************************************
+* Параллельное выполнение задания по диапазонам исполнителей
+* \brief  Run task on items [0, count): worker w takes chunks of its own
+*         range [w * count / n, (w + 1) * count / n) first, so the same items
+*         go to the same worker from call to call, then steals chunks left
+*         in the ranges of the next workers
+* \param[in]  pool    thread pool, NULL - run in the caller thread
+* \param[in]  task    task function
+* \param[in]  arg     task argument
+* \param[in]  count   number of items
+* \param[in]  chunk   items per take, 0 - range / 8
+* \return             chunks done outside the own range
+*******************************************************************************/
+size_t fuzzy_pool_run_local (fuzzy_pool *pool, fuzzy_pool_task task, void *arg,
+                             size_t count, size_t chunk)
+{
+  unsigned i;
+
+  if (count == 0)
+  {
+    return 0;
+  }
+  if ((pool == NULL) || (pool->n == 1))
+  {
+    task (arg, 0, count, 0);
+    return 0;
+  }
+  if (chunk == 0)
+  {
+    chunk = count / (8 * pool->n) + 1;
+  }
+
+  pthread_mutex_lock (&pool->lock);
+  for (i = 0; i < pool->n; i++)
+  {
+    pool->range[i].next = count * i / pool->n;
+    pool->range[i].end  = count * (i + 1) / pool->n;
+  }
+  pool->task   = task;
+  pool->arg    = arg;
+  pool->chunk  = chunk;
+  pool->stolen = 0;
+  pool->local  = true;
+  pool->busy   = pool->n - 1;
+  pool->job++;
+  pthread_cond_broadcast (&pool->start);
+  pthread_mutex_unlock (&pool->lock);
+
+  pool_work_local (pool, 0);
+
+  pthread_mutex_lock (&pool->lock);
+  while (pool->busy != 0)
+  {
+    pthread_cond_wait (&pool->done, &pool->lock);
+  }
+  pthread_mutex_unlock (&pool->lock);
+  return pool->stolen;
+}
+
+/*******************************************************************************
+* Удаление пула потоков
+* \brief  Stop threads and free pool
+* \param[in]  pool  thread pool
+*******************************************************************************/
+void fuzzy_pool_destroy (fuzzy_pool *pool)
+{
+  unsigned i;
+
+  if (pool == NULL)
+  {
+    return;
+  }
+  pthread_mutex_lock (&pool->lock);
+  pool->stop = true;
+  pthread_cond_broadcast (&pool->start);
+  pthread_mutex_unlock (&pool->lock);
+  for (i = 1; i < pool->n; i++)
+  {
+    pthread_join (pool->thread[i - 1], NULL);
+  }
+  pthread_cond_destroy (&pool->done);
+  pthread_cond_destroy (&pool->start);
+  pthread_mutex_destroy (&pool->lock);
+  free (pool->thread);
+  free (pool->range);
+  free (pool);
+}
@@ -0,0 +1,50 @@
+/*******************************************************************************
+* \file     fuzzy_pool.h
+* \author   Ilya Petrukhin (ilya.petrukhin@gmail.com)
+* \brief    Persistent worker thread pool for parallel evaluation
+* \version  2.1
+* \date     2026-10-17
+*******************************************************************************/
+
+#ifndef _FUZZY_POOL_H_
+#define _FUZZY_POOL_H_
+
+#include  <stdint.h>
+#include  <stddef.h>
+
+/*******************************************************************************
+* Rules to using thread pool
+*******************************************************************************/
+// Threads are created once and sleep between jobs:
+//  fuzzy_pool *pool = fuzzy_pool_create (0);       // 0 - one thread per CPU
+//  fuzzy_pool_run (pool, task, arg, count, chunk);  // parallel for [0, count)
+//  fuzzy_pool_destroy (pool);
+//
+// fuzzy_pool_run returns when all items are done. Items are taken by chunks
+// from the shared counter, task gets [begin, end) and worker number
+// 0..fuzzy_pool_size()-1 for per-worker buffers. The calling thread is
+// worker 0. Build with -pthread.
+//
+// Items that should stay on the same worker from call to call (per-core
+// data, caches) - per-worker ranges with stealing:
+//  size_t stolen = fuzzy_pool_run_local (pool, task, arg, count, chunk);
+// Worker w takes chunks of its own range [w * count / n, (w + 1) * count / n)
+// first, then takes the chunks left in the ranges of the next workers.
+// Returns the number of chunks done outside the own range.
+// ***************** end of the brief *****************************************
+
+typedef struct fuzzy_pool fuzzy_pool;
+
+/// Task of the pool: process items [begin, end) by worker
+typedef void (*fuzzy_pool_task) (void *arg, size_t begin, size_t end, unsigned worker);
+
+unsigned    fuzzy_cpu_count (void);                       ///< number of online CPUs
+fuzzy_pool *fuzzy_pool_create (unsigned threads);         ///< create pool, NULL on error
+unsigned    fuzzy_pool_size (const fuzzy_pool *pool);     ///< number of workers
+void        fuzzy_pool_run (fuzzy_pool *pool, fuzzy_pool_task task, void *arg,
+                            size_t count, size_t chunk);  ///< parallel for [0, count)
+size_t      fuzzy_pool_run_local (fuzzy_pool *pool, fuzzy_pool_task task, void *arg,
+                                  size_t count, size_t chunk);  ///< per-worker ranges with stealing
+void        fuzzy_pool_destroy (fuzzy_pool *pool);        ///< stop threads and free pool
+
+#endif  // _FUZZY_POOL_H_
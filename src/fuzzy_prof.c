@@ -0,0 +1,226 @@
+/*******************************************************************************
+* \file     fuzzy_prof.c
+* \author   Ilya Petrukhin (ilya.petrukhin@gmail.com)
+* \brief    This file provides code for the build-time profile of the
+*           controller, built with -DFUZZY_PROFILE=1 only
+* \version  2.1
+* \date     2026-10-17
+*******************************************************************************/
+#include  <stdio.h>
+#include  <stdint.h>
+#include  <stdbool.h>
+#include  <string.h>
+#include  <signal.h>
+#include  "fuzzy_logic.h"
+#include  "fuzzy_prof.h"
+
+#if (FUZZY_PROFILE != 0)
+
+fuzzy_prof_data fuzzy_prof;                       ///< counters of the process
+_Thread_local fuzzy_prof_call fuzzy_prof_thread;  ///< sampling state of the thread
+
+static volatile sig_atomic_t prof_dump_req;       ///< signal came, dump by next sample
+static const char *prof_dump_path;                ///< dump file of the signal
+
+/// счётчики процесса из нескольких потоков
+#define PROF_ADD(p, n)  __atomic_fetch_add (&(p), (n), __ATOMIC_RELAXED)
+#define PROF_LOAD(p)    __atomic_load_n (&(p), __ATOMIC_RELAXED)
+
+
+/*******************************************************************************
+* Сброс счётчиков
+* \brief  Clear all profile counters, when the profiled controllers are idle
+*******************************************************************************/
+void fuzzy_prof_reset (void)
+{
+  memset (&fuzzy_prof, 0, sizeof (fuzzy_prof));
+  fuzzy_prof_thread.counted = fuzzy_prof_thread.calls;
+}
+
+/// класс активации правила
+static inline unsigned prof_class (uint8_t y)
+{
+  return (y == 0) ? FUZZY_ACT_ZERO : ((y == 255) ? FUZZY_ACT_SAT : FUZZY_ACT_FIRED);
+}
+
+/// наибольшее число функций / правил
+static void prof_max (uint16_t *p, uint16_t n)
+{
+  uint16_t old = PROF_LOAD (*p);
+
+  while ((n > old) &&
+         !__atomic_compare_exchange_n (p, &old, n, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+  {
+  }
+}
+
+/// времена стадий, вызовы потока и запрос выгрузки
+static void prof_stages (void)
+{
+  fuzzy_prof_call *c = &fuzzy_prof_thread;
+  unsigned k;
+
+  c->on = false;
+  PROF_ADD (fuzzy_prof.calls, c->calls - c->counted);
+  c->counted = c->calls;
+  PROF_ADD (fuzzy_prof.sampled, 1);
+  for (k = 0; k < FUZZY_STAGES; k++)
+  {
+    PROF_ADD (fuzzy_prof.time[k], c->t[k + 1] - c->t[k]);
+  }
+  if (__atomic_exchange_n (&prof_dump_req, 0, __ATOMIC_RELAXED))
+  {
+    FILE *f = fopen (prof_dump_path, "a");
+
+    if (f)
+    {
+      fuzzy_prof_dump (f);
+      fclose (f);
+    }
+  }
+}
+
+/*******************************************************************************
+* Учёт измеренного вызова модели
+* \brief  Add sampled call of the compiled model: stage times, classes of
+*         rule activations, histograms of function activations
+* \param[in]  mf_y    function activations [n_mf]
+* \param[in]  rule_y  rule activations [n_rule]
+*******************************************************************************/
+void fuzzy_prof_add (const uint8_t *mf_y, uint16_t n_mf,
+                     const uint8_t *rule_y, uint16_t n_rule)
+{
+  uint16_t i;
+
+  prof_max (&fuzzy_prof.n_mf, n_mf);
+  prof_max (&fuzzy_prof.n_rule, n_rule);
+  for (i = 0; (i < n_mf) && (i < FUZZY_PROF_MAX_MF); i++)
+  {
+    PROF_ADD (fuzzy_prof.sampled_mf[i][mf_y[i] * FUZZY_PROF_BUCKETS / 256], 1);
+  }
+  for (i = 0; (i < n_rule) && (i < FUZZY_PROF_MAX_RULE); i++)
+  {
+    PROF_ADD (fuzzy_prof.sampled_rule[i][prof_class (rule_y[i])], 1);
+  }
+  prof_stages ();
+}
+
+/*******************************************************************************
+* Учёт измеренного вызова интерпретатора списков
+* \brief  Add sampled call of process_fuzzy_logic: activations y of the
+*         function and rule lists
+* \param[in]  fuzzy   fuzzy parameters
+*******************************************************************************/
+void fuzzy_prof_add_lists (const fuzzy_param *fuzzy)
+{
+  const fuzzy_funct *f = fuzzy->start_ffunc;
+  const fuzzy_rules *r = fuzzy->start_rule;
+  uint16_t n = 0;
+
+  do
+  {
+    if (n < FUZZY_PROF_MAX_MF)
+    {
+      PROF_ADD (fuzzy_prof.sampled_mf[n][f->y * FUZZY_PROF_BUCKETS / 256], 1);
+    }
+    n++;
+    f = f->next;
+  } while (f != fuzzy->start_ffunc);
+  prof_max (&fuzzy_prof.n_mf, n);
+
+  n = 0;
+  do
+  {
+    if (n < FUZZY_PROF_MAX_RULE)
+    {
+      PROF_ADD (fuzzy_prof.sampled_rule[n][prof_class (r->y)], 1);
+    }
+    n++;
+    r = r->next;
+  } while (r != fuzzy->start_rule);
+  prof_max (&fuzzy_prof.n_rule, n);
+
+  prof_stages ();
+}
+
+/*******************************************************************************
+* Печать счётчиков
+* \brief  Print stage times per call, rule classes and function histograms
+* \param[in]  f       output file
+*******************************************************************************/
+void fuzzy_prof_dump (FILE *f)
+{
+  static const char *stage[FUZZY_STAGES] = { "fuzzify", "rules", "defuzzify" };
+  fuzzy_prof_data *p = &fuzzy_prof;
+  uint64_t total = 0, sampled = PROF_LOAD (p->sampled), time[FUZZY_STAGES];
+  uint32_t c[FUZZY_ACTS];
+  uint16_t n_rule = PROF_LOAD (p->n_rule), n_mf = PROF_LOAD (p->n_mf);
+  uint64_t n;
+  unsigned k, b;
+  uint16_t i;
+
+  fprintf (f, "# fuzzy profile: %llu calls, %llu sampled (1/%u)\n",
+           (unsigned long long)PROF_LOAD (p->calls), (unsigned long long)sampled,
+           1u << FUZZY_PROFILE_SHIFT);
+  for (k = 0; k < FUZZY_STAGES; k++)
+  {
+    time[k] = PROF_LOAD (p->time[k]);
+    total += time[k];
+  }
+  for (k = 0; k < FUZZY_STAGES; k++)
+  {
+    fprintf (f, "stage\t%-10s\t%10.1f %s/call\t%5.1f%%\n", stage[k],
+             sampled ? (double)time[k] / (double)sampled : 0.0, FUZZY_PROF_UNIT,
+             total ? 100.0 * (double)time[k] / (double)total : 0.0);
+  }
+
+  fprintf (f, "# rule\tsampled calls: zero\tfired\tsaturated\tactive%%\n");
+  for (i = 0; (i < n_rule) && (i < FUZZY_PROF_MAX_RULE); i++)
+  {
+    for (k = 0; k < FUZZY_ACTS; k++)
+    {
+      c[k] = PROF_LOAD (p->sampled_rule[i][k]);
+    }
+    n = (uint64_t)c[FUZZY_ACT_ZERO] + c[FUZZY_ACT_FIRED] + c[FUZZY_ACT_SAT];
+    fprintf (f, "rule\t%u\t%lu\t%lu\t%lu\t%5.1f\n", (unsigned)i,
+             (unsigned long)c[FUZZY_ACT_ZERO], (unsigned long)c[FUZZY_ACT_FIRED],
+             (unsigned long)c[FUZZY_ACT_SAT],
+             n ? 100.0 * (double)(n - c[FUZZY_ACT_ZERO]) / (double)n : 0.0);
+  }
+
+  fprintf (f, "# mf\thistogram of activation of sampled calls, %d buckets 0..255\n",
+           FUZZY_PROF_BUCKETS);
+  for (i = 0; (i < n_mf) && (i < FUZZY_PROF_MAX_MF); i++)
+  {
+    fprintf (f, "mf\t%u", (unsigned)i);
+    for (b = 0; b < FUZZY_PROF_BUCKETS; b++)
+    {
+      fprintf (f, "\t%lu", (unsigned long)PROF_LOAD (p->sampled_mf[i][b]));
+    }
+    fprintf (f, "\n");
+  }
+  fflush (f);
+}
+
+/// обработчик сигнала: только флаг
+static void prof_signal (int sig)
+{
+  prof_dump_req = 1;
+  signal (sig, prof_signal);
+}
+
+/*******************************************************************************
+* Выгрузка по сигналу
+* \brief  Dump counters of the running process by the signal: the handler
+*         sets a flag, the next sampled call appends the dump to the file
+* \param[in]  sig     signal number, e.g. SIGUSR1
+* \param[in]  path    dump file
+* \return             true - handler is set
+*******************************************************************************/
+bool fuzzy_prof_dump_on (int sig, const char *path)
+{
+  prof_dump_path = path;
+  return signal (sig, prof_signal) != SIG_ERR;
+}
+
+#endif  // FUZZY_PROFILE
@@ -0,0 +1,166 @@
+/*******************************************************************************
+* \file     fuzzy_prof.h
+* \author   Ilya Petrukhin (ilya.petrukhin@gmail.com)
+* \brief    Build-time profile of the controller: stage timers, rule
+*           counters and histograms of fuzzy functions
+* \version  2.1
+* \date     2026-10-17
+*******************************************************************************/
+
+#ifndef _FUZZY_PROF_H_
+#define _FUZZY_PROF_H_
+
+#include  <stdio.h>
+#include  <stdint.h>
+#include  <stdbool.h>
+#include  "fuzzy_logic.h"
+
+/*******************************************************************************
+* Rules to using profile
+*******************************************************************************/
+// 1. Build with -DFUZZY_PROFILE=1. Without it (default) all FUZZY_PROF_xxx
+// macros are empty and the code of the engines is the same as before.
+// FUZZY_PROFILE_SHIFT sets sampling: every 2^shift call of
+// process_fuzzy_logic / process_fuzzy_logic_ws (_compiled) is measured,
+// default 8 - one call of 256; 0 - every call.
+//
+// 2. Sampled call: cycles (TSC on x86, else ns) of the stages fuzzification,
+// rules, defuzzification; activation of every rule counted as zero,
+// fired (1..254) or saturated (255); activation of every fuzzy function
+// into 16-bucket histogram. Rule and function counters are of the sampled
+// calls only (sampled_rule, sampled_mf), not of every call. Counters are
+// read after the stage from the activation vector, the loops of the engines
+// are not changed; state of the sampled call is kept in fuzzy_prof_thread,
+// not in registers of the loops.
+//
+// 3. Read the counters: global fuzzy_prof (also by debugger or from shared
+// memory), or print them:
+//  fuzzy_prof_dump (stdout);
+//  fuzzy_prof_reset ();
+// or from the running process by signal, the dump is written by the next
+// sampled call of the controller:
+//  fuzzy_prof_dump_on (SIGUSR1, "fuzzy_prof.txt");    // kill -USR1 <pid>
+//
+// Index of rule / function - number in the list (compiled model order).
+// Sampling state is per thread (fuzzy_prof_thread), counters of fuzzy_prof
+// are global for the process and added atomically, so process_fuzzy_logic_ws
+// may be profiled from several threads; fuzzy_prof.calls counts the calls
+// up to the last sampled call of every thread. Reset when the controllers
+// are idle. Batch, incremental and sparse engines are not profiled.
+// ***************** end of the brief *****************************************
+
+#ifndef FUZZY_PROFILE
+#define FUZZY_PROFILE         (0)     ///< 1 - profile is built in
+#endif
+
+#ifndef FUZZY_PROFILE_SHIFT
+#define FUZZY_PROFILE_SHIFT   (8)     ///< every 2^shift call is sampled
+#endif
+
+#define FUZZY_PROF_MAX_MF     (256)   ///< profiled fuzzy functions
+#define FUZZY_PROF_MAX_RULE   (1024)  ///< profiled rules
+#define FUZZY_PROF_BUCKETS    (16)    ///< histogram buckets of activation 0..255
+
+/// Stages of the controller
+typedef enum
+{
+  FUZZY_STAGE_FUZZIFY = 0,  ///< fuzzy functions
+  FUZZY_STAGE_RULES,        ///< rules and centroid sums
+  FUZZY_STAGE_DEFUZZ,       ///< centroid division and limitation
+  FUZZY_STAGES
+} fuzzy_stage;
+
+/// Rule activation classes
+typedef enum
+{
+  FUZZY_ACT_ZERO = 0,       ///< activation 0
+  FUZZY_ACT_FIRED,          ///< 1..254
+  FUZZY_ACT_SAT,            ///< 255
+  FUZZY_ACTS
+} fuzzy_act_class;
+
+/// Profile counters of the process
+typedef struct
+{
+  uint64_t  calls;                    ///< calls of the profiled engines
+  uint64_t  sampled;                  ///< measured calls
+  uint64_t  time[FUZZY_STAGES];       ///< stage time of measured calls, FUZZY_PROF_UNIT
+  uint16_t  n_mf;                     ///< max functions seen
+  uint16_t  n_rule;                   ///< max rules seen
+  uint32_t  sampled_rule[FUZZY_PROF_MAX_RULE][FUZZY_ACTS];     ///< rule activations by class, sampled calls
+  uint32_t  sampled_mf[FUZZY_PROF_MAX_MF][FUZZY_PROF_BUCKETS]; ///< function activation histogram, sampled calls
+} fuzzy_prof_data;
+
+/// Sampling state of the calling thread
+typedef struct
+{
+  uint64_t  calls;                    ///< calls of the thread
+  uint64_t  counted;                  ///< calls of the thread added to fuzzy_prof.calls
+  bool      on;                       ///< current call is sampled
+  uint64_t  t[FUZZY_STAGES + 1];      ///< stage marks of the current call
+} fuzzy_prof_call;
+
+#if (FUZZY_PROFILE != 0)
+
+#if defined (__GNUC__) && (defined (__x86_64__) || defined (__i386__))
+#include  <x86intrin.h>
+#define FUZZY_PROF_NOW()    ((uint64_t)__rdtsc ())    ///< time stamp counter
+#define FUZZY_PROF_UNIT     "cycles"
+#else
+#include  "fuzzy_time.h"
+#define FUZZY_PROF_NOW()    fuzzy_time_ns ()
+#define FUZZY_PROF_UNIT     "ns"
+#endif
+
+extern fuzzy_prof_data fuzzy_prof;                    ///< counters of the process
+extern _Thread_local fuzzy_prof_call fuzzy_prof_thread; ///< sampling state of the thread
+
+void fuzzy_prof_reset (void);                                 ///< clear counters
+void fuzzy_prof_dump (FILE *f);                               ///< print counters
+bool fuzzy_prof_dump_on (int sig, const char *path);          ///< dump by signal
+void fuzzy_prof_add (const uint8_t *mf_y, uint16_t n_mf,
+                     const uint8_t *rule_y, uint16_t n_rule);   ///< sampled call of the model
+void fuzzy_prof_add_lists (const fuzzy_param *fuzzy);           ///< sampled call of the lists
+
+#if defined (__GNUC__)
+#define FUZZY_PROF_COLD(x)  __builtin_expect (!!(x), 0)
+#else
+#define FUZZY_PROF_COLD(x)  (x)
+#endif
+
+/// начало вызова: выборка и отметка времени; состояние вызова в
+/// fuzzy_prof_thread, а не в регистрах горячего цикла
+#define FUZZY_PROF_START()  \
+  do { \
+    if (FUZZY_PROF_COLD ((fuzzy_prof_thread.calls++ & ((1ULL << FUZZY_PROFILE_SHIFT) - 1u)) == 0)) \
+    { fuzzy_prof_thread.on = true; fuzzy_prof_thread.t[0] = FUZZY_PROF_NOW (); } \
+  } while (0)
+
+/// конец стадии k
+#define FUZZY_PROF_MARK(k)  \
+  do { \
+    if (FUZZY_PROF_COLD (fuzzy_prof_thread.on)) { fuzzy_prof_thread.t[(k) + 1] = FUZZY_PROF_NOW (); } \
+  } while (0)
+
+/// счётчики по вектору активаций модели
+#define FUZZY_PROF_ACTS(mf_y, n_mf, rule_y, n_rule)  \
+  do { \
+    if (FUZZY_PROF_COLD (fuzzy_prof_thread.on)) { fuzzy_prof_add (mf_y, n_mf, rule_y, n_rule); } \
+  } while (0)
+
+/// счётчики по спискам функций и правил
+#define FUZZY_PROF_LISTS(fuzzy)  \
+  do { \
+    if (FUZZY_PROF_COLD (fuzzy_prof_thread.on)) { fuzzy_prof_add_lists (fuzzy); } \
+  } while (0)
+
+#else
+
+#define FUZZY_PROF_START()                            do { } while (0)
+#define FUZZY_PROF_MARK(k)                            do { } while (0)
+#define FUZZY_PROF_ACTS(mf_y, n_mf, rule_y, n_rule)   do { } while (0)
+#define FUZZY_PROF_LISTS(fuzzy)                       do { } while (0)
+
+#endif  // FUZZY_PROFILE
+
+#endif  // _FUZZY_PROF_H_
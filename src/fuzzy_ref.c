@@ -0,0 +1,331 @@
+/*******************************************************************************
+* \file     fuzzy_ref.c
+* \author   Ilya Petrukhin (ilya.petrukhin@gmail.com)
+* \brief    This file provides code for double precision reference
+*           evaluation of the compiled fuzzy model
+* \version  2.1
+* \date     2026-10-17
+*******************************************************************************/
+#include  <stdio.h>
+#include  <stdint.h>
+#include  <stdbool.h>
+#include  <stdlib.h>
+#include  <string.h>
+#include  "fuzzy_logic.h"
+#include  "fuzzy_model.h"
+#include  "fuzzy_ref.h"
+
+
+/*******************************************************************************
+* Построение состояния
+* \brief  Reference evaluation state of the compiled model
+* \param[in]  model   compiled model, must outlive the state
+* \param[out] ref     state, free with fuzzy_ref_free
+* \return             FUZZY_OK or error status
+*******************************************************************************/
+fuzzy_status fuzzy_ref_init (const fuzzy_model *model, fuzzy_ref *ref)
+{
+  if ((model == NULL) || (ref == NULL) || (model->mf == NULL))
+  {
+    return FUZZY_ERR_PARAM;
+  }
+  memset (ref, 0, sizeof (fuzzy_ref));
+  ref->mem = calloc ((size_t)model->n_mf + model->n_rule + 1u, sizeof (double));
+  if (ref->mem == NULL)
+  {
+    return FUZZY_ERR_MEMORY;
+  }
+  ref->model = model;
+  ref->act = ref->mem;
+  fuzzy_ref_reset (ref);
+  return FUZZY_OK;
+}
+
+/*******************************************************************************
+* Сброс состояния
+* \brief  Initial activations of the model (FUZZY_MODEL_FWD models)
+* \param[in]  ref     state
+*******************************************************************************/
+void fuzzy_ref_reset (fuzzy_ref *ref)
+{
+  size_t i, n_act = (size_t)ref->model->n_mf + ref->model->n_rule;
+
+  for (i = 0; i < n_act; i++)
+  {
+    ref->act[i] = ref->model->act0[i] / 255.0;
+  }
+}
+
+/*******************************************************************************
+* Освобождение памяти состояния
+* \brief  Free reference state memory
+* \param[in]  ref     state
+*******************************************************************************/
+void fuzzy_ref_free (fuzzy_ref *ref)
+{
+  if (ref)
+  {
+    free (ref->mem);
+    memset (ref, 0, sizeof (fuzzy_ref));
+  }
+}
+
+/// модуль без libm
+static inline double ref_abs (double x)
+{
+  return (x < 0.0) ? -x : x;
+}
+
+/// отрезок (x - x0) / (x1 - x0), 1 - вертикальный край
+static inline double ref_ramp (double x, double x0, double x1)
+{
+  return (x1 != x0) ? (x - x0) / (x1 - x0) : 1.0;
+}
+
+/*******************************************************************************
+* Функция фуззификации в double
+* \brief  Membership of the fuzzy function n without rounding: slopes of
+*         the integer function, break points as the integer function has them
+* \param[in]  model   compiled model
+* \param[in]  n       fuzzy function number
+* \param[in]  x       input value, scaled range +-127
+* \return             membership 0.0..1.0
+*******************************************************************************/
+double fuzzy_ref_mf (const fuzzy_model *model, uint16_t n, double x)
+{
+  const fuzzy_mf_desc *d = &model->mf[n];
+  int p1 = d->a, p2 = d->b, p3 = d->c, temp;
+  int8_t min, max, min2, max2;
+  double y, dx, d3;
+
+  switch (d->shape)
+  {
+  case FS_NONE:
+    return d->y0 / 255.0;
+
+  case FS_CUBE:
+    d3 = ref_abs ((double)p2);
+    d3 = d3 * d3 * d3;
+    dx = ref_abs (x - p1);
+    dx = dx * dx * dx;
+    y = (d3 + dx != 0.0) ? d3 / (d3 + dx) : 1.0;
+    break;
+
+  case FS_TRIANGLE:
+  case FS_A_TRIANGLE:
+    if (d->shape == FS_TRIANGLE)
+    {
+      p3 = p2;
+    }
+    if ((p2 == 0) || (p3 == 0))
+    {
+      return 0.0;
+    }
+    min = (int8_t)(p1 - p2);
+    max = (int8_t)(p1 + p3);
+    if ((x < min) || (x > max))
+    {
+      y = 0.0;
+    }
+    else
+    {
+      y = (x < p1) ? (x - min) / p2 : (max - x) / p3;
+    }
+    break;
+
+  case FS_SQUARE:
+    y = ((x >= p1 - p2) && (x <= p1 + p2)) ? 1.0 : 0.0;
+    break;
+
+  case FS_TRAPECIA:
+    min  = (int8_t)(p1 - p2);
+    max  = (int8_t)(p1 + p2);
+    min2 = (int8_t)(p1 - p3);
+    max2 = (int8_t)(p1 + p3);
+    if ((x < min2) || (x > max2))
+    {
+      y = 0.0;
+    }
+    else if ((x >= min) && (x <= max))
+    {
+      y = 1.0;
+    }
+    else if (x < min)
+    {
+      y = (min > min2) ? ref_ramp (x, min2, min) : 1.0;
+    }
+    else
+    {
+      y = (max2 > max) ? 1.0 - ref_ramp (x, max, max2) : 1.0;
+    }
+    break;
+
+  case FS_LOW:
+  case FS_HIGH:
+    if (p1 > p2)
+    {
+      temp = p1;
+      p1 = p2;
+      p2 = temp;
+    }
+    if (x < p1)
+    {
+      y = 0.0;
+    }
+    else if (x > p2)
+    {
+      y = 1.0;
+    }
+    else
+    {
+      y = (p2 > p1) ? ref_ramp (x, p1, p2) : 1.0;
+    }
+    if ((d->shape == FS_LOW) && !((p2 == p1) && (x == p1)))
+    {
+      y = 1.0 - y;      // ~\_ зеркально _/~, кроме ступеньки p1 == p2
+    }
+    break;
+
+  case FS_CUSTOM:
+  default:
+    /// функция пользователя: только в целых точках
+    x = (x < -128.0) ? -128.0 : ((x > 127.0) ? 127.0 : x);
+    return model->func[n] ((int8_t)((x < 0.0) ? x - 0.5 : x + 0.5), d->a, d->b, d->c) / 255.0;
+  }
+
+  return (y < 0.0) ? 0.0 : ((y > 1.0) ? 1.0 : y);
+}
+
+/// логический оператор в double
+static inline double ref_operator (uint8_t op, double a, double b)
+{
+  switch (op)
+  {
+  case F_AND:
+    return (a < b) ? a : b;
+  case F_OR:
+    return (a > b) ? a : b;
+  case F_NOT:
+    return 1.0 - a;
+  case F_IMP:
+    return (a == 0.0) ? 1.0 : ((b >= a) ? 1.0 : b / a);
+  case F_A:
+    return a;
+  case F_B:
+    return b;
+  case F_FALSE:
+  default:
+    return 0.0;
+  }
+}
+
+/// функции и правила: вектор активаций
+static void ref_activate (fuzzy_ref *ref, const double *in_array)
+{
+  const fuzzy_model *model = ref->model;
+  const fuzzy_rule_ix *r = model->rule;
+  double *act = ref->act;
+  uint16_t i;
+
+  for (i = 0; i < model->n_mf; i++)
+  {
+    act[i] = fuzzy_ref_mf (model, i, in_array[model->mf[i].xn]);
+  }
+  for (i = 0; i < model->n_rule; i++, r++)
+  {
+    act[model->n_mf + i] = ref_operator (r->op, act[r->a], act[r->b]);
+  }
+}
+
+/// центроид с ограничением +-127
+static inline double ref_centroid (double summ_alpha_c, double summ_alpha)
+{
+  double ret = (summ_alpha == 0.0) ? 0.0 : summ_alpha_c / summ_alpha;
+
+  return (ret < -127.0) ? -127.0 : ((ret > 127.0) ? 127.0 : ret);
+}
+
+/// следствие первого порядка без округления, с ограничением +-127
+static double ref_ts (const fuzzy_model *model, uint16_t i, const double *in_array, int8_t out)
+{
+  const fuzzy_ts *ts;
+  double ret;
+  uint8_t k;
+
+  if (model->ts == NULL)
+  {
+    return out;
+  }
+  ts = &model->ts[i];
+  ret = ts->k0;
+  for (k = 0; k < ts->n; k++)
+  {
+    ret += ts->k[k] * in_array[k] / (double)(1 << FUZZY_TS_SHIFT);
+  }
+  return (ret < -127.0) ? -127.0 : ((ret > 127.0) ? 127.0 : ret);
+}
+
+/*******************************************************************************
+* Эталонный нечеткий регулятор в double
+* \brief  Reference fuzzy logic controller, output 0 in double
+* \param[in]  ref       state
+* \param[in]  in_array  input values [n_in], scaled range +-127
+* \return               output value +-127, not rounded
+*******************************************************************************/
+double process_fuzzy_logic_ref (fuzzy_ref *ref, const double *in_array)
+{
+  const fuzzy_model *model = ref->model;
+  const fuzzy_rule_ix *r = model->rule;
+  const double *y = ref->act + model->n_mf;
+  double summ_alpha_c = 0.0, summ_alpha = 0.0;
+  uint16_t i;
+
+  ref_activate (ref, in_array);
+  for (i = 0; i < model->n_rule; i++, r++)
+  {
+    if (r->fin)
+    {
+      summ_alpha_c += y[i] * 255.0 * ref_ts (model, i, in_array, r->out);
+      summ_alpha += y[i] * 255.0;
+    }
+  }
+  return ref_centroid (summ_alpha_c, summ_alpha);
+}
+
+/*******************************************************************************
+* Эталонный нечеткий регулятор с несколькими выходами в double
+* \brief  Reference fuzzy logic controller, all model->n_out outputs
+* \param[in]  ref       state
+* \param[in]  in_array  input values [n_in], scaled range +-127
+* \param[out] out       output values [n_out], +-127, not rounded
+*******************************************************************************/
+void process_fuzzy_logic_ref_mo (fuzzy_ref *ref, const double *in_array, double *out)
+{
+  const fuzzy_model *model = ref->model;
+  const double *y = ref->act + model->n_mf;
+  double summ_alpha_c[FUZZY_MAX_OUT] = {0.0};
+  double summ_alpha[FUZZY_MAX_OUT] = {0.0};
+  uint32_t k;
+  uint16_t i;
+
+  if (model->cq_off == NULL)
+  {
+    out[0] = process_fuzzy_logic_ref (ref, in_array);
+    return;
+  }
+
+  ref_activate (ref, in_array);
+  for (i = 0; i < model->n_rule; i++)
+  {
+    for (k = model->cq_off[i]; k < model->cq_off[i + 1]; k++)
+    {
+      summ_alpha_c[model->cq[k].on] += y[i] * 255.0 *
+        ((model->cq[k].on == 0) ? ref_ts (model, i, in_array, model->cq[k].out) : model->cq[k].out);
+      summ_alpha[model->cq[k].on] += y[i] * 255.0;
+    }
+  }
+  for (i = 0; i < model->n_out; i++)
+  {
+    out[i] = ref_centroid (summ_alpha_c[i], summ_alpha[i]);
+  }
+}
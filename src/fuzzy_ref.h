@@ -0,0 +1,56 @@
+/*******************************************************************************
+* \file     fuzzy_ref.h
+* \author   Ilya Petrukhin (ilya.petrukhin@gmail.com)
+* \brief    Double precision reference evaluation of the fuzzy model
+* \version  2.1
+* \date     2026-10-17
+*******************************************************************************/
+
+#ifndef _FUZZY_REF_H_
+#define _FUZZY_REF_H_
+
+#include  <stdint.h>
+#include  <stdbool.h>
+#include  "fuzzy_logic.h"
+#include  "fuzzy_model.h"
+
+/*******************************************************************************
+* Rules to using reference evaluation
+*******************************************************************************/
+// The reference evaluates the same rule graph as process_fuzzy_logic
+// (the model compiled from the same fuzzy_param) in double: memberships
+// 0.0..1.0 without rounding of the function slopes, operators without
+// truncation, exact centroid without int16_t sums.
+//  fuzzy_ref ref;
+//  fuzzy_ref_init (&model, &ref);
+//  double in[2] = { 12.0, -3.5 };            // scaled range +-127, not rounded
+//  double temp = process_fuzzy_logic_ref (&ref, in);
+//  fuzzy_ref_free (&ref);
+//
+// Function break points are taken as the integer functions have them
+// (int8_t wrap of p1 +- p2 included), so the only differences of the integer
+// engines are rounding and overflow. FS_CUSTOM functions are called at the
+// rounded input. The output and first-order consequents are limited to
+// +-127 as lim_s8 does, consequents are not rounded.
+// FUZZY_MODEL_FWD models keep the activations of the previous call,
+// fuzzy_ref_reset returns to the initial state.
+// One state per caller (thread); the model is only read.
+// ***************** end of the brief *****************************************
+
+/// Reference evaluation state
+typedef struct
+{
+  const fuzzy_model *model;     ///< compiled model
+  double            *act;       ///< activation vector [n_mf + n_rule], 0.0..1.0
+  void              *mem;       ///< owned memory block
+} fuzzy_ref;
+
+fuzzy_status fuzzy_ref_init (const fuzzy_model *model, fuzzy_ref *ref);   ///< state of the model
+void         fuzzy_ref_reset (fuzzy_ref *ref);                            ///< initial activations
+void         fuzzy_ref_free (fuzzy_ref *ref);                             ///< free state memory
+double       fuzzy_ref_mf (const fuzzy_model *model, uint16_t n, double x);  ///< membership 0.0..1.0
+
+double process_fuzzy_logic_ref (fuzzy_ref *ref, const double *in_array);
+void   process_fuzzy_logic_ref_mo (fuzzy_ref *ref, const double *in_array, double *out);
+
+#endif  // _FUZZY_REF_H_
@@ -0,0 +1,328 @@
+/*******************************************************************************
+* \file     fuzzy_sparse.c
+* \author   Ilya Petrukhin (ilya.petrukhin@gmail.com)
+* \brief    This file provides code for sparse (active set) evaluation
+*           of the compiled fuzzy model
+* \version  2.1
+* \date     2026-10-17
+*******************************************************************************/
+#include  <stdio.h>
+#include  <stdint.h>
+#include  <stdbool.h>
+#include  <stdlib.h>
+#include  <string.h>
+#include  "fuzzy_logic.h"
+#include  "fuzzy_model.h"
+#include  "fuzzy_sparse.h"
+
+#define ALIGN_UP(x, a)  (((x) + ((a) - 1)) & ~((size_t)(a) - 1))
+
+/// segment of the input range
+#define SEGMENT(x)      ((uint32_t)(uint8_t)((x) + 128) / (256 / FUZZY_SPARSE_BUCKETS))
+
+
+/*******************************************************************************
+* номер младшего установленного бита
+*******************************************************************************/
+static inline uint32_t ctz64 (uint64_t x)
+{
+#if defined (__GNUC__)
+  return (uint32_t)__builtin_ctzll (x);
+#else
+  uint32_t n = 0;
+
+  while ((x & 1u) == 0)
+  {
+    x >>= 1;
+    n++;
+  }
+  return n;
+#endif
+}
+
+/*******************************************************************************
+* Носители функций, индекс по отрезкам входов и состояние
+* \brief  Find support of every fuzzy function, build segment index of
+*         supports, activation -> rules graph and sparse evaluation state
+* \param[in]  model   compiled model, must outlive the state
+* \param[out] sp      state, free with fuzzy_sparse_free
+* \return             FUZZY_OK or error status
+*******************************************************************************/
+fuzzy_status fuzzy_sparse_init (const fuzzy_model *model, fuzzy_sparse *sp)
+{
+  int8_t *sup_lo, *sup_hi;
+  uint32_t *bkt_off, *dep_off;
+  uint16_t *bkt, *dep;
+  uint64_t *always;
+  size_t n_in, n_mf, n_rule, n_act, n_dep, n_bkt = 0, n_word, n_off, i;
+  size_t off_always, off_visit, off_bkt_off, off_dep_off, off_bkt, off_dep;
+  size_t off_touched, off_sup, off_act, size;
+  uint32_t s;
+  int16_t x;
+  uint8_t *mem, op;
+  bool empty;
+
+  if ((model == NULL) || (sp == NULL) || (model->mf == NULL))
+  {
+    return FUZZY_ERR_PARAM;
+  }
+  memset (sp, 0, sizeof (fuzzy_sparse));
+  n_in = model->n_in;
+  n_mf = model->n_mf;
+  n_rule = model->n_rule;
+  n_act = n_mf + n_rule;
+  n_dep = fuzzy_dep_count (model);
+  n_word = (n_rule + 63) / 64;
+  n_off = n_in * FUZZY_SPARSE_BUCKETS + 1;
+
+  /// носители: первая и последняя точки с ненулевой активацией
+  sup_lo = malloc (2 * n_mf);
+  if (sup_lo == NULL)
+  {
+    return FUZZY_ERR_MEMORY;
+  }
+  sup_hi = sup_lo + n_mf;
+  for (i = 0; i < n_mf; i++)
+  {
+    sup_lo[i] = 1;        // пустой носитель lo > hi
+    sup_hi[i] = 0;
+    empty = true;
+    for (x = -128; x < 128; x++)
+    {
+      if (fuzzy_mf_eval (model, (uint16_t)i, (int8_t)x) != 0)
+      {
+        if (empty)
+        {
+          sup_lo[i] = (int8_t)x;
+          empty = false;
+        }
+        sup_hi[i] = (int8_t)x;
+      }
+    }
+    if (!empty)
+    {
+      n_bkt += SEGMENT (sup_hi[i]) - SEGMENT (sup_lo[i]) + 1;
+    }
+  }
+
+  /// один блок памяти: маски, смещения, списки, носители, активации
+  off_always  = 0;
+  off_visit   = off_always + n_word * sizeof (uint64_t);
+  off_bkt_off = off_visit + n_word * sizeof (uint64_t);
+  off_dep_off = off_bkt_off + n_off * sizeof (uint32_t);
+  off_bkt     = off_dep_off + (n_act + 1) * sizeof (uint32_t);
+  off_dep     = off_bkt + n_bkt * sizeof (uint16_t);
+  off_touched = off_dep + n_dep * sizeof (uint16_t);
+  off_sup     = off_touched + n_act * sizeof (uint16_t);
+  off_act     = off_sup + 2 * n_mf;
+  size        = ALIGN_UP (off_act + n_act, sizeof (void *));
+  mem = calloc (1, size);
+  if (mem == NULL)
+  {
+    free (sup_lo);
+    return FUZZY_ERR_MEMORY;
+  }
+  memcpy (mem + off_sup, sup_lo, 2 * n_mf);
+  free (sup_lo);
+  sup_lo  = (int8_t *)(mem + off_sup);
+  sup_hi  = sup_lo + n_mf;
+  always  = (uint64_t *)(mem + off_always);
+  bkt_off = (uint32_t *)(mem + off_bkt_off);
+  dep_off = (uint32_t *)(mem + off_dep_off);
+  bkt     = (uint16_t *)(mem + off_bkt);
+  dep     = (uint16_t *)(mem + off_dep);
+
+  /// отрезок входа -> функции, носитель которых его пересекает
+  for (i = 0; i < n_mf; i++)
+  {
+    if (sup_lo[i] <= sup_hi[i])
+    {
+      for (s = SEGMENT (sup_lo[i]); s <= SEGMENT (sup_hi[i]); s++)
+      {
+        bkt_off[model->mf[i].xn * FUZZY_SPARSE_BUCKETS + s + 1]++;
+      }
+    }
+  }
+  for (i = 0; i + 1 < n_off; i++)
+  {
+    bkt_off[i + 1] += bkt_off[i];
+  }
+  for (i = 0; i < n_mf; i++)
+  {
+    if (sup_lo[i] <= sup_hi[i])
+    {
+      for (s = SEGMENT (sup_lo[i]); s <= SEGMENT (sup_hi[i]); s++)
+      {
+        bkt[bkt_off[model->mf[i].xn * FUZZY_SPARSE_BUCKETS + s]++] = (uint16_t)i;
+      }
+    }
+  }
+  for (i = n_off - 1; i > 0; i--)
+  {
+    bkt_off[i] = bkt_off[i - 1];
+  }
+  bkt_off[0] = 0;
+
+  /// активация -> правила; правила с ненулевым результатом нулевых операндов
+  fuzzy_dep_build (model, dep_off, dep);
+  for (i = 0; i < n_rule; i++)
+  {
+    op = model->rule[i].op;
+    if ((op == F_NOT) || (op == F_IMP))
+    {
+      always[i / 64] |= (uint64_t)1 << (i % 64);
+    }
+  }
+
+  sp->model   = model;
+  sp->sup_lo  = sup_lo;
+  sp->sup_hi  = sup_hi;
+  sp->bkt_off = bkt_off;
+  sp->bkt     = bkt;
+  sp->dep_off = dep_off;
+  sp->dep     = dep;
+  sp->always  = always;
+  sp->visit   = (uint64_t *)(mem + off_visit);
+  sp->act     = mem + off_act;
+  sp->touched = (uint16_t *)(mem + off_touched);
+  sp->n_word  = (uint32_t)n_word;
+  sp->mem     = mem;
+  if (model->flags & FUZZY_MODEL_FWD)
+  {
+    fuzzy_workspace_init (model, sp->act);
+  }
+  return FUZZY_OK;
+}
+
+/*******************************************************************************
+* Освобождение памяти состояния
+* \brief  Free sparse state memory
+* \param[in]  sp      state
+*******************************************************************************/
+void fuzzy_sparse_free (fuzzy_sparse *sp)
+{
+  if (sp)
+  {
+    free (sp->mem);
+    memset (sp, 0, sizeof (fuzzy_sparse));
+  }
+}
+
+/*******************************************************************************
+* отметить правила, читающие активацию k
+*******************************************************************************/
+static inline void mark_deps (fuzzy_sparse *sp, uint32_t k)
+{
+  uint32_t j, rule;
+
+  for (j = sp->dep_off[k]; j < sp->dep_off[k + 1]; j++)
+  {
+    rule = sp->dep[j];
+    sp->visit[rule / 64] |= (uint64_t)1 << (rule % 64);
+  }
+}
+
+/*******************************************************************************
+* Разреженное вычисление нечеткого регулятора
+* \brief Fuzzy logic controller evaluating only functions with non-zero
+*        activation and rules which can fire, bit-identical to
+*        process_fuzzy_logic_compiled; sp->n_visit - rules visited
+* \param[in] sp        sparse state
+* \param[in] in_array  input values array [model->n_in]
+* \return Output control value
+*******************************************************************************/
+int8_t process_fuzzy_logic_sparse (fuzzy_sparse *sp, const int8_t *in_array)
+{
+  const fuzzy_model *model = sp->model;
+  const fuzzy_rule_ix *r;
+  uint8_t *act = sp->act;
+  uint64_t *visit = sp->visit;
+  uint16_t n_mf = model->n_mf;
+  uint32_t n_touch = 0, n_visit = 0, n, w, i, j, k;
+  int16_t summ_alpha_c = 0;
+  int16_t summ_alpha = 0;
+  int16_t ret;
+  uint8_t alpha, a, b;
+  int8_t x;
+
+  if (model->flags & FUZZY_MODEL_FWD)
+  {
+    sp->n_visit = model->n_rule;
+    sp->n_active = n_mf;
+    return process_fuzzy_logic_ws (model, in_array, act);
+  }
+  memcpy (visit, sp->always, sp->n_word * sizeof (uint64_t));
+
+  /// активные функции по индексу отрезков входа
+  for (n = 0; n < model->n_in; n++)
+  {
+    x = in_array[n];
+    w = n * FUZZY_SPARSE_BUCKETS + SEGMENT (x);
+    for (j = sp->bkt_off[w]; j < sp->bkt_off[w + 1]; j++)
+    {
+      k = sp->bkt[j];
+      if ((x < sp->sup_lo[k]) || (x > sp->sup_hi[k]))
+      {
+        continue;
+      }
+      alpha = fuzzy_mf_eval (model, (uint16_t)k, x);
+      if (alpha != 0)
+      {
+        act[k] = alpha;
+        sp->touched[n_touch++] = (uint16_t)k;
+        mark_deps (sp, k);
+      }
+    }
+  }
+  sp->n_active = n_touch;
+
+  /// правила, которые могут сработать, по порядку списка
+  for (w = 0; w < sp->n_word; w++)
+  {
+    while (visit[w] != 0)
+    {
+      i = w * 64 + ctz64 (visit[w]);
+      visit[w] &= visit[w] - 1;
+      n_visit++;
+      r = &model->rule[i];
+      a = act[r->a];
+      b = act[r->b];
+      if ((r->op == F_AND) && ((a == 0) || (b == 0)))
+      {
+        continue;
+      }
+      alpha = fuzzy_operator (r->op, a, b);
+      if (alpha == 0)
+      {
+        continue;
+      }
+      act[n_mf + i] = alpha;
+      sp->touched[n_touch++] = (uint16_t)(n_mf + i);
+      mark_deps (sp, n_mf + i);
+      if (r->fin)  // если это конечное выражение
+      {
+        summ_alpha_c += (alpha * ((model->ts == NULL) ? (int16_t)r->out :
+                                  (int16_t)fuzzy_ts_eval (&model->ts[i], in_array)));
+        summ_alpha += alpha;
+      }
+    }
+  }
+  sp->n_visit = n_visit;
+
+  /// вне вызова все активации нулевые
+  for (j = 0; j < n_touch; j++)
+  {
+    act[sp->touched[j]] = 0;
+  }
+
+  /// вычисляем воздействие на объект управления
+  if (summ_alpha == 0)
+  {
+    ret = 0;
+  }
+  else
+  {
+    ret = summ_alpha_c / summ_alpha;
+  }
+  return lim_s8 (ret);
+}
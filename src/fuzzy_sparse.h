@@ -0,0 +1,68 @@
+/*******************************************************************************
+* \file     fuzzy_sparse.h
+* \author   Ilya Petrukhin (ilya.petrukhin@gmail.com)
+* \brief    Sparse (active set) evaluation of the compiled fuzzy model:
+*           only functions with non-zero activation and rules which can
+*           fire are evaluated
+* \version  2.1
+* \date     2026-10-17
+*******************************************************************************/
+
+#ifndef _FUZZY_SPARSE_H_
+#define _FUZZY_SPARSE_H_
+
+#include  <stdint.h>
+#include  <stdbool.h>
+#include  "fuzzy_logic.h"
+#include  "fuzzy_model.h"
+
+/*******************************************************************************
+* Rules to using sparse evaluation
+*******************************************************************************/
+//  fuzzy_sparse sp;
+//  fuzzy_sparse_init (&model, &sp);
+//  int8_t temp = process_fuzzy_logic_sparse (&sp, in);
+//  printf ("%u rules visited\n", sp.n_visit);
+//  fuzzy_sparse_free (&sp);
+//
+// fuzzy_sparse_init evaluates every function on the whole int8_t range
+// and keeps its support [lo, hi] (activation above zero). Supports are
+// indexed by FUZZY_SPARSE_BUCKETS segments of each input, so the active
+// functions of an input are found in one short list.
+// Only rules reading a non-zero activation are visited, in list order;
+// F_AND is skipped at once if one operand is zero. F_NOT and F_IMP give
+// non-zero result of zero operands and are visited on every call.
+// Result is bit-identical to process_fuzzy_logic_compiled.
+// FS_CUSTOM functions have to depend only on x and parameters.
+// FUZZY_MODEL_FWD models are evaluated in full by process_fuzzy_logic_ws.
+// One state per caller (thread); the model is only read.
+// ***************** end of the brief *****************************************
+
+#define FUZZY_SPARSE_BUCKETS  (16)    ///< segments of the input range
+
+/// Sparse evaluation state
+typedef struct
+{
+  const fuzzy_model *model;     ///< compiled model
+  const int8_t      *sup_lo;    ///< support low bound of function [n_mf]
+  const int8_t      *sup_hi;    ///< support high bound of function [n_mf]
+  const uint32_t    *bkt_off;   ///< functions of input n, segment s: bkt[bkt_off[n * B + s]..]
+  const uint16_t    *bkt;       ///< function numbers grouped by input segment
+  const uint32_t    *dep_off;   ///< rules reading activation k: dep[dep_off[k]..dep_off[k + 1])
+  const uint16_t    *dep;       ///< rule numbers grouped by operand activation
+  const uint64_t    *always;    ///< rules visited on every call, bit mask [n_word]
+  uint64_t          *visit;     ///< rules to visit, bit mask [n_word]
+  uint8_t           *act;       ///< activation vector [n_mf + n_rule], zero outside call
+  uint16_t          *touched;   ///< non-zero activations of the call [n_mf + n_rule]
+  uint32_t          n_word;     ///< words of the rule bit masks
+  uint32_t          n_visit;    ///< rules visited by the last call
+  uint32_t          n_active;   ///< non-zero functions of the last call
+  void              *mem;       ///< owned memory block
+} fuzzy_sparse;
+
+fuzzy_status fuzzy_sparse_init (const fuzzy_model *model, fuzzy_sparse *sp);  ///< supports, index and state
+void         fuzzy_sparse_free (fuzzy_sparse *sp);                            ///< free state memory
+
+int8_t process_fuzzy_logic_sparse (fuzzy_sparse *sp, const int8_t *in_array);
+
+#endif  // _FUZZY_SPARSE_H_
@@ -0,0 +1,628 @@
+/*******************************************************************************
+* \file     fuzzy_stream.c
+* \author   Ilya Petrukhin (ilya.petrukhin@gmail.com)
+* \brief    This file provides code for streaming replay of recorded sensor
+*           logs: reader, evaluation and writer stages on a ring of blocks
+* \version  2.1
+* \date     2026-10-17
+*******************************************************************************/
+#include  <stdio.h>
+#include  <stdint.h>
+#include  <stdbool.h>
+#include  <stdlib.h>
+#include  <string.h>
+#include  <pthread.h>
+#include  "fuzzy_logic.h"
+#include  "fuzzy_model.h"
+#include  "fuzzy_batch.h"
+#include  "fuzzy_stream.h"
+#include  "fuzzy_time.h"
+
+#define STREAM_RBUF     (1u << 20)  ///< CSV read chunk, max line length
+#define STREAM_TXT      (8)         ///< max text of output value "-32768\n"
+#define STREAM_RAW      (65536)     ///< raw int16 values of scaling table
+
+/// Block of the ring
+typedef struct
+{
+  int8_t    *in;          ///< scaled inputs [block][n_in]
+  int8_t    *out;         ///< outputs [block]
+  size_t    count;        ///< samples in the block
+} stream_slot;
+
+/// Replay shared by the stages
+typedef struct
+{
+  const fuzzy_model       *model;
+  const fuzzy_stream_cfg  *cfg;
+  FILE                    *in;
+  FILE                    *out;
+  size_t                  block;                      ///< samples per block
+  uint16_t                n_in;
+  stream_slot             slot[FUZZY_STREAM_SLOTS];
+  int8_t                  *xtab;                      ///< scaled raw values [n_in][STREAM_RAW]
+  char                    otxt[256][STREAM_TXT];      ///< text of the output value
+  uint8_t                 olen[256];                  ///< text length
+  int16_t                 oval[256];                  ///< scaled output value
+  char                    *rbuf;                      ///< reader chunk / binary records
+  size_t                  rpos;                       ///< first not parsed byte
+  size_t                  rlen;                       ///< bytes in the chunk
+  bool                    eof;                        ///< input is read up to the end
+  unsigned                line;                       ///< CSV lines read
+  char                    *wbuf;                      ///< writer block
+  uint8_t                 *ws;                        ///< workspace of the stateful model
+  fuzzy_batch             batch;                      ///< prepared batch of the model
+  uint8_t                 *scratch;                   ///< batch memory [batch.scratch]
+  pthread_mutex_t         lock;                       ///< protects fields below
+  pthread_cond_t          cond;                       ///< any stage progress
+  uint64_t                n_read;                     ///< blocks filled by the reader
+  uint64_t                n_eval;                     ///< blocks evaluated
+  uint64_t                n_write;                    ///< blocks written
+  bool                    read_end;                   ///< reader finished
+  bool                    eval_end;                   ///< evaluation finished
+  bool                    stop;                       ///< error, all stages stop
+  fuzzy_status            status;                     ///< first error
+  uint64_t                samples;
+  uint64_t                bytes_in;
+  uint64_t                bytes_out;
+  uint64_t                eval_ns;
+} stream_job;
+
+
+/*******************************************************************************
+* Конфигурация по умолчанию
+* \brief  Default configuration: CSV input and output, no scaling
+* \param[out] cfg   configuration
+*******************************************************************************/
+void fuzzy_stream_default (fuzzy_stream_cfg *cfg)
+{
+  memset (cfg, 0, sizeof (fuzzy_stream_cfg));
+  cfg->in_format = FUZZY_STREAM_CSV;
+  cfg->out_format = FUZZY_STREAM_CSV;
+  cfg->block = FUZZY_STREAM_BLOCK;
+}
+
+/*******************************************************************************
+* остановка всех стадий по ошибке
+*******************************************************************************/
+static void stream_fail (stream_job *job, fuzzy_status st)
+{
+  pthread_mutex_lock (&job->lock);
+  if (job->status == FUZZY_OK)
+  {
+    job->status = st;
+  }
+  job->stop = true;
+  pthread_cond_broadcast (&job->cond);
+  pthread_mutex_unlock (&job->lock);
+}
+
+static inline bool stream_sep (char c)
+{
+  return (c == ',') || (c == ';') || (c == ' ') || (c == '\t') || (c == '\r');
+}
+
+static inline bool stream_digit (char c)
+{
+  return (c >= '0') && (c <= '9');
+}
+
+/*******************************************************************************
+* разбор строки CSV
+* \brief  Parse one CSV line [p, end) into scaled inputs
+* \param[out] in    scaled inputs [n_in]
+* \return           1 - sample, 0 - skipped line, -1 - syntax error
+*******************************************************************************/
+static int stream_parse_line (const stream_job *job, const char *p, const char *end, int8_t *in)
+{
+  int32_t v;
+  bool neg;
+  uint16_t d;
+
+  while ((p < end) && stream_sep (*p))
+  {
+    p++;
+  }
+  /// заголовок, комментарий или пустая строка
+  if ((p == end) ||
+      !(stream_digit (*p) ||
+        (((*p == '-') || (*p == '+')) && (p + 1 < end) && stream_digit (p[1]))))
+  {
+    return 0;
+  }
+
+  for (d = 0; d < job->n_in; d++)
+  {
+    if (p == end)
+    {
+      return -1;        // мало полей
+    }
+    neg = (*p == '-');
+    if ((*p == '-') || (*p == '+'))
+    {
+      p++;
+    }
+    if ((p == end) || !stream_digit (*p))
+    {
+      return -1;
+    }
+    v = 0;
+    while ((p < end) && stream_digit (*p))
+    {
+      if (v <= INT16_MAX)
+      {
+        v = v * 10 + (*p - '0');
+      }
+      p++;
+    }
+    if ((p < end) && !stream_sep (*p))
+    {
+      return -1;        // дробь или мусор в поле
+    }
+    v = neg ? -v : v;
+    v = (v > INT16_MAX) ? INT16_MAX : ((v < INT16_MIN) ? INT16_MIN : v);
+    in[d] = job->xtab[(size_t)d * STREAM_RAW + (uint16_t)(int16_t)v];
+    while ((p < end) && stream_sep (*p))
+    {
+      p++;
+    }
+  }
+  return 1;
+}
+
+/*******************************************************************************
+* заполнение блока из CSV
+* \brief  Read and parse CSV lines until the block is full or end of input
+*******************************************************************************/
+static fuzzy_status stream_read_csv (stream_job *job, stream_slot *s)
+{
+  const char *p, *end;
+  size_t n = 0, got;
+  int r;
+
+  while (n < job->block)
+  {
+    p = job->rbuf + job->rpos;
+    end = memchr (p, '\n', job->rlen - job->rpos);
+    if (end == NULL)
+    {
+      if (job->eof)
+      {
+        if (job->rpos == job->rlen)
+        {
+          break;
+        }
+        end = job->rbuf + job->rlen;    // последняя строка без перевода строки
+      }
+      else
+      {
+        /// остаток строки в начало и следующий кусок
+        memmove (job->rbuf, p, job->rlen - job->rpos);
+        job->rlen -= job->rpos;
+        job->rpos = 0;
+        if (job->rlen == STREAM_RBUF)
+        {
+          job->line++;
+          return FUZZY_ERR_SYNTAX;      // слишком длинная строка
+        }
+        got = fread (job->rbuf + job->rlen, 1, STREAM_RBUF - job->rlen, job->in);
+        job->bytes_in += got;
+        job->rlen += got;
+        if (got == 0)
+        {
+          if (ferror (job->in))
+          {
+            return FUZZY_ERR_FILE;
+          }
+          job->eof = true;
+        }
+        continue;
+      }
+    }
+
+    job->line++;
+    r = stream_parse_line (job, p, end, s->in + n * job->n_in);
+    if (r < 0)
+    {
+      return FUZZY_ERR_SYNTAX;
+    }
+    n += (size_t)r;
+    job->rpos = (size_t)(end - job->rbuf) + ((end < job->rbuf + job->rlen) ? 1u : 0u);
+  }
+  s->count = n;
+  return FUZZY_OK;
+}
+
+/*******************************************************************************
+* заполнение блока двоичными записями
+* \brief  Read int16 little endian records until the block is full or end of input
+*******************************************************************************/
+static fuzzy_status stream_read_bin (stream_job *job, stream_slot *s)
+{
+  size_t rec = (size_t)job->n_in * 2u;
+  size_t got, n, i;
+  const uint8_t *r = (const uint8_t *)job->rbuf;
+  uint16_t d;
+
+  got = fread (job->rbuf, 1, job->block * rec, job->in);
+  job->bytes_in += got;
+  if ((got < job->block * rec) && ferror (job->in))
+  {
+    return FUZZY_ERR_FILE;
+  }
+  if (got % rec)
+  {
+    return FUZZY_ERR_SYNTAX;    // неполная последняя запись
+  }
+  n = got / rec;
+  for (i = 0; i < n * job->n_in; i += job->n_in)
+  {
+    for (d = 0; d < job->n_in; d++, r += 2)
+    {
+      s->in[i + d] = job->xtab[(size_t)d * STREAM_RAW + (r[0] | ((unsigned)r[1] << 8))];
+    }
+  }
+  s->count = n;
+  return FUZZY_OK;
+}
+
+/*******************************************************************************
+* поток чтения
+* \brief  Reader stage: fill free blocks of the ring in order
+*******************************************************************************/
+static void *stream_reader (void *arg)
+{
+  stream_job *job = arg;
+  stream_slot *s;
+  fuzzy_status st;
+  bool end;
+
+  for (;;)
+  {
+    pthread_mutex_lock (&job->lock);
+    while ((job->n_read - job->n_write >= FUZZY_STREAM_SLOTS) && !job->stop)
+    {
+      pthread_cond_wait (&job->cond, &job->lock);
+    }
+    end = job->stop;
+    pthread_mutex_unlock (&job->lock);
+    if (end)
+    {
+      break;
+    }
+
+    s = &job->slot[job->n_read % FUZZY_STREAM_SLOTS];
+    st = (job->cfg->in_format == FUZZY_STREAM_BIN) ? stream_read_bin (job, s) :
+                                                     stream_read_csv (job, s);
+    if (st != FUZZY_OK)
+    {
+      stream_fail (job, st);
+      break;
+    }
+
+    pthread_mutex_lock (&job->lock);
+    if (s->count)
+    {
+      job->n_read++;
+    }
+    end = (s->count < job->block);    // меньше блока только в конце входа
+    job->read_end = end;
+    pthread_cond_broadcast (&job->cond);
+    pthread_mutex_unlock (&job->lock);
+    if (end)
+    {
+      break;
+    }
+  }
+  return NULL;
+}
+
+/*******************************************************************************
+* поток записи
+* \brief  Writer stage: format evaluated blocks and write each by one fwrite
+*******************************************************************************/
+static void *stream_writer (void *arg)
+{
+  stream_job *job = arg;
+  const stream_slot *s;
+  char *w;
+  size_t i, n;
+  uint8_t o;
+  bool end;
+
+  for (;;)
+  {
+    pthread_mutex_lock (&job->lock);
+    while ((job->n_write == job->n_eval) && !job->eval_end && !job->stop)
+    {
+      pthread_cond_wait (&job->cond, &job->lock);
+    }
+    end = job->stop || (job->n_write == job->n_eval);
+    pthread_mutex_unlock (&job->lock);
+    if (end)
+    {
+      break;
+    }
+
+    s = &job->slot[job->n_write % FUZZY_STREAM_SLOTS];
+    w = job->wbuf;
+    if (job->cfg->out_format == FUZZY_STREAM_BIN)
+    {
+      for (i = 0; i < s->count; i++)
+      {
+        o = (uint8_t)s->out[i];
+        *w++ = (char)(job->oval[o] & 0xFF);
+        *w++ = (char)((uint16_t)job->oval[o] >> 8);
+      }
+    }
+    else
+    {
+      for (i = 0; i < s->count; i++)
+      {
+        o = (uint8_t)s->out[i];
+        memcpy (w, job->otxt[o], STREAM_TXT);
+        w += job->olen[o];
+      }
+    }
+    n = (size_t)(w - job->wbuf);
+    if (fwrite (job->wbuf, 1, n, job->out) != n)
+    {
+      stream_fail (job, FUZZY_ERR_FILE);
+      break;
+    }
+    job->bytes_out += n;
+
+    pthread_mutex_lock (&job->lock);
+    job->n_write++;
+    pthread_cond_broadcast (&job->cond);
+    pthread_mutex_unlock (&job->lock);
+  }
+  return NULL;
+}
+
+/*******************************************************************************
+* стадия вычисления
+* \brief  Evaluation stage in the caller thread: batch per block
+*******************************************************************************/
+static void stream_eval (stream_job *job)
+{
+  const fuzzy_model *model = job->model;
+  stream_slot *s;
+  fuzzy_status st;
+  uint64_t t;
+  size_t i;
+  bool end;
+
+  for (;;)
+  {
+    pthread_mutex_lock (&job->lock);
+    while ((job->n_eval == job->n_read) && !job->read_end && !job->stop)
+    {
+      pthread_cond_wait (&job->cond, &job->lock);
+    }
+    end = job->stop || (job->n_eval == job->n_read);
+    if (end)
+    {
+      job->eval_end = true;
+      pthread_cond_broadcast (&job->cond);
+    }
+    pthread_mutex_unlock (&job->lock);
+    if (end)
+    {
+      break;
+    }
+
+    s = &job->slot[job->n_eval % FUZZY_STREAM_SLOTS];
+    t = fuzzy_time_ns ();
+    if (job->ws)
+    {
+      /// состояние переходит от отсчета к отсчету через весь поток
+      for (i = 0; i < s->count; i++)
+      {
+        s->out[i] = process_fuzzy_logic_ws (model, s->in + i * job->n_in, job->ws);
+      }
+    }
+    else
+    {
+      st = process_fuzzy_batch_ws (&job->batch, s->in, s->count, s->out, job->scratch);
+      if (st != FUZZY_OK)
+      {
+        stream_fail (job, st);
+        break;
+      }
+    }
+    job->eval_ns += fuzzy_time_ns () - t;
+    job->samples += s->count;
+
+    pthread_mutex_lock (&job->lock);
+    job->n_eval++;
+    pthread_cond_broadcast (&job->cond);
+    pthread_mutex_unlock (&job->lock);
+  }
+}
+
+/*******************************************************************************
+* таблицы масштабирования входов и выходов
+*******************************************************************************/
+static void stream_tables (stream_job *job)
+{
+  const fuzzy_stream_cfg *cfg = job->cfg;
+  char s[STREAM_TXT], *p;
+  int32_t x, v;
+  uint32_t u;
+  uint16_t d;
+
+  for (d = 0; d < job->n_in; d++)
+  {
+    for (x = INT16_MIN; x <= INT16_MAX; x++)
+    {
+      job->xtab[(size_t)d * STREAM_RAW + (uint16_t)x] =
+        cfg->scale[d] ? cfg->scale[d] ((int16_t)x) : lim_s8 ((int16_t)x);
+    }
+  }
+  for (x = INT8_MIN; x <= INT8_MAX; x++)
+  {
+    v = cfg->out_scale ? cfg->out_scale ((int8_t)x) : x;
+    job->oval[(uint8_t)x] = (int16_t)v;
+    /// текст "%d\n"
+    p = s + sizeof (s);
+    *--p = '\n';
+    u = (v < 0) ? (0u - (uint32_t)v) : (uint32_t)v;
+    do
+    {
+      *--p = (char)('0' + u % 10);
+      u /= 10;
+    } while (u);
+    if (v < 0)
+    {
+      *--p = '-';
+    }
+    job->olen[(uint8_t)x] = (uint8_t)(s + sizeof (s) - p);
+    memset (job->otxt[(uint8_t)x], 0, STREAM_TXT);
+    memcpy (job->otxt[(uint8_t)x], p, job->olen[(uint8_t)x]);
+  }
+}
+
+/*******************************************************************************
+* Прогон записанного лога через модель
+* \brief  Replay the input stream through the model to the output stream:
+*         reader, evaluation and writer stages overlap on a ring of blocks
+* \param[in]  model   compiled model
+* \param[in]  cfg     formats, scaling, block size
+* \param[in]  in      input stream (binary mode for FUZZY_STREAM_BIN)
+* \param[in]  out     output stream (binary mode for FUZZY_STREAM_BIN)
+* \param[out] result  samples, bytes, times, error line (option, may be NULL)
+* \return             FUZZY_OK or error status
+*******************************************************************************/
+fuzzy_status fuzzy_stream_run (const fuzzy_model *model, const fuzzy_stream_cfg *cfg,
+                               FILE *in, FILE *out, fuzzy_stream_result *result)
+{
+  stream_job *job;
+  pthread_t reader, writer;
+  fuzzy_stream_result res;
+  fuzzy_status ret = FUZZY_OK;
+  bool ok = true;
+  uint64_t t;
+  size_t k;
+
+  if ((model == NULL) || (model->mf == NULL) || (cfg == NULL) || (in == NULL) || (out == NULL) ||
+      (model->n_in == 0) || (model->n_in > FUZZY_STREAM_IN_MAX) ||
+      (cfg->block > SIZE_MAX / STREAM_TXT / FUZZY_STREAM_IN_MAX))
+  {
+    return FUZZY_ERR_PARAM;
+  }
+  job = calloc (1, sizeof (stream_job));
+  if (job == NULL)
+  {
+    return FUZZY_ERR_MEMORY;
+  }
+  job->model = model;
+  job->cfg = cfg;
+  job->in = in;
+  job->out = out;
+  job->n_in = model->n_in;
+  job->block = cfg->block ? cfg->block : FUZZY_STREAM_BLOCK;
+  job->status = FUZZY_OK;
+
+  /// буферы: блоки кольца, таблицы, кусок чтения, блок записи
+  job->xtab = malloc ((size_t)job->n_in * STREAM_RAW);
+  job->rbuf = malloc ((cfg->in_format == FUZZY_STREAM_BIN) ? job->block * job->n_in * 2u : STREAM_RBUF);
+  job->wbuf = malloc (job->block * STREAM_TXT);
+  if ((job->xtab == NULL) || (job->rbuf == NULL) || (job->wbuf == NULL))
+  {
+    ret = FUZZY_ERR_MEMORY;
+  }
+  for (k = 0; (k < FUZZY_STREAM_SLOTS) && (ret == FUZZY_OK); k++)
+  {
+    job->slot[k].in  = malloc (job->block * job->n_in);
+    job->slot[k].out = malloc (job->block);
+    if ((job->slot[k].in == NULL) || (job->slot[k].out == NULL))
+    {
+      ret = FUZZY_ERR_MEMORY;
+    }
+  }
+  if ((ret == FUZZY_OK) && (model->flags & FUZZY_MODEL_FWD))
+  {
+    job->ws = malloc (fuzzy_workspace_size (model));
+    if (job->ws == NULL)
+    {
+      ret = FUZZY_ERR_MEMORY;
+    }
+    else
+    {
+      fuzzy_workspace_init (model, job->ws);
+    }
+  }
+  else if (ret == FUZZY_OK)
+  {
+    /// план модели один на поток отсчетов
+    ret = fuzzy_batch_init (model, FUZZY_KERNEL_AUTO, &job->batch);
+    if (ret == FUZZY_OK)
+    {
+      job->scratch = malloc (job->batch.scratch);
+      ret = job->scratch ? FUZZY_OK : FUZZY_ERR_MEMORY;
+    }
+  }
+
+  memset (&res, 0, sizeof (res));
+  if (ret == FUZZY_OK)
+  {
+    stream_tables (job);
+    pthread_mutex_init (&job->lock, NULL);
+    pthread_cond_init (&job->cond, NULL);
+
+    t = fuzzy_time_ns ();
+    if (pthread_create (&reader, NULL, stream_reader, job) != 0)
+    {
+      ret = FUZZY_ERR_MEMORY;
+    }
+    else
+    {
+      if (pthread_create (&writer, NULL, stream_writer, job) != 0)
+      {
+        stream_fail (job, FUZZY_ERR_MEMORY);
+        ok = false;
+      }
+      stream_eval (job);
+      if (ok)
+      {
+        pthread_join (writer, NULL);
+      }
+      pthread_join (reader, NULL);
+      ret = job->status;
+      if ((ret == FUZZY_OK) && (fflush (out) != 0))
+      {
+        ret = FUZZY_ERR_FILE;
+      }
+    }
+    res.time_ns = fuzzy_time_ns () - t;
+
+    pthread_cond_destroy (&job->cond);
+    pthread_mutex_destroy (&job->lock);
+  }
+
+  res.samples = job->samples;
+  res.bytes_in = job->bytes_in;
+  res.bytes_out = job->bytes_out;
+  res.eval_ns = job->eval_ns;
+  res.samples_per_s = res.time_ns ? ((double)res.samples * 1e9 / (double)res.time_ns) : 0.0;
+  res.line = (ret == FUZZY_ERR_SYNTAX) ? job->line : 0;
+  if (result)
+  {
+    *result = res;
+  }
+
+  for (k = 0; k < FUZZY_STREAM_SLOTS; k++)
+  {
+    free (job->slot[k].out);
+    free (job->slot[k].in);
+  }
+  free (job->scratch);
+  fuzzy_batch_free (&job->batch);
+  free (job->ws);
+  free (job->wbuf);
+  free (job->rbuf);
+  free (job->xtab);
+  free (job);
+  return ret;
+}
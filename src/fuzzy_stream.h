@@ -0,0 +1,90 @@
+/*******************************************************************************
+* \file     fuzzy_stream.h
+* \author   Ilya Petrukhin (ilya.petrukhin@gmail.com)
+* \brief    Streaming replay of recorded sensor logs through the compiled model
+* \version  2.1
+* \date     2026-10-17
+*******************************************************************************/
+
+#ifndef _FUZZY_STREAM_H_
+#define _FUZZY_STREAM_H_
+
+#include  <stdio.h>
+#include  <stdint.h>
+#include  <stddef.h>
+#include  "fuzzy_logic.h"
+#include  "fuzzy_model.h"
+
+/*******************************************************************************
+* Rules to using stream replay
+*******************************************************************************/
+// 1. Fill the configuration, raw samples are int16_t values of the sensors:
+//  fuzzy_stream_cfg cfg;
+//  fuzzy_stream_default (&cfg);
+//  cfg.in_format = FUZZY_STREAM_CSV;     // or FUZZY_STREAM_BIN
+//  cfg.scale[0] = in0_scaling;           // NULL - lim_s8
+//  cfg.scale[1] = in1_scaling;
+//  cfg.out_scale = out_scaling;          // NULL - no scaling
+//
+// 2. Replay the whole input stream (file, stdin, pipe) to the output one:
+//  fuzzy_stream_result res;
+//  if (fuzzy_stream_run (&model, &cfg, stdin, stdout, &res) != FUZZY_OK)
+//  {
+//    error, res.line - bad CSV line...
+//  }
+//
+// Three stages work at the same time on a ring of FUZZY_STREAM_SLOTS blocks
+// of cfg.block samples: the reader thread reads big chunks, parses and
+// scales them, the caller thread evaluates a block by
+// process_fuzzy_logic_batch, the writer thread formats the outputs and writes
+// the block by one fwrite. Scaling functions are called once per raw value
+// at start (tables of 65536 values), they have to be pure functions.
+// Models with rules reading later rules keep state from sample to sample
+// through the whole stream.
+//
+// CSV input: one sample per line, the first n_in integer fields separated by
+// ',' ';' spaces or tabs are the inputs, other fields are ignored. Lines
+// not starting with a number (header, '#' comments) are skipped, values out
+// of int16 range are limited. CSV output: one output value per line.
+// Binary input: records of n_in int16 little endian values; binary output:
+// int16 little endian value per record.
+// ***************** end of the brief *****************************************
+
+#define FUZZY_STREAM_IN_MAX   (16)          ///< max scaled inputs
+#define FUZZY_STREAM_SLOTS    (3)           ///< blocks in the ring
+#define FUZZY_STREAM_BLOCK    (65536)       ///< default samples per block
+
+/// Record format
+typedef enum
+{
+  FUZZY_STREAM_CSV = 0,   ///< text, one sample per line
+  FUZZY_STREAM_BIN        ///< packed int16 little endian
+} fuzzy_stream_format;
+
+/// Stream configuration
+typedef struct
+{
+  fuzzy_stream_format in_format;                      ///< input records
+  fuzzy_stream_format out_format;                     ///< output records
+  int8_t              (*scale[FUZZY_STREAM_IN_MAX]) (int16_t x);  ///< input scaling, NULL - lim_s8
+  int16_t             (*out_scale) (int8_t out);      ///< output scaling, NULL - none
+  size_t              block;                          ///< samples per block, 0 - FUZZY_STREAM_BLOCK
+} fuzzy_stream_cfg;
+
+/// Stream result
+typedef struct
+{
+  uint64_t  samples;          ///< evaluated samples
+  uint64_t  bytes_in;         ///< read bytes
+  uint64_t  bytes_out;        ///< written bytes
+  uint64_t  time_ns;          ///< wall time of the replay, ns
+  uint64_t  eval_ns;          ///< evaluation time of the caller thread, ns
+  double    samples_per_s;    ///< replay speed
+  unsigned  line;             ///< CSV line of the syntax error
+} fuzzy_stream_result;
+
+void         fuzzy_stream_default (fuzzy_stream_cfg *cfg);   ///< CSV in and out, no scaling
+fuzzy_status fuzzy_stream_run (const fuzzy_model *model, const fuzzy_stream_cfg *cfg,
+                               FILE *in, FILE *out, fuzzy_stream_result *result);
+
+#endif  // _FUZZY_STREAM_H_
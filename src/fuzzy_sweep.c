@@ -0,0 +1,573 @@
+/*******************************************************************************
+* \file     fuzzy_sweep.c
+* \author   Ilya Petrukhin (ilya.petrukhin@gmail.com)
+* \brief    This file provides code for parallel multi-dimensional sweep
+*           of the compiled fuzzy model with buffered TSV / binary output
+* \version  2.1
+* \date     2026-10-17
+*******************************************************************************/
+#include  <stdio.h>
+#include  <stdint.h>
+#include  <stdbool.h>
+#include  <stdlib.h>
+#include  <string.h>
+#include  <ctype.h>
+#include  "fuzzy_logic.h"
+#include  "fuzzy_model.h"
+#include  "fuzzy_batch.h"
+#include  "fuzzy_pool.h"
+#include  "fuzzy_sweep.h"
+#include  "fuzzy_time.h"
+
+#define SWEEP_BLOCK     (4096)      ///< cells per batch call
+#define SWEEP_LINE      (512)       ///< max configuration line
+#define SWEEP_WBUF      (65536)     ///< file write buffer
+
+/// Sweep job shared by workers
+typedef struct
+{
+  const fuzzy_model     *model;
+  const fuzzy_sweep_cfg *cfg;
+  uint32_t              count[FUZZY_SWEEP_DIM_MAX]; ///< values in dimension
+  int8_t                *xv[FUZZY_SWEEP_DIM_MAX];   ///< scaled inputs of dimension values
+  int16_t               *z;                         ///< outputs [cells]
+  int8_t                *in;                        ///< per worker inputs [SWEEP_BLOCK][n_in]
+  int8_t                *out;                       ///< per worker outputs [SWEEP_BLOCK]
+  uint8_t               *ws;                        ///< workspace of the sequential sweep
+  fuzzy_batch           batch;                      ///< prepared batch of the model
+  uint8_t               *scratch;                   ///< per worker batch memory [batch.scratch]
+  volatile fuzzy_status status;                     ///< first batch error
+} sweep_job;
+
+/// Buffered file writer
+typedef struct
+{
+  FILE      *f;
+  size_t    n;
+  bool      err;
+  char      buf[SWEEP_WBUF];
+} sweep_writer;
+
+
+/*******************************************************************************
+* Число значений по измерению
+* \brief  Number of values of the dimension: min, min + step, ... <= max
+* \param[in]  dim   dimension
+* \return           number of values, 0 - invalid dimension
+*******************************************************************************/
+uint32_t fuzzy_sweep_count (const fuzzy_sweep_dim *dim)
+{
+  if ((dim->step <= 0) || (dim->max < dim->min))
+  {
+    return 0;
+  }
+  return (uint32_t)(((int32_t)dim->max - dim->min) / dim->step + 1);
+}
+
+/*******************************************************************************
+* Пустая конфигурация
+* \brief  Default configuration: no dimensions, all CPUs, TSV
+* \param[out] cfg   configuration
+*******************************************************************************/
+void fuzzy_sweep_default (fuzzy_sweep_cfg *cfg)
+{
+  memset (cfg, 0, sizeof (fuzzy_sweep_cfg));
+  cfg->format = FUZZY_SWEEP_TSV;
+  strcpy (cfg->output, "sweep.tsv");
+}
+
+/*******************************************************************************
+* разбор строки конфигурации
+* \brief  Parse one configuration line, comments are removed
+* \return true - line is correct or empty
+*******************************************************************************/
+static bool sweep_parse_line (char *s, fuzzy_sweep_cfg *cfg)
+{
+  char key[16], val[SWEEP_LINE], *p;
+  int min, max, step, threads, n = 0;
+
+  p = strchr (s, '#');
+  if (p)
+  {
+    *p = 0;
+  }
+  if (sscanf (s, "%15s", key) != 1)
+  {
+    return true;        // пустая строка
+  }
+
+  if (strcmp (key, "dim") == 0)
+  {
+    if ((sscanf (s, " %*s %d %d %d %n", &min, &max, &step, &n) != 3) || (s[n] != 0) ||
+        (min < INT16_MIN) || (max > INT16_MAX) || (min > max) ||
+        (step <= 0) || (step > INT16_MAX) || (cfg->n_dim >= FUZZY_SWEEP_DIM_MAX))
+    {
+      return false;
+    }
+    cfg->dim[cfg->n_dim].min  = (int16_t)min;
+    cfg->dim[cfg->n_dim].max  = (int16_t)max;
+    cfg->dim[cfg->n_dim].step = (int16_t)step;
+    cfg->n_dim++;
+    return true;
+  }
+  if (strcmp (key, "threads") == 0)
+  {
+    if ((sscanf (s, " %*s %d %n", &threads, &n) != 1) || (s[n] != 0) || (threads < 0))
+    {
+      return false;
+    }
+    cfg->threads = (unsigned)threads;
+    return true;
+  }
+  if (strcmp (key, "format") == 0)
+  {
+    if ((sscanf (s, " %*s %15s %n", val, &n) != 1) || (s[n] != 0))
+    {
+      return false;
+    }
+    if (strcmp (val, "tsv") == 0)
+    {
+      cfg->format = FUZZY_SWEEP_TSV;
+    }
+    else if (strcmp (val, "bin") == 0)
+    {
+      cfg->format = FUZZY_SWEEP_BIN;
+    }
+    else
+    {
+      return false;
+    }
+    return true;
+  }
+  if (strcmp (key, "output") == 0)
+  {
+    if (sscanf (s, " %*s %511[^\r\n]", val) != 1)
+    {
+      return false;
+    }
+    for (p = val + strlen (val); (p > val) && isspace ((unsigned char)p[-1]); p--)
+    {
+      p[-1] = 0;
+    }
+    if ((val[0] == 0) || (strlen (val) >= sizeof (cfg->output)))
+    {
+      return false;
+    }
+    strcpy (cfg->output, val);
+    return true;
+  }
+  return false;
+}
+
+/*******************************************************************************
+* Чтение конфигурации
+* \brief  Load sweep configuration file, scaling functions are set to NULL
+* \param[in]  path    file name
+* \param[out] cfg     configuration
+* \param[out] line    line of the error (option, may be NULL), 0 - whole file
+* \return             FUZZY_OK, FUZZY_ERR_FILE or FUZZY_ERR_SYNTAX
+*******************************************************************************/
+fuzzy_status fuzzy_sweep_load (const char *path, fuzzy_sweep_cfg *cfg, unsigned *line)
+{
+  char s[SWEEP_LINE];
+  fuzzy_status ret = FUZZY_OK;
+  unsigned ln = 0;
+  FILE *f;
+
+  if (line)
+  {
+    *line = 0;
+  }
+  if ((path == NULL) || (cfg == NULL))
+  {
+    return FUZZY_ERR_PARAM;
+  }
+  f = fopen (path, "r");
+  if (f == NULL)
+  {
+    return FUZZY_ERR_FILE;
+  }
+  fuzzy_sweep_default (cfg);
+
+  while ((ret == FUZZY_OK) && fgets (s, sizeof (s), f))
+  {
+    ln++;
+    if (!sweep_parse_line (s, cfg))
+    {
+      ret = FUZZY_ERR_SYNTAX;
+      if (line)
+      {
+        *line = ln;
+      }
+    }
+  }
+  if ((ret == FUZZY_OK) && ferror (f))
+  {
+    ret = FUZZY_ERR_FILE;
+  }
+  fclose (f);
+  if ((ret == FUZZY_OK) && (cfg->n_dim == 0))
+  {
+    ret = FUZZY_ERR_SYNTAX;     // нет ни одного измерения
+  }
+  return ret;
+}
+
+/*******************************************************************************
+* вычисление части сетки одним исполнителем
+* \brief  Pool task: evaluate cells [begin, end) by SWEEP_BLOCK batches
+*******************************************************************************/
+static void sweep_task (void *arg, size_t begin, size_t end, unsigned worker)
+{
+  sweep_job *job = arg;
+  const fuzzy_model *model = job->model;
+  const fuzzy_sweep_cfg *cfg = job->cfg;
+  int8_t *in = job->in + (size_t)worker * SWEEP_BLOCK * model->n_in;
+  int8_t *out = job->out + (size_t)worker * SWEEP_BLOCK;
+  uint32_t idx[FUZZY_SWEEP_DIM_MAX];
+  size_t c, n, i, rest;
+  uint16_t d;
+  fuzzy_status st;
+
+  /// индексы первой ячейки по измерениям
+  rest = begin;
+  for (d = 0; d < cfg->n_dim; d++)
+  {
+    idx[d] = (uint32_t)(rest % job->count[d]);
+    rest /= job->count[d];
+  }
+
+  for (c = begin; c < end; c += n)
+  {
+    n = (end - c < SWEEP_BLOCK) ? (end - c) : SWEEP_BLOCK;
+    for (i = 0; i < n; i++)
+    {
+      for (d = 0; d < model->n_in; d++)
+      {
+        in[i * model->n_in + d] = (d < cfg->n_dim) ? job->xv[d][idx[d]] : 0;
+      }
+      for (d = 0; (d < cfg->n_dim) && (++idx[d] == job->count[d]); d++)
+      {
+        idx[d] = 0;
+      }
+    }
+
+    if (job->ws)
+    {
+      /// состояние переходит от ячейки к ячейке: строго по порядку
+      for (i = 0; i < n; i++)
+      {
+        out[i] = process_fuzzy_logic_ws (model, in + i * model->n_in, job->ws);
+      }
+    }
+    else
+    {
+      st = process_fuzzy_batch_ws (&job->batch, in, n, out,
+                                   job->scratch + (size_t)worker * job->batch.scratch);
+      if (st != FUZZY_OK)
+      {
+        job->status = st;
+        return;
+      }
+    }
+
+    for (i = 0; i < n; i++)
+    {
+      job->z[c + i] = cfg->out_scale ? cfg->out_scale (out[i]) : out[i];
+    }
+  }
+}
+
+/*******************************************************************************
+* буферизованная запись в файл
+*******************************************************************************/
+static void sweep_flush (sweep_writer *w)
+{
+  if (w->n && (fwrite (w->buf, 1, w->n, w->f) != w->n))
+  {
+    w->err = true;
+  }
+  w->n = 0;
+}
+
+static void sweep_put (sweep_writer *w, const char *s, size_t n)
+{
+  if (w->n + n > sizeof (w->buf))
+  {
+    sweep_flush (w);
+  }
+  memcpy (w->buf + w->n, s, n);
+  w->n += n;
+}
+
+/// целое в десятичном виде и разделитель (0 - без него), как fprintf ("%d\t")
+static void sweep_put_int (sweep_writer *w, int32_t v, char sep)
+{
+  char s[16], *p = s + sizeof (s);
+  uint32_t u = (v < 0) ? (0u - (uint32_t)v) : (uint32_t)v;
+
+  if (sep)
+  {
+    *--p = sep;
+  }
+  do
+  {
+    *--p = (char)('0' + u % 10);
+    u /= 10;
+  } while (u);
+  if (v < 0)
+  {
+    *--p = '-';
+  }
+  sweep_put (w, p, (size_t)(s + sizeof (s) - p));
+}
+
+/// 16 бит little endian
+static void sweep_put_u16 (sweep_writer *w, uint16_t v)
+{
+  char s[2] = { (char)(v & 0xFF), (char)(v >> 8) };
+
+  sweep_put (w, s, 2);
+}
+
+/*******************************************************************************
+* запись таблицы TSV
+* \brief  Write 2-D blocks in the output_int.txt layout
+*******************************************************************************/
+static void sweep_write_tsv (sweep_writer *w, const sweep_job *job)
+{
+  const fuzzy_sweep_cfg *cfg = job->cfg;
+  uint32_t n0 = job->count[0];
+  uint32_t n1 = (cfg->n_dim > 1) ? job->count[1] : 1;
+  uint32_t idx[FUZZY_SWEEP_DIM_MAX] = { 0 };
+  const int16_t *z = job->z;
+  uint32_t k, n;
+  uint16_t d;
+
+  do
+  {
+    if (cfg->n_dim > 2)
+    {
+      sweep_put (w, "#", 1);
+      for (d = 2; d < cfg->n_dim; d++)
+      {
+        sweep_put (w, "\tx", 2);
+        sweep_put_int (w, d, '=');
+        sweep_put_int (w, cfg->dim[d].min + (int32_t)idx[d] * cfg->dim[d].step, 0);
+      }
+      sweep_put (w, "\n", 1);
+    }
+
+    sweep_put (w, "\t", 1);
+    for (k = 0; k < n0; k++)
+    {
+      sweep_put_int (w, cfg->dim[0].min + (int32_t)k * cfg->dim[0].step, '\t');
+    }
+    sweep_put (w, "\n", 1);
+
+    for (n = 0; n < n1; n++)
+    {
+      if (cfg->n_dim > 1)
+      {
+        sweep_put_int (w, cfg->dim[1].min + (int32_t)n * cfg->dim[1].step, '\t');
+      }
+      else
+      {
+        sweep_put (w, "\t", 1);
+      }
+      for (k = 0; k < n0; k++)
+      {
+        sweep_put_int (w, *z++, '\t');
+      }
+      sweep_put (w, "\n", 1);
+    }
+
+    /// следующий блок по старшим измерениям
+    for (d = 2; (d < cfg->n_dim) && (++idx[d] == job->count[d]); d++)
+    {
+      idx[d] = 0;
+    }
+  } while (d < cfg->n_dim);
+}
+
+/*******************************************************************************
+* запись двоичной матрицы
+*******************************************************************************/
+static void sweep_write_bin (sweep_writer *w, const sweep_job *job, size_t cells)
+{
+  const fuzzy_sweep_cfg *cfg = job->cfg;
+  size_t c;
+  uint16_t d;
+
+  sweep_put (w, "FZSW", 4);
+  sweep_put_u16 (w, FUZZY_SWEEP_VERSION);
+  sweep_put_u16 (w, cfg->n_dim);
+  for (d = 0; d < cfg->n_dim; d++)
+  {
+    sweep_put_u16 (w, (uint16_t)cfg->dim[d].min);
+    sweep_put_u16 (w, (uint16_t)cfg->dim[d].max);
+    sweep_put_u16 (w, (uint16_t)cfg->dim[d].step);
+    sweep_put_u16 (w, (uint16_t)(job->count[d] & 0xFFFF));
+    sweep_put_u16 (w, (uint16_t)(job->count[d] >> 16));
+  }
+  for (c = 0; c < cells; c++)
+  {
+    sweep_put_u16 (w, (uint16_t)job->z[c]);
+  }
+}
+
+/*******************************************************************************
+* Прогон модели по сетке входов
+* \brief  Evaluate the model on the whole grid by the thread pool and write
+*         the output file
+* \param[in]  model   compiled model
+* \param[in]  cfg     sweep configuration
+* \param[out] result  cells, workers, times (option, may be NULL)
+* \return             FUZZY_OK or error status
+*******************************************************************************/
+fuzzy_status fuzzy_sweep_run (const fuzzy_model *model, const fuzzy_sweep_cfg *cfg,
+                              fuzzy_sweep_result *result)
+{
+  sweep_job job;
+  sweep_writer *w;
+  fuzzy_pool *pool = NULL;
+  fuzzy_sweep_result res;
+  size_t cells = 1, workers;
+  fuzzy_status ret = FUZZY_OK;
+  bool serial;
+  uint64_t t;
+  uint32_t k;
+  uint16_t d;
+  int32_t x;
+
+  if ((model == NULL) || (cfg == NULL) ||
+      (cfg->n_dim == 0) || (cfg->n_dim > FUZZY_SWEEP_DIM_MAX))
+  {
+    return FUZZY_ERR_PARAM;
+  }
+  memset (&job, 0, sizeof (job));
+  memset (&res, 0, sizeof (res));
+  job.model = model;
+  job.cfg = cfg;
+  for (d = 0; d < cfg->n_dim; d++)
+  {
+    job.count[d] = fuzzy_sweep_count (&cfg->dim[d]);
+    if (job.count[d] == 0)
+    {
+      return FUZZY_ERR_PARAM;
+    }
+    if (cells > SIZE_MAX / sizeof (int16_t) / job.count[d])
+    {
+      return FUZZY_ERR_SIZE;
+    }
+    cells *= job.count[d];
+  }
+
+  /// модель с состоянием считается одним исполнителем по порядку сетки
+  serial = (model->flags & FUZZY_MODEL_FWD) != 0;
+  if (!serial)
+  {
+    pool = fuzzy_pool_create (cfg->threads);
+  }
+  workers = fuzzy_pool_size (pool);
+  job.z   = malloc (cells * sizeof (int16_t));
+  job.in  = malloc (workers * SWEEP_BLOCK * (model->n_in + 1u));
+  job.out = malloc (workers * SWEEP_BLOCK);
+  job.ws  = serial ? malloc (fuzzy_workspace_size (model)) : NULL;
+  w       = malloc (sizeof (sweep_writer));
+  if ((job.z == NULL) || (job.in == NULL) || (job.out == NULL) || (w == NULL) ||
+      (serial && (job.ws == NULL)))
+  {
+    ret = FUZZY_ERR_MEMORY;
+  }
+  /// план модели один на прогон, память пакета у каждого исполнителя своя
+  if ((ret == FUZZY_OK) && !serial)
+  {
+    ret = fuzzy_batch_init (model, FUZZY_KERNEL_AUTO, &job.batch);
+    if (ret == FUZZY_OK)
+    {
+      job.scratch = malloc (workers * job.batch.scratch);
+      ret = job.scratch ? FUZZY_OK : FUZZY_ERR_MEMORY;
+    }
+  }
+  for (d = 0; (d < cfg->n_dim) && (ret == FUZZY_OK); d++)
+  {
+    job.xv[d] = malloc (job.count[d]);
+    if (job.xv[d] == NULL)
+    {
+      ret = FUZZY_ERR_MEMORY;
+      break;
+    }
+    for (k = 0; k < job.count[d]; k++)
+    {
+      x = cfg->dim[d].min + (int32_t)k * cfg->dim[d].step;
+      job.xv[d][k] = cfg->dim[d].scale ? cfg->dim[d].scale ((int16_t)x) : lim_s8 ((int16_t)x);
+    }
+  }
+
+  /// вычисление
+  if (ret == FUZZY_OK)
+  {
+    if (serial)
+    {
+      fuzzy_workspace_init (model, job.ws);
+    }
+    job.status = FUZZY_OK;
+    t = fuzzy_time_ns ();
+    fuzzy_pool_run (pool, sweep_task, &job, cells, 0);
+    res.eval_ns = fuzzy_time_ns () - t;
+    ret = job.status;
+  }
+
+  /// запись одним буферизованным проходом
+  if (ret == FUZZY_OK)
+  {
+    t = fuzzy_time_ns ();
+    w->n = 0;
+    w->f = fopen (cfg->output, (cfg->format == FUZZY_SWEEP_BIN) ? "wb" : "w");
+    w->err = (w->f == NULL);
+    if (w->f)
+    {
+      if (cfg->format == FUZZY_SWEEP_BIN)
+      {
+        sweep_write_bin (w, &job, cells);
+      }
+      else
+      {
+        sweep_write_tsv (w, &job);
+      }
+      sweep_flush (w);
+      if (fclose (w->f) != 0)
+      {
+        w->err = true;
+      }
+    }
+    res.write_ns = fuzzy_time_ns () - t;
+    if (w->err)
+    {
+      ret = FUZZY_ERR_FILE;
+    }
+  }
+
+  res.cells = cells;
+  res.threads = (unsigned)workers;
+  res.cells_per_s = res.eval_ns ? ((double)cells * 1e9 / (double)res.eval_ns) : 0.0;
+  if (result)
+  {
+    *result = res;
+  }
+
+  for (d = 0; d < cfg->n_dim; d++)
+  {
+    free (job.xv[d]);
+  }
+  free (w);
+  free (job.scratch);
+  fuzzy_batch_free (&job.batch);
+  free (job.ws);
+  free (job.out);
+  free (job.in);
+  free (job.z);
+  fuzzy_pool_destroy (pool);
+  return ret;
+}
@@ -0,0 +1,95 @@
+/*******************************************************************************
+* \file     fuzzy_sweep.h
+* \author   Ilya Petrukhin (ilya.petrukhin@gmail.com)
+* \brief    Parallel multi-dimensional sweep of the compiled fuzzy model
+* \version  2.1
+* \date     2026-10-17
+*******************************************************************************/
+
+#ifndef _FUZZY_SWEEP_H_
+#define _FUZZY_SWEEP_H_
+
+#include  <stdint.h>
+#include  <stddef.h>
+#include  "fuzzy_logic.h"
+#include  "fuzzy_model.h"
+
+/*******************************************************************************
+* Rules to using sweep
+*******************************************************************************/
+// 1. Configuration file, one setting per line, '#' - comment:
+//  dim     -250 250 10     // input n: min max step, lines in input order
+//  dim     -30 30 1
+//  threads 0               // workers, 0 - one per CPU
+//  format  tsv             // tsv | bin
+//  output  ../output_int.txt
+//
+// 2. Load it (or fill fuzzy_sweep_cfg by code), set scaling functions:
+//  fuzzy_sweep_cfg cfg;
+//  fuzzy_sweep_load ("sweep.cfg", &cfg, &line);
+//  cfg.dim[0].scale = in0_scaling;    // NULL - lim_s8
+//  cfg.out_scale = out_scaling;       // NULL - no scaling
+//
+// 3. Run: the grid is split between pool workers, every worker evaluates
+// its cells by process_fuzzy_logic_batch, then the file is written with
+// one buffered pass:
+//  fuzzy_sweep_run (&model, &cfg, &result);
+//
+// TSV layout: first line - values of dim 0, then one line per value of
+// dim 1 with its value first (the same as output_int.txt). With more than
+// two dims the 2-D blocks follow one another, every block starts with line
+// "#<tab>x2=v<tab>x3=v...".
+// Binary layout (little endian): "FZSW", uint16 version, uint16 n_dim,
+// n_dim x (int16 min, int16 max, int16 step, uint32 count), then
+// int16 outputs, dim 0 fastest.
+// Models with rules reading later rules are swept by one worker in grid
+// order, because every output depends on the previous one.
+// ***************** end of the brief *****************************************
+
+#define FUZZY_SWEEP_DIM_MAX   (8)       ///< max dimensions
+#define FUZZY_SWEEP_VERSION   (1)       ///< binary file version
+
+/// Output format
+typedef enum
+{
+  FUZZY_SWEEP_TSV = 0,    ///< text table
+  FUZZY_SWEEP_BIN         ///< binary matrix
+} fuzzy_sweep_format;
+
+/// Input dimension of the sweep
+typedef struct
+{
+  int16_t   min;                      ///< first value
+  int16_t   max;                      ///< last value (included if on step)
+  int16_t   step;                     ///< step > 0
+  int8_t    (*scale) (int16_t x);     ///< input scaling, NULL - lim_s8
+} fuzzy_sweep_dim;
+
+/// Sweep configuration
+typedef struct
+{
+  uint16_t            n_dim;                    ///< number of dimensions
+  fuzzy_sweep_dim     dim[FUZZY_SWEEP_DIM_MAX]; ///< dimensions, dim n -> in_array[n]
+  unsigned            threads;                  ///< workers, 0 - one per CPU
+  fuzzy_sweep_format  format;                   ///< output format
+  char                output[256];              ///< output file name
+  int16_t             (*out_scale) (int8_t out);///< output scaling, NULL - none
+} fuzzy_sweep_cfg;
+
+/// Sweep result
+typedef struct
+{
+  size_t    cells;        ///< evaluated cells
+  unsigned  threads;      ///< workers used
+  uint64_t  eval_ns;      ///< evaluation time, ns
+  uint64_t  write_ns;     ///< file write time, ns
+  double    cells_per_s;  ///< evaluation speed
+} fuzzy_sweep_result;
+
+void         fuzzy_sweep_default (fuzzy_sweep_cfg *cfg);      ///< empty configuration
+fuzzy_status fuzzy_sweep_load (const char *path, fuzzy_sweep_cfg *cfg, unsigned *line);
+fuzzy_status fuzzy_sweep_run (const fuzzy_model *model, const fuzzy_sweep_cfg *cfg,
+                              fuzzy_sweep_result *result);
+uint32_t     fuzzy_sweep_count (const fuzzy_sweep_dim *dim);  ///< values in dimension
+
+#endif  // _FUZZY_SWEEP_H_
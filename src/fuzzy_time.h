@@ -0,0 +1,41 @@
+/*******************************************************************************
+* \file     fuzzy_time.h
+* \author   Ilya Petrukhin (ilya.petrukhin@gmail.com)
+* \brief    Monotonic time source for fuzzy logic measurements
+* \version  2.1
+* \date     2026-10-17
+*******************************************************************************/
+
+#ifndef _FUZZY_TIME_H_
+#define _FUZZY_TIME_H_
+
+#include  <stdint.h>
+
+#if defined (_WIN32)
+#include  <windows.h>
+#else
+#include  <time.h>
+#endif
+
+/*************************************************************************
+ * \brief Monotonic time in nanoseconds
+ * \return uint64_t  time, ns
+*************************************************************************/
+inline static uint64_t fuzzy_time_ns (void)
+{
+#if defined (_WIN32)
+  LARGE_INTEGER cnt, freq;
+
+  QueryPerformanceCounter (&cnt);
+  QueryPerformanceFrequency (&freq);
+  return (uint64_t)((cnt.QuadPart / freq.QuadPart) * 1000000000ULL +
+                    ((cnt.QuadPart % freq.QuadPart) * 1000000000ULL) / freq.QuadPart);
+#else
+  struct timespec ts;
+
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+#endif  // _FUZZY_TIME_H_
@@ -0,0 +1,382 @@
+/*******************************************************************************
+* \file     fuzzy_wcet.c
+* \author   Ilya Petrukhin (ilya.petrukhin@gmail.com)
+* \brief    This file provides code for the worst-case execution time search
+*           over the input vectors of the fuzzy controller
+* \version  2.1
+* \date     2026-10-17
+*******************************************************************************/
+#include  <stdio.h>
+#include  <stdint.h>
+#include  <stdbool.h>
+#include  <stdlib.h>
+#include  <string.h>
+#include  "fuzzy_logic.h"
+#include  "fuzzy_model.h"
+#include  "fuzzy_wcet.h"
+#include  "fuzzy_time.h"
+
+#define WCET_CONFIRM    (8)       ///< rounds of the second measurement, x cfg.rounds
+#define WCET_TIMER      (1000)    ///< measurements of the timer overhead
+
+/// Measured vector
+typedef struct
+{
+  double    ns;                       ///< time per call
+  int8_t    in[FUZZY_WCET_MAX_IN];    ///< input vector
+} wcet_cand;
+
+/// Search state
+typedef struct
+{
+  fuzzy_wcet_fn         fn;           ///< evaluation under test
+  void                  *ctx;         ///< its context
+  const fuzzy_wcet_cfg  *cfg;         ///< settings
+  uint64_t              timer;        ///< timer overhead, ns
+  float                 *t;           ///< times of all measured vectors
+  uint64_t              n;            ///< measured vectors
+  wcet_cand             top[FUZZY_WCET_TOP];  ///< slowest, descending
+  unsigned              n_top;        ///< used entries of top
+  wcet_cand             best;         ///< fastest
+  const int8_t          *vec;         ///< sampled vectors [samples][n_in], NULL - all vectors
+  uint32_t              rnd;          ///< xorshift32 state
+} wcet_run;
+
+static volatile uint32_t wcet_sink;   ///< keeps results alive
+
+
+/*******************************************************************************
+* псевдослучайное число xorshift32
+*******************************************************************************/
+static uint32_t wcet_rand (wcet_run *run)
+{
+  uint32_t x = run->rnd;
+
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  run->rnd = x;
+  return x;
+}
+
+/*******************************************************************************
+* учёт замера в двух самых медленных
+*******************************************************************************/
+static inline void wcet_slow (float *slow, float ns)
+{
+  if (ns > slow[0])
+  {
+    slow[1] = slow[0];
+    slow[0] = ns;
+  }
+  else if (ns > slow[1])
+  {
+    slow[1] = ns;
+  }
+}
+
+/*******************************************************************************
+* время вектора по двум самым медленным замерам: второй, один замер - он сам
+*******************************************************************************/
+static inline double wcet_value (const float *slow, uint32_t rounds)
+{
+  return (rounds > 1) ? slow[1] : slow[0];
+}
+
+/*******************************************************************************
+* время одного вызова: rounds замеров по repeat вызовов в slow, перед каждым
+* замером flush вызовов на случайных векторах сбивают предсказатель переходов
+*******************************************************************************/
+static void wcet_measure (wcet_run *run, const int8_t *in, uint32_t rounds, float *slow)
+{
+  int8_t other[FUZZY_WCET_MAX_IN];
+  uint64_t t0, t;
+  uint32_t r, k, s = 0;
+  uint16_t d;
+
+  for (r = 0; r < rounds; r++)
+  {
+    for (k = 0; k < run->cfg->flush; k++)
+    {
+      for (d = 0; d < run->cfg->n_in; d++)
+      {
+        other[d] = (int8_t)wcet_rand (run);
+      }
+      s += (uint8_t)run->fn (run->ctx, other);
+    }
+    t0 = fuzzy_time_ns ();
+    for (k = 0; k < run->cfg->repeat; k++)
+    {
+      s += (uint8_t)run->fn (run->ctx, in);
+    }
+    t = fuzzy_time_ns () - t0;
+    t = (t > run->timer) ? t - run->timer : 0;
+    wcet_slow (slow, (float)t / run->cfg->repeat);
+  }
+  wcet_sink += s;
+}
+
+/*******************************************************************************
+* учёт вектора в самых медленных / самом быстром
+*******************************************************************************/
+static void wcet_record (wcet_run *run, const int8_t *in, double ns)
+{
+  uint16_t n_in = run->cfg->n_in;
+  unsigned k;
+
+  run->t[run->n++] = (float)ns;
+  if ((run->n == 1) || (ns < run->best.ns))
+  {
+    run->best.ns = ns;
+    memcpy (run->best.in, in, n_in);
+  }
+  if ((run->n_top < FUZZY_WCET_TOP) || (ns > run->top[run->n_top - 1].ns))
+  {
+    k = (run->n_top < FUZZY_WCET_TOP) ? run->n_top++ : run->n_top - 1;
+    for (; (k > 0) && (run->top[k - 1].ns < ns); k--)
+    {
+      run->top[k] = run->top[k - 1];
+    }
+    run->top[k].ns = ns;
+    memcpy (run->top[k].in, in, n_in);
+  }
+}
+
+/*******************************************************************************
+* вектор номер i: все векторы по номеру или сохранённые случайные
+*******************************************************************************/
+static void wcet_vector (const wcet_run *run, uint64_t i, int8_t *in)
+{
+  uint16_t n_in = run->cfg->n_in, d;
+
+  if (run->vec)
+  {
+    memcpy (in, &run->vec[i * n_in], n_in);
+    return;
+  }
+  for (d = 0; d < n_in; d++)
+  {
+    in[d] = (int8_t)((i >> (8 * d)) & 0xFF);
+  }
+}
+
+/*******************************************************************************
+* сравнение времён для qsort
+*******************************************************************************/
+static int wcet_cmp (const void *a, const void *b)
+{
+  float x = *(const float *)a, y = *(const float *)b;
+
+  return (x > y) - (x < y);
+}
+
+/*******************************************************************************
+* Настройки поиска по умолчанию
+* \brief  Default settings: 65536 samples, 1 call x 3 rounds after 4 calls on
+*         random vectors, 256 climb steps
+* \param[out] cfg     settings
+* \param[in]  n_in    inputs of the vector
+*******************************************************************************/
+void fuzzy_wcet_default (fuzzy_wcet_cfg *cfg, uint16_t n_in)
+{
+  cfg->n_in    = n_in;
+  cfg->samples = 65536;
+  cfg->repeat  = 1;
+  cfg->rounds  = 3;
+  cfg->flush   = 4;
+  cfg->climb   = 256;
+  cfg->seed    = 0x2545F491u;
+}
+
+/*******************************************************************************
+* Поиск самого медленного входного вектора
+* \brief  Time fn on every input vector (or on samples with local search),
+*         measure the slowest again, report the worst case and the spread;
+*         time of a vector is its second slowest measurement
+* \param[in]  fn      evaluation under test
+* \param[in]  ctx     its context
+* \param[in]  cfg     settings, fuzzy_wcet_default
+* \param[out] rep     report
+* \return             FUZZY_OK, FUZZY_ERR_PARAM, FUZZY_ERR_MEMORY
+*******************************************************************************/
+fuzzy_status fuzzy_wcet_search (fuzzy_wcet_fn fn, void *ctx, const fuzzy_wcet_cfg *cfg,
+                                fuzzy_wcet_report *rep)
+{
+  wcet_run run;
+  wcet_cand cand[FUZZY_WCET_TOP], cur;
+  float c_slow[FUZZY_WCET_TOP][2];
+  int8_t in[FUZZY_WCET_MAX_IN], *vec = NULL;
+  uint64_t n_vec, i, t0, t;
+  double ns, sum = 0;
+  float *t_slow, slow[2];
+  uint32_t k, r, n_cand;
+  uint16_t d;
+  int x;
+
+  if ((fn == NULL) || (cfg == NULL) || (rep == NULL) || (cfg->n_in == 0) ||
+      (cfg->n_in > FUZZY_WCET_MAX_IN) || (cfg->repeat == 0) || (cfg->rounds == 0) ||
+      (cfg->seed == 0))
+  {
+    return FUZZY_ERR_PARAM;
+  }
+  memset (rep, 0, sizeof (fuzzy_wcet_report));
+  memset (&run, 0, sizeof (run));
+  memset (in, 0, sizeof (in));
+  run.fn = fn;
+  run.ctx = ctx;
+  run.cfg = cfg;
+  run.rnd = cfg->seed;
+  rep->n_in = cfg->n_in;
+  rep->exhaustive = ((1ull << (8 * (cfg->n_in - 1))) <= FUZZY_WCET_EXHAUSTIVE / 256);
+  n_vec = rep->exhaustive ? (1ull << (8 * cfg->n_in)) : cfg->samples;
+  if (n_vec == 0)
+  {
+    return FUZZY_ERR_PARAM;
+  }
+
+  /// времена: все векторы с подъёмом, затем два самых медленных замера [n_vec][2]
+  run.t = malloc ((n_vec + cfg->climb) * sizeof (float) + 2 * n_vec * sizeof (float));
+  if (!rep->exhaustive)
+  {
+    vec = malloc (n_vec * cfg->n_in);
+  }
+  if ((run.t == NULL) || (!rep->exhaustive && (vec == NULL)))
+  {
+    free (run.t);
+    free (vec);
+    return FUZZY_ERR_MEMORY;
+  }
+  t_slow = run.t + n_vec + cfg->climb;
+  memset (t_slow, 0, 2 * n_vec * sizeof (float));
+  if (vec)
+  {
+    for (i = 0; i < n_vec * cfg->n_in; i++)
+    {
+      vec[i] = (int8_t)wcet_rand (&run);
+    }
+    run.vec = vec;
+  }
+  t0 = fuzzy_time_ns ();
+
+  /// накладные расходы таймера
+  run.timer = UINT64_MAX;
+  for (k = 0; k < WCET_TIMER; k++)
+  {
+    t = fuzzy_time_ns ();
+    t = fuzzy_time_ns () - t;
+    if (t < run.timer)
+    {
+      run.timer = t;
+    }
+  }
+  wcet_measure (&run, in, cfg->rounds, slow);   // прогрев
+
+  /// проходы по всем векторам: всплеск помех попадает в один проход вектора
+  for (r = 0; r < cfg->rounds; r++)
+  {
+    for (i = 0; i < n_vec; i++)
+    {
+      wcet_vector (&run, i, in);
+      wcet_measure (&run, in, 1, &t_slow[2 * i]);
+    }
+  }
+  for (i = 0; i < n_vec; i++)
+  {
+    wcet_vector (&run, i, in);
+    wcet_record (&run, in, wcet_value (&t_slow[2 * i], cfg->rounds));
+  }
+
+  /// подъём от самого медленного случайного вектора
+  if (!rep->exhaustive)
+  {
+    cur = run.top[0];
+    for (k = 0; k < cfg->climb; k++)
+    {
+      memcpy (in, cur.in, cfg->n_in);
+      d = (uint16_t)(wcet_rand (&run) % cfg->n_in);
+      x = 1 << (wcet_rand (&run) % 7);
+      x = in[d] + ((wcet_rand (&run) & 1) ? x : -x);
+      in[d] = (int8_t)((x < -128) ? -128 : (x > 127) ? 127 : x);
+      slow[0] = slow[1] = 0;
+      wcet_measure (&run, in, cfg->rounds, slow);
+      ns = wcet_value (slow, cfg->rounds);
+      wcet_record (&run, in, ns);
+      if (ns > cur.ns)
+      {
+        cur.ns = ns;
+        memcpy (cur.in, in, cfg->n_in);
+      }
+    }
+  }
+
+  /// самые медленные - повторно, проходами с большим числом замеров;
+  /// худшее - максимум первого и повторного замера
+  n_cand = run.n_top;
+  memcpy (cand, run.top, n_cand * sizeof (wcet_cand));
+  memset (c_slow, 0, sizeof (c_slow));
+  for (r = 0; r < cfg->rounds * WCET_CONFIRM; r++)
+  {
+    for (k = 0; k < n_cand; k++)
+    {
+      wcet_measure (&run, cand[k].in, 1, c_slow[k]);
+    }
+  }
+  for (k = 0; k < n_cand; k++)
+  {
+    ns = wcet_value (c_slow[k], cfg->rounds * WCET_CONFIRM);
+    cand[k].ns = (ns > cand[k].ns) ? ns : cand[k].ns;
+    if ((k == 0) || (cand[k].ns > rep->worst_ns))
+    {
+      rep->worst_ns = cand[k].ns;
+      memcpy (rep->worst_in, cand[k].in, cfg->n_in);
+    }
+  }
+  rep->best_ns = run.best.ns;
+  memcpy (rep->best_in, run.best.in, cfg->n_in);
+
+  /// распределение по векторам
+  qsort (run.t, run.n, sizeof (float), wcet_cmp);
+  for (i = 0; i < run.n; i++)
+  {
+    sum += run.t[i];
+  }
+  rep->vectors = run.n;
+  rep->mean_ns = sum / (double)run.n;
+  rep->p50_ns = run.t[(run.n * 50 + 99) / 100 - 1];
+  rep->p99_ns = run.t[(run.n * 99 + 99) / 100 - 1];
+  rep->spread = (rep->best_ns > 0) ? rep->worst_ns / rep->best_ns : 0.0;
+  rep->timer_ns = (double)run.timer;
+  rep->search_ns = fuzzy_time_ns () - t0;
+  free (run.t);
+  free (vec);
+  return FUZZY_OK;
+}
+
+/*******************************************************************************
+* Вывод отчёта
+* \brief  Print the report: worst and best vectors, distribution, spread
+* \param[in]  name    name of the evaluation
+* \param[in]  rep     report
+* \param[in]  f       output file
+*******************************************************************************/
+void fuzzy_wcet_print (const char *name, const fuzzy_wcet_report *rep, FILE *f)
+{
+  uint16_t d;
+
+  fprintf (f, "%-12s %s, %llu vectors, %.0f ms\n", name,
+           rep->exhaustive ? "exhaustive" : "sampled", (unsigned long long)rep->vectors,
+           rep->search_ns / 1e6);
+  fprintf (f, "%-12s worst %8.2f ns at in =", name, rep->worst_ns);
+  for (d = 0; d < rep->n_in; d++)
+  {
+    fprintf (f, " %4d", rep->worst_in[d]);
+  }
+  fprintf (f, "\n%-12s best  %8.2f ns at in =", name, rep->best_ns);
+  for (d = 0; d < rep->n_in; d++)
+  {
+    fprintf (f, " %4d", rep->best_in[d]);
+  }
+  fprintf (f, "\n%-12s worst / best %.2f (worst measured again), all vectors: mean %.2f  p50 %.2f"
+           "  p99 %.2f ns, timer %.0f ns\n",
+           name, rep->spread, rep->mean_ns, rep->p50_ns, rep->p99_ns, rep->timer_ns);
+}
@@ -0,0 +1,97 @@
+/*******************************************************************************
+* \file     fuzzy_wcet.h
+* \author   Ilya Petrukhin (ilya.petrukhin@gmail.com)
+* \brief    Worst-case execution time search of the fuzzy controller:
+*           the slowest input vector and the time spread over the inputs
+* \version  2.1
+* \date     2026-10-17
+*******************************************************************************/
+
+#ifndef _FUZZY_WCET_H_
+#define _FUZZY_WCET_H_
+
+#include  <stdio.h>
+#include  <stdint.h>
+#include  <stdbool.h>
+#include  "fuzzy_logic.h"
+#include  "fuzzy_model.h"
+
+/*******************************************************************************
+* Rules to using worst-case search
+*******************************************************************************/
+// 1. Evaluation under test as function of the input vector:
+//  static int8_t eval_ct (void *ctx, const int8_t *in)
+//  {
+//    return process_fuzzy_logic_ct (ctx, in);
+//  }
+//
+// 2. Search and report:
+//  fuzzy_wcet_cfg cfg;
+//  fuzzy_wcet_report rep;
+//  fuzzy_wcet_default (&cfg, model.n_in);
+//  fuzzy_wcet_search (eval_ct, &ct, &cfg, &rep);
+//  fuzzy_wcet_print ("ct", &rep, stdout);
+//
+// Every vector is timed as cfg.repeat calls, the second slowest of
+// cfg.rounds measurements is kept (the slowest with one round: a single
+// interrupt does not set the time of the vector), timer overhead is
+// subtracted. Before every measurement cfg.flush untimed calls on random
+// vectors disturb the branch predictor and the caches, so the timed call
+// does not run on the history of the same input; default is one timed call
+// after 4 random ones. The rounds are passes over all vectors.
+// Domains of up to FUZZY_WCET_EXHAUSTIVE vectors (one or two int8_t inputs)
+// are searched exhaustively; larger ones by cfg.samples random vectors and
+// cfg.climb steps of local search from the slowest one (one input moved
+// by +-1..64). The FUZZY_WCET_TOP slowest
+// vectors are measured again with 8 x rounds, the worst case is the max of
+// the times of the first and of the second pass, so it is not below the
+// mean and the percentiles of the first pass; the best case is the fastest
+// vector of the first pass. The worst case includes the noise of the host
+// (interrupts, migrations): an upper estimate, run the search on a quiet
+// target (or its simulator) with the production compiler flags.
+// Tool: tools/fuzzy_wcet.c (line controller or FCL file).
+// ***************** end of the brief *****************************************
+
+#define FUZZY_WCET_MAX_IN       (8)         ///< max inputs of the vector
+#define FUZZY_WCET_EXHAUSTIVE   (65536)     ///< max vectors of exhaustive search
+#define FUZZY_WCET_TOP          (16)        ///< slowest vectors measured again
+
+/// Evaluation under test
+typedef int8_t (*fuzzy_wcet_fn) (void *ctx, const int8_t *in_array);
+
+/// Search settings
+typedef struct
+{
+  uint16_t  n_in;       ///< inputs of the vector 1..FUZZY_WCET_MAX_IN
+  uint32_t  samples;    ///< random vectors when the domain is not searched exhaustively
+  uint32_t  repeat;     ///< calls per measurement
+  uint32_t  rounds;     ///< measurements per vector, the second slowest is kept
+  uint32_t  flush;      ///< untimed calls on random vectors before every measurement
+  uint32_t  climb;      ///< local search steps from the slowest sample
+  uint32_t  seed;       ///< random seed of sampling, not 0
+} fuzzy_wcet_cfg;
+
+/// Search report
+typedef struct
+{
+  bool      exhaustive;                     ///< the whole domain was searched
+  uint16_t  n_in;                           ///< inputs of the vector
+  uint64_t  vectors;                        ///< vectors measured
+  int8_t    worst_in[FUZZY_WCET_MAX_IN];    ///< slowest input vector
+  double    worst_ns;                       ///< its time per call
+  int8_t    best_in[FUZZY_WCET_MAX_IN];     ///< fastest input vector
+  double    best_ns;                        ///< its time per call
+  double    mean_ns;                        ///< mean time over the vectors
+  double    p50_ns;                         ///< median
+  double    p99_ns;                         ///< 99th percentile
+  double    spread;                         ///< worst / best
+  double    timer_ns;                       ///< timer overhead subtracted per measurement
+  uint64_t  search_ns;                      ///< time of the search
+} fuzzy_wcet_report;
+
+void         fuzzy_wcet_default (fuzzy_wcet_cfg *cfg, uint16_t n_in);
+fuzzy_status fuzzy_wcet_search (fuzzy_wcet_fn fn, void *ctx, const fuzzy_wcet_cfg *cfg,
+                                fuzzy_wcet_report *rep);
+void         fuzzy_wcet_print (const char *name, const fuzzy_wcet_report *rep, FILE *f);
+
+#endif  // _FUZZY_WCET_H_
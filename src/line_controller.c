@@ -0,0 +1,267 @@
+/*******************************************************************************
+* \file     line_controller.c
+* \author   Ilya Petrukhin (ilya.petrukhin@gmail.com)
+* \brief    Line following controller: fuzzy functions, rules and scaling
+*           shared by the validation program and the benchmark
+* \version  2.1
+* \date     2026-10-17
+*******************************************************************************/
+#include    <stdio.h>
+#include    <stdbool.h>
+#include    <stdint.h>
+#include    "fuzzy_logic.h"
+#include    "fuzzy_logic16.h"
+#include    "fuzzy_mamdani.h"
+#include    "line_controller.h"
+
+/*************************** Fuzzy logic rules start ***************************************/
+// Дистанция до линии в 2-х сантиметрах (limit +-127 = +-254см)
+#define D_VERY_HIGH  (100)      // 2,0м
+#define D_HIGH       (75)       // 1,5м
+#define D_L1_CEN     (50)       // 1,0м
+#define D_L1_TOP     (25)       // 50см
+#define D_L1_BTN     (50)       // 1,0м
+#define D_ZERO       (0)
+#define D_LOW        (-D_HIGH)
+#define D_VERY_LOW   (-D_VERY_HIGH)
+#define D_Z_TOP      (1)        // 2см
+#define D_Z_BTN      (10)       // 20см
+#define D_R1_CEN     (-D_L1_CEN)
+#define D_R1_TOP     (D_L1_TOP)
+#define D_R1_BTN     (D_L1_BTN)
+
+
+// Угол направления (theta) в градусах
+#define T_VERY_HIGH  (115)
+#define T_HIGH2      (20)
+#define T_HIGH       (15)
+#define T_ZERO       (0)
+#define T_LOW        (-T_HIGH)
+#define T_LOW2       (-T_HIGH2)
+#define T_VERY_LOW   (-T_VERY_HIGH)
+
+#define T_Z_TOP      (5)
+#define T_Z_BTN      (10)
+#define T_SIGMA      (10)
+
+// Воздействие: угол направления колёс в градусах
+#define TURN_H_LEFT     (25)
+#define TURN_LEFT       (4)
+#define NO_TURN         (0)
+#define TURN_RIGHT      (-TURN_LEFT)
+#define TURN_H_RIGHT    (-TURN_H_LEFT)
+
+#define NULL_PARAM      (0)
+#define NULL_OUT        (0)
+
+// правила фуззификации (функции принадлежности)
+//          name,     ffunc,    [n],  a,            b,              c,              next        
+MAKE_FFUNC (d_zero,   trapecia, 0,    D_ZERO,       D_Z_TOP,        D_Z_BTN,        d_r1);     
+MAKE_FFUNC (d_r1,     trapecia, 0,    D_R1_CEN,     D_R1_TOP,       D_R1_BTN,       d_r2);  
+MAKE_FFUNC (d_r2,     low,      0,    D_VERY_LOW,   D_LOW,          NULL_PARAM,     d_l1);   
+MAKE_FFUNC (d_l1,     trapecia, 0,    D_L1_CEN,     D_L1_TOP,       D_L1_BTN,       d_l2);   
+MAKE_FFUNC (d_l2,     high,     0,    D_HIGH,       D_VERY_HIGH,    NULL_PARAM,     t_zero);   
+MAKE_FFUNC (t_zero,   trapecia, 1,    T_ZERO,       T_Z_TOP,        T_Z_BTN,        t_l1);     
+MAKE_FFUNC (t_l1,     triangle, 1,    T_LOW,        T_SIGMA,        NULL_PARAM,     t_l2);    
+MAKE_FFUNC (t_l2,     low,      1,    T_LOW2,       T_LOW,          NULL_PARAM,     t_r1);   
+MAKE_FFUNC (t_r1,     triangle, 1,    T_HIGH,       T_SIGMA,        NULL_PARAM,     t_r2);   
+MAKE_FFUNC (t_r2,     high,     1,    T_HIGH,       T_HIGH2,        NULL_PARAM,     d_zero);   
+
+
+
+// Правила нечёткой логики по данным эксперта
+//        name,          A,          OPER,     B,        fin,       output,         next rule
+MAKE_RULE (rule_01,      d_r2,       F_AND,    t_l2,     true,      NO_TURN,        rule_02);   // на большой дистанции угол въезда 25 градусов
+MAKE_RULE (rule_02,      d_r2,       F_AND,    t_l1,     true,      TURN_LEFT,      rule_03);
+MAKE_RULE (rule_03,      t_zero,     F_OR,     t_r1,     false,     NO_TURN,        rule_04);
+MAKE_RULE (rule_04,      rule_03,    F_OR,     t_r2,     false,     NO_TURN,        rule_05);
+MAKE_RULE (rule_05,      d_r2,       F_AND,    rule_04,  true,      TURN_H_LEFT,    rule_06);
+MAKE_RULE (rule_06,      t_r2,       F_OR,     t_r1,     false,     NO_TURN,        rule_07);
+MAKE_RULE (rule_07,      d_r1,       F_AND,    rule_06,  true,      TURN_H_LEFT,    rule_08);
+MAKE_RULE (rule_08,      d_r1,       F_AND,    t_zero,   true,      TURN_LEFT,      rule_09);
+MAKE_RULE (rule_09,      d_r1,       F_AND,    t_l1,     true,      NO_TURN,        rule_10);
+MAKE_RULE (rule_10,      d_r1,       F_AND,    t_l2,     true,      TURN_RIGHT,     rule_11);
+MAKE_RULE (rule_11,      d_zero,     F_AND,    t_l2,     true,      TURN_RIGHT,     rule_12);
+MAKE_RULE (rule_12,      d_zero,     F_AND,    t_l1,     true,      NO_TURN,        rule_13);
+MAKE_RULE (rule_13,      d_zero,     F_AND,    t_zero,   true,      NO_TURN,        rule_14);
+MAKE_RULE (rule_14,      d_zero,     F_AND,    t_r1,     true,      NO_TURN,        rule_15);
+MAKE_RULE (rule_15,      d_zero,     F_AND,    t_r2,     true,      TURN_LEFT,      rule_16);
+MAKE_RULE (rule_16,      t_l2,       F_OR,     t_l1,     false,     NO_TURN,        rule_17);
+MAKE_RULE (rule_17,      d_l1,       F_AND,    rule_16,  true,      TURN_H_RIGHT,   rule_18);
+MAKE_RULE (rule_18,      d_l1,       F_AND,    t_zero,   true,      TURN_RIGHT,     rule_19);
+MAKE_RULE (rule_19,      d_l1,       F_AND,    t_r1,     true,      NO_TURN,        rule_20);
+MAKE_RULE (rule_20,      d_l1,       F_AND,    t_r2,     true,      TURN_LEFT,      rule_21);
+MAKE_RULE (rule_21,      t_l2,       F_OR,     t_l1,     false,     NO_TURN,        rule_22);
+MAKE_RULE (rule_22,      t_zero,     F_OR,     rule_21,  false,     NO_TURN,        rule_23);
+MAKE_RULE (rule_23,      d_l2,       F_AND,    rule_22,  true,      TURN_H_RIGHT,   rule_24);
+MAKE_RULE (rule_24,      d_l2,       F_AND,    t_r1,     true,      TURN_RIGHT,     rule_25);
+MAKE_RULE (rule_25,      d_l2,       F_AND,    t_r2,     true,      NO_TURN,        rule_01);
+
+
+
+// Выходные множества для приведения к четкости по Мамдани
+#define TURN_H_WIDTH    (TURN_H_LEFT - TURN_LEFT)
+#define TURN_WIDTH      (TURN_LEFT)
+
+const fuzzy_outset line_outset[LINE_N_OUTSET] =
+{
+//  out,            func,       a,              b,              c
+  { TURN_H_RIGHT,   triangle,   TURN_H_RIGHT,   TURN_H_WIDTH,   NULL_PARAM },
+  { TURN_RIGHT,     triangle,   TURN_RIGHT,     TURN_WIDTH,     NULL_PARAM },
+  { NO_TURN,        triangle,   NO_TURN,        TURN_WIDTH,     NULL_PARAM },
+  { TURN_LEFT,      triangle,   TURN_LEFT,      TURN_WIDTH,     NULL_PARAM },
+  { TURN_H_LEFT,    triangle,   TURN_H_LEFT,    TURN_H_WIDTH,   NULL_PARAM },
+};
+
+// Тот же регулятор в 16-разрядном варианте: параметры и выход * LINE16_SCALE
+#define Q16(x)          ((int16_t)((x) * LINE16_SCALE))
+
+//            name,       ffunc,        [n],  a,                  b,                  c,                  next
+MAKE_FFUNC16 (d_zero16,   trapecia16,   0,    Q16(D_ZERO),        Q16(D_Z_TOP),       Q16(D_Z_BTN),       d_r1_16);
+MAKE_FFUNC16 (d_r1_16,    trapecia16,   0,    Q16(D_R1_CEN),      Q16(D_R1_TOP),      Q16(D_R1_BTN),      d_r2_16);
+MAKE_FFUNC16 (d_r2_16,    low16,        0,    Q16(D_VERY_LOW),    Q16(D_LOW),         NULL_PARAM,         d_l1_16);
+MAKE_FFUNC16 (d_l1_16,    trapecia16,   0,    Q16(D_L1_CEN),      Q16(D_L1_TOP),      Q16(D_L1_BTN),      d_l2_16);
+MAKE_FFUNC16 (d_l2_16,    high16,       0,    Q16(D_HIGH),        Q16(D_VERY_HIGH),   NULL_PARAM,         t_zero16);
+MAKE_FFUNC16 (t_zero16,   trapecia16,   1,    Q16(T_ZERO),        Q16(T_Z_TOP),       Q16(T_Z_BTN),       t_l1_16);
+MAKE_FFUNC16 (t_l1_16,    triangle16,   1,    Q16(T_LOW),         Q16(T_SIGMA),       NULL_PARAM,         t_l2_16);
+MAKE_FFUNC16 (t_l2_16,    low16,        1,    Q16(T_LOW2),        Q16(T_LOW),         NULL_PARAM,         t_r1_16);
+MAKE_FFUNC16 (t_r1_16,    triangle16,   1,    Q16(T_HIGH),        Q16(T_SIGMA),       NULL_PARAM,         t_r2_16);
+MAKE_FFUNC16 (t_r2_16,    high16,       1,    Q16(T_HIGH),        Q16(T_HIGH2),       NULL_PARAM,         d_zero16);
+
+//          name,          A,          OPER,     B,          fin,       output,             next rule
+MAKE_RULE16 (rule16_01,    d_r2_16,    F_AND,    t_l2_16,    true,      Q16(NO_TURN),       rule16_02);
+MAKE_RULE16 (rule16_02,    d_r2_16,    F_AND,    t_l1_16,    true,      Q16(TURN_LEFT),     rule16_03);
+MAKE_RULE16 (rule16_03,    t_zero16,   F_OR,     t_r1_16,    false,     Q16(NO_TURN),       rule16_04);
+MAKE_RULE16 (rule16_04,    rule16_03,  F_OR,     t_r2_16,    false,     Q16(NO_TURN),       rule16_05);
+MAKE_RULE16 (rule16_05,    d_r2_16,    F_AND,    rule16_04,  true,      Q16(TURN_H_LEFT),   rule16_06);
+MAKE_RULE16 (rule16_06,    t_r2_16,    F_OR,     t_r1_16,    false,     Q16(NO_TURN),       rule16_07);
+MAKE_RULE16 (rule16_07,    d_r1_16,    F_AND,    rule16_06,  true,      Q16(TURN_H_LEFT),   rule16_08);
+MAKE_RULE16 (rule16_08,    d_r1_16,    F_AND,    t_zero16,   true,      Q16(TURN_LEFT),     rule16_09);
+MAKE_RULE16 (rule16_09,    d_r1_16,    F_AND,    t_l1_16,    true,      Q16(NO_TURN),       rule16_10);
+MAKE_RULE16 (rule16_10,    d_r1_16,    F_AND,    t_l2_16,    true,      Q16(TURN_RIGHT),    rule16_11);
+MAKE_RULE16 (rule16_11,    d_zero16,   F_AND,    t_l2_16,    true,      Q16(TURN_RIGHT),    rule16_12);
+MAKE_RULE16 (rule16_12,    d_zero16,   F_AND,    t_l1_16,    true,      Q16(NO_TURN),       rule16_13);
+MAKE_RULE16 (rule16_13,    d_zero16,   F_AND,    t_zero16,   true,      Q16(NO_TURN),       rule16_14);
+MAKE_RULE16 (rule16_14,    d_zero16,   F_AND,    t_r1_16,    true,      Q16(NO_TURN),       rule16_15);
+MAKE_RULE16 (rule16_15,    d_zero16,   F_AND,    t_r2_16,    true,      Q16(TURN_LEFT),     rule16_16);
+MAKE_RULE16 (rule16_16,    t_l2_16,    F_OR,     t_l1_16,    false,     Q16(NO_TURN),       rule16_17);
+MAKE_RULE16 (rule16_17,    d_l1_16,    F_AND,    rule16_16,  true,      Q16(TURN_H_RIGHT),  rule16_18);
+MAKE_RULE16 (rule16_18,    d_l1_16,    F_AND,    t_zero16,   true,      Q16(TURN_RIGHT),    rule16_19);
+MAKE_RULE16 (rule16_19,    d_l1_16,    F_AND,    t_r1_16,    true,      Q16(NO_TURN),       rule16_20);
+MAKE_RULE16 (rule16_20,    d_l1_16,    F_AND,    t_r2_16,    true,      Q16(TURN_LEFT),     rule16_21);
+MAKE_RULE16 (rule16_21,    t_l2_16,    F_OR,     t_l1_16,    false,     Q16(NO_TURN),       rule16_22);
+MAKE_RULE16 (rule16_22,    t_zero16,   F_OR,     rule16_21,  false,     Q16(NO_TURN),       rule16_23);
+MAKE_RULE16 (rule16_23,    d_l2_16,    F_AND,    rule16_22,  true,      Q16(TURN_H_RIGHT),  rule16_24);
+MAKE_RULE16 (rule16_24,    d_l2_16,    F_AND,    t_r1_16,    true,      Q16(TURN_RIGHT),    rule16_25);
+MAKE_RULE16 (rule16_25,    d_l2_16,    F_AND,    t_r2_16,    true,      Q16(NO_TURN),       rule16_01);
+
+// Тот же регулятор с линейными следствиями (Takagi-Sugeno первого порядка):
+// 5 термов дистанции x 3 терма угла, следствие out = k0 + (k_d * d + k_t * t) / 256
+// коэффициенты подобраны методом наименьших квадратов по выходу 25 правил
+#define T_TS_WIDTH      (10)
+
+//          name,       ffunc,    [n],  a,            b,              c,              next
+MAKE_FFUNC (ts_d_zero,  trapecia, 0,    D_ZERO,       D_Z_TOP,        D_Z_BTN,        ts_d_r1);
+MAKE_FFUNC (ts_d_r1,    trapecia, 0,    D_R1_CEN,     D_R1_TOP,       D_R1_BTN,       ts_d_r2);
+MAKE_FFUNC (ts_d_r2,    low,      0,    D_VERY_LOW,   D_LOW,          NULL_PARAM,     ts_d_l1);
+MAKE_FFUNC (ts_d_l1,    trapecia, 0,    D_L1_CEN,     D_L1_TOP,       D_L1_BTN,       ts_d_l2);
+MAKE_FFUNC (ts_d_l2,    high,     0,    D_HIGH,       D_VERY_HIGH,    NULL_PARAM,     ts_t_l);
+MAKE_FFUNC (ts_t_l,     low,      1,    -T_TS_WIDTH,  T_ZERO,         NULL_PARAM,     ts_t_zero);
+MAKE_FFUNC (ts_t_zero,  triangle, 1,    T_ZERO,       T_TS_WIDTH,     NULL_PARAM,     ts_t_r);
+MAKE_FFUNC (ts_t_r,     high,     1,    T_ZERO,       T_TS_WIDTH,     NULL_PARAM,     ts_d_zero);
+
+//            name,        A,          OPER,     B,          fin,    next rule,     k0,   k_d,  k_t
+MAKE_RULE_TS (rule_ts_01,  ts_d_r2,    F_AND,    ts_t_l,     true,   rule_ts_02,    3,    3,    5);
+MAKE_RULE_TS (rule_ts_02,  ts_d_r2,    F_AND,    ts_t_zero,  true,   rule_ts_03,    26,   -8,   -565);
+MAKE_RULE_TS (rule_ts_03,  ts_d_r2,    F_AND,    ts_t_r,     true,   rule_ts_04,    25,   0,    -1);
+MAKE_RULE_TS (rule_ts_04,  ts_d_r1,    F_AND,    ts_t_l,     true,   rule_ts_05,    -3,   -1,   4);
+MAKE_RULE_TS (rule_ts_05,  ts_d_r1,    F_AND,    ts_t_zero,  true,   rule_ts_06,    1,    1,    -655);
+MAKE_RULE_TS (rule_ts_06,  ts_d_r1,    F_AND,    ts_t_r,     true,   rule_ts_07,    25,   0,    1);
+MAKE_RULE_TS (rule_ts_07,  ts_d_zero,  F_AND,    ts_t_l,     true,   rule_ts_08,    -2,   21,   5);
+MAKE_RULE_TS (rule_ts_08,  ts_d_zero,  F_AND,    ts_t_zero,  true,   rule_ts_09,    0,    68,   -13);
+MAKE_RULE_TS (rule_ts_09,  ts_d_zero,  F_AND,    ts_t_r,     true,   rule_ts_10,    2,    21,   5);
+MAKE_RULE_TS (rule_ts_10,  ts_d_l1,    F_AND,    ts_t_l,     true,   rule_ts_11,    -25,  0,    1);
+MAKE_RULE_TS (rule_ts_11,  ts_d_l1,    F_AND,    ts_t_zero,  true,   rule_ts_12,    -1,   1,    -655);
+MAKE_RULE_TS (rule_ts_12,  ts_d_l1,    F_AND,    ts_t_r,     true,   rule_ts_13,    3,    -1,   4);
+MAKE_RULE_TS (rule_ts_13,  ts_d_l2,    F_AND,    ts_t_l,     true,   rule_ts_14,    -25,  0,    -1);
+MAKE_RULE_TS (rule_ts_14,  ts_d_l2,    F_AND,    ts_t_zero,  true,   rule_ts_15,    -26,  -8,   -565);
+MAKE_RULE_TS (rule_ts_15,  ts_d_l2,    F_AND,    ts_t_r,     true,   rule_ts_01,    -3,   3,    5);
+
+
+/*************************************************************************
+ * @brief user scaling input 1 value to the limits +-127
+ * input - distance in cm +-10000, limitation to +-254
+ * @param in1 
+ * @return int8_t 
+*************************************************************************/
+int8_t in0_scaling (int16_t in1)
+{
+    int16_t ret = in1 / 2;
+
+    return (lim_s8 (ret));
+}
+
+/*************************************************************************
+ * @brief user scaling input 2 value to the limits +-127
+ * input - cource in degree +-180, limitation to +-127 degree
+ * @param in2 
+ * @return int8_t 
+*************************************************************************/
+int8_t in1_scaling (int16_t in2)
+{
+    int16_t ret = in2;
+
+    return (lim_s8 (ret));
+}
+
+/*************************************************************************
+ * @brief user scaling output value +-127 to the control value +-30 valve degree 
+ * no scaling need
+ * @param out       +-127 max
+ * @return int16_t 
+*************************************************************************/
+int16_t out_scaling (int8_t out)
+{
+    return out;
+}
+
+
+/*******************************************************************************
+* Параметры регулятора
+* \brief  Fill fuzzy parameters of the line controller
+* \param[out] fuzzy   fuzzy parameters
+* \param[in]  in      input array [LINE_N_IN]
+*******************************************************************************/
+void line_controller_param (fuzzy_param *fuzzy, int8_t *in)
+{
+    fuzzy->in_array    = in;
+    fuzzy->start_ffunc = &d_zero;
+    fuzzy->start_rule  = &rule_01;
+}
+
+/*******************************************************************************
+* Параметры регулятора с линейными следствиями
+* \brief  Fill fuzzy parameters of the first-order Takagi-Sugeno line
+*         controller: LINE_TS_N_RULE rules instead of LINE_N_RULE
+* \param[out] fuzzy   fuzzy parameters
+* \param[in]  in      input array [LINE_N_IN]
+*******************************************************************************/
+void line_controller_ts_param (fuzzy_param *fuzzy, int8_t *in)
+{
+    fuzzy->in_array    = in;
+    fuzzy->start_ffunc = &ts_d_zero;
+    fuzzy->start_rule  = &rule_ts_01;
+}
+
+/*******************************************************************************
+* Параметры 16-разрядного регулятора
+* \brief  Fill fuzzy parameters of the 16-bit line controller
+* \param[out] fuzzy   fuzzy parameters
+* \param[in]  in      input array [LINE_N_IN], inputs * LINE16_SCALE
+*******************************************************************************/
+void line_controller_param16 (fuzzy_param16 *fuzzy, int16_t *in)
+{
+    fuzzy->in_array    = in;
+    fuzzy->start_ffunc = &d_zero16;
+    fuzzy->start_rule  = &rule16_01;
+}
@@ -0,0 +1,36 @@
+/*******************************************************************************
+* \file     line_controller.h
+* \author   Ilya Petrukhin (ilya.petrukhin@gmail.com)
+* \brief    Line following controller (25 rules): distance to the line and
+*           course angle to the wheels turn angle
+* \version  2.1
+* \date     2026-10-17
+*******************************************************************************/
+
+#ifndef _LINE_CONTROLLER_H_
+#define _LINE_CONTROLLER_H_
+
+#include  <stdint.h>
+#include  <stdbool.h>
+#include  "fuzzy_logic.h"
+#include  "fuzzy_logic16.h"
+#include  "fuzzy_mamdani.h"
+
+#define LINE_N_IN     (2)     ///< inputs: [0] distance, 2 cm; [1] course, degree
+#define LINE_N_RULE   (25)    ///< number of rules
+#define LINE_TS_N_RULE (15)   ///< number of rules of the first-order Takagi-Sugeno controller
+#define LINE_N_OUTSET (5)     ///< output sets of Mamdani defuzzification
+#define LINE16_SCALE  (256)   ///< 16-bit controller: inputs, parameters and output * 256
+
+extern fuzzy_funct d_zero;    ///< first fuzzy function
+extern fuzzy_rules rule_01;   ///< first rule
+extern const fuzzy_outset line_outset[LINE_N_OUTSET];  ///< output sets of the wheels turn angle
+extern fuzzy_funct16 d_zero16;  ///< first fuzzy function of the 16-bit controller
+extern fuzzy_rules16 rule16_01; ///< first rule of the 16-bit controller
+
+void line_controller_param (fuzzy_param *fuzzy, int8_t *in);  ///< fuzzy parameters of the controller
+void line_controller_ts_param (fuzzy_param *fuzzy, int8_t *in);  ///< fuzzy parameters of the Takagi-Sugeno controller
+void line_controller_param16 (fuzzy_param16 *fuzzy, int16_t *in);  ///< fuzzy parameters of the 16-bit controller
+int8_t line_controller_gen (const int8_t *in_array);  ///< generated code of the controller, tools/fuzzy_gen.c
+
+#endif  // _LINE_CONTROLLER_H_
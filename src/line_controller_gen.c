@@ -0,0 +1,270 @@
+/*******************************************************************************
+* \file     line_controller_gen.c
+* \brief    Fuzzy controller line_controller_gen: 10 functions, 25 rules
+*           Generated by fuzzy_codegen, do not edit
+*******************************************************************************/
+#include  <stdint.h>
+#include  <stdbool.h>
+#include  "fuzzy_logic.h"
+
+
+int8_t line_controller_gen (const int8_t *in_array)
+{
+  int32_t x0 = in_array[0];
+  int32_t x1 = in_array[1];
+  uint8_t m0;
+  uint8_t m1;
+  uint8_t m2;
+  uint8_t m3;
+  uint8_t m4;
+  uint8_t m5;
+  uint8_t m6;
+  uint8_t m7;
+  uint8_t m8;
+  uint8_t m9;
+  uint8_t r0;
+  uint8_t r1;
+  uint8_t r2;
+  uint8_t r3;
+  uint8_t r4;
+  uint8_t r5;
+  uint8_t r6;
+  uint8_t r7;
+  uint8_t r8;
+  uint8_t r9;
+  uint8_t r10;
+  uint8_t r11;
+  uint8_t r12;
+  uint8_t r13;
+  uint8_t r14;
+  uint8_t r15;
+  uint8_t r16;
+  uint8_t r17;
+  uint8_t r18;
+  uint8_t r19;
+  uint8_t r20;
+  uint8_t r21;
+  uint8_t r22;
+  uint8_t r23;
+  uint8_t r24;
+  int16_t summ_alpha_c = 0;
+  int16_t summ_alpha = 0;
+
+  /// 0: trapecia (0, 1, 10)
+  if ((x0 < -10) || (x0 > 10))
+  {
+    m0 = 0;
+  }
+  else if (x0 < -1)
+  {
+    m0 = (uint8_t)(((uint32_t)(x0 + 10) * 907u) >> 5);
+  }
+  else if (x0 <= 1)
+  {
+    m0 = 255;
+  }
+  else
+  {
+    m0 = (uint8_t)(((uint32_t)(10 - x0) * 907u) >> 5);
+  }
+  /// 1: trapecia (-50, 25, 50)
+  if ((x0 < -100) || (x0 > 0))
+  {
+    m1 = 0;
+  }
+  else if (x0 < -75)
+  {
+    m1 = (uint8_t)(((uint32_t)(x0 + 100) * 653u) >> 6);
+  }
+  else if (x0 <= -25)
+  {
+    m1 = 255;
+  }
+  else
+  {
+    m1 = (uint8_t)(((uint32_t)(0 - x0) * 653u) >> 6);
+  }
+  /// 2: low (-100, -75, 0)
+  if (x0 > -75)
+  {
+    m2 = 0;
+  }
+  else if (x0 <= -100)
+  {
+    m2 = 255;
+  }
+  else
+  {
+    m2 = (uint8_t)(((uint32_t)(-75 - x0) * 653u) >> 6);
+  }
+  /// 3: trapecia (50, 25, 50)
+  if ((x0 < 0) || (x0 > 100))
+  {
+    m3 = 0;
+  }
+  else if (x0 < 25)
+  {
+    m3 = (uint8_t)(((uint32_t)(x0) * 653u) >> 6);
+  }
+  else if (x0 <= 75)
+  {
+    m3 = 255;
+  }
+  else
+  {
+    m3 = (uint8_t)(((uint32_t)(100 - x0) * 653u) >> 6);
+  }
+  /// 4: high (75, 100, 0)
+  if (x0 < 75)
+  {
+    m4 = 0;
+  }
+  else if (x0 < 100)
+  {
+    m4 = (uint8_t)(((uint32_t)(x0 - 75) * 653u) >> 6);
+  }
+  else
+  {
+    m4 = 255;
+  }
+  /// 5: trapecia (0, 5, 10)
+  if ((x1 < -10) || (x1 > 10))
+  {
+    m5 = 0;
+  }
+  else if (x1 < -5)
+  {
+    m5 = (uint8_t)((uint32_t)(x1 + 10) * 51u);
+  }
+  else if (x1 <= 5)
+  {
+    m5 = 255;
+  }
+  else
+  {
+    m5 = (uint8_t)((uint32_t)(10 - x1) * 51u);
+  }
+  /// 6: triangle (-15, 10, 0)
+  if ((x1 < -25) || (x1 > -5))
+  {
+    m6 = 0;
+  }
+  else if (x1 < -15)
+  {
+    m6 = (uint8_t)(((uint32_t)(x1 + 25) * 51u) >> 1);
+  }
+  else if (x1 <= -15)
+  {
+    m6 = 255;
+  }
+  else
+  {
+    m6 = (uint8_t)(((uint32_t)(-5 - x1) * 51u) >> 1);
+  }
+  /// 7: low (-20, -15, 0)
+  if (x1 > -15)
+  {
+    m7 = 0;
+  }
+  else if (x1 <= -20)
+  {
+    m7 = 255;
+  }
+  else
+  {
+    m7 = (uint8_t)((uint32_t)(-15 - x1) * 51u);
+  }
+  /// 8: triangle (15, 10, 0)
+  if ((x1 < 5) || (x1 > 25))
+  {
+    m8 = 0;
+  }
+  else if (x1 < 15)
+  {
+    m8 = (uint8_t)(((uint32_t)(x1 - 5) * 51u) >> 1);
+  }
+  else if (x1 <= 15)
+  {
+    m8 = 255;
+  }
+  else
+  {
+    m8 = (uint8_t)(((uint32_t)(25 - x1) * 51u) >> 1);
+  }
+  /// 9: high (15, 20, 0)
+  if (x1 < 15)
+  {
+    m9 = 0;
+  }
+  else if (x1 < 20)
+  {
+    m9 = (uint8_t)((uint32_t)(x1 - 15) * 51u);
+  }
+  else
+  {
+    m9 = 255;
+  }
+
+  r0 = (m2 < m7) ? m2 : m7;
+  summ_alpha += r0;
+  r1 = (m2 < m6) ? m2 : m6;
+  summ_alpha_c += r1 * (4);
+  summ_alpha += r1;
+  r2 = (m5 > m8) ? m5 : m8;
+  r3 = (r2 > m9) ? r2 : m9;
+  r4 = (m2 < r3) ? m2 : r3;
+  summ_alpha_c += r4 * (25);
+  summ_alpha += r4;
+  r5 = (m9 > m8) ? m9 : m8;
+  r6 = (m1 < r5) ? m1 : r5;
+  summ_alpha_c += r6 * (25);
+  summ_alpha += r6;
+  r7 = (m1 < m5) ? m1 : m5;
+  summ_alpha_c += r7 * (4);
+  summ_alpha += r7;
+  r8 = (m1 < m6) ? m1 : m6;
+  summ_alpha += r8;
+  r9 = (m1 < m7) ? m1 : m7;
+  summ_alpha_c += r9 * (-4);
+  summ_alpha += r9;
+  r10 = (m0 < m7) ? m0 : m7;
+  summ_alpha_c += r10 * (-4);
+  summ_alpha += r10;
+  r11 = (m0 < m6) ? m0 : m6;
+  summ_alpha += r11;
+  r12 = (m0 < m5) ? m0 : m5;
+  summ_alpha += r12;
+  r13 = (m0 < m8) ? m0 : m8;
+  summ_alpha += r13;
+  r14 = (m0 < m9) ? m0 : m9;
+  summ_alpha_c += r14 * (4);
+  summ_alpha += r14;
+  r15 = (m7 > m6) ? m7 : m6;
+  r16 = (m3 < r15) ? m3 : r15;
+  summ_alpha_c += r16 * (-25);
+  summ_alpha += r16;
+  r17 = (m3 < m5) ? m3 : m5;
+  summ_alpha_c += r17 * (-4);
+  summ_alpha += r17;
+  r18 = (m3 < m8) ? m3 : m8;
+  summ_alpha += r18;
+  r19 = (m3 < m9) ? m3 : m9;
+  summ_alpha_c += r19 * (4);
+  summ_alpha += r19;
+  r20 = (m7 > m6) ? m7 : m6;
+  r21 = (m5 > r20) ? m5 : r20;
+  r22 = (m4 < r21) ? m4 : r21;
+  summ_alpha_c += r22 * (-25);
+  summ_alpha += r22;
+  r23 = (m4 < m8) ? m4 : m8;
+  summ_alpha_c += r23 * (-4);
+  summ_alpha += r23;
+  r24 = (m4 < m9) ? m4 : m9;
+  summ_alpha += r24;
+
+  if (summ_alpha == 0)
+  {
+    return 0;
+  }
+  return lim_s8 ((int16_t)(summ_alpha_c / summ_alpha));
+}
@@ -0,0 +1,45 @@
+/*******************************************************************************
+* \file     fuzzy_gen.c
+* \author   Ilya Petrukhin (ilya.petrukhin@gmail.com)
+* \brief    Generates specialized C code of the line controller
+*           Usage: fuzzy_gen [output file], default src/line_controller_gen.c
+*           Build: gcc -O2 -pthread -Isrc tools/fuzzy_gen.c src/fuzzy_*.c
+*                  src/line_controller.c -o fuzzy_gen
+* \version  2.1
+* \date     2026-10-17
+*******************************************************************************/
+#include  <stdio.h>
+#include  <stdint.h>
+#include  <stdbool.h>
+#include  "fuzzy_logic.h"
+#include  "fuzzy_model.h"
+#include  "fuzzy_codegen.h"
+#include  "line_controller.h"
+
+#define GEN_OUT   "src/line_controller_gen.c"
+
+
+int main (int argc, char **argv)
+{
+  const char *path = (argc > 1) ? argv[1] : GEN_OUT;
+  fuzzy_param param;
+  fuzzy_model model;
+  fuzzy_status st;
+  int8_t in[LINE_N_IN];
+
+  line_controller_param (&param, in);
+  if (fuzzy_compile (&param, &model) != FUZZY_OK)
+  {
+    printf ("Error model!\n");
+    return 1;
+  }
+  st = fuzzy_codegen (&model, "line_controller_gen", path);
+  fuzzy_model_free (&model);
+  if (st != FUZZY_OK)
+  {
+    printf ("Error code generation %d!\n", (int)st);
+    return 1;
+  }
+  printf ("%s written\n", path);
+  return 0;
+}
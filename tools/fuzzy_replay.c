@@ -0,0 +1,218 @@
+/*******************************************************************************
+* \file     fuzzy_replay.c
+* \author   Ilya Petrukhin (ilya.petrukhin@gmail.com)
+* \brief    Replays recorded sensor logs through the line controller
+*           Usage: fuzzy_replay [options] [input [output]], '-' or none - stdin / stdout
+*             -bin        input is binary int16 records (default CSV)
+*             -obin       output is binary int16 values (default CSV)
+*             -raw        inputs are not scaled by in0_scaling / in1_scaling
+*             -fcl file   controller from FCL file
+*             -image file controller from binary image
+*             -block n    samples per block
+*           Samples per second are reported to stderr.
+*           Build: gcc -O2 -pthread -Isrc tools/fuzzy_replay.c src/fuzzy_*.c
+*                  src/line_controller.c -o fuzzy_replay
+* \version  2.1
+* \date     2026-10-17
+*******************************************************************************/
+#include  <stdio.h>
+#include  <stdint.h>
+#include  <stdbool.h>
+#include  <stdlib.h>
+#include  <string.h>
+#include  "fuzzy_logic.h"
+#include  "fuzzy_model.h"
+#include  "fuzzy_fcl.h"
+#include  "fuzzy_image.h"
+#include  "fuzzy_stream.h"
+#include  "line_controller.h"
+
+#if defined (_WIN32)
+#include  <io.h>
+#include  <fcntl.h>
+#endif
+
+#define REPLAY_FBUF   (1u << 20)      ///< stdio buffer of the files
+
+
+static int usage (void)
+{
+  fprintf (stderr, "Usage: fuzzy_replay [-bin] [-obin] [-raw] [-fcl file | -image file]"
+                   " [-block n] [input [output]]\n");
+  return 2;
+}
+
+/// файл или стандартный поток ('-'), двоичный режим для двоичных записей
+static FILE *replay_open (const char *path, bool write, bool bin)
+{
+  if ((path == NULL) || (strcmp (path, "-") == 0))
+  {
+#if defined (_WIN32)
+    if (bin)
+    {
+      _setmode (_fileno (write ? stdout : stdin), _O_BINARY);
+    }
+#endif
+    return write ? stdout : stdin;
+  }
+  if (write)
+  {
+    return fopen (path, bin ? "wb" : "w");
+  }
+  return fopen (path, bin ? "rb" : "r");
+}
+
+
+int main (int argc, char **argv)
+{
+  const char *in_path = NULL, *out_path = NULL, *fcl_path = NULL, *image_path = NULL;
+  static fuzzy_fcl fcl;
+  static fuzzy_image img;
+  fuzzy_param param;
+  fuzzy_model model;
+  const fuzzy_model *run = &model;
+  fuzzy_stream_cfg cfg;
+  fuzzy_stream_result res;
+  fuzzy_status st;
+  FILE *in, *out;
+  bool raw = false;
+  unsigned line;
+  int8_t in_array[LINE_N_IN];
+  int i;
+
+  fuzzy_stream_default (&cfg);
+  for (i = 1; i < argc; i++)
+  {
+    if (strcmp (argv[i], "-bin") == 0)
+    {
+      cfg.in_format = FUZZY_STREAM_BIN;
+    }
+    else if (strcmp (argv[i], "-obin") == 0)
+    {
+      cfg.out_format = FUZZY_STREAM_BIN;
+    }
+    else if (strcmp (argv[i], "-raw") == 0)
+    {
+      raw = true;
+    }
+    else if ((strcmp (argv[i], "-fcl") == 0) && (i + 1 < argc))
+    {
+      fcl_path = argv[++i];
+    }
+    else if ((strcmp (argv[i], "-image") == 0) && (i + 1 < argc))
+    {
+      image_path = argv[++i];
+    }
+    else if ((strcmp (argv[i], "-block") == 0) && (i + 1 < argc))
+    {
+      cfg.block = (size_t)strtoul (argv[++i], NULL, 10);
+    }
+    else if ((argv[i][0] == '-') && (argv[i][1] != 0))
+    {
+      return usage ();
+    }
+    else if (in_path == NULL)
+    {
+      in_path = argv[i];
+    }
+    else if (out_path == NULL)
+    {
+      out_path = argv[i];
+    }
+    else
+    {
+      return usage ();
+    }
+  }
+
+  /// регулятор: встроенный, из FCL или из образа
+  memset (&model, 0, sizeof (model));
+  if (image_path)
+  {
+    st = fuzzy_image_map (image_path, &img);
+    if (st != FUZZY_OK)
+    {
+      fprintf (stderr, "Error image %s: %d!\n", image_path, (int)st);
+      return 1;
+    }
+    run = &img.model;
+  }
+  else
+  {
+    if (fcl_path)
+    {
+      st = fuzzy_fcl_load (fcl_path, &fcl, &line);
+      if (st != FUZZY_OK)
+      {
+        fprintf (stderr, "Error rules %s line %u!\n", fcl_path, line);
+        return 1;
+      }
+      param = fcl.param;
+    }
+    else
+    {
+      line_controller_param (&param, in_array);
+    }
+    if (fuzzy_compile (&param, &model) != FUZZY_OK)
+    {
+      fprintf (stderr, "Error model!\n");
+      return 1;
+    }
+  }
+  if (!raw)
+  {
+    cfg.scale[0] = in0_scaling;
+    cfg.scale[1] = in1_scaling;
+    cfg.out_scale = out_scaling;
+  }
+
+  in = replay_open (in_path, false, cfg.in_format == FUZZY_STREAM_BIN);
+  out = replay_open (out_path, true, cfg.out_format == FUZZY_STREAM_BIN);
+  if ((in == NULL) || (out == NULL))
+  {
+    fprintf (stderr, "Error open %s!\n", (in == NULL) ? in_path : out_path);
+    return 1;
+  }
+  /// блоки пишутся и читаются целиком, буфер stdio только для хвостов
+  setvbuf (in, NULL, _IOFBF, REPLAY_FBUF);
+  setvbuf (out, NULL, _IOFBF, REPLAY_FBUF);
+
+  st = fuzzy_stream_run (run, &cfg, in, out, &res);
+  if ((out != stdout) && (fclose (out) != 0) && (st == FUZZY_OK))
+  {
+    st = FUZZY_ERR_FILE;
+  }
+  if (in != stdin)
+  {
+    fclose (in);
+  }
+
+  if ((st == FUZZY_ERR_SYNTAX) && (cfg.in_format == FUZZY_STREAM_BIN))
+  {
+    fprintf (stderr, "Error input: incomplete record!\n");
+  }
+  else if (st == FUZZY_ERR_SYNTAX)
+  {
+    fprintf (stderr, "Error input line %u!\n", res.line);
+  }
+  else if (st != FUZZY_OK)
+  {
+    fprintf (stderr, "Error replay %d!\n", (int)st);
+  }
+  fprintf (stderr, "%llu samples, %.3f s, %.0f samples/s, eval %.1f%%, in %.1f MB/s, out %.1f MB/s\n",
+           (unsigned long long)res.samples, (double)res.time_ns * 1e-9, res.samples_per_s,
+           res.time_ns ? (100.0 * (double)res.eval_ns / (double)res.time_ns) : 0.0,
+           res.time_ns ? ((double)res.bytes_in * 1e3 / (double)res.time_ns) : 0.0,
+           res.time_ns ? ((double)res.bytes_out * 1e3 / (double)res.time_ns) : 0.0);
+
+  if (image_path)
+  {
+    fuzzy_image_unmap (&img);
+  }
+  else
+  {
+    fuzzy_model_free (&model);
+  }
+  fuzzy_fcl_free (&fcl);
+  return (st == FUZZY_OK) ? 0 : 1;
+}
@@ -0,0 +1,175 @@
+/*******************************************************************************
+* \file     fuzzy_wcet.c
+* \author   Ilya Petrukhin (ilya.petrukhin@gmail.com)
+* \brief    Worst-case execution time report of the line controller:
+*           the slowest input vector of the interpreter, the compiled model
+*           and the constant-time evaluation
+*           Usage: fuzzy_wcet [-fcl file] [-ts] [-samples n] [-repeat n] [-rounds n]
+*                             [-flush n]
+*             -fcl file   controller from FCL file
+*             -ts         line controller with first-order consequents
+*             -samples n  random vectors of models with more than two inputs
+*             -repeat n   calls per measurement
+*             -rounds n   measurements per vector
+*             -flush n    calls on random vectors before every measurement
+*           Build: gcc -O2 -pthread -Isrc tools/fuzzy_wcet.c src/fuzzy_*.c
+*                  src/line_controller.c -o fuzzy_wcet
+* \version  2.1
+* \date     2026-10-17
+*******************************************************************************/
+#include  <stdio.h>
+#include  <stdint.h>
+#include  <stdbool.h>
+#include  <stdlib.h>
+#include  <string.h>
+#include  "fuzzy_logic.h"
+#include  "fuzzy_model.h"
+#include  "fuzzy_fcl.h"
+#include  "fuzzy_ct.h"
+#include  "fuzzy_wcet.h"
+#include  "line_controller.h"
+
+/// Controller under test: interpreter parameters, compiled model and workspace
+typedef struct
+{
+  fuzzy_param       *param;
+  const fuzzy_model *model;
+  uint8_t           *ws;
+} wcet_ctl;
+
+
+static int usage (void)
+{
+  fprintf (stderr, "Usage: fuzzy_wcet [-fcl file] [-ts] [-samples n] [-repeat n] [-rounds n]"
+           " [-flush n]\n");
+  return 2;
+}
+
+/// интерпретатор: входы в массив параметров
+static int8_t eval_interp (void *ctx, const int8_t *in)
+{
+  wcet_ctl *c = ctx;
+
+  memcpy (c->param->in_array, in, c->model->n_in);
+  return process_fuzzy_logic (c->param);
+}
+
+static int8_t eval_compiled (void *ctx, const int8_t *in)
+{
+  wcet_ctl *c = ctx;
+
+  return process_fuzzy_logic_ws (c->model, in, c->ws);
+}
+
+static int8_t eval_ct (void *ctx, const int8_t *in)
+{
+  return process_fuzzy_logic_ct (ctx, in);
+}
+
+
+int main (int argc, char **argv)
+{
+  const char *fcl_path = NULL;
+  static fuzzy_fcl fcl;
+  fuzzy_param param;
+  fuzzy_model model;
+  fuzzy_ct ct;
+  wcet_ctl c;
+  fuzzy_wcet_cfg cfg;
+  fuzzy_wcet_report rep_compiled, rep_ct, rep;
+  int8_t in_array[LINE_N_IN];
+  unsigned line;
+  bool ts = false;
+  int i;
+
+  fuzzy_wcet_default (&cfg, 0);
+  for (i = 1; i < argc; i++)
+  {
+    if ((strcmp (argv[i], "-fcl") == 0) && (i + 1 < argc))
+    {
+      fcl_path = argv[++i];
+    }
+    else if (strcmp (argv[i], "-ts") == 0)
+    {
+      ts = true;
+    }
+    else if ((strcmp (argv[i], "-samples") == 0) && (i + 1 < argc))
+    {
+      cfg.samples = (uint32_t)strtoul (argv[++i], NULL, 10);
+    }
+    else if ((strcmp (argv[i], "-repeat") == 0) && (i + 1 < argc))
+    {
+      cfg.repeat = (uint32_t)strtoul (argv[++i], NULL, 10);
+    }
+    else if ((strcmp (argv[i], "-rounds") == 0) && (i + 1 < argc))
+    {
+      cfg.rounds = (uint32_t)strtoul (argv[++i], NULL, 10);
+    }
+    else if ((strcmp (argv[i], "-flush") == 0) && (i + 1 < argc))
+    {
+      cfg.flush = (uint32_t)strtoul (argv[++i], NULL, 10);
+    }
+    else
+    {
+      return usage ();
+    }
+  }
+
+  /// регулятор: встроенный или из FCL
+  if (fcl_path)
+  {
+    if (fuzzy_fcl_load (fcl_path, &fcl, &line) != FUZZY_OK)
+    {
+      fprintf (stderr, "Error rules %s line %u!\n", fcl_path, line);
+      return 1;
+    }
+    param = fcl.param;
+  }
+  else if (ts)
+  {
+    line_controller_ts_param (&param, in_array);
+  }
+  else
+  {
+    line_controller_param (&param, in_array);
+  }
+  if ((fuzzy_compile (&param, &model) != FUZZY_OK) || (fuzzy_ct_init (&model, &ct) != FUZZY_OK))
+  {
+    fprintf (stderr, "Error model!\n");
+    return 1;
+  }
+  if ((model.n_in == 0) || (model.n_in > FUZZY_WCET_MAX_IN))
+  {
+    fprintf (stderr, "Error model: %u inputs!\n", (unsigned)model.n_in);
+    return 1;
+  }
+  c.param = &param;
+  c.model = &model;
+  c.ws = malloc (fuzzy_workspace_size (&model));
+  if (c.ws == NULL)
+  {
+    return 1;
+  }
+  fuzzy_workspace_init (&model, c.ws);
+  cfg.n_in = model.n_in;
+
+  printf ("%u inputs, %u functions, %u rules\n", (unsigned)model.n_in, (unsigned)model.n_mf,
+          (unsigned)model.n_rule);
+  if ((fuzzy_wcet_search (eval_interp, &c, &cfg, &rep) != FUZZY_OK) ||
+      (fuzzy_wcet_search (eval_compiled, &c, &cfg, &rep_compiled) != FUZZY_OK) ||
+      (fuzzy_wcet_search (eval_ct, &ct, &cfg, &rep_ct) != FUZZY_OK))
+  {
+    fprintf (stderr, "Error search!\n");
+    return 1;
+  }
+  fuzzy_wcet_print ("interp", &rep, stdout);
+  fuzzy_wcet_print ("compiled", &rep_compiled, stdout);
+  fuzzy_wcet_print ("ct", &rep_ct, stdout);
+  printf ("budget: compiled %.2f ns, ct %.2f ns per call (worst case of this machine)\n",
+          rep_compiled.worst_ns, rep_ct.worst_ns);
+
+  free (c.ws);
+  fuzzy_ct_free (&ct);
+  fuzzy_model_free (&model);
+  return 0;
+}